@@ -4,6 +4,7 @@
  *
  */
 
+#include "SpinPause.h"
 #include "BusyPeriodicRunner.h"
 
 #include <iostream>
@@ -17,7 +18,7 @@ size_t PeriodicScheduler::events() const{
     return m_events.size();
 }
 bool PeriodicScheduler::add_event(void* event, std::chrono::milliseconds period, WallClock start){
-    auto ret = m_events.emplace(event, PeriodicEvent{m_callback_id, period});
+    auto ret = m_events.emplace(event, PeriodicEvent{m_callback_id, period, start});
     if (!ret.second){
         //  Already exists. Do nothing.
         return false;
@@ -36,7 +37,14 @@ bool PeriodicScheduler::add_event(void* event, std::chrono::milliseconds period,
 }
 void PeriodicScheduler::remove_event(void* event){
     //  No need to remove from scheduler since it will be skipped over automatically.
-    m_events.erase(event);
+    auto iter = m_events.find(event);
+    if (iter == m_events.end()){
+        return;
+    }
+    if (iter->second.parked){
+        m_parked--;
+    }
+    m_events.erase(iter);
 }
 WallClock PeriodicScheduler::next_event() const{
     auto iter = m_schedule.begin();
@@ -67,9 +75,26 @@ void* PeriodicScheduler::request_next_event(WallClock timestamp){
             continue;
         }
 
+        PeriodicEvent& periodic = iter1->second;
+
+        //  Parked. Push it back to when the park expires.
+        if (periodic.parked && timestamp < periodic.parked_until){
+            m_schedule.emplace(periodic.parked_until, event);
+            m_schedule.erase(iter0);
+            periodic.next = periodic.parked_until;
+            periodic.deferred = true;
+            continue;
+        }
+        if (periodic.parked){
+            periodic.parked = false;
+            m_parked--;
+        }
+        periodic.deferred = false;
+
         //  Schedule the next event first so that we retain strong exception safety if it throws.
-        WallClock next = std::max(iter0->first + iter1->second.period, timestamp);
+        WallClock next = std::max(iter0->first + periodic.period, timestamp);
         m_schedule.emplace(next, iter0->second);
+        periodic.next = next;
 
         //  Now remove the current event.
         m_schedule.erase(iter0);
@@ -77,6 +102,45 @@ void* PeriodicScheduler::request_next_event(WallClock timestamp){
         return event.event;
     }
 }
+void PeriodicScheduler::park_event(void* event, WallClock until){
+    auto iter = m_events.find(event);
+    if (iter == m_events.end()){
+        return;
+    }
+    PeriodicEvent& periodic = iter->second;
+    if (!periodic.parked){
+        m_parked++;
+    }
+    periodic.parked = true;
+    periodic.parked_until = until;
+}
+void PeriodicScheduler::wake_parked(WallClock timestamp){
+    if (m_parked == 0){
+        return;
+    }
+    for (auto& item : m_events){
+        PeriodicEvent& periodic = item.second;
+        if (!periodic.parked){
+            continue;
+        }
+        periodic.parked = false;
+        m_parked--;
+
+        //  Still waiting on its period. Leave it where it is.
+        if (!periodic.deferred){
+            continue;
+        }
+
+        //  It was already due. Give it a new id so the deferred entry gets
+        //  skipped and schedule it now.
+        uint64_t id = m_callback_id;
+        m_schedule.emplace(timestamp, SingleEvent{id, item.first});
+        m_callback_id++;
+        periodic.id = id;
+        periodic.next = timestamp;
+        periodic.deferred = false;
+    }
+}
 
 
 
@@ -107,6 +171,8 @@ private:
 BusyPeriodicRunner::BusyPeriodicRunner(ThreadPool& thread_pool)
     : m_thread_pool(thread_pool)
     , m_pending_waits(0)
+    , m_wake_parked(false)
+    , m_sleeping(false)
 {}
 bool BusyPeriodicRunner::add_event(void* event, std::chrono::milliseconds period, WallClock start){
     throw_if_cancelled();
@@ -136,6 +202,34 @@ void BusyPeriodicRunner::remove_event(void* event){
         m_utilization.push_idle();
     }
 }
+void BusyPeriodicRunner::park_event(void* event, WallClock until){
+    //  run() is called with the lock held.
+    m_scheduler.park_event(event, until);
+}
+void BusyPeriodicRunner::wake_parked_events() noexcept{
+    //  The runner sets "m_sleeping" before it checks the flag for the last
+    //  time and goes to sleep. Both are seq_cst so at least one side sees the
+    //  other's write: either the runner sees the flag and doesn't sleep, or we
+    //  see that it's (about to be) asleep and notify it.
+    m_wake_parked.store(true, std::memory_order_seq_cst);
+
+    //  The runner is busy. It will check the flag before it sleeps again.
+    //  This is the common case since the runner holds the lock while it runs
+    //  events, so we must not wait on the lock here.
+    //
+    //  Otherwise, the runner may still be between its check and the wait. It
+    //  only releases the lock once it is waiting, so a notify is only
+    //  guaranteed to reach it if we hold the lock. That window is short and
+    //  runs no events, so spin on try_lock() instead of blocking.
+    while (m_sleeping.load(std::memory_order_seq_cst)){
+        std::unique_lock<Mutex> lg(m_lock, std::try_to_lock);
+        if (lg.owns_lock()){
+            m_cv.notify_all();
+            return;
+        }
+        pause();
+    }
+}
 bool BusyPeriodicRunner::cancel(std::exception_ptr exception) noexcept{
     if (Cancellable::cancel(std::move(exception))){
         return true;
@@ -161,6 +255,10 @@ void BusyPeriodicRunner::thread_loop(){
 
         WallClock now = current_time();
 
+        if (m_wake_parked.exchange(false, std::memory_order_acq_rel)){
+            m_scheduler.wake_parked(now);
+        }
+
         {
             WriteSpinLock lg1(m_stats_lock);
             m_utilization.push_event(now - last_check_timestamp - idle_since_last_check, now);
@@ -186,12 +284,20 @@ void BusyPeriodicRunner::thread_loop(){
             return;
         }
 
+        //  See wake_parked_events().
+        m_sleeping.store(true, std::memory_order_seq_cst);
+        if (m_wake_parked.load(std::memory_order_seq_cst)){
+            m_sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
         WallClock start = current_time();
         if (next < WallClock::max()){
             m_cv.wait_until(lg, next);
         }else{
             m_cv.wait(lg);
         }
+        m_sleeping.store(false, std::memory_order_relaxed);
         WallClock end = current_time();
         idle_since_last_check += end - start;
     }
@@ -42,11 +42,24 @@ public:
     //  If nothing is before the current timestamp, return nullptr.
     void* request_next_event(WallClock timestamp = current_time());
 
+    //  Hold back "event" until wake_parked() or until "until", whichever is
+    //  first. The period is still respected. A parked event that has come due
+    //  fires as soon as it is woken.
+    void park_event(void* event, WallClock until);
+    void wake_parked(WallClock timestamp = current_time());
+
 private:
     //  "id" is needed to solve the ABA problem if the same pointer is removed/re-added.
     struct PeriodicEvent{
         uint64_t id;
         std::chrono::milliseconds period;
+        WallClock next;
+
+        bool parked = false;
+        WallClock parked_until;
+
+        //  The event came due while parked and was pushed back to "parked_until".
+        bool deferred = false;
     };
     struct SingleEvent{
         uint64_t id;
@@ -55,6 +68,7 @@ private:
 
 private:
     uint64_t m_callback_id = 0;
+    size_t m_parked = 0;
     std::map<void*, PeriodicEvent> m_events;
     std::multimap<WallClock, SingleEvent> m_schedule;
 };
@@ -78,6 +92,15 @@ protected:
     bool add_event(void* event, std::chrono::milliseconds period, WallClock start = current_time());
     void remove_event(void* event);
 
+    //  Only call this from inside run() on the event being run.
+    //  Skip "event" until wake_parked_events() is called or "until" is reached.
+    void park_event(void* event, WallClock until);
+
+    //  Release all parked events. This never waits for a running event so it
+    //  is safe to call from threads that must not stall (like the video frame
+    //  callback). At most it spins briefly while the runner goes to sleep.
+    void wake_parked_events() noexcept;
+
     //  Run the event. "is_back_to_back" is true if there was no wait between
     //  this event and the previous one.
     //  This can be used is a performance hint to the child class to reuse
@@ -94,6 +117,8 @@ private:
     ThreadPool& m_thread_pool;
 
     std::atomic<size_t> m_pending_waits;
+    std::atomic<bool> m_wake_parked;
+    std::atomic<bool> m_sleeping;   //  The runner is waiting on (or about to wait on) "m_cv".
     Mutex m_lock;
     ConditionVariable m_cv;
 
@@ -34,9 +34,12 @@ public:
     size_t empty() const{ return m_front == m_back; }
     size_t full() const{ return m_back - m_front >= m_capacity; }
     size_t size() const{ return m_back - m_front; }
+    size_t capacity() const{ return m_capacity; }
 
     const Object& front() const;
           Object& front();
+    const Object& back() const;
+          Object& back();
     const Object& operator[](size_t index) const;
           Object& operator[](size_t index);
 
@@ -46,6 +49,7 @@ public:
     template <class... Args>
     Object* try_push_back(Args&&... args);
     void pop_front();
+    void pop_back();
 
 private:
     size_t m_capacity;
@@ -147,6 +151,16 @@ Object& CircularBuffer<Object>::front(){
     return m_ptr[m_front];
 }
 template <typename Object>
+const Object& CircularBuffer<Object>::back() const{
+    size_t back = m_back - 1;
+    return m_ptr[back >= m_capacity ? back - m_capacity : back];
+}
+template <typename Object>
+Object& CircularBuffer<Object>::back(){
+    size_t back = m_back - 1;
+    return m_ptr[back >= m_capacity ? back - m_capacity : back];
+}
+template <typename Object>
 const Object& CircularBuffer<Object>::operator[](size_t index) const{
     index += m_front;
     if (index >= m_capacity){
@@ -204,6 +218,14 @@ void CircularBuffer<Object>::pop_front(){
     m_front = front - diff;
     m_back -= diff;
 }
+template <typename Object>
+void CircularBuffer<Object>::pop_back(){
+    if (m_front == m_back){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "CircularBuffer: Attempted to pop while empty.");
+    }
+    back().~Object();
+    m_back--;
+}
 
 
 
@@ -0,0 +1,45 @@
+/*  CPU Affinity
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "CpuAffinity.h"
+
+
+#if _WIN32
+#include "CpuAffinity_Windows.tpp"
+#endif
+
+#if defined(__linux) || defined(__APPLE__)
+#include "CpuAffinity_Linux.tpp"
+#endif
+
+
+namespace PokemonAutomation{
+
+
+std::string processor_list_to_string(const std::vector<size_t>& processors){
+    std::string str;
+    size_t c = 0;
+    while (c < processors.size()){
+        size_t start = processors[c];
+        size_t end = start;
+        c++;
+        while (c < processors.size() && processors[c] == end + 1){
+            end++;
+            c++;
+        }
+        if (!str.empty()){
+            str += ", ";
+        }
+        str += std::to_string(start);
+        if (end != start){
+            str += "-" + std::to_string(end);
+        }
+    }
+    return str;
+}
+
+
+}
@@ -0,0 +1,47 @@
+/*  CPU Affinity
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Processor topology and per-thread core affinity.
+ *
+ *  Processor IDs are the OS processor numbers. On Windows, only the first
+ *  processor group is supported. (same as the process-wide core affinity
+ *  option) On macOS, affinity is not supported and setting it will fail.
+ *
+ */
+
+#ifndef PokemonAutomation_CpuAffinity_H
+#define PokemonAutomation_CpuAffinity_H
+
+#include <string>
+#include <vector>
+
+namespace PokemonAutomation{
+
+
+struct LogicalProcessor{
+    size_t id;      //  OS processor number.
+    size_t core;    //  Physical core. SMT siblings have the same value.
+    size_t node;    //  NUMA node.
+};
+
+//  All processors this process is allowed to run on, sorted by ID.
+//  This is read once on first use.
+const std::vector<LogicalProcessor>& logical_processors();
+
+//  Restrict the current thread to the specified processors.
+//  An empty list allows all processors in logical_processors().
+//  Returns false if this isn't supported or the OS rejected it.
+bool set_this_thread_affinity(const std::vector<size_t>& processors);
+
+//  The processor the current thread is running on right now.
+//  Returns -1 if this isn't supported.
+int current_processor();
+
+//  "0-3, 8, 10-11"
+std::string processor_list_to_string(const std::vector<size_t>& processors);
+
+
+
+}
+#endif
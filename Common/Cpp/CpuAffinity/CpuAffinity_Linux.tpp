@@ -0,0 +1,136 @@
+/*  CPU Affinity (Linux)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <map>
+#include <thread>
+#include <fstream>
+#include <dirent.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include "CpuAffinity.h"
+
+namespace PokemonAutomation{
+
+
+
+#if defined(__APPLE__)
+
+//  macOS has no way to pin a thread. Report every processor as its own core.
+const std::vector<LogicalProcessor>& logical_processors(){
+    static const std::vector<LogicalProcessor> processors = []{
+        std::vector<LogicalProcessor> ret;
+        size_t count = std::thread::hardware_concurrency();
+        for (size_t c = 0; c < count; c++){
+            ret.emplace_back(LogicalProcessor{c, c, 0});
+        }
+        return ret;
+    }();
+    return processors;
+}
+bool set_this_thread_affinity(const std::vector<size_t>& processors){
+    return false;
+}
+int current_processor(){
+    return -1;
+}
+
+#else
+
+namespace{
+
+bool read_sysfs_integer(const std::string& path, size_t& value){
+    std::ifstream file(path);
+    return (bool)(file >> value);
+}
+size_t read_numa_node(size_t processor){
+    //  "/sys/devices/system/cpu/cpu3/node0" exists if cpu3 is on node 0.
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(processor);
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr){
+        return 0;
+    }
+    size_t node = 0;
+    while (dirent* entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            name.find_first_not_of("0123456789", 4) == std::string::npos
+        ){
+            node = std::stoull(name.substr(4));
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+}
+
+
+const std::vector<LogicalProcessor>& logical_processors(){
+    static const std::vector<LogicalProcessor> processors = []{
+        std::vector<LogicalProcessor> ret;
+
+        //  The main thread's mask is the process mask.
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(getpid(), sizeof(allowed), &allowed) != 0){
+            size_t count = std::thread::hardware_concurrency();
+            for (size_t c = 0; c < count; c++){
+                ret.emplace_back(LogicalProcessor{c, c, 0});
+            }
+            return ret;
+        }
+
+        //  (package, core_id) -> dense core index
+        std::map<std::pair<size_t, size_t>, size_t> cores;
+        for (size_t c = 0; c < CPU_SETSIZE; c++){
+            if (!CPU_ISSET(c, &allowed)){
+                continue;
+            }
+            std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/";
+            size_t package = 0;
+            size_t core_id = c;
+            read_sysfs_integer(topology + "physical_package_id", package);
+            if (!read_sysfs_integer(topology + "core_id", core_id)){
+                core_id = c;
+                package = 0;
+            }
+            auto iter = cores.emplace(std::make_pair(package, core_id), cores.size()).first;
+            ret.emplace_back(LogicalProcessor{c, iter->second, read_numa_node(c)});
+        }
+        return ret;
+    }();
+    return processors;
+}
+bool set_this_thread_affinity(const std::vector<size_t>& processors){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (processors.empty()){
+        for (const LogicalProcessor& processor : logical_processors()){
+            CPU_SET(processor.id, &set);
+        }
+    }else{
+        for (size_t processor : processors){
+            if (processor < CPU_SETSIZE){
+                CPU_SET(processor, &set);
+            }
+        }
+    }
+    if (CPU_COUNT(&set) == 0){
+        return false;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+int current_processor(){
+    return sched_getcpu();
+}
+
+#endif
+
+
+
+}
@@ -0,0 +1,109 @@
+/*  CPU Affinity (Windows)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <memory>
+#include <Windows.h>
+#include "CpuAffinity.h"
+
+namespace PokemonAutomation{
+
+
+
+const std::vector<LogicalProcessor>& logical_processors(){
+    static const std::vector<LogicalProcessor> processors = []{
+        std::vector<LogicalProcessor> ret;
+
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)){
+            process_mask = ((DWORD_PTR)1 << (GetActiveProcessorCount(0) - 1) << 1) - 1;
+        }
+
+        const size_t BITS = sizeof(DWORD_PTR) * 8;
+        std::vector<size_t> core_of(BITS);
+        std::vector<size_t> node_of(BITS, 0);
+        for (size_t c = 0; c < BITS; c++){
+            core_of[c] = c;
+        }
+
+        DWORD bytes = 0;
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &bytes);
+        std::unique_ptr<char[]> buffer(new char[bytes]);
+        if (bytes != 0 && GetLogicalProcessorInformationEx(
+            RelationAll,
+            (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer.get(),
+            &bytes
+        )){
+            size_t core = 0;
+            for (DWORD offset = 0; offset < bytes;){
+                auto* info = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)(buffer.get() + offset);
+                offset += info->Size;
+
+                KAFFINITY mask;
+                if (info->Relationship == RelationProcessorCore){
+                    if (info->Processor.GroupMask[0].Group != 0){
+                        continue;
+                    }
+                    mask = info->Processor.GroupMask[0].Mask;
+                    for (size_t c = 0; c < BITS; c++){
+                        if (mask & ((KAFFINITY)1 << c)){
+                            core_of[c] = core;
+                        }
+                    }
+                    core++;
+                }else if (info->Relationship == RelationNumaNode){
+                    if (info->NumaNode.GroupMask.Group != 0){
+                        continue;
+                    }
+                    mask = info->NumaNode.GroupMask.Mask;
+                    for (size_t c = 0; c < BITS; c++){
+                        if (mask & ((KAFFINITY)1 << c)){
+                            node_of[c] = info->NumaNode.NodeNumber;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (size_t c = 0; c < BITS; c++){
+            if (process_mask & ((DWORD_PTR)1 << c)){
+                ret.emplace_back(LogicalProcessor{c, core_of[c], node_of[c]});
+            }
+        }
+        return ret;
+    }();
+    return processors;
+}
+bool set_this_thread_affinity(const std::vector<size_t>& processors){
+    DWORD_PTR mask = 0;
+    if (processors.empty()){
+        for (const LogicalProcessor& processor : logical_processors()){
+            mask |= (DWORD_PTR)1 << processor.id;
+        }
+    }else{
+        for (size_t processor : processors){
+            if (processor < sizeof(DWORD_PTR) * 8){
+                mask |= (DWORD_PTR)1 << processor;
+            }
+        }
+    }
+    if (mask == 0){
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+int current_processor(){
+    PROCESSOR_NUMBER number;
+    GetCurrentProcessorNumberEx(&number);
+    if (number.Group != 0){
+        return -1;
+    }
+    return (int)number.Number;
+}
+
+
+
+}
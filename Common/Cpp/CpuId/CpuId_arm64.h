@@ -17,6 +17,9 @@ struct CPU_Features{
     CPU_Features& set_to_current();
 
     bool OK_M1 = false;
+
+    //  ARMv8 SHA256 instructions.
+    bool HW_SHA2 = false;
 };
 
 
@@ -37,8 +37,20 @@ uint64_t detect_NEON()
     return available;
 }
 
+uint64_t detect_SHA2(){
+    uint64_t available = 0;
+    size_t size = sizeof(available);
+    if (sysctlbyname("hw.optional.arm.FEAT_SHA256", &available, &size, NULL, 0) < 0){
+        //  Older macOS doesn't have this attribute. Every Apple arm64 chip has
+        //  the SHA2 instructions so fall back to NEON.
+        return detect_NEON();
+    }
+    return available;
+}
+
 CPU_Features& CPU_Features::set_to_current(){
     OK_M1 = detect_NEON() > 0;
+    HW_SHA2 = detect_SHA2() > 0;
     return *this;
 }
 
@@ -46,6 +58,7 @@ CPU_Features make_M1(){
     CPU_Features ret;
 
     ret.OK_M1 = true;
+    ret.HW_SHA2 = true;
     return ret;
 }
 
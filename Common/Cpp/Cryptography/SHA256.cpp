@@ -5,6 +5,8 @@
  */
 
 #include <string.h>
+#include <algorithm>
+#include "Common/Cpp/CpuId/CpuId.h"
 #include "SHA256.h"
 
 namespace PokemonAutomation{
@@ -20,7 +22,8 @@ uint32_t rotate_right32(uint32_t x, int bits){
 }
 
 
-const uint32_t SHA256::ROUND_CONSTANTS[64] = {
+extern const uint32_t SHA256_ROUND_CONSTANTS[64];
+const uint32_t SHA256_ROUND_CONSTANTS[64] = {
     0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
     0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
     0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -30,6 +33,81 @@ const uint32_t SHA256::ROUND_CONSTANTS[64] = {
     0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
+
+
+
+void sha256_compress_Default(uint32_t state[8], const void* data, size_t blocks){
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+    for (; blocks > 0; blocks--, ptr += 64){
+        uint32_t w[64];
+        memcpy(w, ptr, 64);
+        for (int i = 0; i < 16; i++){
+            w[i] = byte_swap32(w[i]);
+        }
+
+        for (int i = 16; i < 64; i++){
+            uint32_t s0 = rotate_right32(w[i - 15],  7) ^ rotate_right32(w[i - 15], 18) ^ (w[i - 15] >>  3);
+            uint32_t s1 = rotate_right32(w[i -  2], 17) ^ rotate_right32(w[i -  2], 19) ^ (w[i -  2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+        for (int i = 0; i < 64; i++){
+            uint32_t s0 = rotate_right32(e,  6) ^ rotate_right32(e, 11) ^ rotate_right32(e, 25);
+            uint32_t x0 = (e & f) ^ (~e & g);
+            uint32_t t0 = h + s0 + x0 + SHA256_ROUND_CONSTANTS[i] + w[i];
+            uint32_t s1 = rotate_right32(a,  2) ^ rotate_right32(a, 13) ^ rotate_right32(a, 22);
+            uint32_t x1 = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t1 = s1 + x1;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t0;
+            d = c;
+            c = b;
+            b = a;
+            a = t0 + t1;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+void sha256_compress_x64_SHA(uint32_t state[8], const void* data, size_t blocks);
+void sha256_compress_arm64_SHA2(uint32_t state[8], const void* data, size_t blocks);
+
+
+void sha256_compress(uint32_t state[8], const void* data, size_t blocks){
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem && CPU_CAPABILITY_CURRENT.HW_SHA){
+        sha256_compress_x64_SHA(state, data, blocks);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.HW_SHA2){
+        sha256_compress_arm64_SHA2(state, data, blocks);
+        return;
+    }
+#endif
+    sha256_compress_Default(state, data, blocks);
+}
+
+
+
 void SHA256::reset(){
     m_bytes_loaded = 0;
     m_bytes_in_buffer = 0;
@@ -44,74 +122,46 @@ void SHA256::reset(){
 }
 void SHA256::push(const void* data, size_t bytes){
     const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
-    for (; bytes > 0; bytes--){
-        m_bytes_loaded++;
-        m_buffer[m_bytes_in_buffer++] = *ptr++;
-        if (m_bytes_in_buffer == 64){
-            push_block();
-            m_bytes_in_buffer = 0;
+    m_bytes_loaded += bytes;
+
+    //  Top off the partial block from the previous push.
+    if (m_bytes_in_buffer != 0){
+        size_t current = std::min<size_t>(64 - m_bytes_in_buffer, bytes);
+        memcpy(m_buffer + m_bytes_in_buffer, ptr, current);
+        m_bytes_in_buffer += (uint32_t)current;
+        ptr += current;
+        bytes -= current;
+        if (m_bytes_in_buffer < 64){
+            return;
         }
-    }
-}
-void SHA256::push_block(){
-    uint32_t w[64];
-    for (int i = 0; i < 16; i++){
-        w[i] = byte_swap32(m_words[i]);
-    }
-
-    for (int i = 16; i < 64; i++){
-        uint32_t s0 = rotate_right32(w[i - 15],  7) ^ rotate_right32(w[i - 15], 18) ^ (w[i - 15] >>  3);
-        uint32_t s1 = rotate_right32(w[i -  2], 17) ^ rotate_right32(w[i -  2], 19) ^ (w[i -  2] >> 10);
-        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        sha256_compress(m_hash, m_buffer, 1);
+        m_bytes_in_buffer = 0;
     }
 
-    uint32_t a = m_hash[0];
-    uint32_t b = m_hash[1];
-    uint32_t c = m_hash[2];
-    uint32_t d = m_hash[3];
-    uint32_t e = m_hash[4];
-    uint32_t f = m_hash[5];
-    uint32_t g = m_hash[6];
-    uint32_t h = m_hash[7];
-    for (int i = 0; i < 64; i++){
-        uint32_t s0 = rotate_right32(e,  6) ^ rotate_right32(e, 11) ^ rotate_right32(e, 25);
-        uint32_t x0 = (e & f) ^ (~e & g);
-        uint32_t t0 = h + s0 + x0 + ROUND_CONSTANTS[i] + w[i];
-        uint32_t s1 = rotate_right32(a,  2) ^ rotate_right32(a, 13) ^ rotate_right32(a, 22);
-        uint32_t x1 = (a & b) ^ (a & c) ^ (b & c);
-        uint32_t t1 = s1 + x1;
-        h = g;
-        g = f;
-        f = e;
-        e = d + t0;
-        d = c;
-        c = b;
-        b = a;
-        a = t0 + t1;
+    //  Hash all the full blocks directly from the input.
+    size_t blocks = bytes / 64;
+    if (blocks != 0){
+        sha256_compress(m_hash, ptr, blocks);
+        ptr += blocks * 64;
+        bytes -= blocks * 64;
     }
 
-    m_hash[0] += a;
-    m_hash[1] += b;
-    m_hash[2] += c;
-    m_hash[3] += d;
-    m_hash[4] += e;
-    m_hash[5] += f;
-    m_hash[6] += g;
-    m_hash[7] += h;
+    memcpy(m_buffer, ptr, bytes);
+    m_bytes_in_buffer = (uint32_t)bytes;
 }
 void SHA256::finish(){
     m_buffer[m_bytes_in_buffer++] = 0x80;
     memset(m_buffer + m_bytes_in_buffer, 0, 64 - m_bytes_in_buffer);
 
     if (m_bytes_in_buffer > 56){
-        push_block();
+        sha256_compress(m_hash, m_buffer, 1);
         memset(m_buffer, 0, 64);
     }
 
     uint64_t bits = m_bytes_loaded * 8;
     m_words[15] = byte_swap32((uint32_t)bits);
     m_words[14] = byte_swap32((uint32_t)(bits >> 32));
-    push_block();
+    sha256_compress(m_hash, m_buffer, 1);
 }
 
 
@@ -13,6 +13,11 @@
 namespace PokemonAutomation{
 
 
+//  Run the SHA256 compression function on "blocks" consecutive 64-byte blocks.
+//  Uses the SHA extensions if the CPU has them.
+void sha256_compress(uint32_t state[8], const void* data, size_t blocks);
+
+
 
 class SHA256{
     uint32_t m_hash[8];
@@ -33,10 +38,6 @@ public:
     void reset();
     void push(const void* data, size_t bytes);
     void finish();
-
-private:
-    static const uint32_t ROUND_CONSTANTS[64];
-    void push_block();
 };
 
 
@@ -0,0 +1,59 @@
+/* SHA256 (arm64 SHA2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  SHA256 compression using the ARMv8 SHA2 instructions.
+ *
+ */
+
+#ifdef PA_AutoDispatch_arm64_20_M1
+
+#include <arm_neon.h>
+#include "SHA256.h"
+
+namespace PokemonAutomation{
+
+
+extern const uint32_t SHA256_ROUND_CONSTANTS[64];
+
+
+void sha256_compress_arm64_SHA2(uint32_t state[8], const void* data, size_t blocks){
+    uint32x4_t state0 = vld1q_u32(&state[0]);   //  ABCD
+    uint32x4_t state1 = vld1q_u32(&state[4]);   //  EFGH
+
+    const uint8_t* ptr = (const uint8_t*)data;
+    for (; blocks > 0; blocks--, ptr += 64){
+        const uint32x4_t abcd = state0;
+        const uint32x4_t efgh = state1;
+
+        uint32x4_t w[4];
+        for (size_t g = 0; g < 16; g++){
+            uint32x4_t& current = w[g % 4];
+            if (g < 4){
+                current = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(ptr + 16 * g)));
+            }else{
+                //  w[i - 16] + s0(w[i - 15]) + w[i - 7] + s1(w[i - 2])
+                current = vsha256su1q_u32(
+                    vsha256su0q_u32(current, w[(g + 1) % 4]),
+                    w[(g + 2) % 4], w[(g + 3) % 4]
+                );
+            }
+
+            uint32x4_t message = vaddq_u32(current, vld1q_u32(&SHA256_ROUND_CONSTANTS[4 * g]));
+            uint32x4_t previous = state0;
+            state0 = vsha256hq_u32(state0, state1, message);
+            state1 = vsha256h2q_u32(state1, previous, message);
+        }
+
+        state0 = vaddq_u32(state0, abcd);
+        state1 = vaddq_u32(state1, efgh);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+
+
+}
+#endif
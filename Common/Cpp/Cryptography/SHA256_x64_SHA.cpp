@@ -0,0 +1,67 @@
+/* SHA256 (x64 SHA)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  SHA256 compression using the Intel SHA extensions.
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <immintrin.h>
+#include "SHA256.h"
+
+namespace PokemonAutomation{
+
+
+extern const uint32_t SHA256_ROUND_CONSTANTS[64];
+
+
+void sha256_compress_x64_SHA(uint32_t state[8], const void* data, size_t blocks){
+    const __m128i BYTE_SWAP = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    //  The SHA instructions want the state as ABEF and CDGH.
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1);      //  CDAB
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b);   //  EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   //  ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);        //  CDGH
+
+    const __m128i* ptr = (const __m128i*)data;
+    for (; blocks > 0; blocks--, ptr += 4){
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+
+        __m128i w[4];
+        for (size_t g = 0; g < 16; g++){
+            __m128i& current = w[g % 4];
+            if (g < 4){
+                current = _mm_shuffle_epi8(_mm_loadu_si128(ptr + g), BYTE_SWAP);
+            }else{
+                //  w[i - 16] + s0(w[i - 15]) + w[i - 7] + s1(w[i - 2])
+                __m128i x = _mm_sha256msg1_epu32(current, w[(g + 1) % 4]);
+                x = _mm_add_epi32(x, _mm_alignr_epi8(w[(g + 3) % 4], w[(g + 2) % 4], 4));
+                current = _mm_sha256msg2_epu32(x, w[(g + 3) % 4]);
+            }
+
+            __m128i message = _mm_add_epi32(current, _mm_loadu_si128((const __m128i*)&SHA256_ROUND_CONSTANTS[4 * g]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            message = _mm_shuffle_epi32(message, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);              //  FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1);           //  DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);        //  DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           //  HGFE
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+
+
+}
+#endif
@@ -6,7 +6,7 @@
 
 #include "Common/Cpp/Filesystem/FileIO.h"
 #include "JsonArray.h"
-#include "JsonTools.h"
+#include "JsonParser.h"
 
 namespace PokemonAutomation{
 
@@ -27,11 +27,9 @@ JsonArray JsonArray::clone() const{
 
 
 std::string JsonArray::dump(int indent) const{
-    nlohmann::json::array_t ret;
-    for (const auto& item : *this){
-        ret.emplace_back(to_nlohmann(item));
-    }
-    return nlohmann::json(ret).dump(indent);
+    std::string ret;
+    dump_json_native(ret, *this, indent);
+    return ret;
 }
 void JsonArray::dump(const std::string& filename, int indent) const{
     string_to_file(filename, dump(indent));
@@ -6,7 +6,7 @@
 
 #include "Common/Cpp/Filesystem/FileIO.h"
 #include "JsonObject.h"
-#include "JsonTools.h"
+#include "JsonParser.h"
 
 namespace PokemonAutomation{
 
@@ -221,11 +221,9 @@ bool JsonObject::read_string(std::string& value, const std::string& key) const{
 
 
 std::string JsonObject::dump(int indent) const{
-    nlohmann::json ret;
-    for (const auto& item : *this){
-        ret[item.first] = to_nlohmann(item.second);
-    }
-    return nlohmann::json(ret).dump(indent);
+    std::string ret;
+    dump_json_native(ret, *this, indent);
+    return ret;
 }
 void JsonObject::dump(const std::string& filename, int indent) const{
     string_to_file(filename, dump(indent));
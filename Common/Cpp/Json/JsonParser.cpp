@@ -0,0 +1,732 @@
+/*  JSON Parser
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <cmath>
+#include "3rdParty/nlohmann/json.hpp"
+#include "JsonArray.h"
+#include "JsonObject.h"
+#include "JsonParser.h"
+
+namespace PokemonAutomation{
+
+
+
+//
+//  Parser
+//
+
+namespace{
+
+//  Guard against stack overflow on malicious input.
+constexpr size_t MAX_JSON_DEPTH = 4096;
+
+
+//  Length of the multi-byte UTF-8 sequence starting at "ptr". (RFC 3629)
+//  Returns 0 if it is not valid.
+size_t utf8_sequence_length(const char* p_ptr, const char* p_end){
+    const unsigned char* ptr = (const unsigned char*)p_ptr;
+    const unsigned char* end = (const unsigned char*)p_end;
+    unsigned char lead = ptr[0];
+
+    size_t length;
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xbf;
+    if (0xc2 <= lead && lead <= 0xdf){
+        length = 2;
+    }else if (lead == 0xe0){
+        length = 3; lo = 0xa0;
+    }else if ((0xe1 <= lead && lead <= 0xec) || lead == 0xee || lead == 0xef){
+        length = 3;
+    }else if (lead == 0xed){
+        length = 3; hi = 0x9f;
+    }else if (lead == 0xf0){
+        length = 4; lo = 0x90;
+    }else if (0xf1 <= lead && lead <= 0xf3){
+        length = 4;
+    }else if (lead == 0xf4){
+        length = 4; hi = 0x8f;
+    }else{
+        return 0;
+    }
+
+    if ((size_t)(end - ptr) < length){
+        return 0;
+    }
+    if (ptr[1] < lo || ptr[1] > hi){
+        return 0;
+    }
+    for (size_t c = 2; c < length; c++){
+        if (ptr[c] < 0x80 || ptr[c] > 0xbf){
+            return 0;
+        }
+    }
+    return length;
+}
+
+
+
+class JsonReader{
+public:
+    JsonReader(const char* data, size_t bytes)
+        : m_ptr(data)
+        , m_end(data + bytes)
+    {
+        //  Skip the UTF-8 BOM.
+        if (bytes >= 3 &&
+            (unsigned char)data[0] == 0xef &&
+            (unsigned char)data[1] == 0xbb &&
+            (unsigned char)data[2] == 0xbf
+        ){
+            m_ptr += 3;
+        }
+    }
+
+    bool parse_document(JsonValue& value){
+        skip_whitespace();
+        if (!parse_value(value, 0)){
+            return false;
+        }
+        skip_whitespace();
+
+        //  A null character is treated as the end of the input. (same as
+        //  nlohmann) This lets files with trailing zero padding load.
+        return m_ptr == m_end || *m_ptr == '\0';
+    }
+
+
+private:
+    void skip_whitespace(){
+        while (m_ptr < m_end){
+            switch (*m_ptr){
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                m_ptr++;
+                continue;
+            default:
+                return;
+            }
+        }
+    }
+
+    bool parse_value(JsonValue& value, size_t depth){
+        if (m_ptr >= m_end){
+            return false;
+        }
+        switch (*m_ptr){
+        case '{':
+            return parse_object(value, depth);
+        case '[':
+            return parse_array(value, depth);
+        case '"':{
+            std::string str;
+            if (!parse_string(str)){
+                return false;
+            }
+            value = std::move(str);
+            return true;
+        }
+        case 't':
+            if (!parse_literal("true")){
+                return false;
+            }
+            value = true;
+            return true;
+        case 'f':
+            if (!parse_literal("false")){
+                return false;
+            }
+            value = false;
+            return true;
+        case 'n':
+            if (!parse_literal("null")){
+                return false;
+            }
+            value.clear();
+            return true;
+        default:
+            return parse_number(value);
+        }
+    }
+
+    bool parse_literal(const char* literal){
+        size_t length = strlen(literal);
+        if ((size_t)(m_end - m_ptr) < length || memcmp(m_ptr, literal, length) != 0){
+            return false;
+        }
+        m_ptr += length;
+        return true;
+    }
+
+    bool parse_object(JsonValue& value, size_t depth){
+        if (++depth > MAX_JSON_DEPTH){
+            return false;
+        }
+        m_ptr++;    //  Skip '{'
+
+        JsonObject object;
+        skip_whitespace();
+        if (m_ptr < m_end && *m_ptr == '}'){
+            m_ptr++;
+            value = std::move(object);
+            return true;
+        }
+
+        while (true){
+            skip_whitespace();
+            if (m_ptr >= m_end || *m_ptr != '"'){
+                return false;
+            }
+            std::string key;
+            if (!parse_string(key)){
+                return false;
+            }
+
+            skip_whitespace();
+            if (m_ptr >= m_end || *m_ptr != ':'){
+                return false;
+            }
+            m_ptr++;
+            skip_whitespace();
+
+            //  Duplicate keys: last one wins.
+            JsonValue& item = object[std::move(key)];
+            if (!parse_value(item, depth)){
+                return false;
+            }
+
+            skip_whitespace();
+            if (m_ptr >= m_end){
+                return false;
+            }
+            char ch = *m_ptr++;
+            if (ch == ','){
+                continue;
+            }
+            if (ch == '}'){
+                break;
+            }
+            return false;
+        }
+
+        value = std::move(object);
+        return true;
+    }
+
+    bool parse_array(JsonValue& value, size_t depth){
+        if (++depth > MAX_JSON_DEPTH){
+            return false;
+        }
+        m_ptr++;    //  Skip '['
+
+        JsonArray array;
+        skip_whitespace();
+        if (m_ptr < m_end && *m_ptr == ']'){
+            m_ptr++;
+            value = std::move(array);
+            return true;
+        }
+
+        while (true){
+            skip_whitespace();
+            JsonValue item;
+            if (!parse_value(item, depth)){
+                return false;
+            }
+            array.push_back(std::move(item));
+
+            skip_whitespace();
+            if (m_ptr >= m_end){
+                return false;
+            }
+            char ch = *m_ptr++;
+            if (ch == ','){
+                continue;
+            }
+            if (ch == ']'){
+                break;
+            }
+            return false;
+        }
+
+        value = std::move(array);
+        return true;
+    }
+
+    static int hex_digit(char ch){
+        if ('0' <= ch && ch <= '9'){
+            return ch - '0';
+        }
+        if ('a' <= ch && ch <= 'f'){
+            return ch - 'a' + 10;
+        }
+        if ('A' <= ch && ch <= 'F'){
+            return ch - 'A' + 10;
+        }
+        return -1;
+    }
+    bool parse_hex4(uint32_t& codepoint){
+        if (m_end - m_ptr < 4){
+            return false;
+        }
+        codepoint = 0;
+        for (size_t c = 0; c < 4; c++){
+            int digit = hex_digit(*m_ptr++);
+            if (digit < 0){
+                return false;
+            }
+            codepoint = (codepoint << 4) | (uint32_t)digit;
+        }
+        return true;
+    }
+    static void append_utf8(std::string& str, uint32_t codepoint){
+        if (codepoint < 0x80){
+            str += (char)codepoint;
+        }else if (codepoint < 0x800){
+            str += (char)(0xc0 | (codepoint >> 6));
+            str += (char)(0x80 | (codepoint & 0x3f));
+        }else if (codepoint < 0x10000){
+            str += (char)(0xe0 | (codepoint >> 12));
+            str += (char)(0x80 | ((codepoint >> 6) & 0x3f));
+            str += (char)(0x80 | (codepoint & 0x3f));
+        }else{
+            str += (char)(0xf0 | (codepoint >> 18));
+            str += (char)(0x80 | ((codepoint >> 12) & 0x3f));
+            str += (char)(0x80 | ((codepoint >> 6) & 0x3f));
+            str += (char)(0x80 | (codepoint & 0x3f));
+        }
+    }
+    bool parse_escape(std::string& str){
+        if (m_ptr >= m_end){
+            return false;
+        }
+        switch (*m_ptr++){
+        case '"':   str += '"';     return true;
+        case '\\':  str += '\\';    return true;
+        case '/':   str += '/';     return true;
+        case 'b':   str += '\b';    return true;
+        case 'f':   str += '\f';    return true;
+        case 'n':   str += '\n';    return true;
+        case 'r':   str += '\r';    return true;
+        case 't':   str += '\t';    return true;
+        case 'u':   break;
+        default:    return false;
+        }
+
+        uint32_t codepoint;
+        if (!parse_hex4(codepoint)){
+            return false;
+        }
+        if (0xdc00 <= codepoint && codepoint <= 0xdfff){
+            //  Unpaired low surrogate.
+            return false;
+        }
+        if (0xd800 <= codepoint && codepoint <= 0xdbff){
+            uint32_t low;
+            if (m_end - m_ptr < 2 || m_ptr[0] != '\\' || m_ptr[1] != 'u'){
+                return false;
+            }
+            m_ptr += 2;
+            if (!parse_hex4(low) || low < 0xdc00 || low > 0xdfff){
+                return false;
+            }
+            codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+        }
+        append_utf8(str, codepoint);
+        return true;
+    }
+
+    bool skip_utf8_sequence(){
+        size_t length = utf8_sequence_length(m_ptr, m_end);
+        m_ptr += length;
+        return length != 0;
+    }
+
+    bool parse_string(std::string& str){
+        m_ptr++;    //  Skip opening quote.
+        while (true){
+            //  Copy runs of plain ASCII in bulk.
+            const char* start = m_ptr;
+            while (m_ptr < m_end){
+                unsigned char ch = (unsigned char)*m_ptr;
+                if (ch == '"' || ch == '\\' || ch < 0x20 || ch >= 0x80){
+                    break;
+                }
+                m_ptr++;
+            }
+            str.append(start, m_ptr);
+
+            if (m_ptr >= m_end){
+                return false;
+            }
+
+            unsigned char ch = (unsigned char)*m_ptr;
+            if (ch == '"'){
+                m_ptr++;
+                return true;
+            }
+            if (ch == '\\'){
+                m_ptr++;
+                if (!parse_escape(str)){
+                    return false;
+                }
+                continue;
+            }
+            if (ch < 0x20){
+                //  Control characters must be escaped.
+                return false;
+            }
+
+            start = m_ptr;
+            if (!skip_utf8_sequence()){
+                return false;
+            }
+            str.append(start, m_ptr);
+        }
+    }
+
+    bool parse_number(JsonValue& value){
+        const char* start = m_ptr;
+        bool negative = false;
+        bool is_integer = true;
+
+        if (m_ptr < m_end && *m_ptr == '-'){
+            negative = true;
+            m_ptr++;
+        }
+
+        //  Integer part: "0" or [1-9][0-9]*
+        if (m_ptr >= m_end){
+            return false;
+        }
+        if (*m_ptr == '0'){
+            m_ptr++;
+        }else if ('1' <= *m_ptr && *m_ptr <= '9'){
+            while (m_ptr < m_end && '0' <= *m_ptr && *m_ptr <= '9'){
+                m_ptr++;
+            }
+        }else{
+            return false;
+        }
+
+        //  Fraction
+        if (m_ptr < m_end && *m_ptr == '.'){
+            is_integer = false;
+            m_ptr++;
+            if (m_ptr >= m_end || *m_ptr < '0' || *m_ptr > '9'){
+                return false;
+            }
+            while (m_ptr < m_end && '0' <= *m_ptr && *m_ptr <= '9'){
+                m_ptr++;
+            }
+        }
+
+        //  Exponent
+        if (m_ptr < m_end && (*m_ptr == 'e' || *m_ptr == 'E')){
+            is_integer = false;
+            m_ptr++;
+            if (m_ptr < m_end && (*m_ptr == '+' || *m_ptr == '-')){
+                m_ptr++;
+            }
+            if (m_ptr >= m_end || *m_ptr < '0' || *m_ptr > '9'){
+                return false;
+            }
+            while (m_ptr < m_end && '0' <= *m_ptr && *m_ptr <= '9'){
+                m_ptr++;
+            }
+        }
+
+        if (is_integer){
+            //  Accumulate with overflow detection.
+            const char* ptr = start + (negative ? 1 : 0);
+            uint64_t magnitude = 0;
+            bool overflow = false;
+            for (; ptr < m_ptr; ptr++){
+                uint64_t digit = (uint64_t)(*ptr - '0');
+                if (magnitude > (UINT64_MAX - digit) / 10){
+                    overflow = true;
+                    break;
+                }
+                magnitude = magnitude * 10 + digit;
+            }
+            if (!overflow){
+                if (!negative){
+                    //  Values above INT64_MAX wrap into the signed range the
+                    //  same way the nlohmann conversion does.
+                    //  read_integer(uint64_t&) will recover the original value.
+                    value = (int64_t)magnitude;
+                    return true;
+                }
+                if (magnitude <= (uint64_t)INT64_MAX + 1){
+                    value = (int64_t)(0 - magnitude);
+                    return true;
+                }
+            }
+            //  Out of range. Fall through to floating-point.
+        }
+
+        //  strtod() needs a null-terminated string in the current locale.
+        std::string buffer(start, m_ptr);
+        const char* decimal_point = localeconv()->decimal_point;
+        if (decimal_point != nullptr && decimal_point[0] != '.' && decimal_point[0] != '\0'){
+            size_t pos = buffer.find('.');
+            if (pos != std::string::npos){
+                buffer[pos] = decimal_point[0];
+            }
+        }
+        char* end;
+        double x = strtod(buffer.c_str(), &end);
+        if (end != buffer.c_str() + buffer.size()){
+            return false;
+        }
+        //  Like nlohmann, reject literals that overflow a double. (1e400)
+        //  strtod() also reports ERANGE on underflow, but nlohmann accepts
+        //  those as zero or a denormal, so don't check errno.
+        if (!std::isfinite(x)){
+            return false;
+        }
+        value = x;
+        return true;
+    }
+
+
+private:
+    const char* m_ptr;
+    const char* m_end;
+};
+
+}
+
+
+bool parse_json_native(JsonValue& value, const char* data, size_t bytes){
+    JsonReader reader(data, bytes);
+    if (reader.parse_document(value)){
+        return true;
+    }
+    value.clear();
+    return false;
+}
+
+
+
+
+//
+//  Writer
+//
+
+namespace{
+
+class JsonWriter{
+public:
+    JsonWriter(std::string& out, int indent)
+        : m_out(out)
+        , m_indent(indent)
+    {}
+
+    void write_value(const JsonValue& value, size_t current_indent){
+        switch (value.type()){
+        case JsonType::EMPTY:
+            m_out += "null";
+            return;
+        case JsonType::BOOLEAN:
+            m_out += value.to_boolean_default() ? "true" : "false";
+            return;
+        case JsonType::INTEGER:
+            write_integer(value.to_integer_default());
+            return;
+        case JsonType::FLOAT:
+            write_float(value.to_double_default());
+            return;
+        case JsonType::STRING:
+            write_string(*value.to_string());
+            return;
+        case JsonType::ARRAY:
+            write_array(*value.to_array(), current_indent);
+            return;
+        case JsonType::OBJECT:
+            write_object(*value.to_object(), current_indent);
+            return;
+        }
+    }
+
+    void write_array(const JsonArray& array, size_t current_indent){
+        if (array.empty()){
+            m_out += "[]";
+            return;
+        }
+        if (m_indent < 0){
+            m_out += '[';
+            bool first = true;
+            for (const JsonValue& item : array){
+                if (!first){
+                    m_out += ',';
+                }
+                first = false;
+                write_value(item, 0);
+            }
+            m_out += ']';
+            return;
+        }
+
+        size_t new_indent = current_indent + m_indent;
+        m_out += "[\n";
+        bool first = true;
+        for (const JsonValue& item : array){
+            if (!first){
+                m_out += ",\n";
+            }
+            first = false;
+            m_out.append(new_indent, ' ');
+            write_value(item, new_indent);
+        }
+        m_out += '\n';
+        m_out.append(current_indent, ' ');
+        m_out += ']';
+    }
+
+    void write_object(const JsonObject& object, size_t current_indent){
+        //  Empty objects have always been written as null. Keep it that way so
+        //  existing files don't change.
+        if (object.empty()){
+            m_out += "null";
+            return;
+        }
+        if (m_indent < 0){
+            m_out += '{';
+            bool first = true;
+            for (const auto& item : object){
+                if (!first){
+                    m_out += ',';
+                }
+                first = false;
+                write_string(item.first);
+                m_out += ':';
+                write_value(item.second, 0);
+            }
+            m_out += '}';
+            return;
+        }
+
+        size_t new_indent = current_indent + m_indent;
+        m_out += "{\n";
+        bool first = true;
+        for (const auto& item : object){
+            if (!first){
+                m_out += ",\n";
+            }
+            first = false;
+            m_out.append(new_indent, ' ');
+            write_string(item.first);
+            m_out += ": ";
+            write_value(item.second, new_indent);
+        }
+        m_out += '\n';
+        m_out.append(current_indent, ' ');
+        m_out += '}';
+    }
+
+
+private:
+    void write_integer(int64_t x){
+        char buffer[24];
+        char* end = buffer + sizeof(buffer);
+        char* ptr = end;
+        uint64_t magnitude = x < 0 ? 0 - (uint64_t)x : (uint64_t)x;
+        do{
+            *--ptr = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        }while (magnitude != 0);
+        if (x < 0){
+            *--ptr = '-';
+        }
+        m_out.append(ptr, end);
+    }
+    void write_float(double x){
+        if (!std::isfinite(x)){
+            m_out += "null";
+            return;
+        }
+        //  Use the same shortest round-trip formatting as nlohmann so that
+        //  files are unchanged by the switch.
+        char buffer[64];
+        char* end = nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), x);
+        m_out.append(buffer, end);
+    }
+    void write_string(const std::string& str){
+        static const char HEX[] = "0123456789abcdef";
+        m_out += '"';
+        const char* ptr = str.data();
+        const char* end = ptr + str.size();
+        while (ptr < end){
+            //  Copy runs that need no escaping in bulk.
+            const char* start = ptr;
+            while (ptr < end){
+                unsigned char ch = (unsigned char)*ptr;
+                if (ch < 0x80){
+                    if (ch < 0x20 || ch == '"' || ch == '\\'){
+                        break;
+                    }
+                    ptr++;
+                    continue;
+                }
+                size_t length = utf8_sequence_length(ptr, end);
+                if (length == 0){
+                    //  Let nlohmann throw the same type_error.316 that the
+                    //  old to_nlohmann() path did.
+                    nlohmann::json(str).dump();
+                }
+                ptr += length;
+            }
+            m_out.append(start, ptr);
+            if (ptr >= end){
+                break;
+            }
+
+            unsigned char ch = (unsigned char)*ptr++;
+            switch (ch){
+            case '\b':  m_out += "\\b";     break;
+            case '\t':  m_out += "\\t";     break;
+            case '\n':  m_out += "\\n";     break;
+            case '\f':  m_out += "\\f";     break;
+            case '\r':  m_out += "\\r";     break;
+            case '"':   m_out += "\\\"";    break;
+            case '\\':  m_out += "\\\\";    break;
+            default:
+                m_out += "\\u00";
+                m_out += HEX[ch >> 4];
+                m_out += HEX[ch & 0x0f];
+            }
+        }
+        m_out += '"';
+    }
+
+
+private:
+    std::string& m_out;
+    int m_indent;
+};
+
+}
+
+
+void dump_json_native(std::string& out, const JsonValue& value, int indent){
+    JsonWriter(out, indent).write_value(value, 0);
+}
+void dump_json_native(std::string& out, const JsonArray& value, int indent){
+    JsonWriter(out, indent).write_array(value, 0);
+}
+void dump_json_native(std::string& out, const JsonObject& value, int indent){
+    JsonWriter(out, indent).write_object(value, 0);
+}
+
+
+
+
+}
@@ -0,0 +1,40 @@
+/*  JSON Parser
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Native JSON parser and writer for JsonValue.
+ *
+ *  The parser builds JsonValue/JsonArray/JsonObject directly from the text
+ *  without going through an intermediate nlohmann::json tree. The writer
+ *  serializes straight into a string.
+ *
+ *  Both are intended to be drop-in replacements for the nlohmann round-trip.
+ *  They accept the same (strict) grammar and produce byte-identical output.
+ *
+ */
+
+#ifndef PokemonAutomation_Common_Json_JsonParser_H
+#define PokemonAutomation_Common_Json_JsonParser_H
+
+#include <string>
+#include "JsonValue.h"
+
+namespace PokemonAutomation{
+
+
+//  Parse the JSON text in [data, data + bytes).
+//  Returns true and sets "value" on success.
+//  On failure, returns false and "value" is set to null.
+bool parse_json_native(JsonValue& value, const char* data, size_t bytes);
+
+
+//  Append the serialization of "value" to "out".
+//  Negative indent will produce the compact form.
+//  Throws nlohmann::json::type_error (316) if a string isn't valid UTF-8.
+void dump_json_native(std::string& out, const JsonValue& value, int indent = 4);
+void dump_json_native(std::string& out, const JsonArray& value, int indent = 4);
+void dump_json_native(std::string& out, const JsonObject& value, int indent = 4);
+
+
+}
+#endif
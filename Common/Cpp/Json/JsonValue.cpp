@@ -4,12 +4,11 @@
  *
  */
 
-#include "3rdParty/nlohmann/json.hpp"
 #include "Common/Cpp/Filesystem/FileIO.h"
 #include "JsonValue.h"
 #include "JsonArray.h"
 #include "JsonObject.h"
-#include "JsonTools.h"
+#include "JsonParser.h"
 
 //#include <iostream>
 //using std::cout;
@@ -368,14 +367,18 @@ bool JsonValue::read_string(std::string& value) const{
 
 
 JsonValue parse_json(const std::string& str){
-    return from_nlohmann(nlohmann::json::parse(str, nullptr, false));
+    JsonValue ret;
+    parse_json_native(ret, str.data(), str.size());
+    return ret;
 }
 JsonValue load_json_file(const std::string& filename){
     std::string str = file_to_string(filename);
     return parse_json(str);
 }
 std::string JsonValue::dump(int indent) const{
-    return to_nlohmann(*this).dump(indent);
+    std::string ret;
+    dump_json_native(ret, *this, indent);
+    return ret;
 }
 void JsonValue::dump(const std::string& filename, int indent) const{
     string_to_file(filename, dump(indent));
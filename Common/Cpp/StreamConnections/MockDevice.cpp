@@ -226,11 +226,21 @@ size_t MockDevice::verify_stream_data(){
 
 
 
+void MockDevice::set_device_handler(std::function<void(ReliableStreamConnectionPolling& connection)> handler){
+    std::lock_guard<Mutex> lg(m_device_lock);
+    m_device_handler = std::move(handler);
+}
+
+
 void MockDevice::device_thread(){
     std::unique_lock<Mutex> lg(m_device_lock);
     while (!m_stopping.load(std::memory_order_relaxed)){
         m_connection.run_send_events(Milliseconds(0));
         m_connection.run_recv_events(Milliseconds(0));
+        if (m_device_handler){
+            m_device_handler(m_connection);
+            m_connection.run_send_events(Milliseconds(0));
+        }
         m_device_cv.wait_for(lg, Milliseconds(10));
     }
 }
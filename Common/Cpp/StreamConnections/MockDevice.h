@@ -8,6 +8,7 @@
 #define PokemonAutomation_MockDevice_H
 
 #include <deque>
+#include <functional>
 #include "Common/Cpp/StreamConnections/PollingStreamConnections.h"
 #include "Common/Cpp/StreamConnections/PushingStreamConnections.h"
 #include "Common/Cpp/Concurrency/Mutex.h"
@@ -48,6 +49,15 @@ public:
     size_t verify_stream_data();
 
 
+public:
+    //  Call from device.
+
+    //  Run "handler" on the device thread every time it polls the connection.
+    //  The handler owns the received stream. Don't use the stream verification
+    //  functions above while a handler is set.
+    void set_device_handler(std::function<void(ReliableStreamConnectionPolling& connection)> handler);
+
+
 private:
     void device_thread();
     void host_recv_thread();
@@ -86,6 +96,7 @@ private:
     std::deque<uint8_t> m_host_to_device_line;
 
     std::deque<uint8_t> m_expected_host_to_device_stream;
+    std::function<void(ReliableStreamConnectionPolling& connection)> m_device_handler;
 
     std::atomic<bool> m_stopping;
 
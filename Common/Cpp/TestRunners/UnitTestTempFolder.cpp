@@ -0,0 +1,39 @@
+/*  Unit Test Temp Folder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <random>
+#include <filesystem>
+#include "UnitTestTempFolder.h"
+
+namespace PokemonAutomation{
+
+
+
+UnitTestTempFolder::UnitTestTempFolder(const std::string& name){
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path path = fs::temp_directory_path(ec);
+    if (ec){
+        return;
+    }
+    path /= "PokemonAutomation-" + name + "-" + std::to_string(std::random_device()());
+    fs::create_directories(path, ec);
+    if (ec){
+        return;
+    }
+    m_path = Filesystem::Path(std::move(path));
+}
+UnitTestTempFolder::~UnitTestTempFolder(){
+    if (m_path.empty()){
+        return;
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(m_path.stdpath(), ec);
+}
+
+
+
+}
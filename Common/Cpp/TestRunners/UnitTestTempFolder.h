@@ -0,0 +1,46 @@
+/*  Unit Test Temp Folder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A uniquely named folder under the system temp directory for tests that
+ *  need to write files. It is deleted along with everything in it when this
+ *  goes out of scope.
+ *
+ */
+
+#ifndef PokemonAutomation_UnitTestTempFolder_H
+#define PokemonAutomation_UnitTestTempFolder_H
+
+#include <string>
+#include "Common/Cpp/Filesystem/FilePath.h"
+#include "UnitTest.h"
+
+namespace PokemonAutomation{
+
+
+
+class UnitTestTempFolder{
+    UnitTestTempFolder(const UnitTestTempFolder&) = delete;
+    void operator=(const UnitTestTempFolder&) = delete;
+
+public:
+    UnitTestTempFolder(const std::string& name);
+    ~UnitTestTempFolder();
+
+    //  Empty if the folder could not be created.
+    const Filesystem::Path& path() const{ return m_path; }
+    bool empty() const{ return m_path.empty(); }
+
+    //  What a test should return when the folder could not be created.
+    static UnitTestResult skipped(){
+        return UnitTestResult(UnitTestResult::SKIPPED, "No temp directory.");
+    }
+
+private:
+    Filesystem::Path m_path;
+};
+
+
+
+}
+#endif
@@ -0,0 +1,219 @@
+/*  Tracing
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <set>
+#include <mutex>
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Tracing.h"
+
+namespace PokemonAutomation{
+namespace Tracing{
+
+
+
+namespace{
+
+//  Per thread. 32 bytes each.
+const size_t EVENTS_PER_THREAD = 8192;
+
+enum class EventType : uint8_t{
+    COMPLETE,
+    COUNTER,
+};
+struct Event{
+    const char* name;
+    int64_t timestamp_us;
+    union{
+        int64_t duration_us;
+        double value;
+    };
+    EventType type;
+};
+
+//  Single writer (the owning thread), any number of readers.
+//  Readers may see a slot while it is being overwritten. Those are detected
+//  by re-reading the index afterwards and dropped.
+struct ThreadBuffer{
+    uint64_t tid;
+    std::atomic<uint64_t> index{0};
+    Event events[EVENTS_PER_THREAD];
+};
+
+struct TraceGlobals{
+    const TraceClock::time_point epoch = TraceClock::now();
+
+    Mutex lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::set<std::string> strings;
+
+    static TraceGlobals& instance(){
+        static TraceGlobals globals;
+        return globals;
+    }
+};
+
+ThreadBuffer* this_thread_buffer() noexcept{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer != nullptr){
+        return buffer;
+    }
+    try{
+        //  Buffers are never freed. A dump can happen after the thread exits.
+        TraceGlobals& globals = TraceGlobals::instance();
+        std::unique_ptr<ThreadBuffer> ptr(new ThreadBuffer());
+        std::lock_guard<Mutex> lg(globals.lock);
+        ptr->tid = globals.buffers.size() + 1;
+        globals.buffers.emplace_back(std::move(ptr));
+        buffer = globals.buffers.back().get();
+    }catch (...){}
+    return buffer;
+}
+
+void push_event(const Event& event) noexcept{
+    ThreadBuffer* buffer = this_thread_buffer();
+    if (buffer == nullptr){
+        return;
+    }
+    uint64_t index = buffer->index.load(std::memory_order_relaxed);
+    //  Pairs with the acquire fence in dump_chrome_trace(). A reader that sees
+    //  any of this write will also see the index we are overwriting at.
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer->events[index % EVENTS_PER_THREAD] = event;
+    buffer->index.store(index + 1, std::memory_order_release);
+}
+
+int64_t to_us(TraceClock::time_point timestamp){
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        timestamp - TraceGlobals::instance().epoch
+    ).count();
+}
+
+void append_json_string(std::string& str, const char* text){
+    str += '"';
+    for (; *text != '\0'; text++){
+        char ch = *text;
+        switch (ch){
+        case '"':   str += "\\\""; break;
+        case '\\':  str += "\\\\"; break;
+        case '\n':  str += "\\n"; break;
+        case '\t':  str += "\\t"; break;
+        default:
+            if ((unsigned char)ch < 0x20){
+                continue;
+            }
+            str += ch;
+        }
+    }
+    str += '"';
+}
+
+}
+
+
+
+void record_complete(const char* name, TraceClock::time_point start, TraceClock::time_point end) noexcept{
+    Event event;
+    event.name = name;
+    event.timestamp_us = to_us(start);
+    event.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    event.type = EventType::COMPLETE;
+    push_event(event);
+}
+void record_counter(const char* name, double value) noexcept{
+    Event event;
+    event.name = name;
+    event.timestamp_us = to_us(TraceClock::now());
+    event.value = value;
+    event.type = EventType::COUNTER;
+    push_event(event);
+}
+const char* intern(const std::string& name){
+    TraceGlobals& globals = TraceGlobals::instance();
+    std::lock_guard<Mutex> lg(globals.lock);
+    return globals.strings.insert(name).first->c_str();
+}
+
+
+
+std::string dump_chrome_trace(){
+    TraceGlobals& globals = TraceGlobals::instance();
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<Mutex> lg(globals.lock);
+        for (const auto& buffer : globals.buffers){
+            buffers.emplace_back(buffer.get());
+        }
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto begin_event = [&]{
+        if (!first){
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    std::vector<Event> events;
+    for (ThreadBuffer* buffer : buffers){
+        std::string tid = std::to_string(buffer->tid);
+
+        begin_event();
+        json += "{\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"name\":\"thread_name\",\"args\":{\"name\":\"Thread " + tid + "\"}}";
+
+        uint64_t end = buffer->index.load(std::memory_order_acquire);
+        uint64_t start = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (uint64_t c = start; c < end; c++){
+            events.emplace_back(buffer->events[c % EVENTS_PER_THREAD]);
+        }
+
+        //  Drop anything the thread overwrote while we were copying.
+        //  The fence keeps the copy above from being reordered past the
+        //  re-read of the index.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t new_end = buffer->index.load(std::memory_order_relaxed);
+        uint64_t first_valid = new_end >= EVENTS_PER_THREAD ? new_end - EVENTS_PER_THREAD + 1 : 0;
+        size_t skip = first_valid > start ? (size_t)(first_valid - start) : 0;
+
+        for (size_t c = skip; c < events.size(); c++){
+            const Event& event = events[c];
+            begin_event();
+            json += "{\"pid\":1,\"tid\":" + tid + ",\"name\":";
+            append_json_string(json, event.name);
+            json += ",\"ts\":" + std::to_string(event.timestamp_us);
+            switch (event.type){
+            case EventType::COMPLETE:
+                json += ",\"ph\":\"X\",\"dur\":" + std::to_string(event.duration_us) + "}";
+                break;
+            case EventType::COUNTER:
+                json += ",\"ph\":\"C\",\"args\":{\"value\":" + std::to_string(event.value) + "}}";
+                break;
+            }
+        }
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+bool dump_chrome_trace(const std::string& path){
+    std::string json = dump_chrome_trace();
+    FileIO file;
+    if (!file.open(Filesystem::Path(path), FileMode::WRITE | FileMode::BINARY)){
+        return false;
+    }
+    return file.write(json) == json.size();
+}
+
+
+
+}
+}
@@ -0,0 +1,94 @@
+/*  Tracing
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Lightweight scoped tracing for hot paths. The result can be opened in
+ *  chrome://tracing or https://ui.perfetto.dev.
+ *
+ *      void foo(){
+ *          PA_TRACE_SCOPE("foo");
+ *          ...
+ *          PA_TRACE_COUNTER("Queue Size", queue.size());
+ *      }
+ *
+ *  Tracing is only compiled in if PA_ENABLE_TRACING is defined. (CMake
+ *  option of the same name.) Otherwise the macros expand to nothing and
+ *  dump_chrome_trace() writes an empty trace.
+ *
+ *  Each thread records into its own fixed-size ring buffer. Recording
+ *  takes no locks. Only the most recent events of each thread are kept so
+ *  this can stay on for the entire session and be dumped when something
+ *  goes wrong.
+ *
+ *  Names must be string literals or come from intern().
+ *
+ */
+
+#ifndef PokemonAutomation_Tracing_H
+#define PokemonAutomation_Tracing_H
+
+#include <string>
+#include <chrono>
+
+namespace PokemonAutomation{
+namespace Tracing{
+
+
+#ifdef PA_ENABLE_TRACING
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+
+using TraceClock = std::chrono::steady_clock;
+
+void record_complete(const char* name, TraceClock::time_point start, TraceClock::time_point end) noexcept;
+void record_counter(const char* name, double value) noexcept;
+
+//  Returns a pointer that stays valid until the program exits. The same
+//  string always returns the same pointer. Use this for names that are built
+//  at runtime. This takes a lock so do it once and keep the pointer.
+const char* intern(const std::string& name);
+
+
+class Scope{
+public:
+    Scope(const char* name) noexcept
+        : m_name(name)
+        , m_start(TraceClock::now())
+    {}
+    ~Scope(){
+        record_complete(m_name, m_start, TraceClock::now());
+    }
+    Scope(const Scope&) = delete;
+    void operator=(const Scope&) = delete;
+
+private:
+    const char* m_name;
+    TraceClock::time_point m_start;
+};
+
+
+//  Chrome trace-event JSON of everything currently in the buffers.
+std::string dump_chrome_trace();
+bool dump_chrome_trace(const std::string& path);
+
+
+
+}
+}
+
+
+#ifdef PA_ENABLE_TRACING
+#define PA_TRACE_CONCAT0(a, b)  a##b
+#define PA_TRACE_CONCAT(a, b)   PA_TRACE_CONCAT0(a, b)
+#define PA_TRACE_SCOPE(name)    PokemonAutomation::Tracing::Scope PA_TRACE_CONCAT(pa_trace_scope_, __LINE__)(name)
+#define PA_TRACE_COUNTER(name, value)   PokemonAutomation::Tracing::record_counter(name, (double)(value))
+#else
+#define PA_TRACE_SCOPE(name)
+#define PA_TRACE_COUNTER(name, value)
+#endif
+
+
+#endif
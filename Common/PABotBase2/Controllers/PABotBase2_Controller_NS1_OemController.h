@@ -63,6 +63,18 @@ struct PABB_PACK Message_Command_NS1_OemController_FullState : MessageHeader{
 };
 
 
+#define PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH      0x99
+struct PABB_PACK Message_Command_NS1_OemController_ButtonsEntry{
+    uint16_t milliseconds;
+    NintendoSwitch::OemController_State0x30_Buttons buttons;
+};
+struct PABB_PACK Message_Command_NS1_OemController_ButtonsBatch : MessageHeader{
+    //  Only the first (message_bytes - sizeof(MessageHeader)) / sizeof(entry)
+    //  entries are sent.
+    Message_Command_NS1_OemController_ButtonsEntry entries[PABB2_MESSAGE_COMMAND_BATCH_MAX_ENTRIES];
+};
+
+
 
 }
 }
@@ -0,0 +1,82 @@
+/*  PABotBase2 Command Batch (FW)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Walks the entries of a batched command message.
+ *
+ *  The firmware keeps the whole message in one command queue slot and runs
+ *  the entries one at a time in order. It sends a single
+ *  PABB2_MESSAGE_OPCODE_CQ_COMMAND_FINISHED for the message when the last
+ *  entry finishes. A cancel or replace drops the rest of the batch.
+ *
+ */
+
+#ifndef PokemonAutomation_PABotBase2FW_CommandBatch_H
+#define PokemonAutomation_PABotBase2FW_CommandBatch_H
+
+#include <stddef.h>
+#include <string.h>
+#include "PABotBase2_MessageProtocol.h"
+
+namespace PokemonAutomation{
+namespace PABotBase2{
+
+
+
+template <typename EntryType>
+class CommandBatchCursor{
+public:
+    //  Returns the # of entries in "message". Returns 0 if the length isn't
+    //  a valid batch of "EntryType".
+    static size_t entries_in(const MessageHeader* message){
+        if (message->message_bytes <= sizeof(MessageHeader)){
+            return 0;
+        }
+        size_t bytes = message->message_bytes - sizeof(MessageHeader);
+        if (bytes % sizeof(EntryType) != 0){
+            return 0;
+        }
+        size_t entries = bytes / sizeof(EntryType);
+        return entries <= PABB2_MESSAGE_COMMAND_BATCH_MAX_ENTRIES ? entries : 0;
+    }
+
+
+public:
+    //  "message" must stay alive until the cursor is done with it.
+    //  Returns false if the message is not a valid batch.
+    bool reset(const MessageHeader* message){
+        m_entries = (const unsigned char*)(message + 1);
+        m_size = entries_in(message);
+        m_index = 0;
+        return m_size != 0;
+    }
+
+    size_t size() const{ return m_size; }
+    size_t index() const{ return m_index; }
+    bool done() const{ return m_index >= m_size; }
+
+    //  The entries are packed. Copy it out instead of handing out a pointer.
+    EntryType current() const{
+        EntryType entry;
+        memcpy(&entry, m_entries + m_index * sizeof(EntryType), sizeof(EntryType));
+        return entry;
+    }
+
+    //  Returns true if this moved past the last entry.
+    bool advance(){
+        m_index++;
+        return done();
+    }
+
+
+private:
+    const unsigned char* m_entries = nullptr;
+    size_t m_size = 0;
+    size_t m_index = 0;
+};
+
+
+
+}
+}
+#endif
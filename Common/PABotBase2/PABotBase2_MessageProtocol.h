@@ -25,6 +25,15 @@ namespace PABotBase2{
 
 #define PABB2_MESSAGE_PROTOCOL_VERSION      2026061801
 
+//  Optional features and the minor protocol version that adds them.
+//
+//  No firmware handles batched commands yet, so the protocol version above
+//  stays at minor version 1 and the host never sends them. A firmware that
+//  dispatches PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH (using
+//  CommandBatchCursor in PABotBase2FW_CommandBatch.h) must bump the protocol
+//  to minor version 2 in the same change.
+#define PABB2_MESSAGE_MINOR_VERSION_COMMAND_BATCH   2
+
 
 struct PABB_PACK MessageHeader{
     uint16_t message_bytes;
@@ -69,6 +78,11 @@ struct PABB_PACK Message_u32 : MessageHeader{
 #define PABB2_MESSAGE_OPCODE_CQ_REPLACE_ON_NEXT     0x42
 #define PABB2_MESSAGE_OPCODE_CQ_COMMAND_FINISHED    0x43
 
+//  A batched command is a header followed by a whole number of fixed-size
+//  entries. It takes one command queue slot and finishes after the last entry.
+//  Each entry runs exactly like the unbatched version of the command.
+#define PABB2_MESSAGE_COMMAND_BATCH_MAX_ENTRIES     16
+
 
 }
 }
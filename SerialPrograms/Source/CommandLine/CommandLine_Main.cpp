@@ -7,7 +7,9 @@
  */
 
 //#include <iostream>
+#include <string.h>
 #include "Common/Cpp/Color.h"
+#include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Logging/MultiOutputLogger.h"
 #include "Common/Cpp/Logging/LastLogTracker.h"
 #include "Common/Cpp/Logging/FileLogger.h"
@@ -16,6 +18,7 @@
 #include "CommonFramework/Logging/Logger.h"
 // #include "CommonFramework/Logging/OutputRedirector.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/TelemetryFile.h"
 #include "Integrations/PybindSwitchController.h"
 #include "NintendoSwitch/Controllers/NintendoSwitch_ControllerButtons.h"
 
@@ -38,6 +41,39 @@ FileLogger& global_file_logger(){
 }
 
 
+//  <program> --export-telemetry <file.patm> [csv|json] [output]
+int export_telemetry(Logger& logger, int argc, char* argv[]){
+    std::string input = argv[2];
+    std::string format = argc >= 4 ? argv[3] : "csv";
+    if (format != "csv" && format != "json"){
+        logger.log("Unknown format: " + format + ". Use \"csv\" or \"json\".", COLOR_RED);
+        return 1;
+    }
+    std::string output = argc >= 5 ? argv[4] : input + "." + format;
+
+    try{
+        TelemetryFileData data = read_telemetry_file(input);
+        if (data.truncated){
+            logger.log("File ends in an incomplete record. It was dropped.", COLOR_ORANGE);
+        }
+        if (format == "csv"){
+            export_telemetry_csv(data, output);
+        }else{
+            export_telemetry_json(data, output);
+        }
+        logger.log(
+            "Exported " + std::to_string(data.samples.size()) + " samples in " +
+            std::to_string(data.channels.size()) + " channels to: " + output,
+            COLOR_GREEN
+        );
+    }catch (const Exception& e){
+        logger.log(e.to_str(), COLOR_RED);
+        return 1;
+    }
+    return 0;
+}
+
+
 }
 
 int main(int argc, char* argv[]){
@@ -58,10 +94,17 @@ int main(int argc, char* argv[]){
     logger.log("Starting Program...");
     logger.log("Pokemon Automation - Command Line Tool");
 
+    if (argc >= 3 && strcmp(argv[1], "--export-telemetry") == 0){
+        int ret = export_telemetry(logger, argc, argv);
+        global_file_logger().stop();
+        return ret;
+    }
+
     // Check if port name argument is provided
     if (argc < 2){
         logger.log("Usage: " + std::string(argv[0]) + " <port_name>", COLOR_RED);
         logger.log("Example: " + std::string(argv[0]) + " cu.usbserial-0001");
+        logger.log("Usage: " + std::string(argv[0]) + " --export-telemetry <file.patm> [csv|json] [output]");
         return 1;
     }
 
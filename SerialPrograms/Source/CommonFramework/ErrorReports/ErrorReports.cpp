@@ -14,6 +14,7 @@
 #include "Common/Cpp/Json/JsonObject.h"
 #include "Common/Cpp/Concurrency/AsyncTask.h"
 #include "Common/Cpp/Hardware/Hardware.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/StaticGlobals.h"
 #include "CommonFramework/GlobalAutoPaths.h"
@@ -23,6 +24,7 @@
 #include "Common/Cpp/ColoredText.h"
 #include "CommonFramework/Recording/StreamHistorySession.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/ImageEncoder.h"
 #include "ProgramDumper.h"
 #include "ErrorReports.h"
 
@@ -102,6 +104,14 @@ ErrorReportOption::ErrorReportOption()
 }
 
 
+static std::string screenshot_extension(const ImageViewRGB32& image){
+    //  4k .png images are too big for current Discord limits.
+    return image.width() > 1920
+        ? ".jpg"
+        : ".png";
+}
+
+
 SendableErrorReport::SendableErrorReport()
     : m_timestamp(now_to_filestring())
     , m_directory(RUNTIME_BASE_PATH() + ERROR_PATH_UNSENT + "/" + m_timestamp + "/")
@@ -137,6 +147,12 @@ SendableErrorReport::SendableErrorReport(
     m_title = std::move(title);
     m_messages = std::move(messages);
     m_image = image;
+    if (m_image){
+        //  Written in the background while the rest of the report is put
+        //  together. save_report_json() waits for it.
+        m_screenshot_name = "Screenshot" + screenshot_extension(m_image);
+        m_screenshot = ImageEncoder::instance().save(m_image, m_directory + m_screenshot_name);
+    }
     {
         std::string log;
         for (const LogLine& line : global_last_log_history().get_recent((size_t)-1)){
@@ -163,6 +179,9 @@ SendableErrorReport::SendableErrorReport(
     if (program_dump(logger, m_directory + ERROR_DUMP_NAME)){
         m_dump_name = ERROR_DUMP_NAME;
     }
+    if (Tracing::ENABLED && Tracing::dump_chrome_trace(m_directory + "Trace.json")){
+        m_files.emplace_back("Trace.json");
+    }
 }
 
 SendableErrorReport::SendableErrorReport(std::string directory)
@@ -263,11 +282,12 @@ void SendableErrorReport::save_report_json(Logger* logger) const{
         }
         report["Messages"] = std::move(messages);
     }
-    if (m_image){
-        //  4k .png images are too big for current Discord limits.
-        std::string extension = m_image.width() > 1920
-            ? ".jpg"
-            : ".png";
+    if (m_screenshot){
+        if (m_screenshot->wait()){
+            report["Screenshot"] = m_screenshot_name;
+        }
+    }else if (m_image){
+        std::string extension = screenshot_extension(m_image);
         if (m_image.save(m_directory + "Screenshot" + extension)){
             report["Screenshot"] = "Screenshot" + extension;
         }
@@ -22,6 +22,7 @@ namespace PokemonAutomation{
 
 class AsyncTask;
 class StreamHistorySession;
+class PendingImageFile;
 
 
 // Filename constants for error report components
@@ -135,6 +136,8 @@ private:
     std::vector<std::pair<std::string, std::string>> m_messages;
     ImageRGB32 m_image_owner;
     ImageViewRGB32 m_image;
+    std::shared_ptr<PendingImageFile> m_screenshot;     //  Being written in the background.
+    std::string m_screenshot_name;
     std::string m_logs_name;
     std::string m_video_name;
     std::string m_dump_name;
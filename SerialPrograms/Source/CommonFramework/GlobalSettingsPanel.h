@@ -129,6 +129,16 @@ public:
     // Which tests to ignore running under the command line test mode.
     // If a test path appears in both COMMAND_LINE_TEST_LIST and COMMAND_LINE_IGNORE_LIST, it's still ignored.
     std::vector<std::string> COMMAND_LINE_IGNORE_LIST;
+    // Whether to dispatch the test files across the computation thread pool.
+    // Off by default. Turn it on with "PARALLEL" in the command line test settings.
+    bool COMMAND_LINE_TEST_PARALLEL = false;
+    // Where to write the per-detector timing report. Empty (the default) to not write one.
+    std::string COMMAND_LINE_TEST_TIMING_REPORT;
+    // A timing report from a previous run to compare against. Empty to skip the comparison.
+    std::string COMMAND_LINE_TEST_TIMING_BASELINE;
+    // A detector is flagged as a regression if its average time per file exceeds
+    // the baseline by more than this ratio.
+    double COMMAND_LINE_TEST_TIMING_TOLERANCE = 1.5;
 };
 
 
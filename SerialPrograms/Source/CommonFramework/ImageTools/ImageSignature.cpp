@@ -0,0 +1,167 @@
+/*  Image Signature
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Time.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "ImageDiff.h"
+#include "ImageSignature.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace ImageMatch{
+
+
+
+ImageSignature::ImageSignature(const ImageViewRGB32& image)
+    : m_width(image.width())
+    , m_height(image.height())
+{
+    if (!image){
+        return;
+    }
+
+    const size_t blocks_x = std::min(BLOCKS_X, m_width);
+    const size_t blocks_y = std::min(BLOCKS_Y, m_height);
+    m_blocks.resize(blocks_x * blocks_y);
+
+    for (size_t by = 0; by < blocks_y; by++){
+        const size_t y0 = by * m_height / blocks_y;
+        const size_t y1 = (by + 1) * m_height / blocks_y;
+        Block* blocks = &m_blocks[by * blocks_x];
+        for (size_t y = y0; y < y1; y += ROW_STEP){
+            const uint32_t* row = (const uint32_t*)((const char*)image.data() + y * image.bytes_per_row());
+            for (size_t bx = 0; bx < blocks_x; bx++){
+                const size_t x0 = bx * m_width / blocks_x;
+                const size_t x1 = (bx + 1) * m_width / blocks_x;
+                uint32_t red = 0;
+                uint32_t green = 0;
+                uint32_t blue = 0;
+                uint32_t alpha = 0xffffffff;
+                for (size_t x = x0; x < x1; x++){
+                    uint32_t pixel = row[x];
+                    red += (pixel >> 16) & 0xff;
+                    green += (pixel >> 8) & 0xff;
+                    blue += pixel & 0xff;
+                    alpha &= pixel;
+                }
+                Block& block = blocks[bx];
+                block.red += red;
+                block.green += green;
+                block.blue += blue;
+                block.pixels += (uint32_t)(x1 - x0);
+                block.opaque &= (alpha >> 24) == 0xff;
+            }
+        }
+    }
+}
+
+
+//  For the n pixels of a block, sum((a - b)^2) >= (sum(a) - sum(b))^2 / n.
+static uint64_t block_bound(uint64_t reference, uint64_t image, uint32_t pixels){
+    int64_t diff = (int64_t)reference - (int64_t)image;
+    return (uint64_t)(diff * diff) / pixels;
+}
+
+double ImageSignature::min_RMSD(const ImageSignature& image) const{
+    if (m_width != image.m_width || m_height != image.m_height || m_blocks.empty()){
+        return 0;
+    }
+
+    //  A lower bound on the sum of squares that pixel_RMSD() computes.
+    uint64_t sumsqrs = 0;
+    for (size_t c = 0; c < m_blocks.size(); c++){
+        const Block& ref = m_blocks[c];
+        const Block& img = image.m_blocks[c];
+        if (!ref.opaque || ref.pixels == 0){
+            continue;
+        }
+        sumsqrs += block_bound(ref.red, img.red, ref.pixels);
+        sumsqrs += block_bound(ref.green, img.green, ref.pixels);
+        sumsqrs += block_bound(ref.blue, img.blue, ref.pixels);
+    }
+
+    //  pixel_RMSD() divides by the # of opaque pixels which is at most the
+    //  area. Same operations in the same order so the rounding can't put this
+    //  above the real value.
+    return std::sqrt((double)sumsqrs / (double)(m_width * m_height));
+}
+
+
+
+void benchmark_ImageSignature(Logger& logger, size_t iterations){
+    std::mt19937 rng(0);
+    auto make_frame = [&](size_t offset){
+        ImageRGB32 image(1920, 1080);
+        for (size_t r = 0; r < image.height(); r++){
+            for (size_t c = 0; c < image.width(); c++){
+                uint32_t red = (uint32_t)(((c + offset) * 255 / 1920) & 0xff);
+                uint32_t green = (uint32_t)(r * 255 / 1080);
+                uint32_t blue = (uint32_t)(((c + offset) ^ r) & 0xff);
+                uint32_t noise = rng() & 0x030303;
+                image.pixel(c, r) = (0xff000000 | (red << 16) | (green << 8) | blue) ^ noise;
+            }
+        }
+        return image;
+    };
+
+    //  "frozen" only differs by capture noise. "moving" is scrolling.
+    std::vector<ImageRGB32> frames;
+    frames.emplace_back(make_frame(0));
+    frames.emplace_back(make_frame(0));
+    frames.emplace_back(make_frame(64));
+    const double THRESHOLD = 10;
+
+    for (size_t pair = 1; pair < frames.size(); pair++){
+        const ImageRGB32& previous = frames[0];
+        const ImageRGB32& current = frames[pair];
+        bool expected = pixel_RMSD(previous, current) > THRESHOLD;
+
+        WallClock start = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            if ((pixel_RMSD(previous, current) > THRESHOLD) != expected){
+                logger.log("Inconsistent result.", COLOR_RED);
+            }
+        }
+        double full = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)iterations;
+
+        //  Like FrozenImageDetector, the previous signature is kept so only
+        //  the new frame is summed.
+        ImageSignature previous_signature(previous);
+        size_t skipped = 0;
+        start = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            ImageSignature signature(current);
+            bool changed = previous_signature.exceeds(signature, THRESHOLD);
+            skipped += changed;
+            if (!changed){
+                changed = pixel_RMSD(previous, current) > THRESHOLD;
+            }
+            if (changed != expected){
+                logger.log("Signature changed the result.", COLOR_RED);
+            }
+        }
+        double fast = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)iterations;
+
+        logger.log(
+            std::string(pair == 1 ? "Frozen" : "Moving") + " frame: pixel_RMSD = " + tostr_fixed(full, 1) +
+            " us, signature first = " + tostr_fixed(fast, 1) + " us (" +
+            std::to_string(skipped) + "/" + std::to_string(iterations) + " skipped the full comparison)"
+        );
+    }
+}
+
+
+
+}
+}
@@ -0,0 +1,81 @@
+/*  Image Signature
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  A small summary of an image that is cheap to compare. It is the channel
+ *  sums over a grid of blocks.
+ *
+ *  Comparing two signatures gives a lower bound on pixel_RMSD() of the two
+ *  images. When the bound is already over the threshold, the full comparison
+ *  can be skipped without changing the result. Otherwise you still need to
+ *  run pixel_RMSD().
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ImageSignature_H
+#define PokemonAutomation_CommonFramework_ImageSignature_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace PokemonAutomation{
+    class Logger;
+    class ImageViewRGB32;
+namespace ImageMatch{
+
+
+class ImageSignature{
+public:
+    static const size_t BLOCKS_X = 32;
+    static const size_t BLOCKS_Y = 18;
+
+    //  Only every Nth row of each block is summed. The bound still holds
+    //  since it only needs a subset of the pixels.
+    static const size_t ROW_STEP = 2;
+
+public:
+    ImageSignature() = default;
+    explicit ImageSignature(const ImageViewRGB32& image);
+
+    size_t width() const{ return m_width; }
+    size_t height() const{ return m_height; }
+
+    //  Lower bound of pixel_RMSD(reference, image) where this is the signature
+    //  of "reference". Returns 0 if the sizes don't match.
+    double min_RMSD(const ImageSignature& image) const;
+
+    //  Returns true if pixel_RMSD(reference, image) > "max_rmsd" is certain.
+    //  Returns false if it's unknown.
+    bool exceeds(const ImageSignature& image, double max_rmsd) const{
+        return min_RMSD(image) > max_rmsd;
+    }
+
+
+private:
+    struct Block{
+        uint64_t red = 0;
+        uint64_t green = 0;
+        uint64_t blue = 0;
+        uint32_t pixels = 0;
+        //  All the summed pixels have alpha = 255. Other blocks can't be used
+        //  as the reference since pixel_RMSD() skips transparent pixels.
+        bool opaque = true;
+    };
+
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<Block> m_blocks;
+};
+
+
+
+//  Time the "has it changed" decision on 1080p frames: full pixel_RMSD()
+//  vs. signatures first.
+void benchmark_ImageSignature(Logger& logger, size_t iterations);
+
+
+
+}
+}
+#endif
@@ -73,6 +73,7 @@ public:
 public:
     using ImageViewRGB32::sub_image;
     using ImageViewRGB32::save;
+    using ImageViewRGB32::encode;
 
 
 private:
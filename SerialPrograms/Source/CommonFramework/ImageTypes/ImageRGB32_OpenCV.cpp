@@ -124,6 +124,26 @@ bool OpenCV_save_image(const ImageViewRGB32& image, const std::string& filename)
 
     return true;
 }
+std::string OpenCV_encode_image(const ImageViewRGB32& image, const std::string& extension, int quality){
+    std::vector<int> params;
+    if (quality >= 0){
+        quality = std::min(quality, 100);
+        if (extension == ".jpg" || extension == ".jpeg"){
+            params = {cv::IMWRITE_JPEG_QUALITY, quality};
+        }else if (extension == ".png"){
+            //  100 is no compression, 0 is the most.
+            params = {cv::IMWRITE_PNG_COMPRESSION, (100 - quality) * 9 / 100};
+        }
+    }
+
+    std::vector<uint8_t> compressed_buffer;
+    bool success = cv::imencode(extension, to_OpenCV_ref(image), compressed_buffer, params);
+    if (!success || compressed_buffer.empty()){
+        global_logger_tagged().log("Failed to encode image as: " + extension);
+        return "";
+    }
+    return std::string((const char*)compressed_buffer.data(), compressed_buffer.size());
+}
 
 
 
@@ -18,6 +18,7 @@ ImageRGB32 OpenCV_scale_image(const ImageViewRGB32& image, size_t width, size_t
 
 ImageRGB32 OpenCV_load_image(const std::string& filename);
 bool OpenCV_save_image(const ImageViewRGB32& image, const std::string& filename);
+std::string OpenCV_encode_image(const ImageViewRGB32& image, const std::string& extension, int quality);
 
 
 
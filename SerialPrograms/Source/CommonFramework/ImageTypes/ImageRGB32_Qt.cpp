@@ -5,6 +5,7 @@
  */
 
 #include <iostream>
+#include <QBuffer>
 #include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "ImageRGB32_Qt.h"
@@ -63,6 +64,17 @@ bool QImage_save_image(const ImageViewRGB32& image, const std::string& filename)
     }
     return success;
 }
+std::string QImage_encode_image(const ImageViewRGB32& image, const std::string& extension, int quality){
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    std::string format = extension.empty() || extension[0] != '.' ? extension : extension.substr(1);
+    if (!to_QImage_ref(image).save(&buffer, format.c_str(), quality)){
+        global_logger_tagged().log("Failed to encode image as: " + extension);
+        return "";
+    }
+    return bytes.toStdString();
+}
 
 
 
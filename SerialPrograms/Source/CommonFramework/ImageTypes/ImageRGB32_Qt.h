@@ -25,6 +25,7 @@ ImageRGB32 QImage_to_ImageRGB32(QImage image);
 
 ImageRGB32 QImage_load_image(const std::string& filename);
 bool QImage_save_image(const ImageViewRGB32& image, const std::string& filename);
+std::string QImage_encode_image(const ImageViewRGB32& image, const std::string& extension, int quality);
 
 
 
@@ -58,6 +58,17 @@ bool ImageViewRGB32::save(const std::string& path) const{
 #endif
 
 }
+std::string ImageViewRGB32::encode(const std::string& extension, int quality) const{
+#ifdef PA_IMAGE_BACKEND_None
+    return "";
+#endif
+#ifdef PA_IMAGE_BACKEND_Qt
+    return QImage_encode_image(*this, extension, quality);
+#endif
+#ifdef PA_IMAGE_BACKEND_OpenCV
+    return OpenCV_encode_image(*this, extension, quality);
+#endif
+}
 
 
 ImageRGB32 ImageViewRGB32::scale_to(size_t width, size_t height) const{
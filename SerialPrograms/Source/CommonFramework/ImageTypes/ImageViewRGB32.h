@@ -44,6 +44,11 @@ public:
     // Call QImage::save() to save image to file. Return whether the save is successful.
     // If the path includes nonexistent folders, save() will create it first.
     bool save(const std::string& path) const;
+    // Compress to the format of "extension" (".png" or ".jpg") without writing a file.
+    // "quality" is 0 - 100, or -1 for the default of the image backend. For .jpg it is the
+    // usual JPEG quality. For .png (lossless) higher is faster with a bigger file.
+    // Return an empty string if the image can't be encoded.
+    std::string encode(const std::string& extension, int quality = -1) const;
     ImageRGB32 scale_to(size_t width, size_t height) const;
 
 private:
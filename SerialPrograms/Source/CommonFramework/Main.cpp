@@ -21,6 +21,8 @@
 #include "StaticRegistration.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/TelemetryRecorder.h"
+#include "CommonFramework/Options/Environment/PerformanceOptions.h"
 #include "VideoPipeline/Backends/MediaServicesQt6.h"
 #include "Globals.h"
 #include "GlobalSettingsPanel.h"
@@ -145,6 +147,7 @@ int run_program(int argc, char *argv[]){
     ScopeExit cleanup([]{
         SerialPortPoller::instance().stop();
         GlobalMediaServices::instance().stop();
+        TelemetryRecorder::instance().stop();
     });
 
     //  Preload a bunch of stuff now so they are ready later.
@@ -203,6 +206,10 @@ int run_program(int argc, char *argv[]){
 
     set_working_directory();
 
+    if (PerformanceOptions::instance().RECORD_TELEMETRY){
+        TelemetryRecorder::instance().start(logger, USER_FILE_PATH() + "Telemetry/");
+    }
+
     //  Run this asynchronously to we don't block startup.
     AsyncTask task = send_all_unsent_reports(logger, true);
 
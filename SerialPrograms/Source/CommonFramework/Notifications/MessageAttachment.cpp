@@ -9,6 +9,7 @@
 #include "Common/Cpp/PrettyPrint.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Tools/ImageEncoder.h"
 #include "MessageAttachment.h"
 
 namespace PokemonAutomation{
@@ -39,12 +40,19 @@ PendingFileSend::~PendingFileSend(){
         return;
     }
 
+    //  Don't wait for the encoder if it isn't done yet.
+    if (m_image_file){
+        m_image_file->remove_when_finished();
+        return;
+    }
+
     QFile file(QString::fromStdString(m_filepath));
     file.remove();
 }
 PendingFileSend::PendingFileSend(const std::string& file, bool keep_file)
     : m_keep_file(keep_file)
     , m_extend_lifetime(false)
+    , m_save_reported(false)
     , m_filepath(file)
 {
     QFileInfo info(QString::fromStdString(file));
@@ -53,6 +61,7 @@ PendingFileSend::PendingFileSend(const std::string& file, bool keep_file)
 PendingFileSend::PendingFileSend(Logger& logger, const ImageAttachment& image)
     : m_keep_file(image.keep_file)
     , m_extend_lifetime(false)
+    , m_save_reported(false)
 {
     if (image.mode == ImageAttachmentMode::NO_SCREENSHOT){
         return;
@@ -84,13 +93,25 @@ PendingFileSend::PendingFileSend(Logger& logger, const ImageAttachment& image)
         m_filepath += m_filename;
     }
 
-    if (image.image.save(m_filepath)){
-        logger.log("Saved image to: " + m_filepath, COLOR_BLUE);
-    }else{
-        logger.log("Unable to save screenshot to: " + m_filepath, COLOR_RED);
-        m_filename.clear();
-        m_filepath.clear();
+    m_image_file = ImageEncoder::instance().save(image.image, m_filepath);
+    logger.log("Saving image in the background to: " + m_filepath, COLOR_BLUE);
+}
+const std::string& PendingFileSend::filepath() const{
+    static const std::string EMPTY;
+    if (!m_image_file){
+        return m_filepath;
+    }
+
+    //  The program's logger may be gone by the time a sender gets here.
+    bool success = m_image_file->wait();
+    if (!m_save_reported.exchange(true, std::memory_order_relaxed)){
+        if (success){
+            global_logger_tagged().log("Saved image to: " + m_filepath, COLOR_BLUE);
+        }else{
+            global_logger_tagged().log("Unable to save screenshot to: " + m_filepath, COLOR_RED);
+        }
     }
+    return success ? m_filepath : EMPTY;
 }
 void PendingFileSend::extend_lifetime(){
     m_extend_lifetime.store(true, std::memory_order_release);
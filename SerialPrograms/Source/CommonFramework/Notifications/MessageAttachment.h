@@ -15,6 +15,8 @@
 
 namespace PokemonAutomation{
 
+class PendingImageFile;
+
 
 struct ImageAttachment{
     ImageViewRGB32 image;
@@ -33,6 +35,10 @@ struct ImageAttachment{
 
 //  Represents a file that's in the process of being sent.
 //  If (keep_file = false), the file is automatically deleted after being sent.
+//
+//  Screenshots are written in the background by ImageEncoder. filepath()
+//  waits for the file and is empty if it couldn't be written. Senders must
+//  then leave out the attachment and anything that refers to it.
 class PendingFileSend{
 public:
     ~PendingFileSend();
@@ -42,7 +48,7 @@ public:
     PendingFileSend(Logger& logger, const ImageAttachment& image);
 
     const std::string& filename() const{ return m_filename; }
-    const std::string& filepath() const{ return m_filepath; }
+    const std::string& filepath() const;
     bool keep_file() const{ return m_keep_file; }
 
     //  Work around bug in Sleepy that destroys file before it's not needed anymore.
@@ -51,9 +57,11 @@ public:
 private:
     bool m_keep_file;
     std::atomic<bool> m_extend_lifetime;
+    mutable std::atomic<bool> m_save_reported;
 //    QFile m_file;
     std::string m_filename;
     std::string m_filepath;
+    std::shared_ptr<PendingImageFile> m_image_file;
 };
 
 
@@ -89,7 +89,9 @@ void send_raw_notification(
     std::shared_ptr<PendingFileSend> file;
     if (image.image.width() > 0 && image.image.height() > 0){ // if image not empty
         file = std::make_shared<PendingFileSend>(logger, image);
-        hasImageFile = !file->filepath().empty();
+        //  Don't wait for the screenshot to be written. (filepath() would)
+        //  If it fails, the senders drop the attachment and the embed image.
+        hasImageFile = !file->filename().empty();
     };
 
     JsonObject embed;
@@ -67,11 +67,20 @@ PerformanceOptions::PerformanceOptions()
         LockMode::UNLOCK_WHILE_RUNNING,
         "2000 us"
     )
+    , RECORD_TELEMETRY(
+        "<b>Record Telemetry:</b><br>"
+        "Record CPU, memory and inference timings to \"UserFiles/Telemetry/\" once a second. "
+        "Use this to find out what slowed down during a long run.<br>"
+        "Restart the program for this to take effect.",
+        LockMode::LOCK_WHILE_RUNNING,
+        false
+    )
 {
     PA_ADD_OPTION(PROCESSOR_LEVEL);
 #ifdef _WIN32
     PA_ADD_OPTION(CORE_AFFINITY);
 #endif
+    PA_ADD_OPTION(THREAD_AFFINITY);
 
     PA_ADD_OPTION(UI_THREAD_PRIORITY);
     PA_ADD_OPTION(REALTIME_THREAD_PRIORITY0);
@@ -85,6 +94,8 @@ PerformanceOptions::PerformanceOptions()
 //    PA_ADD_OPTION(PRECISE_WAKE_MARGIN);
 
     PA_ADD_OPTION(ONNX_OPTIONS);
+
+    PA_ADD_OPTION(RECORD_TELEMETRY);
 }
 
 
@@ -8,11 +8,13 @@
 #define PokemonAutomation_PerformanceOptions_H
 
 #include "Common/Cpp/Options/GroupOption.h"
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
 #include "Common/Cpp/Options/TimeDurationOption.h"
 #include "CommonFramework/Options/ThreadPoolOption.h"
 #include "ProcessPriorityOption.h"
 #include "ProcessorLevelOption.h"
 #include "CoreAffinityOption.h"
+#include "ThreadAffinityOption.h"
 #include "OnnxOptions.h"
 
 namespace PokemonAutomation{
@@ -33,6 +35,7 @@ public:
 #ifdef _WIN32
     CoreAffinityOption CORE_AFFINITY;
 #endif
+    ThreadAffinityOption THREAD_AFFINITY;
 
     ThreadPriorityOption UI_THREAD_PRIORITY;
     ThreadPriorityOption REALTIME_THREAD_PRIORITY0;
@@ -44,6 +47,8 @@ public:
 
     MicrosecondsOption PRECISE_WAKE_MARGIN;
 
+    BooleanCheckBoxOption RECORD_TELEMETRY;
+
     OnnxOptions ONNX_OPTIONS;
 };
 
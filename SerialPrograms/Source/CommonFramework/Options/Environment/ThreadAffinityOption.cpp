@@ -0,0 +1,58 @@
+/* Thread Affinity Option
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "ThreadAffinityOption.h"
+
+namespace PokemonAutomation{
+
+
+
+ThreadAffinityOption::ThreadAffinityOption()
+    : GroupOption(
+        "Thread Affinity",
+        LockMode::LOCK_WHILE_RUNNING,
+        EnableMode::DEFAULT_DISABLED,
+        true
+    )
+    , m_description(
+        "Pin the video conversion and inference threads of each console to their own set of cores "
+        "and keep the serial port threads on cores of their own. "
+        "This reduces inference latency jitter on machines running many consoles at once.<br>"
+        "The current placement is shown in the video overlay stats.<br>"
+        "Not supported on macOS. Restart the program for changes to take effect."
+    )
+    , CONSOLE_GROUPS(
+        "<b>Console Core Groups:</b><br>"
+        "Split the cores into this many groups. Console N uses group (N mod groups). "
+        "Set this to the number of consoles you run at once.",
+        LockMode::LOCK_WHILE_RUNNING,
+        4, 1
+    )
+    , SERIAL_IO_CORES(
+        "<b>Serial I/O Cores:</b><br>"
+        "Reserve this many physical cores (from the end) for serial port threads. "
+        "Set to zero to leave serial threads unpinned.",
+        LockMode::LOCK_WHILE_RUNNING,
+        1
+    )
+    , SEPARATE_SMT_SIBLINGS(
+        "<b>Separate SMT Siblings:</b><br>"
+        "Only give console groups one hyperthread of each physical core. "
+        "The other hyperthread is left to everything else so it doesn't slow down inference.",
+        LockMode::LOCK_WHILE_RUNNING,
+        false
+    )
+{
+    PA_ADD_STATIC(m_description);
+    PA_ADD_OPTION(CONSOLE_GROUPS);
+    PA_ADD_OPTION(SERIAL_IO_CORES);
+    PA_ADD_OPTION(SEPARATE_SMT_SIBLINGS);
+}
+
+
+
+
+}
@@ -0,0 +1,35 @@
+/* Thread Affinity Option
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_ThreadAffinityOption_H
+#define PokemonAutomation_ThreadAffinityOption_H
+
+#include "Common/Cpp/Options/StaticTextOption.h"
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
+#include "Common/Cpp/Options/GroupOption.h"
+
+namespace PokemonAutomation{
+
+
+//  Per-console thread placement. See ThreadAffinityPolicy for how these are
+//  turned into core sets.
+class ThreadAffinityOption : public GroupOption{
+public:
+    ThreadAffinityOption();
+
+public:
+    StaticTextOption m_description;
+    SimpleIntegerOption<uint8_t> CONSOLE_GROUPS;
+    SimpleIntegerOption<uint8_t> SERIAL_IO_CORES;
+    BooleanCheckBoxOption SEPARATE_SMT_SIBLINGS;
+};
+
+
+
+
+}
+#endif
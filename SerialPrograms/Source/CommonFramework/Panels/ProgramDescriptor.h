@@ -7,6 +7,8 @@
 #ifndef PokemonAutomation_CommonFramework_ProgramDescriptor_H
 #define PokemonAutomation_CommonFramework_ProgramDescriptor_H
 
+#include <vector>
+#include "CommonFramework/Language.h"
 #include "PanelDescriptor.h"
 
 namespace PokemonAutomation{
@@ -32,6 +34,15 @@ public:
     using PanelDescriptor::PanelDescriptor;
 
     virtual std::unique_ptr<StatsTracker> make_stats() const;
+
+    //  OCR instances to load in the background when the program panel is
+    //  opened so that the first reads don't pay for the model load.
+    //  Only for languages that are known up front.
+    struct OcrPrewarm{
+        Language language;
+        size_t instances;
+    };
+    virtual std::vector<OcrPrewarm> ocr_prewarm() const;
 };
 
 
@@ -18,6 +18,7 @@
 #include "CommonFramework/ResourceDownload/GlobalResourceDownloadManager.h"
 #include "CommonFramework/ResourceDownload/ResourceDownloadHelpers.h"
 #include "CommonFramework/ResourceDownload/ResourceDownloadHelpersQt.h"
+#include "CommonTools/OCR/OCR_Routines.h"
 #include "Integrations/ProgramTracker.h"
 
 namespace PokemonAutomation{
@@ -42,6 +43,24 @@ ProgramSession::ProgramSession(const ProgramDescriptor& descriptor)
     , m_state(ProgramState::STOPPED)
 {
     load_historical_stats();
+
+    std::vector<ProgramDescriptor::OcrPrewarm> prewarm = descriptor.ocr_prewarm();
+    if (!prewarm.empty()){
+        m_ocr_prewarm = GlobalThreadPools::unlimited_normal().dispatch_now_blocking(
+            [this, prewarm = std::move(prewarm)]{
+                for (const ProgramDescriptor::OcrPrewarm& item : prewarm){
+                    try{
+                        OCR::ensure_ocr_instances(item.language, item.instances);
+                    }catch (Exception& e){
+                        m_logger.log(
+                            "Unable to prewarm OCR (" + language_data(item.language).code + "): " + e.message(),
+                            COLOR_RED
+                        );
+                    }
+                }
+            }
+        );
+    }
 }
 ProgramSession::~ProgramSession(){
     ProgramTracker::instance().remove_program(m_instance_id);
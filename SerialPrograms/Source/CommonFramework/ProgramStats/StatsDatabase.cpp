@@ -4,9 +4,14 @@
  *
  */
 
+#include <string.h>
+#include <algorithm>
 #include <QFile>
 #include <QSaveFile>
+#include <QLockFile>
+#include "Common/CRC32/pabb_CRC32.h"
 #include "Common/Cpp/Time.h"
+#include "Common/Cpp/PrettyPrint.h"
 #include "StatsDatabase.h"
 
 #include <iostream>
@@ -41,6 +46,114 @@ const std::map<std::string, std::string> STATS_DATABASE_ALIASES{
 
 
 
+//  Journal
+//
+//  Updates are appended to "<stats file>.journal". The first line is
+//  "PA-Stats-Journal <epoch>". Every line after that is one record:
+//
+//      <crc32 of payload, 8 hex digits> <program identifier>\t<stat line>
+//
+//  A record that fails its checksum is skipped. This includes a record that
+//  was cut off by a crash.
+//
+//  Compaction writes the stats file with "Journal Epoch: <epoch + 1>" as the
+//  first line and then clears the journal. The journal is only replayed if
+//  its epoch matches the stats file. So if we crash between the two steps,
+//  the records that were already folded in aren't applied again.
+//
+//  Multiple instances can share the stats file. Everything is done under a
+//  lock file.
+
+const char STATS_JOURNAL_HEADER[] = "PA-Stats-Journal ";
+const char STATS_EPOCH_HEADER[] = "Journal Epoch: ";
+const size_t STATS_JOURNAL_COMPACT_BYTES = 64 * 1024;
+const int STATS_LOCK_TIMEOUT_MS = 10000;
+
+std::string stats_journal_path(const std::string& filepath){
+    return filepath + ".journal";
+}
+
+uint32_t stats_record_crc32(const std::string& payload){
+    //  The portable CRC32 only takes up to 255 bytes at a time.
+    uint32_t crc = 0xffffffff;
+    const char* ptr = payload.data();
+    size_t bytes = payload.size();
+    while (bytes > 0){
+        uint8_t block = (uint8_t)std::min<size_t>(bytes, 255);
+        pabb_crc32_buffer(&crc, ptr, block);
+        ptr += block;
+        bytes -= block;
+    }
+    return ~crc;
+}
+std::string encode_stats_record(const std::string& identifier, const StatLine& line){
+    std::string payload = identifier + "\t" + line.to_str();
+    return tostr_hex_padded(8, stats_record_crc32(payload)) + " " + payload + "\r\n";
+}
+bool decode_stats_record(const std::string& line, std::string& identifier, std::string& stats){
+    if (line.size() < 9 || line[8] != ' '){
+        return false;
+    }
+    uint32_t crc = 0;
+    for (size_t c = 0; c < 8; c++){
+        char ch = line[c];
+        crc <<= 4;
+        if ('0' <= ch && ch <= '9'){
+            crc |= ch - '0';
+        }else if ('a' <= ch && ch <= 'f'){
+            crc |= ch - 'a' + 10;
+        }else{
+            return false;
+        }
+    }
+    std::string payload = line.substr(9);
+    if (stats_record_crc32(payload) != crc){
+        return false;
+    }
+    size_t tab = payload.find('\t');
+    if (tab == std::string::npos){
+        return false;
+    }
+    identifier = payload.substr(0, tab);
+    stats = payload.substr(tab + 1);
+    return true;
+}
+
+bool parse_stats_epoch(std::string line, const char* prefix, uint64_t& epoch){
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')){
+        line.pop_back();
+    }
+    size_t prefix_length = strlen(prefix);
+    if (line.size() <= prefix_length || line.compare(0, prefix_length, prefix) != 0){
+        return false;
+    }
+    epoch = 0;
+    for (size_t c = prefix_length; c < line.size(); c++){
+        char ch = line[c];
+        if (ch < '0' || ch > '9'){
+            return false;
+        }
+        epoch = epoch * 10 + (ch - '0');
+    }
+    return true;
+}
+
+//  Returns false if the stats file exists but can't be read.
+bool read_stats_epoch(const std::string& filepath, uint64_t& epoch){
+    epoch = 0;
+    QFile file(QString::fromStdString(filepath));
+    if (!file.exists()){
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+    parse_stats_epoch(file.readLine(256).toStdString(), STATS_EPOCH_HEADER, epoch);
+    return true;
+}
+
+
+
 StatLine::StatLine(StatsTracker& tracker)
     : m_time(current_time_to_str())
     , m_stats(tracker.to_str(StatsTracker::SAVE_TO_STATS_FILE))
@@ -141,13 +254,68 @@ void StatSet::save_to_file(const std::string& filepath){
     }
 }
 void StatSet::open_from_file(const std::string& filepath){
-    QFile file(QString::fromStdString(filepath));
-    if (!file.open(QIODevice::ReadOnly)){
-        return;
+    //  If another instance is stuck holding the lock, read anyway.
+    QLockFile lock(QString::fromStdString(filepath + ".lock"));
+    lock.tryLock(STATS_LOCK_TIMEOUT_MS);
+
+    uint64_t epoch;
+    load_locked(filepath, epoch);
+}
+bool StatSet::load_locked(const std::string& filepath, uint64_t& epoch){
+    m_data.clear();
+    epoch = 0;
+    {
+        QFile file(QString::fromStdString(filepath));
+        if (file.exists()){
+            if (!file.open(QIODevice::ReadOnly)){
+                return false;
+            }
+            std::string str = file.readAll().toStdString();
+            load_from_string(str.c_str());
+            parse_stats_epoch(str.substr(0, str.find('\n')), STATS_EPOCH_HEADER, epoch);
+        }
     }
 
-    std::string str = file.readAll().data();
-    load_from_string(str.c_str());
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (!file.open(QIODevice::ReadOnly)){
+        return true;
+    }
+    std::string data = file.readAll().toStdString();
+
+    size_t pos = data.find('\n');
+    uint64_t journal_epoch;
+    if (pos == std::string::npos ||
+        !parse_stats_epoch(data.substr(0, pos), STATS_JOURNAL_HEADER, journal_epoch) ||
+        journal_epoch != epoch
+    ){
+        return true;
+    }
+    pos++;
+
+    std::string identifier;
+    std::string stats;
+    while (pos < data.size()){
+        //  The last line may be missing its line break. The checksum decides
+        //  whether it's complete.
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos){
+            end = data.size();
+        }
+        std::string line = data.substr(pos, end - pos);
+        pos = end + 1;
+        while (!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        if (!decode_stats_record(line, identifier, stats)){
+            continue;
+        }
+        auto iter = STATS_DATABASE_ALIASES.find(identifier);
+        if (iter != STATS_DATABASE_ALIASES.end()){
+            identifier = iter->second;
+        }
+        m_data[identifier] += stats;
+    }
+    return true;
 }
 
 bool StatSet::update_file(
@@ -155,22 +323,90 @@ bool StatSet::update_file(
     const std::string& identifier,
     StatsTracker& tracker
 ){
-    QFile file(QString::fromStdString(filepath));
-    while (!file.open(QIODevice::ReadWrite)){
+    QLockFile lock(QString::fromStdString(filepath + ".lock"));
+    if (!lock.tryLock(STATS_LOCK_TIMEOUT_MS)){
         return false;
     }
-    std::string data = file.readAll().data();
 
-    StatSet set;
-    set.load_from_string(data.c_str());
+    uint64_t epoch;
+    if (!read_stats_epoch(filepath, epoch)){
+        return false;
+    }
 
-    set[identifier] += tracker;
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (!file.open(QIODevice::ReadWrite)){
+        return false;
+    }
 
-    data = set.to_str();
-    file.seek(0);
-    file.write(data.c_str(), data.size());
-    file.resize(data.size());
+    std::string data;
+    uint64_t journal_epoch;
+    if (!parse_stats_epoch(file.readLine(256).toStdString(), STATS_JOURNAL_HEADER, journal_epoch) ||
+        journal_epoch != epoch
+    ){
+        //  Missing, or already folded into the stats file.
+        file.resize(0);
+        data = STATS_JOURNAL_HEADER + std::to_string(epoch) + "\r\n";
+    }else{
+        //  Terminate a record that was cut off so it doesn't swallow this one.
+        char last = '\n';
+        file.seek(file.size() - 1);
+        file.getChar(&last);
+        if (last != '\n'){
+            data = "\r\n";
+        }
+    }
+    data += encode_stats_record(identifier, StatLine(tracker));
+
+    file.seek(file.size());
+    if (file.write(data.c_str(), data.size()) != (qint64)data.size() || !file.flush()){
+        return false;
+    }
+    size_t journal_bytes = (size_t)file.size();
+    file.close();
 
+    //  The record is already safe in the journal. If this fails it will be
+    //  retried on the next update.
+    if (journal_bytes >= STATS_JOURNAL_COMPACT_BYTES){
+        compact_locked(filepath);
+    }
+
+    return true;
+}
+
+bool StatSet::compact_file(const std::string& filepath){
+    QLockFile lock(QString::fromStdString(filepath + ".lock"));
+    if (!lock.tryLock(STATS_LOCK_TIMEOUT_MS)){
+        return false;
+    }
+    return compact_locked(filepath);
+}
+bool StatSet::compact_locked(const std::string& filepath){
+    StatSet set;
+    uint64_t epoch;
+    if (!set.load_locked(filepath, epoch)){
+        return false;
+    }
+    epoch++;
+
+    {
+        QSaveFile file(QString::fromStdString(filepath));
+        if (!file.open(QIODevice::WriteOnly)){
+            return false;
+        }
+        std::string data = STATS_EPOCH_HEADER + std::to_string(epoch) + "\r\n\r\n" + set.to_str();
+        file.write(data.c_str(), data.size());
+        if (!file.commit()){
+            return false;
+        }
+    }
+
+    //  If this fails, the old journal is stale and gets reset on the next
+    //  update.
+    QFile file(QString::fromStdString(stats_journal_path(filepath)));
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        std::string data = STATS_JOURNAL_HEADER + std::to_string(epoch) + "\r\n";
+        file.write(data.c_str(), data.size());
+    }
     return true;
 }
 
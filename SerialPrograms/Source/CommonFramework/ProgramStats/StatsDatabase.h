@@ -2,6 +2,11 @@
  *
  *  From: https://github.com/PokemonAutomation/
  *
+ *  The stats file is a readable text file with one section per program.
+ *  Updates don't rewrite it. They are appended to a checksummed journal
+ *  next to it ("<stats file>.journal") which is folded back into the stats
+ *  file once it gets large. See StatsDatabase.cpp for the format.
+ *
  */
 
 #ifndef PokemonAutomation_StatsDatabase_H
@@ -54,18 +59,29 @@ public:
     std::string to_str() const;
 
     void save_to_file(const std::string& filepath);
+
+    //  Load the stats file and replay its journal.
     void open_from_file(const std::string& filepath);
 
+    //  Append the current stats of this program to the journal. This is
+    //  O(1) in the size of the stats file.
     static bool update_file(
         const std::string& filepath,
         const std::string& identifier,
         StatsTracker& tracker
     );
 
+    //  Fold the journal into the stats file now.
+    static bool compact_file(const std::string& filepath);
+
 private:
     bool get_line(std::string& line, const char*& ptr);
     void load_from_string(const char* ptr);
 
+    //  These must be called with the stats file locked.
+    bool load_locked(const std::string& filepath, uint64_t& epoch);
+    static bool compact_locked(const std::string& filepath);
+
 private:
     std::map<std::string, StatList> m_data;
 };
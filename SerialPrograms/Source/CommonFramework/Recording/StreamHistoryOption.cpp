@@ -105,12 +105,39 @@ StreamHistoryOption::StreamHistoryOption()
         80,
         0, 100
     )
+    , MJPEG_PASSTHROUGH(
+        "<b>MJPEG Passthrough:</b><br>"
+        "If the capture card already delivers MJPEG frames, store them as-is "
+        "instead of decoding and re-compressing them. "
+        "This only applies when the resolution is set to match the input.",
+        LockMode::UNLOCK_WHILE_RUNNING,
+        true
+    )
+    , COMPRESSION_THREADS(
+        "<b>Compression Threads:</b><br>"
+        "Compress frames on this many threads in parallel. "
+        "Increase this if the overlay reports dropped frames. "
+        "Takes effect the next time the video stream starts.",
+        LockMode::LOCK_WHILE_RUNNING,
+        2, 1, 16
+    )
+    , MEMORY_BUDGET_MB(
+        "<b>Memory Budget (MB):</b><br>"
+        "Maximum amount of memory used to hold compressed frames for each video stream. "
+        "If this is exceeded, the oldest frames are discarded before the history window is reached. "
+        "Takes effect the next time the video stream starts.",
+        LockMode::LOCK_WHILE_RUNNING,
+        1024, 16
+    )
 {
     PA_ADD_STATIC(DESCRIPTION);
     PA_ADD_OPTION(HISTORY_SECONDS);
     PA_ADD_OPTION(RESOLUTION);
     PA_ADD_OPTION(VIDEO_FPS);
     PA_ADD_OPTION(JPEG_QUALITY);
+    PA_ADD_OPTION(MJPEG_PASSTHROUGH);
+    PA_ADD_OPTION(COMPRESSION_THREADS);
+    PA_ADD_OPTION(MEMORY_BUDGET_MB);
     // PA_ADD_OPTION(ENCODING_MODE);
     // PA_ADD_OPTION(VIDEO_QUALITY);
     // PA_ADD_OPTION(VIDEO_BITRATE);
@@ -8,6 +8,7 @@
 #define PokemonAutomation_StreamHistoryOption_H
 
 #include "Common/Cpp/Options/StaticTextOption.h"
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
 #include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Options/EnumDropdownOption.h"
 #include "Common/Cpp/Options/GroupOption.h"
@@ -60,6 +61,10 @@ public:
     };
     EnumDropdownOption<VideoFPS> VIDEO_FPS;
     SimpleIntegerOption<uint16_t> JPEG_QUALITY;
+
+    BooleanCheckBoxOption MJPEG_PASSTHROUGH;
+    SimpleIntegerOption<uint8_t> COMPRESSION_THREADS;
+    SimpleIntegerOption<uint32_t> MEMORY_BUDGET_MB;
 };
 
 
@@ -5,6 +5,7 @@
  */
 
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
 #include "Common/Cpp/Containers/Pimpl.tpp"
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
@@ -38,6 +39,10 @@ struct StreamHistorySession::Data{
     bool m_has_video;
     std::shared_ptr<StreamHistoryTracker> m_current;
 
+    //  Used to highlight the overlay stat when frames are being dropped.
+    uint64_t m_last_dropped = 0;
+    WallClock m_last_drop_time = WallClock::min();
+
     Data(Logger& logger)
         : m_logger(logger)
         , m_window(GlobalSettings::instance().STREAM_HISTORY->HISTORY_SECONDS)
@@ -91,6 +96,41 @@ bool StreamHistorySession::save(const std::string& filename) const{
 
     return tracker->save(filename);
 }
+OverlayStatSnapshot StreamHistorySession::get_current(){
+    Data& data = *m_data;
+    std::shared_ptr<StreamHistoryTracker> tracker;
+    {
+        WriteSpinLock lg(data.m_lock);
+        tracker = data.m_current;
+    }
+    if (!tracker){
+        return OverlayStatSnapshot();
+    }
+
+    StreamHistoryStats stats = tracker->stats();
+    uint64_t dropped = stats.frames_dropped_backlog + stats.frames_dropped_budget;
+
+    WallClock now = current_time();
+    WriteSpinLock lg(data.m_lock);
+    if (dropped < data.m_last_dropped){
+        //  Tracker was reset.
+        data.m_last_dropped = 0;
+    }
+    if (dropped > data.m_last_dropped){
+        data.m_last_dropped = dropped;
+        data.m_last_drop_time = now;
+    }
+
+    OverlayStatSnapshot ret;
+    ret.text = "History: " + tostr_u_commas(stats.frames_stored) + " frames (" + tostr_bytes(stats.bytes_stored) + ")";
+    if (dropped != 0){
+        ret.text += ", Dropped: " + tostr_u_commas(stats.frames_dropped_backlog) + " (lag) / " + tostr_u_commas(stats.frames_dropped_budget) + " (memory)";
+    }
+    if (data.m_last_drop_time != WallClock::min() && now - data.m_last_drop_time < std::chrono::seconds(10)){
+        ret.color = COLOR_ORANGE;
+    }
+    return ret;
+}
 void StreamHistorySession::on_samples(const float* samples, size_t frames){
     Data& data = *m_data;
     WriteSpinLock lg(data.m_lock);
@@ -13,6 +13,7 @@
 #include "Common/Cpp/Containers/Pimpl.h"
 #include "CommonFramework/AudioPipeline/AudioSession.h"
 #include "CommonFramework/VideoPipeline/VideoSession.h"
+#include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
 
 namespace PokemonAutomation{
 
@@ -22,6 +23,7 @@ class StreamHistorySession
     , public VideoFrameListener
     , public AudioSession::StateListener
     , public VideoSession::StateListener
+    , public OverlayStat
 {
 public:
     ~StreamHistorySession();
@@ -43,6 +45,10 @@ public:
     virtual void pre_resolution_change(Resolution resolution) override;
     virtual void post_resolution_change(Resolution resolution) override;
 
+public:
+    //  Overlay stat with the # of stored/dropped frames.
+    virtual OverlayStatSnapshot get_current() override;
+
 private:
     void clear();
     void initialize();
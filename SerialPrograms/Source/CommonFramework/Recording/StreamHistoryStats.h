@@ -0,0 +1,31 @@
+/*  Stream History Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_StreamHistoryStats_H
+#define PokemonAutomation_StreamHistoryStats_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PokemonAutomation{
+
+
+struct StreamHistoryStats{
+    size_t frames_stored = 0;
+    uint64_t bytes_stored = 0;
+    uint64_t frames_compressed = 0;
+    uint64_t frames_passthrough = 0;
+
+    //  Frames dropped because the compression workers fell behind.
+    uint64_t frames_dropped_backlog = 0;
+
+    //  Frames evicted before the end of the window to stay within the memory budget.
+    uint64_t frames_dropped_budget = 0;
+};
+
+
+}
+#endif
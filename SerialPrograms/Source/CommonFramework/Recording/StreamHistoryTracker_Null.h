@@ -12,6 +12,7 @@
 #include "Common/Compiler.h"
 #include "Common/Cpp/Logging/AbstractLogger.h"
 #include "CommonFramework/VideoPipeline/Backends/VideoFrameQt.h"
+#include "StreamHistoryStats.h"
 
 namespace PokemonAutomation{
 
@@ -34,6 +35,10 @@ public:
         return false;
     }
 
+    StreamHistoryStats stats() const{
+        return StreamHistoryStats();
+    }
+
 public:
     void on_samples(const float* data, size_t frames){}
     void on_frame(std::shared_ptr<const VideoFrame> frame){}
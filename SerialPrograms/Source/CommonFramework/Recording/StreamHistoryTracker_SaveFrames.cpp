@@ -117,6 +117,26 @@ std::vector<uchar> compress_video_frame(const QVideoFrame& const_frame){
     return compressed_buffer; // Store this in the circular buffer
 }
 
+std::vector<uchar> passthrough_mjpeg_frame(const QVideoFrame& const_frame){
+    if (const_frame.pixelFormat() != QVideoFrameFormat::Format_Jpeg){
+        return {};
+    }
+
+    QVideoFrame frame = const_frame;
+    if (!frame.map(QVideoFrame::ReadOnly)){
+        return {};
+    }
+    auto guard = qScopeGuard([&frame] { frame.unmap(); });
+
+    //  For JPEG frames, plane 0 is the entire compressed payload.
+    const uchar* data = frame.bits(0);
+    int bytes = frame.mappedBytes(0);
+    if (data == nullptr || bytes <= 0){
+        return {};
+    }
+    return std::vector<uchar>(data, data + bytes);
+}
+
 size_t get_target_fps(){
     const StreamHistoryOption& settings = GlobalSettings::instance().STREAM_HISTORY;
     size_t target_fps;
@@ -145,9 +165,14 @@ size_t get_target_fps(){
 
 
 StreamHistoryTracker::~StreamHistoryTracker(){
-    m_stopping = true;
+    {
+        std::lock_guard<Mutex> lock(m_queue_lock);
+        m_stopping = true;
+    }
     m_cv.notify_all();
-    m_worker.wait_and_ignore_exceptions();
+    for (AsyncTask& worker : m_workers){
+        worker.wait_and_ignore_exceptions();
+    }
 }
 
 StreamHistoryTracker::StreamHistoryTracker(
@@ -167,10 +192,16 @@ StreamHistoryTracker::StreamHistoryTracker(
     , m_target_fps(get_target_fps())
     , m_frame_interval(1000000 / m_target_fps)
     , m_next_frame_time(WallClock::min())
+    , m_worker_count(GlobalSettings::instance().STREAM_HISTORY->COMPRESSION_THREADS)
+    , m_max_pending_frames(MAX_PENDING_FRAMES * m_worker_count)
+    , m_memory_budget((uint64_t)GlobalSettings::instance().STREAM_HISTORY->MEMORY_BUDGET_MB << 20)
 {
-    m_worker = GlobalThreadPools::unlimited_normal().dispatch_now_blocking(
-        [this]{ worker_loop(); }
-    );
+    m_workers.reserve(m_worker_count);
+    for (size_t c = 0; c < m_worker_count; c++){
+        m_workers.emplace_back(GlobalThreadPools::unlimited_normal().dispatch_now_blocking(
+            [this]{ worker_loop(); }
+        ));
+    }
 }
 
 void StreamHistoryTracker::set_window(std::chrono::seconds window){
@@ -235,9 +266,10 @@ void StreamHistoryTracker::on_frame(std::shared_ptr<const VideoFrame> frame){
         std::lock_guard<Mutex> lock(m_queue_lock);
 
         // Drop oldest if we are falling behind
-        if (m_pending_frames.size() >= MAX_PENDING_FRAMES){
+        if (m_pending_frames.size() >= m_max_pending_frames){
             m_pending_frames.pop_front(); 
-            m_logger.log("StreamHistory worker thread lagging: Frame dropped.", COLOR_RED);
+            m_frames_dropped_backlog++;
+            m_logger.log("StreamHistory worker threads lagging: Frame dropped.", COLOR_RED);
         }
         m_pending_frames.emplace_back(std::move(frame));
 
@@ -248,8 +280,31 @@ void StreamHistoryTracker::on_frame(std::shared_ptr<const VideoFrame> frame){
 
 
 
+StreamHistoryStats StreamHistoryTracker::stats() const{
+    StreamHistoryStats ret;
+    {
+        ReadSpinLock lg(m_lock, PA_CURRENT_FUNCTION);
+        ret.frames_stored = m_compressed_frames.size();
+        ret.bytes_stored = m_compressed_bytes;
+        ret.frames_compressed = m_frames_compressed;
+        ret.frames_passthrough = m_frames_passthrough;
+        ret.frames_dropped_budget = m_frames_dropped_budget;
+    }
+    {
+        std::lock_guard<Mutex> lock(m_queue_lock);
+        ret.frames_dropped_backlog = m_frames_dropped_backlog;
+    }
+    return ret;
+}
+
+
+
 void StreamHistoryTracker::clear_old(){
     //  Must call under lock.
+    if (m_compressed_frames.empty()){
+        return;
+    }
+
     WallClock latest_frame = m_compressed_frames.back().timestamp;
     WallClock threshold = latest_frame - m_window;
 
@@ -276,11 +331,19 @@ void StreamHistoryTracker::clear_old(){
 
     while (!m_compressed_frames.empty()){
         if (m_compressed_frames.front().timestamp < threshold){
+            m_compressed_bytes -= m_compressed_frames.front().compressed_frame.size();
             m_compressed_frames.pop_front();
         }else{
             break;
         }
     }
+
+    //  Enforce the memory budget. Always keep the latest frame.
+    while (m_compressed_bytes > m_memory_budget && m_compressed_frames.size() > 1){
+        m_compressed_bytes -= m_compressed_frames.front().compressed_frame.size();
+        m_compressed_frames.pop_front();
+        m_frames_dropped_budget++;
+    }
 }
 
 
@@ -360,38 +423,83 @@ bool StreamHistoryTracker::save(const std::string& filename) const{
 }
 
 
+void StreamHistoryTracker::commit_frame(uint64_t seqnum, CompressedVideoFrame frame, bool passthrough){
+    WriteSpinLock lg(m_lock, PA_CURRENT_FUNCTION);
+
+    if (passthrough){
+        m_frames_passthrough++;
+    }else{
+        m_frames_compressed++;
+    }
+
+    if (seqnum != m_next_commit_seqnum){
+        m_reorder_buffer.emplace(seqnum, std::move(frame));
+        return;
+    }
+
+    //  Commit this frame along with any later frames that were waiting on it.
+    //  Frames that failed to compress are empty and only advance the sequence.
+    while (true){
+        if (!frame.compressed_frame.empty()){
+            m_compressed_bytes += frame.compressed_frame.size();
+            m_compressed_frames.emplace_back(std::move(frame));
+        }
+        m_next_commit_seqnum++;
+
+        auto iter = m_reorder_buffer.begin();
+        if (iter == m_reorder_buffer.end() || iter->first != m_next_commit_seqnum){
+            break;
+        }
+        frame = std::move(iter->second);
+        m_reorder_buffer.erase(iter);
+    }
+
+    clear_old(); // Cleanup happens here
+}
 void StreamHistoryTracker::worker_loop(){
-    while (!m_stopping){
+    while (true){
         std::shared_ptr<const VideoFrame> frame;
+        uint64_t seqnum;
 
         // 1. Wait for a frame to process
         {
             std::unique_lock<Mutex> lock(m_queue_lock);
             m_cv.wait(lock, [this] { return !m_pending_frames.empty() || m_stopping; });
-            
-            if (m_stopping && m_pending_frames.empty()) return;
 
+            //  Finish what's queued before stopping.
+            if (m_pending_frames.empty()) return;
+
+            //  Sequence numbers are assigned on dequeue so that frames dropped
+            //  from the backlog do not leave holes in the commit order.
             frame = std::move(m_pending_frames.front());
             m_pending_frames.pop_front();
+            seqnum = m_next_dispatch_seqnum++;
         }
 
         // 2. Perform the expensive compression (Outside the lock)
-        auto compressed_data = compress_video_frame(frame->frame);
-
-        // 3. Move the result into the main storage
-        {
-            WriteSpinLock lg(m_lock, PA_CURRENT_FUNCTION);
-            m_compressed_frames.emplace_back(CompressedVideoFrame{
-                frame->timestamp, 
-                std::move(compressed_data)
-            });
-            clear_old(); // Cleanup happens here
+        const StreamHistoryOption& settings = GlobalSettings::instance().STREAM_HISTORY;
+        bool passthrough = false;
+        std::vector<uchar> compressed_data;
+        if (settings.MJPEG_PASSTHROUGH &&
+            settings.RESOLUTION == StreamHistoryOption::Resolution::MATCH_INPUT
+        ){
+            compressed_data = passthrough_mjpeg_frame(frame->frame);
+            passthrough = !compressed_data.empty();
+        }
+        if (!passthrough){
+            compressed_data = compress_video_frame(frame->frame);
         }
+
+        // 3. Move the result into the main storage in frame order
+        commit_frame(
+            seqnum,
+            CompressedVideoFrame{frame->timestamp, std::move(compressed_data)},
+            passthrough
+        );
     }
 }
 
 
-
 }
 
 // #include "StreamHistoryTracker_SaveFrames.moc" 
@@ -10,6 +10,7 @@
 #ifndef PokemonAutomation_StreamHistoryTracker_SaveFrames_H
 #define PokemonAutomation_StreamHistoryTracker_SaveFrames_H
 
+#include <map>
 #include <deque>
 #include <QImage>
 #include <QVideoFrame>
@@ -20,6 +21,7 @@
 #include "Common/Cpp/Concurrency/ConditionVariable.h"
 #include "Common/Cpp/Concurrency/AsyncTask.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "StreamHistoryStats.h"
 
 
 namespace PokemonAutomation{
@@ -46,6 +48,10 @@ struct CompressedVideoFrame{
 QImage decompress_video_frame(const std::vector<uchar> &compressed_buffer);
 std::vector<uchar> compress_video_frame(const QVideoFrame& const_frame);
 
+//  If the frame is already a JPEG (MJPEG capture cards), return a copy of the
+//  compressed payload. Otherwise returns an empty buffer.
+std::vector<uchar> passthrough_mjpeg_frame(const QVideoFrame& const_frame);
+
 class StreamHistoryTracker{
 public:
     ~StreamHistoryTracker();
@@ -60,15 +66,19 @@ public:
 
     bool save(const std::string& filename) const;
 
+    StreamHistoryStats stats() const;
+
 public:
     void on_samples(const float* data, size_t frames);
     void on_frame(std::shared_ptr<const VideoFrame> frame);
 
 private:
     void clear_old();
+    void commit_frame(uint64_t seqnum, CompressedVideoFrame frame, bool passthrough);
     void worker_loop(); // The function that runs in the thread
 
 private:
+    //  Per compression worker. The total backlog scales with the # of workers.
     static constexpr size_t MAX_PENDING_FRAMES = 10;
     Logger& m_logger;
     mutable SpinLock m_lock;
@@ -83,23 +93,35 @@ private:
     std::chrono::microseconds m_frame_interval;
     WallClock m_next_frame_time;
 
+    const size_t m_worker_count;
+    const size_t m_max_pending_frames;
+    const uint64_t m_memory_budget;
+
     //  We use shared_ptr here so it's fast to snapshot when we need to copy
     //  everything asynchronously.
     // std::deque<std::shared_ptr<AudioBlock>> m_audio;
     // std::deque<std::shared_ptr<const VideoFrame>> m_frames;
     std::deque<CompressedVideoFrame> m_compressed_frames;
+    uint64_t m_compressed_bytes = 0;
+
+    //  Workers finish out of order. Completed frames wait here until all the
+    //  frames before them have been committed. (protected by m_lock)
+    std::map<uint64_t, CompressedVideoFrame> m_reorder_buffer;
+    uint64_t m_next_commit_seqnum = 0;
+
+    uint64_t m_frames_compressed = 0;
+    uint64_t m_frames_passthrough = 0;
+    uint64_t m_frames_dropped_budget = 0;
 
-    AsyncTask m_worker;
+    std::vector<AsyncTask> m_workers;
     std::atomic<bool> m_stopping{false};
     
-    // Queue for the worker thread
-    Mutex m_queue_lock;
+    // Queue for the worker threads
+    mutable Mutex m_queue_lock;
     ConditionVariable m_cv;
     std::deque<std::shared_ptr<const VideoFrame>> m_pending_frames;
-
-    
-
-    
+    uint64_t m_next_dispatch_seqnum = 0;
+    uint64_t m_frames_dropped_backlog = 0;
 };
 
 
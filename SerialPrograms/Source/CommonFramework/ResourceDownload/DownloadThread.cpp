@@ -6,6 +6,7 @@
 
 #include "Common/Cpp/ScopeExit.h"
 #include "Common/Cpp/Filesystem/Filesystem.h"
+#include "Common/Cpp/Concurrency/AsyncTask.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "CommonFramework/Exceptions/OperationFailedException.h"
@@ -17,6 +18,7 @@
 #include "DownloadThread.h"
 
 
+#include <atomic>
 #include <iostream>
 using std::cout;
 using std::endl;
@@ -116,35 +118,55 @@ void DownloadThread::run_download(DownloadedResourceMetadata resource_metadata){
             }
         );
 
-        // hash
-        std::string hash = 
-            hash_file(
+        // Verify and unzip at the same time. Both only read the zip file so
+        // they can overlap. If the hash doesn't match, the catch blocks below
+        // delete everything that was extracted.
+        std::string hash;
+        std::atomic<bool> unzip_done(false);
+        AsyncTask hash_task = GlobalThreadPools::unlimited_normal().dispatch_now_blocking([&, this]{
+            hash = hash_file(
                 this,
                 zip_path,
+                [&, this](uint64_t bytes_done, uint64_t total_bytes){
+                    // Only show the verification progress once unzipping is done
+                    // so the two don't fight over the progress bar.
+                    if (unzip_done.load(std::memory_order_acquire)){
+                        m_hooks.report_hash_progress(bytes_done, total_bytes);
+                    }
+                }
+            );
+        });
+
+        // unzip
+        std::exception_ptr unzip_error;
+        try{
+            unzip_file(
+                *this,
+                zip_path.c_str(), 
+                resource_directory.c_str(),
                 [this](uint64_t bytes_done, uint64_t total_bytes){
-                    m_hooks.report_hash_progress(bytes_done, total_bytes);
+                    m_hooks.report_unzip_progress(bytes_done, total_bytes);
                 }
             );
+        }catch (...){
+            unzip_error = std::current_exception();
+        }
+        unzip_done.store(true, std::memory_order_release);
+
+        hash_task.wait_and_rethrow_exceptions();
         std::string expected_hash = resource_metadata.sha256;
         if (hash != expected_hash){
             std::cerr << "current hash: " << hash << endl;
             throw_and_log<OperationFailedException>(logger, ErrorReport::NO_ERROR_REPORT, 
                 "Downloaded file failed verification. SHA 256 hash did not match the expected value.");
         }
+        if (unzip_error){
+            std::rethrow_exception(unzip_error);
+        }
 
         // Filesystem::Path p{zip_path};
         // cout << "File size: " << std::filesystem::file_size(p) << endl;
 
-        // unzip
-        unzip_file(
-            *this,
-            zip_path.c_str(), 
-            resource_directory.c_str(),
-            [this](uint64_t bytes_done, uint64_t total_bytes){
-                m_hooks.report_unzip_progress(bytes_done, total_bytes);
-            }
-        );
-
         // delete old zip file
         Filesystem::remove(zip_path);
 
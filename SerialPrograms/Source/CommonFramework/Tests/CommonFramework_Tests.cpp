@@ -0,0 +1,30 @@
+/*  Common Framework Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "CommonFramework_Tests.h"
+#include "Json_Tests.h"
+#include "FileTools_Tests.h"
+#include "ProgramStats_Tests.h"
+#include "ImageEncoder_Tests.h"
+#include "ImageSignature_Tests.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+void add_tests(UnitTestDatabase& database){
+    add_tests_Json(database);
+    add_tests_FileTools(database);
+    add_tests_ProgramStats(database);
+    add_tests_ImageEncoder(database);
+    add_tests_ImageSignature(database);
+}
+
+
+
+}
+}
@@ -0,0 +1,23 @@
+/*  Common Framework Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_Tests_H
+#define PokemonAutomation_CommonFramework_Tests_H
+
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+void add_tests(UnitTestDatabase& database);
+
+
+
+}
+}
+#endif
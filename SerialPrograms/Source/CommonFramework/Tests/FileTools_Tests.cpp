@@ -0,0 +1,199 @@
+/*  File Tools Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <random>
+#include <filesystem>
+#include "miniz-3.1.1/miniz.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/Cryptography/SHA256.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "Common/Cpp/TestRunners/UnitTestTempFolder.h"
+#include "CommonFramework/Tools/FileHash.h"
+#include "CommonFramework/Tools/FileUnzip.h"
+#include "FileTools_Tests.h"
+
+namespace PokemonAutomation{
+
+void sha256_compress_Default(uint32_t state[8], const void* data, size_t blocks);
+
+namespace CommonFramework{
+
+
+
+static std::string sha256_hex(const std::string& data){
+    SHA256 hash;
+    hash.push(data.data(), data.size());
+    hash.finish();
+    return hash.get_hash_hex();
+}
+
+
+
+//  Known answers and consistency between the portable and the hardware paths.
+class Test_SHA256 : public UnitTest{
+public:
+    Test_SHA256()
+        : UnitTest("CommonFramework::FileTools - SHA256")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        if (sha256_hex("") != "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"){
+            return "Empty string.";
+        }
+        if (sha256_hex("abc") != "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"){
+            return "abc";
+        }
+        if (sha256_hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") != "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"){
+            return "Two block message.";
+        }
+        if (sha256_hex(std::string(1000000, 'a')) != "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"){
+            return "One million a's.";
+        }
+
+        std::mt19937_64 rng(0);
+        std::string data(64 * 1024, '\0');
+        for (char& ch : data){
+            ch = (char)rng();
+        }
+
+        //  Whatever compress function is selected must match the portable one.
+        for (size_t iteration = 0; iteration < 100; iteration++){
+            uint32_t expected[8];
+            uint32_t actual[8];
+            for (size_t c = 0; c < 8; c++){
+                expected[c] = actual[c] = (uint32_t)rng();
+            }
+            size_t blocks = rng() % (data.size() / 64);
+            sha256_compress_Default(expected, data.data(), blocks);
+            sha256_compress(actual, data.data(), blocks);
+            if (memcmp(expected, actual, sizeof(expected)) != 0){
+                return "Compress mismatch on " + std::to_string(blocks) + " blocks.";
+            }
+        }
+
+        //  The result must not depend on how the input is split.
+        const std::string expected = sha256_hex(data);
+        for (size_t iteration = 0; iteration < 100; iteration++){
+            SHA256 hash;
+            size_t pos = 0;
+            while (pos < data.size()){
+                size_t bytes = std::min<size_t>(rng() % 300, data.size() - pos);
+                hash.push(data.data() + pos, bytes);
+                pos += bytes;
+            }
+            hash.finish();
+            if (hash.get_hash_hex() != expected){
+                return "Chunked push mismatch.";
+            }
+        }
+
+        return true;
+    }
+};
+
+
+
+//  Build an archive, then verify and extract it the same way a downloaded
+//  resource pack is.
+class Test_HashAndUnzip : public UnitTest{
+public:
+    Test_HashAndUnzip()
+        : UnitTest("CommonFramework::FileTools - Hash and Unzip")
+    {
+        m_memory = 256 * 1024 * 1024;
+    }
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        namespace fs = std::filesystem;
+
+        UnitTestTempFolder folder("FileToolsTest");
+        if (folder.empty()){
+            return UnitTestTempFolder::skipped();
+        }
+        const Filesystem::Path& base = folder.path();
+        const std::string zip_path = (base / "fixture.zip").string();
+        const fs::path target_dir = base / "out";
+
+        //  Mix of a few large entries (model files) and many small ones
+        //  (Tesseract data, images) in nested folders.
+        std::mt19937_64 rng(1);
+        std::vector<std::pair<std::string, std::string>> files;
+        for (size_t c = 0; c < 64; c++){
+            size_t bytes = c < 4 ? 16 * 1024 * 1024 : rng() % (256 * 1024);
+            std::string data(bytes, '\0');
+            for (size_t i = 0; i < bytes; i++){
+                //  Partially compressible.
+                data[i] = (char)(i % 7 == 0 ? rng() : i / 64);
+            }
+            files.emplace_back(
+                "Folder" + std::to_string(c % 3) + "/Sub" + std::to_string(c % 5) + "/File" + std::to_string(c) + ".bin",
+                std::move(data)
+            );
+        }
+        files.emplace_back("Empty.txt", "");
+
+        {
+            mz_zip_archive zip;
+            memset(&zip, 0, sizeof(zip));
+            if (!mz_zip_writer_init_file(&zip, zip_path.c_str(), 0)){
+                return "Unable to create fixture archive.";
+            }
+            for (const auto& file : files){
+                if (!mz_zip_writer_add_mem(&zip, file.first.c_str(), file.second.data(), file.second.size(), MZ_DEFAULT_LEVEL)){
+                    mz_zip_writer_end(&zip);
+                    return "Unable to add " + file.first + " to fixture archive.";
+                }
+            }
+            bool ok = mz_zip_writer_finalize_archive(&zip);
+            mz_zip_writer_end(&zip);
+            if (!ok){
+                return "Unable to finalize fixture archive.";
+            }
+        }
+
+        WallClock time0 = current_time();
+        std::string hash = hash_file(&scope, zip_path);
+        WallClock time1 = current_time();
+        unzip_file(scope, zip_path.c_str(), target_dir.string().c_str(), nullptr);
+        WallClock time2 = current_time();
+
+        if (hash != sha256_hex(file_to_string(zip_path))){
+            return "hash_file() does not match SHA256 of the archive.";
+        }
+
+        for (const auto& file : files){
+            std::string actual;
+            if (!file_to_string((target_dir / file.first).string(), actual)){
+                return "Missing extracted file: " + file.first;
+            }
+            if (actual != file.second){
+                return "Extracted file does not match: " + file.first;
+            }
+        }
+
+        logger.log(
+            "Archive: " + std::to_string(fs::file_size(zip_path) / 1024) + " KB, hash = " +
+            std::to_string(std::chrono::duration_cast<Milliseconds>(time1 - time0).count()) + " ms, unzip = " +
+            std::to_string(std::chrono::duration_cast<Milliseconds>(time2 - time1).count()) + " ms"
+        );
+        return true;
+    }
+};
+
+
+
+void add_tests_FileTools(UnitTestDatabase& database){
+    database.add<Test_SHA256>();
+    database.add<Test_HashAndUnzip>();
+}
+
+
+
+}
+}
@@ -0,0 +1,164 @@
+/*  Image Encoder Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <random>
+#include <filesystem>
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "Common/Cpp/TestRunners/UnitTestTempFolder.h"
+#include "CommonFramework/ImageTools/ImageDiff.h"
+#include "CommonFramework/Tools/ImageEncoder.h"
+#include "ImageEncoder_Tests.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+//  Smooth gradients. If "noise", every pixel also gets random low bits.
+static ImageRGB32 make_test_image(size_t width, size_t height, bool noise){
+    ImageRGB32 image(width, height);
+    std::mt19937 rng(0);
+    for (size_t r = 0; r < height; r++){
+        for (size_t c = 0; c < width; c++){
+            uint32_t red = (uint32_t)(c * 255 / width);
+            uint32_t green = (uint32_t)(r * 255 / height);
+            uint32_t blue = (uint32_t)((c + r) * 127 / (width + height));
+            uint32_t pixel = 0xff000000 | (red << 16) | (green << 8) | blue;
+            if (noise){
+                pixel ^= rng() & 0x1f1f1f;
+            }
+            image.pixel(c, r) = pixel;
+        }
+    }
+    return image;
+}
+
+static bool identical(const ImageViewRGB32& x, const ImageViewRGB32& y){
+    if (x.width() != y.width() || x.height() != y.height()){
+        return false;
+    }
+    for (size_t r = 0; r < x.height(); r++){
+        for (size_t c = 0; c < x.width(); c++){
+            if (x.pixel(c, r) != y.pixel(c, r)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+
+//  Files written in the background read back as the image that was
+//  submitted.
+class Test_ImageEncoderRoundTrip : public UnitTest{
+public:
+    Test_ImageEncoderRoundTrip()
+        : UnitTest("CommonFramework::ImageEncoder - Round Trip")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        namespace fs = std::filesystem;
+
+        UnitTestTempFolder folder("ImageEncoderTest");
+        if (folder.empty()){
+            return UnitTestTempFolder::skipped();
+        }
+        const Filesystem::Path& base = folder.path();
+
+        ImageEncoder& encoder = ImageEncoder::instance();
+        const ImageRGB32 reference = make_test_image(321, 187, true);
+
+        //  PNG is lossless at every compression level. The caller is free to
+        //  change its image as soon as save() returns.
+        for (int quality : {-1, 0, 50, 100}){
+            ImageRGB32 image = reference.copy();
+            std::string path = (base / ("Lossless" + std::to_string(quality) + ".png")).string();
+            std::shared_ptr<PendingImageFile> file = encoder.save(image, path, quality);
+            image.fill(0);
+            if (!file->wait()){
+                return "Unable to write: " + path;
+            }
+            if (!identical(reference, ImageRGB32(path))){
+                return "PNG at quality " + std::to_string(quality) + " doesn't match the original.";
+            }
+        }
+        {
+            std::string fast = (base / "Lossless100.png").string();
+            std::string small = (base / "Lossless0.png").string();
+            if (fs::file_size(fast) <= fs::file_size(small)){
+                return "PNG compression level had no effect.";
+            }
+        }
+
+        //  A frame we just encoded is reused byte for byte.
+        ImageEncoder::Stats before = encoder.stats();
+        const std::string again = (base / "Again.png").string();
+        if (!encoder.save(reference, again, 100)->wait()){
+            return "Unable to write: " + again;
+        }
+        ImageEncoder::Stats after = encoder.stats();
+        if (after.reused != before.reused + 1 || after.encoded != before.encoded){
+            return "Identical frame was encoded again.";
+        }
+        if (file_to_string(again) != file_to_string((base / "Lossless100.png").string())){
+            return "Reused frame doesn't match.";
+        }
+        scope.throw_if_cancelled();
+
+        //  JPG is close, and smaller with lower quality.
+        const ImageRGB32 smooth = make_test_image(321, 187, false);
+        const std::string high = (base / "High.jpg").string();
+        const std::string low = (base / "Low.jpg").string();
+        std::shared_ptr<PendingImageFile> high_file = encoder.save(smooth, high, 95);
+        std::shared_ptr<PendingImageFile> low_file = encoder.save(smooth, low, 20);
+        if (!high_file->wait() || !low_file->wait()){
+            return "Unable to write JPG.";
+        }
+        double rmsd = ImageMatch::pixel_RMSD(smooth, ImageRGB32(high));
+        if (!(rmsd < 4)){
+            return "JPG at quality 95 is too far off. RMSD = " + std::to_string(rmsd);
+        }
+        if (fs::file_size(low) >= fs::file_size(high)){
+            return "JPG quality had no effect.";
+        }
+
+        //  Nothing to write.
+        if (encoder.save(ImageViewRGB32(), (base / "Null.png").string())->wait()){
+            return "Null image reported success.";
+        }
+
+        //  A file dropped before it's written is removed once it is. The
+        //  encoder is FIFO so it's done with the first file before the second.
+        const std::string dropped = (base / "Dropped.png").string();
+        const std::string kept = (base / "Kept.png").string();
+        std::shared_ptr<PendingImageFile> dropped_file = encoder.save(make_test_image(640, 360, true), dropped);
+        std::shared_ptr<PendingImageFile> kept_file = encoder.save(smooth, kept);
+        dropped_file->remove_when_finished();
+        if (!kept_file->wait()){
+            return "Unable to write: " + kept;
+        }
+        if (fs::exists(dropped) || !fs::exists(kept)){
+            return "Dropped file was not removed.";
+        }
+
+        logger.log("PNG: " + std::to_string(fs::file_size((base / "Lossless-1.png").string())) + " bytes, JPG RMSD = " + std::to_string(rmsd));
+        return true;
+    }
+};
+
+
+
+void add_tests_ImageEncoder(UnitTestDatabase& database){
+    database.add<Test_ImageEncoderRoundTrip>();
+}
+
+
+
+}
+}
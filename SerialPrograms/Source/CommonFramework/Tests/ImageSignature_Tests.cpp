@@ -0,0 +1,310 @@
+/*  Image Signature Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <random>
+#include <filesystem>
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/GlobalAutoPaths.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "CommonFramework/ImageTools/ImageDiff.h"
+#include "CommonFramework/ImageTools/ImageSignature.h"
+#include "CommonTools/VisualDetectors/FrozenImageDetector.h"
+#include "CommonTools/VisualDetectors/ImageMatchDetector.h"
+#include "ImageSignature_Tests.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+using namespace ImageMatch;
+
+
+
+//  Game screenshots that are already used by other tests.
+static std::vector<ImageRGB32> load_screenshots(){
+    const char* FILES[] = {
+        "PokemonLA/BlackOutDetector/macOS_bright/BlackOut1_True.png",
+        "PokemonLA/BlackOutDetector/macOS_bright/BlackOut2_True.png",
+        "PokemonLA/BlackOutDetector/macOS_bright/Coastlands_False.png",
+        "PokemonLA/BlackOutDetector/macOS_bright/Fieldlands_False.jpg",
+        "PokemonLA/BlackOutDetector/macOS_bright/Mirelands_False.png",
+        "PokemonLA/BlackOutDetector/macOS_bright/Village_False.png",
+        "PokemonLA/BlackOutDetector/WinPowcxy/BlackOut_True.png",
+    };
+    std::vector<ImageRGB32> ret;
+    for (const char* file : FILES){
+        std::string path = UNIT_TEST_RESOURCE_PATH() + file;
+        if (std::filesystem::exists(path)){
+            ret.emplace_back(path);
+        }
+    }
+    return ret;
+}
+
+static uint32_t clamp_channel(int value){
+    return (uint32_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+//  Capture noise. Every channel moves by up to "amplitude".
+static ImageRGB32 add_noise(const ImageViewRGB32& image, int amplitude, uint32_t seed){
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> noise(-amplitude, amplitude);
+    ImageRGB32 ret = image.copy();
+    for (size_t r = 0; r < ret.height(); r++){
+        for (size_t c = 0; c < ret.width(); c++){
+            uint32_t pixel = ret.pixel(c, r);
+            uint32_t red = clamp_channel((int)((pixel >> 16) & 0xff) + noise(rng));
+            uint32_t green = clamp_channel((int)((pixel >> 8) & 0xff) + noise(rng));
+            uint32_t blue = clamp_channel((int)(pixel & 0xff) + noise(rng));
+            ret.pixel(c, r) = (pixel & 0xff000000) | (red << 16) | (green << 8) | blue;
+        }
+    }
+    return ret;
+}
+
+//  Scrolling.
+static ImageRGB32 shift_left(const ImageViewRGB32& image, size_t pixels){
+    ImageRGB32 ret = image.copy();
+    for (size_t r = 0; r < ret.height(); r++){
+        for (size_t c = 0; c < ret.width(); c++){
+            ret.pixel(c, r) = image.pixel(std::min(c + pixels, image.width() - 1), r);
+        }
+    }
+    return ret;
+}
+
+//  A fade.
+static ImageRGB32 brighten(const ImageViewRGB32& image, int amount){
+    ImageRGB32 ret = image.copy();
+    for (size_t r = 0; r < ret.height(); r++){
+        for (size_t c = 0; c < ret.width(); c++){
+            uint32_t pixel = ret.pixel(c, r);
+            uint32_t red = clamp_channel((int)((pixel >> 16) & 0xff) + amount);
+            uint32_t green = clamp_channel((int)((pixel >> 8) & 0xff) + amount);
+            uint32_t blue = clamp_channel((int)(pixel & 0xff) + amount);
+            ret.pixel(c, r) = (pixel & 0xff000000) | (red << 16) | (green << 8) | blue;
+        }
+    }
+    return ret;
+}
+
+//  A reference with a transparent hole in it. pixel_RMSD() skips those pixels.
+static ImageRGB32 punch_hole(const ImageViewRGB32& image){
+    ImageRGB32 ret = image.copy();
+    for (size_t r = ret.height() / 3; r < ret.height() / 2; r++){
+        for (size_t c = ret.width() / 4; c < ret.width() / 2; c++){
+            ret.pixel(c, r) &= 0x00ffffff;
+        }
+    }
+    return ret;
+}
+
+//  Each screenshot with frozen and moving versions of itself.
+static std::vector<ImageRGB32> make_frames(const std::vector<ImageRGB32>& screenshots){
+    std::vector<ImageRGB32> frames;
+    uint32_t seed = 0;
+    for (const ImageRGB32& image : screenshots){
+        frames.emplace_back(image.copy());
+        frames.emplace_back(add_noise(image, 2, seed++));
+        frames.emplace_back(add_noise(image, 12, seed++));
+        frames.emplace_back(shift_left(image, 4));
+        frames.emplace_back(brighten(image, 24));
+    }
+    return frames;
+}
+
+const ImageFloatBox BOXES[] = {
+    {0.0, 0.0, 1.0, 1.0},
+    {0.1, 0.1, 0.3, 0.2},
+    {0.5, 0.6, 0.45, 0.35},
+    {0.49, 0.49, 0.02, 0.02},
+};
+const double THRESHOLDS[] = {0, 1, 2, 5, 10, 20, 30, 50, 80, 120, 200};
+
+
+
+//  The signature bound must never be above the real RMSD.
+class Test_ImageSignatureBound : public UnitTest{
+public:
+    Test_ImageSignatureBound()
+        : UnitTest("CommonFramework::ImageSignature - Bound")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        std::vector<ImageRGB32> screenshots = load_screenshots();
+        if (screenshots.empty()){
+            return UnitTestResult(UnitTestResult::SKIPPED, "No screenshots found.");
+        }
+        std::vector<ImageRGB32> frames = make_frames(screenshots);
+        std::vector<ImageRGB32> references;
+        for (const ImageRGB32& frame : frames){
+            references.emplace_back(frame.copy());
+        }
+        for (const ImageRGB32& image : screenshots){
+            references.emplace_back(punch_hole(image));
+        }
+
+        size_t decisions = 0;
+        size_t skipped = 0;
+        for (const ImageRGB32& reference : references){
+            scope.throw_if_cancelled();
+            for (const ImageRGB32& frame : frames){
+                if (reference.width() != frame.width() || reference.height() != frame.height()){
+                    continue;
+                }
+                for (const ImageFloatBox& box : BOXES){
+                    ImageViewRGB32 ref_box = extract_box_reference(reference, box);
+                    ImageViewRGB32 img_box = extract_box_reference(frame, box);
+                    ImageSignature ref_signature(ref_box);
+                    ImageSignature img_signature(img_box);
+
+                    double rmsd = pixel_RMSD(ref_box, img_box);
+                    double bound = ref_signature.min_RMSD(img_signature);
+                    if (bound > rmsd){
+                        return "Bound " + std::to_string(bound) + " is above the RMSD " + std::to_string(rmsd) + ".";
+                    }
+                    for (double threshold : THRESHOLDS){
+                        decisions++;
+                        if (!ref_signature.exceeds(img_signature, threshold)){
+                            continue;
+                        }
+                        skipped++;
+                        if (!(rmsd > threshold)){
+                            return "Signature decided differently at threshold " + std::to_string(threshold) + ".";
+                        }
+                    }
+                }
+            }
+        }
+
+        logger.log(
+            "Signatures decided " + std::to_string(skipped) + " / " + std::to_string(decisions) +
+            " comparisons without the full RMSD."
+        );
+        return true;
+    }
+};
+
+
+
+//  The old FrozenImageDetector: full RMSD against a copy of the last frame
+//  that was different.
+class ReferenceFrozenImageDetector{
+public:
+    ReferenceFrozenImageDetector(const ImageFloatBox& box, std::chrono::milliseconds timeout, double threshold)
+        : m_box(box)
+        , m_timeout(timeout)
+        , m_threshold(threshold)
+        , m_timestamp(WallClock::min())
+    {}
+    bool process_frame(const ImageViewRGB32& frame, WallClock timestamp){
+        if (m_previous.width() != frame.width() || m_previous.height() != frame.height()){
+            m_previous = frame.copy();
+            m_timestamp = timestamp;
+            return false;
+        }
+        double rmsd = pixel_RMSD(
+            extract_box_reference(m_previous, m_box),
+            extract_box_reference(frame, m_box)
+        );
+        if (rmsd > m_threshold){
+            m_previous = frame.copy();
+            m_timestamp = timestamp;
+            return false;
+        }
+        return timestamp - m_timestamp > m_timeout;
+    }
+
+private:
+    ImageFloatBox m_box;
+    std::chrono::milliseconds m_timeout;
+    double m_threshold;
+    ImageRGB32 m_previous;
+    WallClock m_timestamp;
+};
+
+
+//  Play the frames like a video where the screen alternates between moving
+//  and frozen. The detectors must agree with the full RMSD on every frame.
+class Test_ImageSignatureDetectors : public UnitTest{
+public:
+    Test_ImageSignatureDetectors()
+        : UnitTest("CommonFramework::ImageSignature - Detector Decisions")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        std::vector<ImageRGB32> screenshots = load_screenshots();
+        if (screenshots.empty()){
+            return UnitTestResult(UnitTestResult::SKIPPED, "No screenshots found.");
+        }
+        std::vector<ImageRGB32> frames = make_frames(screenshots);
+
+        //  Each frame shows for a few ticks. The noisy ones are frozen for
+        //  most thresholds.
+        std::vector<size_t> sequence;
+        for (size_t c = 0; c < frames.size(); c++){
+            for (size_t repeat = 0; repeat < 1 + c % 4; repeat++){
+                sequence.emplace_back(c);
+            }
+        }
+
+        size_t frozen = 0;
+        for (const ImageFloatBox& box : BOXES){
+            for (double threshold : {2., 10., 30.}){
+                scope.throw_if_cancelled();
+                const std::chrono::milliseconds TIMEOUT(250);
+                ReferenceFrozenImageDetector reference(box, TIMEOUT, threshold);
+                FrozenImageDetector snapshot_detector(COLOR_CYAN, box, TIMEOUT, threshold);
+                FrozenImageDetector view_detector(COLOR_CYAN, box, TIMEOUT, threshold);
+
+                WallClock timestamp = WallClock::min() + std::chrono::hours(1);
+                for (size_t index : sequence){
+                    timestamp += std::chrono::milliseconds(100);
+                    bool expected = reference.process_frame(frames[index], timestamp);
+                    frozen += expected;
+                    if (snapshot_detector.process_frame(VideoSnapshot(frames[index].copy(), timestamp)) != expected){
+                        return "FrozenImageDetector (snapshot) disagrees at threshold " + std::to_string(threshold) + ".";
+                    }
+                    if (view_detector.process_frame(frames[index], timestamp) != expected){
+                        return "FrozenImageDetector (view) disagrees at threshold " + std::to_string(threshold) + ".";
+                    }
+                }
+            }
+        }
+
+        for (const ImageRGB32& screenshot : screenshots){
+            std::shared_ptr<const ImageRGB32> reference = std::make_shared<const ImageRGB32>(punch_hole(screenshot));
+            for (const ImageFloatBox& box : BOXES){
+                for (bool scale_brightness : {false, true}){
+                    for (double threshold : THRESHOLDS){
+                        scope.throw_if_cancelled();
+                        ImageMatchDetector detector(reference, box, threshold, scale_brightness);
+                        for (const ImageRGB32& frame : frames){
+                            if (detector.detect(frame) != (detector.rmsd(frame) <= threshold)){
+                                return "ImageMatchDetector disagrees at threshold " + std::to_string(threshold) + ".";
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        logger.log("Frozen decisions: " + std::to_string(frozen));
+        return true;
+    }
+};
+
+
+
+void add_tests_ImageSignature(UnitTestDatabase& database){
+    database.add<Test_ImageSignatureBound>();
+    database.add<Test_ImageSignatureDetectors>();
+}
+
+
+
+}
+}
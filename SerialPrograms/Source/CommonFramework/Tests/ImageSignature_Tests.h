@@ -0,0 +1,23 @@
+/*  Image Signature Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ImageSignature_Tests_H
+#define PokemonAutomation_CommonFramework_ImageSignature_Tests_H
+
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+void add_tests_ImageSignature(UnitTestDatabase& database);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,288 @@
+/*  JSON Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <random>
+#include "3rdParty/nlohmann/json.hpp"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonTools.h"
+#include "Common/Cpp/Json/JsonParser.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/Language.h"
+#include "CommonFramework/GlobalAutoPaths.h"
+#include "Json_Tests.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+//  Generate random JSON text that exercises escapes, unicode, integer
+//  boundaries and floats.
+class RandomJsonGenerator{
+public:
+    RandomJsonGenerator(uint64_t seed)
+        : m_rng(seed)
+    {}
+
+    std::string value(size_t depth = 0){
+        switch (m_rng() % (depth > 4 ? 6 : 8)){
+        case 0:
+            return "null";
+        case 1:
+            return m_rng() % 2 ? "true" : "false";
+        case 2:{
+            static const char* NUMBERS[] = {
+                "0", "-0", "123", "-0.0", "0.1", "1e5", "1.5", "1E+300", "3.14159e-10",
+                "9223372036854775807", "-9223372036854775808",
+                "18446744073709551616", "-9223372036854775809",
+                "1e400", "-1e400", "1e-400",
+            };
+            return NUMBERS[m_rng() % (sizeof(NUMBERS) / sizeof(NUMBERS[0]))];
+        }
+        case 3:{
+            double x = std::ldexp((double)(m_rng() % 1000000), (int)(m_rng() % 80) - 40);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "%.17g", m_rng() % 2 ? x : -x);
+            return buffer;
+        }
+        case 4:
+        case 5:
+            return string();
+        case 6:{
+            std::string ret = "[ ";
+            size_t items = m_rng() % 5;
+            for (size_t c = 0; c < items; c++){
+                if (c != 0){
+                    ret += " ,\n";
+                }
+                ret += value(depth + 1);
+            }
+            return ret + "]";
+        }
+        default:{
+            std::string ret = "{";
+            size_t items = m_rng() % 5;
+            for (size_t c = 0; c < items; c++){
+                if (c != 0){
+                    ret += ",";
+                }
+                ret += string() + "\t:" + value(depth + 1);
+            }
+            return ret + "}";
+        }
+        }
+    }
+
+    void corrupt(std::string& str){
+        static const char CHARS[] = {'x', ',', ']', '}', '"', '\\', ' ', '\x01', '\xff'};
+        size_t pos = m_rng() % (str.size() + 1);
+        str.insert(pos, 1, CHARS[m_rng() % sizeof(CHARS)]);
+    }
+
+    bool coin(size_t one_in){
+        return m_rng() % one_in == 0;
+    }
+
+private:
+    std::string string(){
+        static const char* PIECES[] = {
+            "a", "z", "\\n", "\\u00e9", "\\ud83d\\ude00", "\xc3\xa9", "\\\"", "\\/", "\\t",
+        };
+        std::string ret = "\"";
+        size_t pieces = m_rng() % 8;
+        for (size_t c = 0; c < pieces; c++){
+            ret += PIECES[m_rng() % (sizeof(PIECES) / sizeof(PIECES[0]))];
+        }
+        return ret + "\"";
+    }
+
+private:
+    std::mt19937_64 m_rng;
+};
+
+
+
+//  Files to exercise the parser on: the settings file and the Pokemon name
+//  OCR dictionaries. Only the ones that exist are returned.
+static std::vector<std::pair<std::string, std::string>> load_real_json_files(){
+    std::vector<std::string> paths;
+    paths.emplace_back(PROGRAM_SETTING_JSON_PATH());
+    for (size_t c = 1; c < (size_t)Language::EndOfList; c++){
+        paths.emplace_back(
+            RESOURCE_PATH() + "Pokemon/PokemonNameOCR/PokemonOCR-" +
+            language_data((Language)c).code + ".json"
+        );
+    }
+
+    std::vector<std::pair<std::string, std::string>> ret;
+    for (std::string& path : paths){
+        std::string text;
+        if (file_to_string(path, text)){
+            ret.emplace_back(std::move(path), std::move(text));
+        }
+    }
+    return ret;
+}
+
+//  What the old nlohmann-based path writes for this text.
+static std::string dump_json_nlohmann(const nlohmann::json& json, int indent){
+    return to_nlohmann(from_nlohmann(json)).dump(indent);
+}
+
+
+
+//  The native parser/writer must accept exactly what nlohmann accepts and
+//  produce byte-identical output to the old nlohmann-based path.
+class Test_JsonNativeMatchesNlohmann : public UnitTest{
+public:
+    Test_JsonNativeMatchesNlohmann()
+        : UnitTest("CommonFramework::Json - Native Parser Matches nlohmann")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        RandomJsonGenerator generator(0);
+        for (size_t iteration = 0; iteration < 20000; iteration++){
+            std::string text = generator.value();
+            if (generator.coin(20)){
+                generator.corrupt(text);
+            }
+
+            nlohmann::json expected = nlohmann::json::parse(text, nullptr, false);
+
+            JsonValue actual;
+            bool ok = parse_json_native(actual, text.data(), text.size());
+            if (ok == expected.is_discarded()){
+                return "Parse success mismatch: " + text;
+            }
+            if (!ok){
+                continue;
+            }
+
+            for (int indent : {-1, 0, 4}){
+                if (actual.dump(indent) != dump_json_nlohmann(expected, indent)){
+                    return "Output mismatch: " + text;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+
+
+//  Whatever we write must read back as the same value.
+class Test_JsonRoundTrip : public UnitTest{
+public:
+    Test_JsonRoundTrip()
+        : UnitTest("CommonFramework::Json - Round Trip")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        RandomJsonGenerator generator(1);
+        for (size_t iteration = 0; iteration < 5000; iteration++){
+            std::string text = generator.value();
+            JsonValue value;
+            if (!parse_json_native(value, text.data(), text.size())){
+                //  Out of range numbers are rejected. Whether that matches
+                //  nlohmann is checked by the test above.
+                continue;
+            }
+            for (int indent : {-1, 4}){
+                std::string dump = value.dump(indent);
+                JsonValue reloaded;
+                if (!parse_json_native(reloaded, dump.data(), dump.size())){
+                    return "Failed to reload: " + dump;
+                }
+                if (reloaded.dump(indent) != dump){
+                    return "Round trip mismatch: " + text;
+                }
+            }
+        }
+
+        //  Invalid UTF-8 can't be written. nlohmann threw, so must we.
+        try{
+            JsonValue("a\xff").dump();
+            return "Wrote invalid UTF-8.";
+        }catch (const nlohmann::json::type_error&){}
+
+        //  Real files must also be written exactly as before.
+        for (const auto& file : load_real_json_files()){
+            const std::string& text = file.second;
+            JsonValue value;
+            if (!parse_json_native(value, text.data(), text.size())){
+                return "Failed to parse: " + file.first;
+            }
+            std::string dump = value.dump(4);
+            if (dump != dump_json_nlohmann(nlohmann::json::parse(text, nullptr, false), 4)){
+                return "Output mismatch: " + file.first;
+            }
+            JsonValue reloaded;
+            if (!parse_json_native(reloaded, dump.data(), dump.size()) || reloaded.dump(4) != dump){
+                return "Round trip mismatch: " + file.first;
+            }
+        }
+        return true;
+    }
+};
+
+
+
+void benchmark_JsonLoad(Logger& logger, size_t iterations){
+    WallDuration total_old = WallDuration::zero();
+    WallDuration total_new = WallDuration::zero();
+
+    std::vector<std::pair<std::string, std::string>> files = load_real_json_files();
+    if (files.empty()){
+        logger.log("No JSON files found.");
+        return;
+    }
+
+    for (const auto& file : files){
+        const std::string& text = file.second;
+
+        WallClock time0 = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            JsonValue value = from_nlohmann(nlohmann::json::parse(text, nullptr, false));
+            to_nlohmann(value).dump(4);
+        }
+        WallClock time1 = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            JsonValue value;
+            parse_json_native(value, text.data(), text.size());
+            value.dump(4);
+        }
+        WallClock time2 = current_time();
+
+        total_old += time1 - time0;
+        total_new += time2 - time1;
+        logger.log(
+            file.first + " (" + std::to_string(text.size()) + " bytes): nlohmann = " +
+            std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / iterations) +
+            " us, native = " +
+            std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() / iterations) +
+            " us"
+        );
+    }
+
+    logger.log(
+        "Total: nlohmann = " + std::to_string(std::chrono::duration_cast<Milliseconds>(total_old).count()) +
+        " ms, native = " + std::to_string(std::chrono::duration_cast<Milliseconds>(total_new).count()) + " ms"
+    );
+}
+
+
+
+void add_tests_Json(UnitTestDatabase& database){
+    database.add<Test_JsonNativeMatchesNlohmann>();
+    database.add<Test_JsonRoundTrip>();
+}
+
+
+
+}
+}
@@ -0,0 +1,28 @@
+/*  JSON Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_Json_Tests_H
+#define PokemonAutomation_CommonFramework_Json_Tests_H
+
+#include <stddef.h>
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+void add_tests_Json(UnitTestDatabase& database);
+
+//  Time the old nlohmann round trip against the native parser/writer on the
+//  settings file and the Pokemon name OCR dictionaries.
+void benchmark_JsonLoad(Logger& logger, size_t iterations);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,248 @@
+/*  Program Stats Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <filesystem>
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "Common/Cpp/TestRunners/UnitTestTempFolder.h"
+#include "CommonFramework/ProgramStats/StatsDatabase.h"
+#include "ProgramStats_Tests.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+class TestStatsTracker : public StatsTracker{
+public:
+    TestStatsTracker(uint64_t resets = 0){
+        m_display_order.emplace_back("Resets");
+        m_stats["Resets"] = resets;
+    }
+    uint64_t resets() const{
+        return m_stats.find("Resets")->second.load(std::memory_order_relaxed);
+    }
+};
+
+static uint64_t total_resets(StatSet& set, const std::string& identifier){
+    TestStatsTracker tracker;
+    set[identifier].aggregate(tracker);
+    return tracker.resets();
+}
+
+
+
+//  Updates, replay and compaction, starting from a stats file written by an
+//  older version.
+class Test_StatsJournal : public UnitTest{
+public:
+    Test_StatsJournal()
+        : UnitTest("CommonFramework::ProgramStats - Journal")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        namespace fs = std::filesystem;
+
+        UnitTestTempFolder folder("StatsJournalTest");
+        if (folder.empty()){
+            return UnitTestTempFolder::skipped();
+        }
+        const Filesystem::Path& base = folder.path();
+        const std::string path = (base / "PA-Stats.txt").string();
+
+        {
+            StatSet set;
+            TestStatsTracker tracker(5);
+            set["Program-A"] += tracker;
+            set["Program-A"] += tracker;
+            set.save_to_file(path);
+        }
+
+        //  "Dex Rec Finder" is an alias for "PokemonSwSh:DexRecFinder".
+        const std::string identifiers[] = {"Program-A", "Program-B", "Dex Rec Finder"};
+        uint64_t expected[] = {10, 0, 0};
+        size_t lines[] = {2, 0, 0};
+
+        //  Enough to compact automatically a few times.
+        for (size_t c = 0; c < 4000; c++){
+            if (c % 256 == 0){
+                scope.throw_if_cancelled();
+            }
+            if (c == 100 && !StatSet::compact_file(path)){
+                return "Unable to compact.";
+            }
+            TestStatsTracker tracker(c);
+            if (!StatSet::update_file(path, identifiers[c % 3], tracker)){
+                return "Unable to update stats file.";
+            }
+            expected[c % 3] += c;
+            lines[c % 3]++;
+        }
+
+        StatSet set;
+        set.open_from_file(path);
+        const std::string loaded[] = {"Program-A", "Program-B", "PokemonSwSh:DexRecFinder"};
+        for (size_t c = 0; c < 3; c++){
+            if (set[loaded[c]].size() != lines[c] || total_resets(set, loaded[c]) != expected[c]){
+                return loaded[c] + ": Expected " + std::to_string(expected[c]) + " in " +
+                    std::to_string(lines[c]) + " lines. Got " + std::to_string(total_resets(set, loaded[c])) +
+                    " in " + std::to_string(set[loaded[c]].size()) + " lines.";
+            }
+        }
+
+        std::string stats_file = file_to_string(path);
+        if (stats_file.rfind("Journal Epoch: ", 0) != 0){
+            return "Stats file was never compacted.";
+        }
+        if (stats_file.find("Program-B") == std::string::npos){
+            return "Compacted stats file is missing a program.";
+        }
+
+        logger.log(
+            "Stats file: " + std::to_string(fs::file_size(path)) + " bytes, journal: " +
+            std::to_string(fs::file_size(path + ".journal")) + " bytes"
+        );
+        return true;
+    }
+};
+
+
+
+//  Cut the journal off at every byte, as if we crashed mid-write.
+class Test_StatsJournalTruncation : public UnitTest{
+public:
+    Test_StatsJournalTruncation()
+        : UnitTest("CommonFramework::ProgramStats - Truncated Journal")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        namespace fs = std::filesystem;
+
+        UnitTestTempFolder folder("StatsJournalTruncationTest");
+        if (folder.empty()){
+            return UnitTestTempFolder::skipped();
+        }
+        const Filesystem::Path& base = folder.path();
+        const std::string path = (base / "PA-Stats.txt").string();
+        const std::string journal_path = path + ".journal";
+
+        const size_t RECORDS = 16;
+        for (size_t c = 0; c < RECORDS; c++){
+            TestStatsTracker tracker((uint64_t)1 << c);
+            if (!StatSet::update_file(path, "Program", tracker)){
+                return "Unable to update stats file.";
+            }
+        }
+        const std::string journal = file_to_string(journal_path);
+
+        //  Byte offsets just past the end of each line. The first is the
+        //  header. A record is complete once everything before its "\r\n" is
+        //  there.
+        std::vector<size_t> line_ends;
+        for (size_t c = 0; c < journal.size(); c++){
+            if (journal[c] == '\n'){
+                line_ends.emplace_back(c + 1);
+            }
+        }
+        if (line_ends.size() != RECORDS + 1){
+            return "Expected one line per record.";
+        }
+
+        for (size_t cut = 0; cut <= journal.size(); cut++){
+            scope.throw_if_cancelled();
+
+            size_t records = 0;
+            while (records < RECORDS && line_ends[records + 1] - 2 <= cut){
+                records++;
+            }
+            uint64_t expected = ((uint64_t)1 << records) - 1;
+
+            string_to_file(journal_path, journal.substr(0, cut));
+            {
+                StatSet set;
+                set.open_from_file(path);
+                if (set["Program"].size() != records || total_resets(set, "Program") != expected){
+                    return "Cut at " + std::to_string(cut) + ": Expected " + std::to_string(records) +
+                        " records. Got " + std::to_string(set["Program"].size()) + ".";
+                }
+            }
+
+            //  The next update must survive the torn record. If the header
+            //  itself was torn, the journal starts over.
+            TestStatsTracker tracker((uint64_t)1 << 40);
+            if (!StatSet::update_file(path, "Program", tracker)){
+                return "Unable to update stats file.";
+            }
+            {
+                StatSet set;
+                set.open_from_file(path);
+                if (set["Program"].size() != records + 1 ||
+                    total_resets(set, "Program") != expected + ((uint64_t)1 << 40)
+                ){
+                    return "Cut at " + std::to_string(cut) + ": Update after the cut was lost.";
+                }
+            }
+        }
+
+        //  A damaged record in the middle is skipped. The rest are kept.
+        {
+            std::string damaged = journal;
+            damaged[line_ends[5] + 12] ^= 1;
+            string_to_file(journal_path, damaged);
+
+            StatSet set;
+            set.open_from_file(path);
+            uint64_t expected = (((uint64_t)1 << RECORDS) - 1) & ~((uint64_t)1 << 5);
+            if (set["Program"].size() != RECORDS - 1 || total_resets(set, "Program") != expected){
+                return "Damaged record was not skipped.";
+            }
+        }
+
+        //  Crash after compaction wrote the stats file but before it cleared
+        //  the journal. The stale journal must not be applied again.
+        {
+            string_to_file(journal_path, journal);
+            if (!StatSet::compact_file(path)){
+                return "Unable to compact.";
+            }
+            string_to_file(journal_path, journal);
+
+            uint64_t expected = ((uint64_t)1 << RECORDS) - 1;
+            StatSet set;
+            set.open_from_file(path);
+            if (set["Program"].size() != RECORDS || total_resets(set, "Program") != expected){
+                return "Stale journal was applied twice.";
+            }
+
+            TestStatsTracker tracker((uint64_t)1 << 40);
+            if (!StatSet::update_file(path, "Program", tracker)){
+                return "Unable to update stats file.";
+            }
+            set.open_from_file(path);
+            if (set["Program"].size() != RECORDS + 1 ||
+                total_resets(set, "Program") != expected + ((uint64_t)1 << 40)
+            ){
+                return "Update after a stale journal was lost.";
+            }
+        }
+
+        logger.log("Checked " + std::to_string(journal.size() + 1) + " cut points.");
+        return true;
+    }
+};
+
+
+
+void add_tests_ProgramStats(UnitTestDatabase& database){
+    database.add<Test_StatsJournal>();
+    database.add<Test_StatsJournalTruncation>();
+}
+
+
+
+}
+}
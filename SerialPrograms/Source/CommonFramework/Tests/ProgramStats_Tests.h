@@ -0,0 +1,23 @@
+/*  Program Stats Tests
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ProgramStats_Tests_H
+#define PokemonAutomation_CommonFramework_ProgramStats_Tests_H
+
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace PokemonAutomation{
+namespace CommonFramework{
+
+
+
+void add_tests_ProgramStats(UnitTestDatabase& database);
+
+
+
+}
+}
+#endif
@@ -7,9 +7,11 @@
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/ScopeExit.h"
 #include "Common/Cpp/Containers/AlignedMalloc.h"
+#include "Common/Cpp/Concurrency/AsyncTask.h"
 #include "Common/Cpp/Filesystem/FileIO.h"
 #include "Common/Cpp/Filesystem/Filesystem.h"
 #include "Common/Cpp/Cryptography/SHA256.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "FileHash.h"
 
 //#include <iostream>
@@ -39,24 +41,41 @@ std::string hash_file(
     uint64_t file_size = Filesystem::file_size(path);
     uint64_t total_bytes_read = 0;
 
+    //  Double buffer so the next read overlaps with hashing the current one.
     constexpr size_t BUFFER_SIZE = 1024 * 1024;
-    void* buffer = aligned_malloc(BUFFER_SIZE, 4096);   // Pre-allocate 1MB once
+    char* buffer = (char*)aligned_malloc(2 * BUFFER_SIZE, 4096);   // Pre-allocate 2 x 1MB once
     ScopeExit sg([&]{ aligned_free(buffer); });
 
-    size_t bytes_read;
-    do{
+    char* current = buffer;
+    char* next = buffer + BUFFER_SIZE;
+    size_t bytes_read = file.read(current, BUFFER_SIZE);
+    while (true){
         if (scope != nullptr){
             scope->throw_if_cancelled();
         }
 
-        bytes_read = file.read(buffer, BUFFER_SIZE);
-        hash.push(buffer, bytes_read);
+        size_t next_bytes_read = 0;
+        AsyncTask reader;
+        if (bytes_read == BUFFER_SIZE){
+            reader = GlobalThreadPools::unlimited_normal().dispatch_now_blocking([&]{
+                next_bytes_read = file.read(next, BUFFER_SIZE);
+            });
+        }
+
+        hash.push(current, bytes_read);
         total_bytes_read += bytes_read;
 
         if (hash_progress != nullptr){
             hash_progress(total_bytes_read, file_size);
         }
-    }while (bytes_read == BUFFER_SIZE);
+
+        if (!reader){
+            break;
+        }
+        reader.wait_and_rethrow_exceptions();
+        bytes_read = next_bytes_read;
+        std::swap(current, next);
+    }
 
     hash.finish();
     return hash.get_hash_hex();
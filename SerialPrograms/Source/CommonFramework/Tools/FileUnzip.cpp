@@ -17,7 +17,11 @@
 #include "Common/Cpp/ScopeExit.h"
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Filesystem/Filesystem.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "FileUnzip.h"
+#include <atomic>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -29,21 +33,28 @@ namespace PokemonAutomation{
 
 namespace fs = std::filesystem;
 
-struct ProgressData {
-    std::ofstream* out_file;
+//  Shared by all the threads extracting the same archive.
+struct UnzipProgress{
+    Mutex lock;
     uint64_t total_bytes;
     uint64_t processed_bytes;
-    int last_percentage;
     std::function<void(uint64_t bytes_done, uint64_t total_bytes)> progress_callback;
     CancellableScope& scope;
+    std::atomic<bool> stopped;
+};
+
+struct ProgressData {
+    std::ofstream* out_file;
+    UnzipProgress& progress;
 };
 
 // Callback triggered for every chunk of decompressed data
 // pOpaque is an opaque pointer that actually represents ProgressData
 size_t write_callback(void* pOpaque, [[maybe_unused]] mz_uint64 file_ofs, const void* pBuf, size_t n){
     ProgressData* data = static_cast<ProgressData*>(pOpaque);
+    UnzipProgress& progress = data->progress;
 
-    if (data->scope.cancelled()){
+    if (progress.scope.cancelled() || progress.stopped.load(std::memory_order_relaxed)){
         return 0;  // this causes mz_zip_reader_extract_to_callback to return an error
     }
 
@@ -55,13 +66,16 @@ size_t write_callback(void* pOpaque, [[maybe_unused]] mz_uint64 file_ofs, const
         
     // Write chunk to disk
     data->out_file->write(static_cast<const char*>(pBuf), n);
+    if (!*data->out_file){
+        return 0;
+    }
     
     // Update and display progress
-    data->processed_bytes += n;
-
-    data->progress_callback(data->processed_bytes, data->total_bytes);
-
-
+    std::lock_guard<Mutex> lg(progress.lock);
+    progress.processed_bytes += n;
+    if (progress.progress_callback != nullptr){
+        progress.progress_callback(progress.processed_bytes, progress.total_bytes);
+    }
             
     return n;
 }
@@ -136,24 +150,18 @@ void unzip_file(
     });
 
     // Get total number of files in the archive
-    int num_files = (int)mz_zip_reader_get_num_files(&zip_archive);
-
-    // calculate total uncompressed size
+    mz_uint num_files = mz_zip_reader_get_num_files(&zip_archive);
+
+    // Validate every entry and create the directory tree up front so the
+    // extraction threads only need to write files.
+    struct Entry{
+        mz_uint index;
+        uint64_t bytes;
+        Filesystem::Path out_path;
+    };
+    std::vector<Entry> entries;
     uint64_t total_uncompressed_size = 0;
-    for (int i = 0; i < num_files; i++){
-        scope.throw_if_cancelled();
-
-        mz_zip_archive_file_stat file_stat; // holds info on the specific file
-
-        // fills file_stat with the data for the current index
-        if (!mz_zip_reader_file_stat(&zip_archive, i, &file_stat)) continue;
-
-        // cout << std::to_string(file_stat.m_uncomp_size) << endl;
-        total_uncompressed_size += file_stat.m_uncomp_size;
-    }
-
-    uint64_t total_processed_bytes = 0;
-    for (int i = 0; i < num_files; i++){
+    for (mz_uint i = 0; i < num_files; i++){
         scope.throw_if_cancelled();
 
         mz_zip_archive_file_stat file_stat; // holds info on the specific file
@@ -184,27 +192,75 @@ void unzip_file(
             ec.clear(); 
         }
 
-        
-        std::ofstream out_file(out_path.string(), std::ios::binary); // std::ios::binary is to prevent line-ending conversions.
-        ProgressData progress = { &out_file, total_uncompressed_size, total_processed_bytes, -1, progress_callback, scope };
+        // cout << std::to_string(file_stat.m_uncomp_size) << endl;
+        total_uncompressed_size += file_stat.m_uncomp_size;
+        entries.emplace_back(Entry{i, file_stat.m_uncomp_size, std::move(out_path)});
+    }
+
+    // Start the largest entries first so one big model file doesn't end up
+    // running alone at the end.
+    std::sort(
+        entries.begin(), entries.end(),
+        [](const Entry& x, const Entry& y){ return x.bytes > y.bytes; }
+    );
+
+    UnzipProgress progress{
+        {}, total_uncompressed_size, 0, std::move(progress_callback), scope, false
+    };
+    std::atomic<size_t> next_entry(0);
+
+    // Each thread opens its own handle to the archive since a miniz reader
+    // cannot be shared between threads. Threads pull entries until none are left.
+    auto extract_entries = [&](size_t){
+        mz_zip_archive thread_archive;
+        memset(&thread_archive, 0, sizeof(thread_archive));
+        if (!mz_zip_reader_init_file(&thread_archive, zip_path, 0)){
+            progress.stopped.store(true, std::memory_order_relaxed);
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, 
+                "unzip_file: failed to run mz_zip_reader_init_file. mz_zip_error: " + std::to_string(mz_zip_get_last_error(&thread_archive)));
+        }
+        ScopeExit thread_exit([&]{
+            mz_zip_reader_end(&thread_archive);
+        });
+
+        while (true){
+            size_t index = next_entry.fetch_add(1, std::memory_order_relaxed);
+            if (index >= entries.size()){
+                return;
+            }
+            if (scope.cancelled() || progress.stopped.load(std::memory_order_relaxed)){
+                return;
+            }
+            const Entry& entry = entries[index];
 
-        // Extract using the callback
-        // decompresses the file in chunks and repeatedly calls write_callback to save those chunks to the disk via the out_file
-        mz_bool status = mz_zip_reader_extract_to_callback(&zip_archive, i, write_callback, &progress, 0);
+            std::ofstream out_file(entry.out_path.string(), std::ios::binary); // std::ios::binary is to prevent line-ending conversions.
+            ProgressData data{&out_file, progress};
 
-        if (!status){
+            // Extract using the callback
+            // decompresses the file in chunks and repeatedly calls write_callback to save those chunks to the disk via the out_file
+            mz_bool status = mz_zip_reader_extract_to_callback(&thread_archive, entry.index, write_callback, &data, 0);
             out_file.close();
-            if (scope.cancelled()){
-                // close and delete the partially unzipped file
-                fs::remove(out_path, ec);
-                throw OperationCancelledException();
+            if (status && out_file){
+                continue;
+            }
+
+            // close and delete the partially unzipped file
+            std::error_code ec{};
+            fs::remove(entry.out_path, ec);
+            if (scope.cancelled() || progress.stopped.load(std::memory_order_relaxed)){
+                return;
             }
+            progress.stopped.store(true, std::memory_order_relaxed);
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, 
+                "unzip_file: failed to extract " + entry.out_path.string() + ". mz_zip_error: " + std::to_string(mz_zip_get_last_error(&thread_archive)));
         }
+    };
 
-        // std::cout << "\nFinished: " << file_stat.m_filename << std::endl;
-        total_processed_bytes += file_stat.m_uncomp_size;
-    }
+    ThreadPool& thread_pool = GlobalThreadPools::computation_normal();
+    size_t threads = std::min(entries.size(), thread_pool.max_threads());
+    thread_pool.run_in_parallel(extract_entries, 0, threads, 1);
 
+    scope.throw_if_cancelled();
 }
 
 // void unzip_file(const std::string& zip_path, const std::string& output_dir){
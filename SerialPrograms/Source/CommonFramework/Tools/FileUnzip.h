@@ -18,6 +18,8 @@ namespace PokemonAutomation{
 // if target_dir doesn't already exist, it will create it.
 // throw OperationCancelledException if the CancellableScope is cancelled
 // throw InternalProgramError if unzipping fails.
+// The entries are decompressed in parallel on the computation thread pool.
+// progress_callback may be called from any of those threads, but never concurrently.
 void unzip_file(
     CancellableScope& scope,
     const char* zip_path, 
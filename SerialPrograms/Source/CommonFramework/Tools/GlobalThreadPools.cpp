@@ -7,6 +7,7 @@
 #include "Common/Cpp/Concurrency/Backends/ThreadPool_Default.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/Options/Environment/PerformanceOptions.h"
+#include "ThreadAffinityPolicy.h"
 #include "GlobalThreadPools.h"
 
 namespace PokemonAutomation{
@@ -60,6 +61,16 @@ ThreadPool& unlimited_normal(){
     );
     return runner;
 }
+ThreadPool& unlimited_serial_io(){
+    static ThreadPool_Default runner(
+        [](){
+            PerformanceOptions::instance().REALTIME_THREAD_PRIORITY0.set_on_this_thread(global_logger_tagged());
+            ThreadAffinityPolicy::pin_this_thread(ThreadAffinityGroup::serial_io());
+        },
+        0
+    );
+    return runner;
+}
 
 
 
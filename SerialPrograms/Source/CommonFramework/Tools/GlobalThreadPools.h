@@ -26,6 +26,10 @@ ThreadPool& unlimited_realtime();
 ThreadPool& unlimited_pivot();
 ThreadPool& unlimited_normal();
 
+//  Serial port threads. These are pinned to their own cores if thread
+//  affinity is enabled.
+ThreadPool& unlimited_serial_io();
+
 
 
 }
@@ -0,0 +1,266 @@
+/*  Image Encoder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <random>
+#include <filesystem>
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/Filesystem/Filesystem.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "ImageEncoder.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+
+bool PendingImageFile::is_finished() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_finished;
+}
+bool PendingImageFile::wait() const{
+    std::unique_lock<Mutex> lg(m_lock);
+    m_cv.wait(lg, [this]{ return m_finished; });
+    return m_success;
+}
+void PendingImageFile::remove_when_finished(){
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        if (!m_finished){
+            m_remove = true;
+            return;
+        }
+        if (!m_success){
+            return;
+        }
+    }
+    Filesystem::remove(m_path);
+}
+void PendingImageFile::report_finished(bool success){
+    bool remove;
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        m_finished = true;
+        m_success = success;
+        remove = success && m_remove;
+        m_cv.notify_all();
+    }
+    if (remove){
+        Filesystem::remove(m_path);
+    }
+}
+
+
+
+//  Not cryptographic. Only needs to tell frames apart.
+static uint64_t hash_image(const ImageViewRGB32& image){
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ ((uint64_t)image.width() << 32) ^ image.height();
+    const size_t bytes = image.width() * sizeof(uint32_t);
+    const char* row = (const char*)image.data();
+    for (size_t r = 0; r < image.height(); r++, row += image.bytes_per_row()){
+        size_t c = 0;
+        for (; c + 8 <= bytes; c += 8){
+            uint64_t word;
+            memcpy(&word, row + c, 8);
+            hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+            hash ^= hash >> 32;
+        }
+        for (; c < bytes; c += 4){
+            uint32_t word;
+            memcpy(&word, row + c, 4);
+            hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+            hash ^= hash >> 32;
+        }
+    }
+    return hash;
+}
+
+static std::string file_extension(const std::string& path){
+    size_t dot = path.rfind('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)){
+        return "";
+    }
+    return path.substr(dot);
+}
+
+
+
+ImageEncoder& ImageEncoder::instance(){
+    static ImageEncoder encoder;
+    return encoder;
+}
+ImageEncoder::ImageEncoder()
+    : m_thread([this]{ thread_loop(); })
+{}
+ImageEncoder::~ImageEncoder(){
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    m_thread.join();
+}
+
+std::shared_ptr<PendingImageFile> ImageEncoder::save(
+    const ImageViewRGB32& image,
+    std::string path,
+    int quality
+){
+    std::shared_ptr<PendingImageFile> file = std::make_shared<PendingImageFile>(std::move(path));
+    if (!image){
+        file->report_finished(false);
+        return file;
+    }
+
+    //  The caller's image may go away as soon as we return.
+    Job job{file, image.copy(), quality};
+
+    std::lock_guard<Mutex> lg(m_lock);
+    m_queue.emplace_back(std::move(job));
+    m_cv.notify_all();
+    return file;
+}
+ImageEncoder::Stats ImageEncoder::stats() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_stats;
+}
+
+
+std::shared_ptr<const std::string> ImageEncoder::encode(const Job& job){
+    const std::string extension = file_extension(job.file->path());
+    const uint64_t hash = hash_image(job.image);
+
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        for (const RecentFrame& frame : m_recent){
+            if (frame.hash == hash &&
+                frame.width == job.image.width() &&
+                frame.height == job.image.height() &&
+                frame.extension == extension &&
+                frame.quality == job.quality
+            ){
+                m_stats.reused++;
+                return frame.bytes;
+            }
+        }
+    }
+
+    std::shared_ptr<const std::string> bytes = std::make_shared<const std::string>(
+        job.image.encode(extension, job.quality)
+    );
+    if (bytes->empty()){
+        return nullptr;
+    }
+
+    std::lock_guard<Mutex> lg(m_lock);
+    m_stats.encoded++;
+    m_recent.emplace_back(RecentFrame{hash, job.image.width(), job.image.height(), extension, job.quality, bytes});
+    if (m_recent.size() > RECENT_FRAMES){
+        m_recent.pop_front();
+    }
+    return bytes;
+}
+
+void ImageEncoder::thread_loop(){
+    while (true){
+        Job job;
+        {
+            std::unique_lock<Mutex> lg(m_lock);
+            m_cv.wait(lg, [this]{ return m_stopping || !m_queue.empty(); });
+
+            //  Finish what's queued before stopping.
+            if (m_queue.empty()){
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        bool success = false;
+        try{
+            std::shared_ptr<const std::string> bytes = encode(job);
+            if (bytes){
+                const std::string& path = job.file->path();
+                Filesystem::Path folder = Filesystem::Path(path).parent_path();
+                if (!folder.empty() && !Filesystem::exists(folder)){
+                    Filesystem::create_directories(folder);
+                }
+                FileIO file(path, FileMode::WRITE | FileMode::BINARY);
+                success = file.is_open() && file.write(bytes->data(), bytes->size()) == bytes->size();
+            }
+        }catch (...){}
+
+        if (!success){
+            global_logger_tagged().log("Failed to save image: " + job.file->path(), COLOR_RED);
+            std::lock_guard<Mutex> lg(m_lock);
+            m_stats.failed++;
+        }
+        job.file->report_finished(success);
+    }
+}
+
+
+
+void benchmark_ImageEncoder(Logger& logger, size_t iterations){
+    namespace fs = std::filesystem;
+
+    //  Gradients with some noise. Roughly as hard to compress as a game frame.
+    ImageRGB32 image(1920, 1080);
+    std::mt19937 rng(0);
+    for (size_t r = 0; r < image.height(); r++){
+        for (size_t c = 0; c < image.width(); c++){
+            uint32_t red = (uint32_t)(c * 255 / 1920);
+            uint32_t green = (uint32_t)(r * 255 / 1080);
+            uint32_t blue = (uint32_t)((c ^ r) & 0xff);
+            uint32_t noise = rng() & 0x0f0f0f;
+            image.pixel(c, r) = (0xff000000 | (red << 16) | (green << 8) | blue) ^ noise;
+        }
+    }
+
+    fs::path base = fs::temp_directory_path() / "PokemonAutomation-ImageEncoderBenchmark";
+    fs::create_directories(base);
+
+    for (const char* extension : {".png", ".jpg"}){
+        WallClock start = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            image.save((base / ("Sync-" + std::to_string(c) + extension)).string());
+        }
+        double sync = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)iterations;
+
+        //  Change a pixel each time so nothing is reused.
+        std::vector<std::shared_ptr<PendingImageFile>> files;
+        double stall = 0;
+        start = current_time();
+        for (size_t c = 0; c < iterations; c++){
+            image.pixel(0, 0) = (uint32_t)c;
+            WallClock submit = current_time();
+            files.emplace_back(ImageEncoder::instance().save(image, (base / ("Async-" + std::to_string(c) + extension)).string()));
+            stall += std::chrono::duration_cast<std::chrono::microseconds>(current_time() - submit).count();
+        }
+        for (const std::shared_ptr<PendingImageFile>& file : files){
+            file->wait();
+        }
+        double total = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)iterations;
+
+        logger.log(
+            std::string(extension) + ": program thread stall: sync = " + tostr_fixed(sync, 0) +
+            " us, async = " + tostr_fixed(stall / iterations, 0) + " us (" + tostr_fixed(total, 0) + " us per frame in the background)"
+        );
+    }
+
+    std::error_code ec;
+    fs::remove_all(base, ec);
+}
+
+
+
+}
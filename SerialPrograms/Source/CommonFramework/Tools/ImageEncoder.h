@@ -0,0 +1,129 @@
+/*  Image Encoder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Save screenshots in the background so that the program thread doesn't
+ *  wait on the PNG/JPG compression. The image is copied when it is submitted
+ *  and the file is written by the encoder thread.
+ *
+ *  A frame that is identical to one of the last few that were encoded (same
+ *  pixels, format and quality) reuses the compressed bytes.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ImageEncoder_H
+#define PokemonAutomation_CommonFramework_ImageEncoder_H
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <deque>
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+
+
+//  An image file that is being written in the background.
+class PendingImageFile{
+public:
+    PendingImageFile(std::string path)
+        : m_path(std::move(path))
+    {}
+
+    const std::string& path() const{ return m_path; }
+
+    bool is_finished() const;
+
+    //  Wait for the file to be written. Returns false if it couldn't be.
+    bool wait() const;
+
+    //  Delete the file once it has been written. (or now if it already has)
+    void remove_when_finished();
+
+
+private:
+    friend class ImageEncoder;
+    void report_finished(bool success);
+
+    const std::string m_path;
+    mutable Mutex m_lock;
+    mutable ConditionVariable m_cv;
+    bool m_finished = false;
+    bool m_success = false;
+    bool m_remove = false;
+};
+
+
+
+class ImageEncoder{
+public:
+    struct Stats{
+        uint64_t encoded = 0;       //  Frames that were compressed.
+        uint64_t reused = 0;        //  Frames that matched a recent one.
+        uint64_t failed = 0;
+    };
+
+    static ImageEncoder& instance();
+
+    //  Copy the image and write it to "path" in the background. The format
+    //  is taken from the extension. See ImageViewRGB32::encode() for "quality".
+    //  If the image is null, the returned file is already finished and failed.
+    std::shared_ptr<PendingImageFile> save(
+        const ImageViewRGB32& image,
+        std::string path,
+        int quality = -1
+    );
+
+    Stats stats() const;
+
+
+private:
+    struct Job{
+        std::shared_ptr<PendingImageFile> file;
+        ImageRGB32 image;
+        int quality = -1;
+    };
+    struct RecentFrame{
+        uint64_t hash;
+        size_t width;
+        size_t height;
+        std::string extension;
+        int quality;
+        std::shared_ptr<const std::string> bytes;
+    };
+
+    ImageEncoder();
+    ~ImageEncoder();
+
+    void thread_loop();
+    std::shared_ptr<const std::string> encode(const Job& job);
+
+
+private:
+    static const size_t RECENT_FRAMES = 4;
+
+    mutable Mutex m_lock;
+    ConditionVariable m_cv;
+    bool m_stopping = false;
+    std::deque<Job> m_queue;
+    std::deque<RecentFrame> m_recent;
+    Stats m_stats;
+
+    Thread m_thread;
+};
+
+
+
+//  Time how long the caller is blocked when saving a screenshot. Synchronous
+//  ImageViewRGB32::save() vs. ImageEncoder::save().
+void benchmark_ImageEncoder(Logger& logger, size_t iterations);
+
+
+
+}
+#endif
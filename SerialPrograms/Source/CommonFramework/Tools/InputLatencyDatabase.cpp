@@ -0,0 +1,145 @@
+/*  Input Latency Database
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Color.h"
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "CommonFramework/GlobalAutoPaths.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "InputLatencyDatabase.h"
+
+namespace PokemonAutomation{
+
+
+
+void InputLatencyHistogram::add(std::chrono::microseconds latency){
+    m_samples.insert(
+        std::upper_bound(m_samples.begin(), m_samples.end(), latency),
+        latency
+    );
+}
+std::chrono::microseconds InputLatencyHistogram::mean() const{
+    int64_t sum = 0;
+    for (std::chrono::microseconds x : m_samples){
+        sum += x.count();
+    }
+    return std::chrono::microseconds(sum / (int64_t)m_samples.size());
+}
+std::chrono::microseconds InputLatencyHistogram::percentile(double fraction) const{
+    fraction = std::min(std::max(fraction, 0.), 1.);
+    size_t index = (size_t)(fraction * (double)(m_samples.size() - 1) + 0.5);
+    return m_samples[index];
+}
+
+std::string InputLatencyHistogram::dump(std::chrono::milliseconds bucket_width) const{
+    if (m_samples.empty()){
+        return "No samples.";
+    }
+
+    auto to_ms = [](std::chrono::microseconds x){
+        return tostr_fixed((double)x.count() / 1000, 1);
+    };
+
+    std::string str;
+    str += "Samples: " + std::to_string(m_samples.size());
+    str += ", Min: " + to_ms(min());
+    str += " ms, Median: " + to_ms(percentile(0.5));
+    str += " ms, 90%: " + to_ms(percentile(0.9));
+    str += " ms, Max: " + to_ms(max());
+    str += " ms, Mean: " + to_ms(mean()) + " ms";
+
+    const int64_t width = std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(bucket_width).count(), 1);
+    auto iter = m_samples.begin();
+    while (iter != m_samples.end()){
+        int64_t bucket = iter->count() / width;
+        auto end = std::upper_bound(
+            iter, m_samples.end(),
+            std::chrono::microseconds((bucket + 1) * width - 1)
+        );
+        size_t count = end - iter;
+        str += "\n";
+        str += std::to_string(bucket * width / 1000) + " - " + std::to_string((bucket + 1) * width / 1000) + " ms: ";
+        str += std::string(count, '*');
+        str += " (" + std::to_string(count) + ")";
+        iter = end;
+    }
+    return str;
+}
+
+JsonValue InputLatencyHistogram::to_json() const{
+    JsonArray ret;
+    for (std::chrono::microseconds x : m_samples){
+        ret.push_back(x.count());
+    }
+    return ret;
+}
+void InputLatencyHistogram::load_json(const JsonValue& json){
+    m_samples.clear();
+    for (const JsonValue& item : json.to_array_throw()){
+        m_samples.emplace_back(std::chrono::microseconds(item.to_integer_throw()));
+    }
+    std::sort(m_samples.begin(), m_samples.end());
+}
+
+
+
+InputLatencyDatabase& InputLatencyDatabase::instance(){
+    static InputLatencyDatabase database;
+    return database;
+}
+InputLatencyDatabase::InputLatencyDatabase()
+    : m_path(SETTINGS_PATH() + "InputLatency.json")
+{
+    try{
+        JsonValue json = load_json_file(m_path);
+        for (const auto& item : json.to_object_throw(m_path)){
+            const JsonObject& obj = item.second.to_object_throw(m_path);
+            Entry entry;
+            entry.updated = obj.get_string_default("Updated");
+            entry.histogram.load_json(obj.get_value_throw("SamplesMicroseconds", m_path));
+            m_entries[item.first] = std::move(entry);
+        }
+    }catch (FileException&){
+        //  Nothing has been calibrated yet.
+    }catch (Exception& e){
+        global_logger_tagged().log("Unable to load input latency data: " + e.message(), COLOR_RED);
+        m_entries.clear();
+    }
+}
+
+std::optional<InputLatencyHistogram> InputLatencyDatabase::get(const std::string& key) const{
+    std::lock_guard<Mutex> lg(m_lock);
+    auto iter = m_entries.find(key);
+    if (iter == m_entries.end()){
+        return std::nullopt;
+    }
+    return iter->second.histogram;
+}
+void InputLatencyDatabase::set(const std::string& key, InputLatencyHistogram histogram){
+    std::lock_guard<Mutex> lg(m_lock);
+    Entry& entry = m_entries[key];
+    entry.updated = current_time_to_str();
+    entry.histogram = std::move(histogram);
+    save();
+}
+void InputLatencyDatabase::save() const{
+    JsonObject root;
+    for (const auto& item : m_entries){
+        JsonObject obj;
+        obj["Updated"] = item.second.updated;
+        obj["SamplesMicroseconds"] = item.second.histogram.to_json();
+        root[item.first] = std::move(obj);
+    }
+    JsonValue(std::move(root)).dump(m_path);
+}
+
+
+
+}
@@ -0,0 +1,87 @@
+/*  Input Latency Database
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Measured input-to-frame latency for each console/controller/capture
+ *  combination. Written by the Input Latency Calibrator and saved to
+ *  "InputLatency.json" in the settings folder.
+ *
+ *  Latency is measured from when the host issues a button press on an idle
+ *  command queue to the capture timestamp of the first frame that shows its
+ *  effect. So it includes the controller, the console, the capture card and
+ *  the frame conversion.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_InputLatencyDatabase_H
+#define PokemonAutomation_CommonFramework_InputLatencyDatabase_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+
+namespace PokemonAutomation{
+
+class JsonValue;
+
+
+class InputLatencyHistogram{
+public:
+    void add(std::chrono::microseconds latency);
+
+    size_t size() const{ return m_samples.size(); }
+    bool empty() const{ return m_samples.empty(); }
+    const std::vector<std::chrono::microseconds>& samples() const{ return m_samples; }
+
+    //  These require !empty().
+    std::chrono::microseconds min() const{ return m_samples.front(); }
+    std::chrono::microseconds max() const{ return m_samples.back(); }
+    std::chrono::microseconds mean() const;
+
+    //  "fraction" is in [0, 1]. 0.5 is the median.
+    std::chrono::microseconds percentile(double fraction) const;
+
+    //  One line summary followed by one line per non-empty bucket.
+    std::string dump(std::chrono::milliseconds bucket_width) const;
+
+    JsonValue to_json() const;
+    void load_json(const JsonValue& json);
+
+private:
+    //  Sorted.
+    std::vector<std::chrono::microseconds> m_samples;
+};
+
+
+
+class InputLatencyDatabase{
+public:
+    static InputLatencyDatabase& instance();
+
+    std::optional<InputLatencyHistogram> get(const std::string& key) const;
+
+    //  Replace the entry for "key" and save the file.
+    void set(const std::string& key, InputLatencyHistogram histogram);
+
+private:
+    InputLatencyDatabase();
+    void save() const;
+
+private:
+    struct Entry{
+        std::string updated;
+        InputLatencyHistogram histogram;
+    };
+
+    const std::string m_path;
+    mutable Mutex m_lock;
+    std::map<std::string, Entry> m_entries;
+};
+
+
+
+}
+#endif
@@ -0,0 +1,301 @@
+/*  Telemetry File
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "TelemetryFile.h"
+
+namespace PokemonAutomation{
+
+
+
+namespace{
+
+const char TELEMETRY_MAGIC[8] = {'P', 'A', 'T', 'L', 'M', '0', '0', '1'};
+const size_t HEADER_SIZE = 8 + 8 + 4;
+const size_t SAMPLE_RECORD_SIZE = 1 + 2 + 4 + 4 + 4 + 4;
+
+enum RecordType : uint8_t{
+    RECORD_CHANNEL  = 1,
+    RECORD_SAMPLE   = 2,
+};
+
+//  Only little-endian hosts are supported. So these are straight copies.
+template <typename Type>
+void append(std::string& buffer, Type x){
+    buffer.append((const char*)&x, sizeof(Type));
+}
+template <typename Type>
+bool consume(const std::string& buffer, size_t& index, Type& x){
+    if (buffer.size() - index < sizeof(Type)){
+        return false;
+    }
+    memcpy(&x, buffer.data() + index, sizeof(Type));
+    index += sizeof(Type);
+    return true;
+}
+
+void encode_header(std::string& buffer, int64_t start_time_us, uint32_t period_ms){
+    buffer.append(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    append(buffer, start_time_us);
+    append(buffer, period_ms);
+}
+void encode_channel(std::string& buffer, uint16_t id, const std::string& name){
+    uint16_t length = (uint16_t)std::min<size_t>(name.size(), 0xffff);
+    append(buffer, (uint8_t)RECORD_CHANNEL);
+    append(buffer, id);
+    append(buffer, length);
+    buffer.append(name.data(), length);
+}
+void encode_sample(std::string& buffer, const TelemetrySample& sample){
+    append(buffer, (uint8_t)RECORD_SAMPLE);
+    append(buffer, sample.channel);
+    append(buffer, sample.time_ms);
+    append(buffer, sample.count);
+    append(buffer, sample.mean);
+    append(buffer, sample.max);
+}
+
+//  Returns false if this isn't a telemetry file.
+bool parse_telemetry(TelemetryFileData& data, const std::string& buffer){
+    if (buffer.size() < HEADER_SIZE || memcmp(buffer.data(), TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC)) != 0){
+        return false;
+    }
+    size_t index = sizeof(TELEMETRY_MAGIC);
+    consume(buffer, index, data.start_time_us);
+    consume(buffer, index, data.period_ms);
+
+    while (index < buffer.size()){
+        uint8_t type;
+        consume(buffer, index, type);
+        switch (type){
+        case RECORD_CHANNEL:{
+            uint16_t id;
+            uint16_t length;
+            if (!consume(buffer, index, id) || !consume(buffer, index, length) ||
+                buffer.size() - index < length
+            ){
+                data.truncated = true;
+                return true;
+            }
+            if (data.channels.size() <= id){
+                data.channels.resize((size_t)id + 1);
+            }
+            data.channels[id] = buffer.substr(index, length);
+            index += length;
+            break;
+        }
+        case RECORD_SAMPLE:{
+            TelemetrySample sample;
+            if (!consume(buffer, index, sample.channel) ||
+                !consume(buffer, index, sample.time_ms) ||
+                !consume(buffer, index, sample.count) ||
+                !consume(buffer, index, sample.mean) ||
+                !consume(buffer, index, sample.max)
+            ){
+                data.truncated = true;
+                return true;
+            }
+            data.samples.emplace_back(sample);
+            break;
+        }
+        default:
+            //  Garbage. Most likely a partial write. Keep what we have.
+            data.truncated = true;
+            return true;
+        }
+    }
+    return true;
+}
+
+std::string channel_name(const TelemetryFileData& data, uint16_t id){
+    if (id < data.channels.size() && !data.channels[id].empty()){
+        return data.channels[id];
+    }
+    return "Channel " + std::to_string(id);
+}
+
+}
+
+
+
+bool TelemetryFileWriter::open(const std::string& path, WallClock start, std::chrono::milliseconds period){
+    if (!m_file.open(Filesystem::Path(path), FileMode::WRITE | FileMode::BINARY)){
+        return false;
+    }
+    int64_t start_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        start.time_since_epoch()
+    ).count();
+    encode_header(m_buffer, start_us, (uint32_t)period.count());
+    flush();
+    return true;
+}
+void TelemetryFileWriter::close(){
+    flush();
+    m_file.close();
+}
+void TelemetryFileWriter::write_channel(uint16_t id, const std::string& name){
+    encode_channel(m_buffer, id, name);
+}
+void TelemetryFileWriter::write_sample(const TelemetrySample& sample){
+    encode_sample(m_buffer, sample);
+}
+void TelemetryFileWriter::flush(){
+    if (!m_file.is_open()){
+        m_buffer.clear();
+        return;
+    }
+    if (!m_buffer.empty()){
+        m_file.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+    m_file.flush();
+}
+
+
+
+TelemetryFileData read_telemetry_file(const std::string& path){
+    std::string buffer = file_to_string(path);
+    TelemetryFileData data;
+    if (!parse_telemetry(data, buffer)){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Not a telemetry file.", path);
+    }
+    return data;
+}
+void export_telemetry_csv(const TelemetryFileData& data, const std::string& path){
+    std::string csv = "Time (s),Channel,Count,Mean,Max\n";
+    for (const TelemetrySample& sample : data.samples){
+        std::string name = channel_name(data, sample.channel);
+        if (name.find_first_of(",\"") != std::string::npos){
+            std::string quoted = "\"";
+            for (char ch : name){
+                if (ch == '"'){
+                    quoted += '"';
+                }
+                quoted += ch;
+            }
+            name = quoted + "\"";
+        }
+        csv += tostr_fixed(sample.time_ms / 1000., 3);
+        csv += ",";
+        csv += name;
+        csv += ",";
+        csv += std::to_string(sample.count);
+        csv += ",";
+        csv += std::to_string(sample.mean);
+        csv += ",";
+        csv += std::to_string(sample.max);
+        csv += "\n";
+    }
+    string_to_file(path, csv);
+}
+void export_telemetry_json(const TelemetryFileData& data, const std::string& path){
+    std::vector<JsonArray> series(data.channels.size());
+    for (const TelemetrySample& sample : data.samples){
+        if (series.size() <= sample.channel){
+            series.resize((size_t)sample.channel + 1);
+        }
+        JsonArray point;
+        point.push_back(sample.time_ms / 1000.);
+        point.push_back((int64_t)sample.count);
+        point.push_back((double)sample.mean);
+        point.push_back((double)sample.max);
+        series[sample.channel].push_back(std::move(point));
+    }
+
+    JsonObject channels;
+    for (size_t c = 0; c < series.size(); c++){
+        channels[channel_name(data, (uint16_t)c)] = std::move(series[c]);
+    }
+
+    JsonObject json;
+    json["StartTime"] = data.start_time_us;
+    json["Period"] = (int64_t)data.period_ms;
+    json["Truncated"] = data.truncated;
+    json["Channels"] = std::move(channels);
+    json.dump(path);
+}
+
+
+
+
+class Test_TelemetryFile : public UnitTest{
+public:
+    Test_TelemetryFile()
+        : UnitTest("CommonFramework::TelemetryFile - Round Trip and Truncation")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        std::string buffer;
+        encode_header(buffer, 1234567890, 1000);
+        encode_channel(buffer, 0, "System/CPU Utilization");
+        encode_channel(buffer, 1, "Video/Snapshot Conversion (ms)");
+
+        std::vector<TelemetrySample> expected;
+        for (uint32_t t = 0; t < 100; t++){
+            for (uint16_t id = 0; id < 2; id++){
+                TelemetrySample sample{id, t * 1000, t + id, 0.5f * t, 1.5f * t + id};
+                encode_sample(buffer, sample);
+                expected.emplace_back(sample);
+            }
+        }
+        size_t complete_size = buffer.size();
+
+        //  Cut the file at every possible point in the last few records.
+        for (size_t size = complete_size; size + 200 > complete_size; size--){
+            TelemetryFileData data;
+            if (!parse_telemetry(data, buffer.substr(0, size))){
+                return "Header rejected.";
+            }
+            if (data.start_time_us != 1234567890 || data.period_ms != 1000){
+                return "Header mismatch.";
+            }
+            if (data.channels.size() != 2 || data.channels[1] != "Video/Snapshot Conversion (ms)"){
+                return "Channel mismatch.";
+            }
+            if (data.truncated != ((complete_size - size) % SAMPLE_RECORD_SIZE != 0)){
+                return "Truncation not reported at size " + std::to_string(size) + ".";
+            }
+            if (data.samples.size() > expected.size()){
+                return "Too many samples.";
+            }
+            //  Only whole records are kept.
+            if (data.samples.size() != expected.size() - (complete_size - size + SAMPLE_RECORD_SIZE - 1) / SAMPLE_RECORD_SIZE){
+                return "Wrong sample count at size " + std::to_string(size) + ".";
+            }
+            for (size_t c = 0; c < data.samples.size(); c++){
+                const TelemetrySample& x = data.samples[c];
+                const TelemetrySample& y = expected[c];
+                if (x.channel != y.channel || x.time_ms != y.time_ms || x.count != y.count ||
+                    x.mean != y.mean || x.max != y.max
+                ){
+                    return "Sample " + std::to_string(c) + " mismatch.";
+                }
+            }
+        }
+
+        TelemetryFileData data;
+        if (parse_telemetry(data, "Not a telemetry file at all.")){
+            return "Accepted a bad header.";
+        }
+
+        logger.log("Samples: " + std::to_string(expected.size()) + ", Bytes: " + std::to_string(complete_size));
+        return true;
+    }
+};
+
+
+
+void add_tests_TelemetryFile(UnitTestDatabase& database){
+    database.add<Test_TelemetryFile>();
+}
+
+
+
+}
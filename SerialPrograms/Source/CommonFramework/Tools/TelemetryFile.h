@@ -0,0 +1,104 @@
+/*  Telemetry File
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Binary time-series format written by the TelemetryRecorder.
+ *
+ *  The file is a header followed by a stream of records. Everything is
+ *  little-endian.
+ *
+ *      Header:
+ *          char[8]     "PATLM001"
+ *          int64       Start time. (microseconds since Unix epoch)
+ *          uint32      Sample period. (milliseconds)
+ *
+ *      Channel Record: (declares a channel before its first sample)
+ *          uint8       1
+ *          uint16      Channel ID
+ *          uint16      Name length
+ *          char[]      Name (UTF-8)
+ *
+ *      Sample Record: (one sample period of one channel)
+ *          uint8       2
+ *          uint16      Channel ID
+ *          uint32      Time since start. (milliseconds)
+ *          uint32      Number of values in this period.
+ *          float       Mean
+ *          float       Max
+ *
+ *  The file is flushed after every period. If the program dies, the reader
+ *  drops the incomplete record at the end and keeps everything before it.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_TelemetryFile_H
+#define PokemonAutomation_CommonFramework_TelemetryFile_H
+
+#include <string>
+#include <vector>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+
+namespace PokemonAutomation{
+
+
+struct TelemetrySample{
+    uint16_t channel;
+    uint32_t time_ms;
+    uint32_t count;
+    float mean;
+    float max;
+};
+
+
+
+class TelemetryFileWriter{
+public:
+    //  Returns false if the file can't be created.
+    bool open(const std::string& path, WallClock start, std::chrono::milliseconds period);
+    bool is_open() const{ return m_file.is_open(); }
+    void close();
+
+    void write_channel(uint16_t id, const std::string& name);
+    void write_sample(const TelemetrySample& sample);
+    void flush();
+
+private:
+    FileIO m_file;
+    std::string m_buffer;
+};
+
+
+
+struct TelemetryFileData{
+    int64_t start_time_us = 0;
+    uint32_t period_ms = 0;
+
+    //  Indexed by channel ID.
+    std::vector<std::string> channels;
+
+    //  In file order.
+    std::vector<TelemetrySample> samples;
+
+    //  True if the file ended in the middle of a record.
+    bool truncated = false;
+};
+
+//  Throws FileException if the file can't be opened or isn't a telemetry file.
+TelemetryFileData read_telemetry_file(const std::string& path);
+
+//  One row per sample: "Time (s), Channel, Count, Mean, Max"
+void export_telemetry_csv(const TelemetryFileData& data, const std::string& path);
+
+//  { "StartTime": ..., "Period": ..., "Channels": { name: [[time, count, mean, max], ...] } }
+void export_telemetry_json(const TelemetryFileData& data, const std::string& path);
+
+
+
+void add_tests_TelemetryFile(UnitTestDatabase& database);
+
+
+
+}
+#endif
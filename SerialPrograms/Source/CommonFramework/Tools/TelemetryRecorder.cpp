@@ -0,0 +1,188 @@
+/*  Telemetry Recorder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Filesystem/Filesystem.h"
+#include "Common/Cpp/Logging/AbstractLogger.h"
+#include "Common/Cpp/MemoryUtilization/MemoryUtilization.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "TelemetryRecorder.h"
+
+namespace PokemonAutomation{
+
+
+
+TelemetryRecorder& TelemetryRecorder::instance(){
+    static TelemetryRecorder recorder;
+    return recorder;
+}
+TelemetryRecorder::TelemetryRecorder()
+    : m_enabled(false)
+    , m_stopping(false)
+{}
+TelemetryRecorder::~TelemetryRecorder(){
+    stop();
+}
+
+
+void TelemetryRecorder::start(Logger& logger, const std::string& directory){
+    std::lock_guard<Mutex> lg(m_lock);
+    if (m_thread){
+        return;
+    }
+
+    Filesystem::create_directories(Filesystem::Path(directory));
+    std::string path = directory + "Telemetry-" + now_to_filestring() + ".patm";
+
+    m_start = current_time();
+    if (!m_file.open(path, m_start, PERIOD)){
+        logger.log("Unable to create telemetry file: " + path, COLOR_RED);
+        return;
+    }
+    logger.log("Recording telemetry to: " + path);
+
+    m_last_sample = m_start;
+    m_last_cpu = SystemCpuTime::now();
+    m_last_realtime_pool = GlobalThreadPools::computation_realtime().cpu_time();
+    m_last_normal_pool = GlobalThreadPools::computation_normal().cpu_time();
+
+    m_stopping = false;
+    m_enabled.store(true, std::memory_order_relaxed);
+    m_thread = GlobalThreadPools::unlimited_normal().dispatch_now_blocking([this]{
+        thread_loop();
+    });
+}
+void TelemetryRecorder::stop() noexcept{
+    if (!m_thread){
+        return;
+    }
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_thread.wait_and_ignore_exceptions();
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+
+TelemetryChannel& TelemetryRecorder::channel(const std::string& name){
+    std::lock_guard<Mutex> lg(m_channels_lock);
+    auto iter = m_channels.find(name);
+    if (iter != m_channels.end()){
+        return *iter->second;
+    }
+    std::unique_ptr<TelemetryChannel> channel(
+        new TelemetryChannel(m_enabled, (uint16_t)m_channel_list.size(), name)
+    );
+    m_channel_list.emplace_back(channel.get());
+    return *m_channels.emplace(name, std::move(channel)).first->second;
+}
+
+
+
+void TelemetryRecorder::thread_loop(){
+    std::unique_lock<Mutex> lg(m_lock);
+    WallClock next = current_time() + PERIOD;
+    while (true){
+        m_cv.wait_until(lg, next, [&]{ return m_stopping || current_time() >= next; });
+
+        WallClock now = current_time();
+        sample_system();
+        write_period(now);
+
+        if (m_stopping){
+            m_file.close();
+            return;
+        }
+
+        //  Skip missed periods instead of bursting to catch up.
+        next += PERIOD;
+        if (next < now){
+            next = now + PERIOD;
+        }
+    }
+}
+void TelemetryRecorder::sample_system(){
+    static TelemetryChannel& cpu = channel("System/CPU Utilization (%)");
+    static TelemetryChannel& system_memory = channel("System/Memory Used (MB)");
+    static TelemetryChannel& process_memory = channel("Process/Physical Memory (MB)");
+    static TelemetryChannel& realtime_pool = channel("Thread Pool/Realtime Utilization (%)");
+    static TelemetryChannel& normal_pool = channel("Thread Pool/Normal Utilization (%)");
+
+    const double MB = 1 << 20;
+
+    WallClock now = current_time();
+    double elapsed_us = (double)std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_sample).count();
+    m_last_sample = now;
+    if (elapsed_us <= 0){
+        return;
+    }
+
+    SystemCpuTime cpu_time = SystemCpuTime::now();
+    size_t vcores = SystemCpuTime::vcores();
+    if (vcores != 0 && cpu_time.is_valid() && m_last_cpu.is_valid()){
+        double busy_us = (double)(cpu_time - m_last_cpu).count();
+        cpu.record(100. * busy_us / vcores / elapsed_us);
+    }
+    m_last_cpu = cpu_time;
+
+    MemoryUsage memory = process_memory_usage();
+    if (memory.total_used_system_memory != 0){
+        system_memory.record(memory.total_used_system_memory / MB);
+    }
+    if (memory.process_physical_memory != 0){
+        process_memory.record(memory.process_physical_memory / MB);
+    }
+
+    auto record_pool = [&](TelemetryChannel& channel, ThreadPool& pool, WallDuration& last){
+        WallDuration current = pool.cpu_time();
+        size_t threads = pool.max_threads();
+        if (current > WallDuration::zero() && last > WallDuration::zero() && threads != 0){
+            double busy_us = (double)std::chrono::duration_cast<std::chrono::microseconds>(current - last).count();
+            channel.record(100. * busy_us / threads / elapsed_us);
+        }
+        last = current;
+    };
+    record_pool(realtime_pool, GlobalThreadPools::computation_realtime(), m_last_realtime_pool);
+    record_pool(normal_pool, GlobalThreadPools::computation_normal(), m_last_normal_pool);
+}
+void TelemetryRecorder::write_period(WallClock now){
+    std::vector<TelemetryChannel*> channels;
+    {
+        std::lock_guard<Mutex> lg(m_channels_lock);
+        channels = m_channel_list;
+    }
+
+    uint32_t time_ms = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_start).count();
+    for (TelemetryChannel* channel : channels){
+        TelemetrySample sample;
+        {
+            WriteSpinLock lg(channel->m_lock);
+            if (channel->m_count == 0){
+                continue;
+            }
+            sample.channel = channel->m_id;
+            sample.time_ms = time_ms;
+            sample.count = channel->m_count;
+            sample.mean = (float)(channel->m_sum / channel->m_count);
+            sample.max = (float)channel->m_max;
+            channel->m_count = 0;
+            channel->m_sum = 0;
+            channel->m_max = 0;
+        }
+        if (!channel->m_declared){
+            m_file.write_channel(channel->m_id, channel->m_name);
+            channel->m_declared = true;
+        }
+        m_file.write_sample(sample);
+    }
+    m_file.flush();
+}
+
+
+
+}
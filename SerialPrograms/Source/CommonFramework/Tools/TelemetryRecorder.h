@@ -0,0 +1,122 @@
+/*  Telemetry Recorder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Record CPU, memory and per-stage timings to a file for the whole session
+ *  so that slowdowns in long runs can be traced to a stage afterwards.
+ *
+ *  Values are recorded into named channels. Every period, each channel that
+ *  received values writes one sample (count, mean, max) to the file. See
+ *  TelemetryFile.h for the format.
+ *
+ *  Recording is off unless PerformanceOptions::RECORD_TELEMETRY is set.
+ *  When it is off, TelemetryChannel::record() is a single atomic load.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_TelemetryRecorder_H
+#define PokemonAutomation_CommonFramework_TelemetryRecorder_H
+
+#include <memory>
+#include <map>
+#include <vector>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "Common/Cpp/Concurrency/AsyncTask.h"
+#include "Common/Cpp/CpuUtilization/CpuUtilization.h"
+#include "TelemetryFile.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+
+
+class TelemetryChannel{
+public:
+    void record(double value){
+        if (!m_enabled.load(std::memory_order_relaxed)){
+            return;
+        }
+        WriteSpinLock lg(m_lock);
+        m_count++;
+        m_sum += value;
+        m_max = m_count == 1 ? value : std::max(m_max, value);
+    }
+    void record(WallDuration duration){
+        record(std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.);
+    }
+
+private:
+    friend class TelemetryRecorder;
+    TelemetryChannel(const std::atomic<bool>& enabled, uint16_t id, std::string name)
+        : m_enabled(enabled)
+        , m_id(id)
+        , m_name(std::move(name))
+    {}
+
+    const std::atomic<bool>& m_enabled;
+    const uint16_t m_id;
+    const std::string m_name;
+    bool m_declared = false;
+
+    SpinLock m_lock;
+    uint32_t m_count = 0;
+    double m_sum = 0;
+    double m_max = 0;
+};
+
+
+
+class TelemetryRecorder{
+public:
+    static TelemetryRecorder& instance();
+
+    //  Start writing "<directory>/Telemetry-<time>.patm". Does nothing if
+    //  already started.
+    void start(Logger& logger, const std::string& directory);
+    void stop() noexcept;
+
+    //  Get the channel with this name. The same name always returns the same
+    //  channel and channels are never destroyed. So get them once and keep
+    //  the reference.
+    //
+    //  Time channels should be in milliseconds and say so in the name.
+    TelemetryChannel& channel(const std::string& name);
+
+private:
+    TelemetryRecorder();
+    ~TelemetryRecorder();
+
+    void thread_loop();
+    void sample_system();
+    void write_period(WallClock now);
+
+private:
+    static constexpr std::chrono::milliseconds PERIOD = std::chrono::seconds(1);
+
+    std::atomic<bool> m_enabled;
+
+    Mutex m_channels_lock;
+    std::map<std::string, std::unique_ptr<TelemetryChannel>> m_channels;
+    std::vector<TelemetryChannel*> m_channel_list;
+
+    //  Only touched by the recording thread.
+    TelemetryFileWriter m_file;
+    WallClock m_start;
+    WallClock m_last_sample;
+    SystemCpuTime m_last_cpu;
+    WallDuration m_last_realtime_pool;
+    WallDuration m_last_normal_pool;
+
+    Mutex m_lock;
+    ConditionVariable m_cv;
+    bool m_stopping;
+    AsyncTask m_thread;
+};
+
+
+
+}
+#endif
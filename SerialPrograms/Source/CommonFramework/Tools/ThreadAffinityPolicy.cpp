@@ -0,0 +1,280 @@
+/*  Thread Affinity Policy
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <atomic>
+#include <map>
+#include <algorithm>
+#include "Common/Cpp/CpuAffinity/CpuAffinity.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Options/Environment/PerformanceOptions.h"
+#include "ThreadAffinityPolicy.h"
+
+namespace PokemonAutomation{
+namespace ThreadAffinityPolicy{
+
+
+
+namespace{
+
+//  Placement is tracked for this many groups and processors. Anything past
+//  that is ignored.
+const size_t MAX_PLACEMENT_GROUPS = 64;
+const size_t MAX_PLACEMENT_PROCESSORS = 256;
+const size_t PLACEMENT_WORDS = MAX_PLACEMENT_PROCESSORS / 64;
+
+
+struct PhysicalCore{
+    size_t node;
+    std::vector<size_t> siblings;   //  Sorted
+};
+
+struct AffinityLayout{
+    bool enabled = false;
+    std::vector<size_t> serial_io;
+    std::vector<std::vector<size_t>> consoles;
+};
+
+AffinityLayout build_layout(
+    const std::vector<LogicalProcessor>& processors,
+    size_t console_groups, size_t serial_io_cores, bool separate_smt_siblings
+){
+    AffinityLayout layout;
+
+    std::map<size_t, PhysicalCore> core_map;
+    for (const LogicalProcessor& processor : processors){
+        PhysicalCore& core = core_map[processor.core];
+        core.node = processor.node;
+        core.siblings.emplace_back(processor.id);
+    }
+
+    //  Order by NUMA node so that contiguous ranges stay on one node.
+    std::vector<PhysicalCore> cores;
+    for (auto& item : core_map){
+        std::sort(item.second.siblings.begin(), item.second.siblings.end());
+        cores.emplace_back(std::move(item.second));
+    }
+    std::sort(
+        cores.begin(), cores.end(),
+        [](const PhysicalCore& x, const PhysicalCore& y){
+            if (x.node != y.node){
+                return x.node < y.node;
+            }
+            return x.siblings[0] < y.siblings[0];
+        }
+    );
+
+    //  Nothing to separate.
+    if (cores.size() < 2){
+        return layout;
+    }
+
+    //  Always leave at least one core for the consoles.
+    serial_io_cores = std::min(serial_io_cores, cores.size() - 1);
+    size_t console_cores = cores.size() - serial_io_cores;
+    for (size_t c = console_cores; c < cores.size(); c++){
+        for (size_t processor : cores[c].siblings){
+            layout.serial_io.emplace_back(processor);
+        }
+    }
+    std::sort(layout.serial_io.begin(), layout.serial_io.end());
+
+    console_groups = std::max<size_t>(std::min(console_groups, console_cores), 1);
+
+    //  Cores per NUMA node. (in order)
+    std::vector<std::pair<size_t, size_t>> nodes;   //  (first core, # of cores)
+    for (size_t c = 0; c < console_cores; c++){
+        if (nodes.empty() || cores[c].node != cores[nodes.back().first].node){
+            nodes.emplace_back(c, 0);
+        }
+        nodes.back().second++;
+    }
+
+    //  Give each node a share of the groups proportional to its cores so
+    //  that no group spans two nodes. If there are fewer groups than nodes,
+    //  that isn't possible. Treat everything as one node.
+    std::vector<size_t> groups_per_node;
+    if (console_groups < nodes.size()){
+        nodes.assign(1, std::make_pair(0, console_cores));
+        groups_per_node.emplace_back(console_groups);
+    }else{
+        size_t assigned = 0;
+        for (const auto& node : nodes){
+            size_t groups = std::max<size_t>(console_groups * node.second / console_cores, 1);
+            groups = std::min(groups, node.second);
+            groups_per_node.emplace_back(groups);
+            assigned += groups;
+        }
+        //  Hand out the rest (or take back the excess) starting from the
+        //  node with the most cores per group.
+        while (assigned != console_groups){
+            size_t best = 0;
+            double best_ratio = assigned < console_groups ? -1 : 1e300;
+            for (size_t n = 0; n < nodes.size(); n++){
+                double ratio = (double)nodes[n].second / groups_per_node[n];
+                if (assigned < console_groups
+                    ? groups_per_node[n] < nodes[n].second && ratio > best_ratio
+                    : groups_per_node[n] > 1 && ratio < best_ratio
+                ){
+                    best = n;
+                    best_ratio = ratio;
+                }
+            }
+            if (assigned < console_groups){
+                groups_per_node[best]++;
+                assigned++;
+            }else{
+                groups_per_node[best]--;
+                assigned--;
+            }
+        }
+    }
+
+    for (size_t n = 0; n < nodes.size(); n++){
+        size_t first = nodes[n].first;
+        size_t count = nodes[n].second;
+        size_t groups = groups_per_node[n];
+        for (size_t g = 0; g < groups; g++){
+            size_t start = first + g * count / groups;
+            size_t end = first + (g + 1) * count / groups;
+            std::vector<size_t> group;
+            for (size_t c = start; c < end; c++){
+                const std::vector<size_t>& siblings = cores[c].siblings;
+                if (separate_smt_siblings){
+                    group.emplace_back(siblings[0]);
+                }else{
+                    group.insert(group.end(), siblings.begin(), siblings.end());
+                }
+            }
+            std::sort(group.begin(), group.end());
+            layout.consoles.emplace_back(std::move(group));
+        }
+    }
+
+    layout.enabled = true;
+    return layout;
+}
+
+
+struct PolicyState{
+    AffinityLayout layout;
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> placement[MAX_PLACEMENT_GROUPS][PLACEMENT_WORDS] = {};
+
+    static PolicyState& instance(){
+        static PolicyState state;
+        return state;
+    }
+
+    PolicyState(){
+        const ThreadAffinityOption& option = PerformanceOptions::instance().THREAD_AFFINITY;
+        if (!option.enabled()){
+            return;
+        }
+
+        Logger& logger = global_logger_tagged();
+        layout = build_layout(
+            logical_processors(),
+            option.CONSOLE_GROUPS,
+            option.SERIAL_IO_CORES,
+            option.SEPARATE_SMT_SIBLINGS
+        );
+        if (!layout.enabled){
+            logger.log("Thread Affinity: Not enough cores to separate. Threads will not be pinned.", COLOR_ORANGE);
+            return;
+        }
+
+        std::string str = "Thread Affinity:";
+        for (size_t c = 0; c < layout.consoles.size(); c++){
+            str += "\n    Console Group " + std::to_string(c) + ": " + processor_list_to_string(layout.consoles[c]);
+        }
+        str += "\n    Serial I/O: ";
+        str += layout.serial_io.empty()
+            ? "Unpinned"
+            : processor_list_to_string(layout.serial_io);
+        logger.log(str, COLOR_BLUE);
+    }
+};
+
+thread_local ThreadAffinityGroup t_current_group;
+
+}
+
+
+
+bool enabled(){
+    return PolicyState::instance().layout.enabled;
+}
+
+const std::vector<size_t>& processors(ThreadAffinityGroup group){
+    static const std::vector<size_t> UNRESTRICTED;
+    const AffinityLayout& layout = PolicyState::instance().layout;
+    size_t id = group.id();
+    if (!layout.enabled || id == 0){
+        return UNRESTRICTED;
+    }
+    if (id == 1){
+        return layout.serial_io;
+    }
+    return layout.consoles[(id - 2) % layout.consoles.size()];
+}
+
+
+void pin_this_thread(ThreadAffinityGroup group) noexcept{
+    if (t_current_group == group){
+        return;
+    }
+    t_current_group = group;
+    try{
+        PolicyState& state = PolicyState::instance();
+        if (!state.layout.enabled || state.failed.load(std::memory_order_relaxed)){
+            return;
+        }
+        if (set_this_thread_affinity(processors(group))){
+            return;
+        }
+        if (!state.failed.exchange(true)){
+            global_logger_tagged().log("Thread Affinity: Unable to set thread affinity. Threads will not be pinned.", COLOR_RED);
+        }
+    }catch (...){}
+}
+ThreadAffinityGroup this_thread_group() noexcept{
+    return t_current_group;
+}
+
+
+void report_placement() noexcept{
+    int processor = current_processor();
+    if (processor < 0 || (size_t)processor >= MAX_PLACEMENT_PROCESSORS){
+        return;
+    }
+    std::atomic<uint64_t>& word = PolicyState::instance().placement
+        [t_current_group.id() % MAX_PLACEMENT_GROUPS]
+        [(size_t)processor / 64];
+    uint64_t bit = (uint64_t)1 << (processor % 64);
+
+    //  Avoid the write if it's already set. This is almost always the case.
+    if ((word.load(std::memory_order_relaxed) & bit) == 0){
+        word.fetch_or(bit, std::memory_order_relaxed);
+    }
+}
+std::vector<size_t> take_placement(ThreadAffinityGroup group){
+    std::atomic<uint64_t>* words = PolicyState::instance().placement[group.id() % MAX_PLACEMENT_GROUPS];
+    std::vector<size_t> ret;
+    for (size_t w = 0; w < PLACEMENT_WORDS; w++){
+        uint64_t bits = words[w].exchange(0, std::memory_order_relaxed);
+        for (size_t b = 0; b < 64; b++){
+            if (bits & ((uint64_t)1 << b)){
+                ret.emplace_back(w * 64 + b);
+            }
+        }
+    }
+    return ret;
+}
+
+
+
+}
+}
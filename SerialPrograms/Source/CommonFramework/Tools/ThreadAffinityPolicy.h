@@ -0,0 +1,97 @@
+/*  Thread Affinity Policy
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Decides which cores each kind of thread runs on. (Settings -> Performance
+ *  -> Thread Affinity)
+ *
+ *  The cores are laid out in NUMA node order. The last SERIAL_IO_CORES
+ *  physical cores go to serial I/O threads. The rest are cut into
+ *  CONSOLE_GROUPS contiguous groups so each console stays on one node when
+ *  possible.
+ *
+ *  Threads in shared pools are pinned when they pick up work for a console.
+ *  Pinning is remembered per thread so pinning again to the same group is
+ *  free. If the option is off, everything here does nothing except record
+ *  placement.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ThreadAffinityPolicy_H
+#define PokemonAutomation_CommonFramework_ThreadAffinityPolicy_H
+
+#include <stddef.h>
+#include <vector>
+
+namespace PokemonAutomation{
+
+
+class ThreadAffinityGroup{
+public:
+    //  No restriction.
+    ThreadAffinityGroup() : m_id(0) {}
+
+    static ThreadAffinityGroup serial_io(){ return ThreadAffinityGroup(1); }
+    static ThreadAffinityGroup console(size_t index){ return ThreadAffinityGroup(2 + index); }
+
+    bool operator==(const ThreadAffinityGroup& x) const{ return m_id == x.m_id; }
+    bool operator!=(const ThreadAffinityGroup& x) const{ return m_id != x.m_id; }
+
+    size_t id() const{ return m_id; }
+
+private:
+    explicit ThreadAffinityGroup(size_t id) : m_id(id) {}
+
+    size_t m_id;
+};
+
+
+namespace ThreadAffinityPolicy{
+
+
+bool enabled();
+
+//  The cores assigned to this group. Empty means unrestricted.
+const std::vector<size_t>& processors(ThreadAffinityGroup group);
+
+//  Move the current thread to this group.
+void pin_this_thread(ThreadAffinityGroup group) noexcept;
+ThreadAffinityGroup this_thread_group() noexcept;
+
+
+//  Record which core the current thread is on under its current group.
+//  Call this from hot loops. It's cheap.
+void report_placement() noexcept;
+
+//  Cores reported for this group since the last call. Sorted.
+std::vector<size_t> take_placement(ThreadAffinityGroup group);
+
+
+}
+
+
+
+//  Pin the current thread for the lifetime of this object, then restore.
+//  Use this for work dispatched to a shared pool on behalf of a group.
+class ScopedThreadAffinity{
+public:
+    ScopedThreadAffinity(ThreadAffinityGroup group) noexcept
+        : m_previous(ThreadAffinityPolicy::this_thread_group())
+    {
+        ThreadAffinityPolicy::pin_this_thread(group);
+    }
+    ~ScopedThreadAffinity(){
+        ThreadAffinityPolicy::pin_this_thread(m_previous);
+    }
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+    void operator=(const ScopedThreadAffinity&) = delete;
+
+private:
+    ThreadAffinityGroup m_previous;
+};
+
+
+
+
+}
+#endif
@@ -40,9 +40,9 @@ bool VideoStream::save_stream_history(const std::string& filename){
 }
 
 
-void VideoStream::initialize_inference_threads(CancellableScope& scope){
-    m_video_pivot.reset(scope, m_video);
-    m_audio_pivot.reset(scope, m_audio);
+void VideoStream::initialize_inference_threads(CancellableScope& scope, ThreadAffinityGroup affinity){
+    m_video_pivot.reset(scope, m_video, affinity);
+    m_audio_pivot.reset(scope, m_audio, affinity);
     m_overlay.add_stat(*m_video_pivot);
     m_overlay.add_stat(*m_audio_pivot);
 }
@@ -20,6 +20,7 @@
 #include <string>
 #include "Common/Cpp/Logging/AbstractLogger.h"
 #include "Common/Cpp/Containers/Pimpl.h"
+#include "CommonFramework/Tools/ThreadAffinityPolicy.h"
 
 namespace PokemonAutomation{
 
@@ -72,7 +73,11 @@ public:
 
 
 public:
-    void initialize_inference_threads(CancellableScope& scope);
+    //  The inference threads run on the cores of "affinity".
+    void initialize_inference_threads(
+        CancellableScope& scope,
+        ThreadAffinityGroup affinity = ThreadAffinityGroup()
+    );
 
 
 private:
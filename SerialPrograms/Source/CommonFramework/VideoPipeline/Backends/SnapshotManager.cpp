@@ -6,8 +6,12 @@
 
 //#include "Common/Cpp/Concurrency/ReverseLockGuard.h"
 #include "Common/Cpp/Concurrency/AsyncTask.h"
+#include "Common/Cpp/Concurrency/SpinPause.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/ImageTypes/ImageRGB32_Qt.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/ThreadAffinityPolicy.h"
+#include "CommonFramework/Tools/TelemetryRecorder.h"
 #include "SnapshotManager.h"
 
 //#include <iostream>
@@ -22,13 +26,17 @@ namespace PokemonAutomation{
 SnapshotManager::~SnapshotManager(){
     std::unique_lock<Mutex> lg(m_lock);
     m_cv.wait(lg, [this]{
-        cleanup();
+        ObjectsToGC objects_to_gc;
+        cleanup(objects_to_gc);
         return m_pending_conversions.empty();
     });
 }
 SnapshotManager::SnapshotManager(Logger& logger, QVideoFrameCache& cache)
     : m_logger(logger)
     , m_cache(cache)
+    , m_queued_convert(false)
+    , m_requested_seqnum(0)
+    , m_latest_slot(SNAPSHOT_SLOTS)
     , m_stats_conversion("ConvertFrame", "ms", 1000, std::chrono::seconds(10))
 {}
 
@@ -42,6 +50,9 @@ QImage SnapshotManager::frame_to_image(const QVideoFrame& frame){
     return image;
 }
 VideoSnapshot SnapshotManager::convert(QVideoFrame frame, WallClock timestamp) noexcept{
+    PA_TRACE_SCOPE("SnapshotManager::convert");
+    static TelemetryChannel& telemetry = TelemetryRecorder::instance().channel("Video/Snapshot Conversion (ms)");
+
     VideoSnapshot snapshot;
     snapshot.timestamp = timestamp;
     try{
@@ -50,6 +61,7 @@ VideoSnapshot SnapshotManager::convert(QVideoFrame frame, WallClock timestamp) n
             QImage_to_ImageRGB32(frame_to_image(frame))
         );
         WallClock time1 = current_time();
+        telemetry.record(time1 - time0);
         WriteSpinLock lg(m_stats_lock);
         m_stats_conversion.report_data(
             m_logger,
@@ -70,15 +82,14 @@ void SnapshotManager::convert(uint64_t seqnum, QVideoFrame frame, WallClock time
         std::lock_guard<Mutex> lg(m_lock);
 //        cout << "SnapshotManager::convert() - post convert: " << seqnum << endl;
 
-        push_new_screenshot(seqnum, std::move(snapshot));
+        publish_snapshot(seqnum, std::move(snapshot), objects_to_gc);
 
-        if (m_queued_convert){
-            m_queued_convert = false;
+        if (m_queued_convert.exchange(false, std::memory_order_relaxed)){
             seqnum = m_cache.get_latest(frame, timestamp);
             dispatch_conversion(seqnum, std::move(frame), timestamp);
         }
 
-        objects_to_gc = cleanup();
+        cleanup(objects_to_gc);
     }
     objects_to_gc.destroy_now();
 
@@ -87,6 +98,12 @@ void SnapshotManager::convert(uint64_t seqnum, QVideoFrame frame, WallClock time
 bool SnapshotManager::try_dispatch_conversion(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept{
     //  Must call under the lock.
 
+    //  Already converted.
+    size_t latest = m_latest_slot.load(std::memory_order_relaxed);
+    if (latest < SNAPSHOT_SLOTS && m_slots[latest].seqnum >= seqnum){
+        return false;
+    }
+
     AsyncTask* task;
     try{
         task = &m_pending_conversions[seqnum];
@@ -100,7 +117,12 @@ bool SnapshotManager::try_dispatch_conversion(uint64_t seqnum, QVideoFrame frame
     }
 
     try{
+        //  Run the conversion on the cores of whoever asked for it. (usually
+        //  the console's inference pivot)
+        ThreadAffinityGroup affinity = ThreadAffinityPolicy::this_thread_group();
         std::function<void()> lambda = [=, this, frame = std::move(frame)](){
+            ScopedThreadAffinity scope(affinity);
+            ThreadAffinityPolicy::report_placement();
             convert(seqnum, std::move(frame), timestamp);
         };
 
@@ -112,7 +134,7 @@ bool SnapshotManager::try_dispatch_conversion(uint64_t seqnum, QVideoFrame frame
         }
 
         //  Dispatch failed. Queue it for later.
-        m_queued_convert = true;
+        m_queued_convert.store(true, std::memory_order_relaxed);
     }catch (...){}
 
     m_pending_conversions.erase(seqnum);
@@ -124,30 +146,128 @@ void SnapshotManager::dispatch_conversion(uint64_t seqnum, QVideoFrame frame, Wa
     //  Must call under the lock.
     try_dispatch_conversion(seqnum, std::move(frame), timestamp);
 }
+void SnapshotManager::request_conversion(uint64_t seqnum) noexcept{
+    //  "m_requested_seqnum" is stored as seqnum + 1 so that zero means
+    //  nothing has been requested.
+    uint64_t previous = m_requested_seqnum.load(std::memory_order_relaxed);
+    do{
+        if (previous > seqnum){
+            return;
+        }
+    }while (!m_requested_seqnum.compare_exchange_weak(previous, seqnum + 1, std::memory_order_relaxed));
+
+    //  We own this frame. Dispatch it if nobody is holding the lock.
+    std::unique_lock<Mutex> lg(m_lock, std::try_to_lock);
+    if (lg.owns_lock()){
+        QVideoFrame frame;
+        WallClock timestamp;
+        uint64_t latest = m_cache.get_latest(frame, timestamp);
+        try_dispatch_conversion(latest, std::move(frame), timestamp);
+        if (!m_queued_convert.load(std::memory_order_relaxed)){
+            return;
+        }
+    }else{
+        m_queued_convert.store(true, std::memory_order_relaxed);
+    }
+
+    //  Couldn't dispatch it. Give up the claim so the next reader tries again.
+    uint64_t expected = seqnum + 1;
+    m_requested_seqnum.compare_exchange_strong(expected, previous, std::memory_order_relaxed);
+}
+
+
+bool SnapshotManager::read_latest(uint64_t& seqnum, VideoSnapshot& snapshot) const noexcept{
+    while (true){
+        size_t index = m_latest_slot.load(std::memory_order_acquire);
+        if (index >= SNAPSHOT_SLOTS){
+            return false;
+        }
+        SnapshotSlot& slot = m_slots[index];
+
+        uint64_t generation = slot.generation.load(std::memory_order_acquire);
+        if (generation == 0){
+            //  The slot is being reused. The latest slot has moved on.
+            pause();
+            continue;
+        }
+
+        slot.readers.fetch_add(1, std::memory_order_seq_cst);
+        if (slot.generation.load(std::memory_order_seq_cst) == generation){
+            seqnum = slot.seqnum;
+            snapshot = slot.snapshot;
+            slot.readers.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+        slot.readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+bool SnapshotManager::publish_snapshot(uint64_t seqnum, VideoSnapshot snapshot, ObjectsToGC& objects_to_gc){
+    //  Must call under the lock.
 
-bool SnapshotManager::push_new_screenshot(uint64_t seqnum, VideoSnapshot snapshot){
-    if (!m_converted_snapshot_archive.empty() && m_converted_snapshot_archive.rbegin()->first > seqnum){
+    size_t latest = m_latest_slot.load(std::memory_order_relaxed);
+    if (latest < SNAPSHOT_SLOTS && m_slots[latest].seqnum > seqnum){
+        objects_to_gc.snapshots_to_free.emplace_back(std::move(snapshot));
         return false;
     }
-    m_converted_snapshot_archive[seqnum] = snapshot;
-    return true;
+
+    //  Prefer a slot that only we reference so its old snapshot is freed
+    //  here. Never touch the latest slot since readers are on it.
+    while (true){
+        for (size_t pass = 0; pass < 2; pass++){
+            for (size_t c = 1; c <= SNAPSHOT_SLOTS; c++){
+                size_t index = (latest + c) % SNAPSHOT_SLOTS;
+                if (index == latest){
+                    continue;
+                }
+                SnapshotSlot& slot = m_slots[index];
+                if (pass == 0 && slot.snapshot.frame.use_count() > 1){
+                    continue;
+                }
+
+                //  Claim the slot. Back off if a reader got there first.
+                uint64_t generation = slot.generation.load(std::memory_order_relaxed);
+                slot.generation.store(0, std::memory_order_seq_cst);
+                if (slot.readers.load(std::memory_order_seq_cst) != 0){
+                    slot.generation.store(generation, std::memory_order_release);
+                    continue;
+                }
+
+                if (slot.snapshot.frame){
+                    if (slot.snapshot.frame.use_count() <= 1){
+                        objects_to_gc.snapshots_to_free.emplace_back(std::move(slot.snapshot));
+                    }else{
+                        m_retained_snapshots.emplace_back(std::move(slot.snapshot));
+                    }
+                }
+
+                slot.seqnum = seqnum;
+                slot.snapshot = std::move(snapshot);
+                slot.generation.store(m_next_generation++, std::memory_order_release);
+                m_latest_slot.store(index, std::memory_order_release);
+                return true;
+            }
+        }
+
+        //  Every other slot is being read. This only lasts a few instructions.
+        pause();
+    }
 }
+
+
 void SnapshotManager::ObjectsToGC::destroy_now(){
     tasks_to_free.clear();
     snapshots_to_free.clear();
 }
-SnapshotManager::ObjectsToGC SnapshotManager::cleanup(){
+void SnapshotManager::cleanup(ObjectsToGC& objects_to_gc){
     //  Must call under the lock!
 
-    //  Grab and return all objects that are ready to be garbage collected.
-
-    ObjectsToGC ret;
+    //  Grab all objects that are ready to be garbage collected.
 
     //  Cleanup finished tasks.
     while (!m_pending_conversions.empty()){
         auto iter = m_pending_conversions.begin();
         if (iter->second.is_finished()){
-            ret.tasks_to_free.emplace_back(std::move(iter->second));
+            objects_to_gc.tasks_to_free.emplace_back(std::move(iter->second));
             m_pending_conversions.erase(iter);
             m_cv.notify_all();
         }else{
@@ -155,78 +275,89 @@ SnapshotManager::ObjectsToGC SnapshotManager::cleanup(){
         }
     }
 
-    //  Walk through the snapshot archive and clear out everything with only
-    //  one reference. But leave behind the latest screenshot.
+    //  Clear out every old snapshot that only we reference. But leave behind
+    //  the latest screenshot.
 
-    if (m_converted_snapshot_archive.size() <= 1){
-        return ret;
-    }
+    size_t latest = m_latest_slot.load(std::memory_order_relaxed);
+    for (size_t index = 0; index < SNAPSHOT_SLOTS; index++){
+        SnapshotSlot& slot = m_slots[index];
+        if (index == latest || !slot.snapshot.frame || slot.snapshot.frame.use_count() > 1){
+            continue;
+        }
 
-    auto stop = m_converted_snapshot_archive.end();
-    --stop;
+        //  Leave the generation at zero so nobody reads it until it's reused.
+        uint64_t generation = slot.generation.load(std::memory_order_relaxed);
+        slot.generation.store(0, std::memory_order_seq_cst);
+        if (slot.readers.load(std::memory_order_seq_cst) != 0){
+            slot.generation.store(generation, std::memory_order_release);
+            continue;
+        }
 
-    for (auto iter = m_converted_snapshot_archive.begin(); iter != stop;){
-        if (iter->second.frame.use_count() <= 1){
-            ret.snapshots_to_free.emplace_back(std::move(iter->second));
-            iter = m_converted_snapshot_archive.erase(iter);
+        //  A reader may have copied the snapshot between the check above and
+        //  claiming the slot. If so, leave it for the next cleanup.
+        if (slot.snapshot.frame.use_count() > 1){
+            slot.generation.store(generation, std::memory_order_release);
+            continue;
+        }
+        objects_to_gc.snapshots_to_free.emplace_back(std::move(slot.snapshot));
+        slot.snapshot.frame.reset();
+    }
+
+    for (auto iter = m_retained_snapshots.begin(); iter != m_retained_snapshots.end();){
+        if (iter->frame.use_count() <= 1){
+            objects_to_gc.snapshots_to_free.emplace_back(std::move(*iter));
+            iter = m_retained_snapshots.erase(iter);
         }else{
             ++iter;
         }
     }
-
-    return ret;
 }
 
 
 VideoSnapshot SnapshotManager::snapshot_latest_blocking(){
-    ObjectsToGC objects_to_gc;
+    //  Already up-to-date. Return it.
     {
-        std::unique_lock<Mutex> lg(m_lock);
-        objects_to_gc = cleanup();
+        uint64_t seqnum = m_cache.seqnum();
+        uint64_t published;
+        VideoSnapshot snapshot;
+        if (read_latest(published, snapshot) && seqnum <= published){
+//            cout << "snapshot_latest_blocking(): Cached" << endl;
+            return snapshot;
+        }
     }
-    objects_to_gc.destroy_now();
 
+    ObjectsToGC objects_to_gc;
     VideoSnapshot snapshot;
     bool notify = false;
     {
         std::unique_lock<Mutex> lg(m_lock);
+        cleanup(objects_to_gc);
 
 //        cout << "snapshot_latest_blocking()" << endl;
 
-        //  Already up-to-date. Return it.
         uint64_t seqnum = m_cache.seqnum();
-        if (!m_converted_snapshot_archive.empty()){
-            auto iter = m_converted_snapshot_archive.rbegin();
-            if (seqnum <= iter->first){
-//                cout << "snapshot_latest_blocking(): Cached" << endl;
-                return iter->second;
-            }
-        }
-
-        //  Check if we're already converting it.
-        if (!m_pending_conversions.empty() && m_pending_conversions.rbegin()->first >= seqnum){
+        uint64_t published;
+        if (read_latest(published, snapshot) && seqnum <= published){
+            //  Finished while we were waiting for the lock.
+        }else if (!m_pending_conversions.empty() && m_pending_conversions.rbegin()->first >= seqnum){
+            //  Already converting it. Wait for it.
 //            cout << "snapshot_latest_blocking(): Already Converting" << endl;
-            while (true){
-                std::map<uint64_t, VideoSnapshot>::reverse_iterator iter = m_converted_snapshot_archive.rbegin();
-                if (iter->first >= seqnum){
-                    return iter->second;
-                }
-                m_cv.wait(lg);
-            }
-        }
-
-
-        //  Otherwise, we use this thread to convert the latest frame.
-//        cout << "snapshot_latest_blocking(): Convert Now" << endl;
-
-        QVideoFrame frame;
-        WallClock timestamp;
-        seqnum = m_cache.get_latest(frame, timestamp);
+            m_cv.wait(lg, [&]{
+                return read_latest(published, snapshot) && published >= seqnum;
+            });
+        }else{
+            //  Otherwise, we use this thread to convert the latest frame.
+//            cout << "snapshot_latest_blocking(): Convert Now" << endl;
+            QVideoFrame frame;
+            WallClock timestamp;
+            seqnum = m_cache.get_latest(frame, timestamp);
 
-        notify = push_new_screenshot(seqnum, convert(std::move(frame), timestamp));
+            notify = publish_snapshot(seqnum, convert(std::move(frame), timestamp), objects_to_gc);
 
-        snapshot = m_converted_snapshot_archive.rbegin()->second;
+            read_latest(published, snapshot);
+        }
     }
+    objects_to_gc.destroy_now();
 
     if (notify){
         m_cv.notify_all();
@@ -237,56 +368,33 @@ VideoSnapshot SnapshotManager::snapshot_latest_blocking(){
 }
 
 VideoSnapshot SnapshotManager::snapshot_recent_nonblocking(WallClock min_time){
-//    WallClock now = current_time();
+    //  This is called by every inference callback. It must not take the lock.
 
-    std::lock_guard<Mutex> lg(m_lock);
+    uint64_t seqnum = m_cache.seqnum();
+    uint64_t published;
+    VideoSnapshot snapshot;
+    bool have_snapshot = read_latest(published, snapshot);
 
     //  Already up-to-date. Return it.
-    uint64_t seqnum = m_cache.seqnum();
-    if (!m_converted_snapshot_archive.empty()){
-        auto iter = m_converted_snapshot_archive.rbegin();
-        if (seqnum <= iter->first){
-//            cout << "snapshot_latest_blocking(): Cached" << endl;
-            return iter->second;
-        }
+    if (have_snapshot && seqnum <= published){
+        return snapshot;
     }
 
-    QVideoFrame frame;
-    WallClock timestamp;
-    seqnum = m_cache.get_latest(frame, timestamp);
-
     //  Dispatch this frame for conversion.
-    dispatch_conversion(seqnum, std::move(frame), timestamp);
+    request_conversion(seqnum);
 
     //  No cached snapshot.
-    if (m_converted_snapshot_archive.empty()){
+    if (!have_snapshot){
         return VideoSnapshot();
     }
 
     //  Cached snapshot is too old.
-    auto iter = m_converted_snapshot_archive.rbegin();
-    if (min_time > iter->second.timestamp){
+    if (min_time > snapshot.timestamp){
         return VideoSnapshot();
     }
 
-    return iter->second;
+    return snapshot;
 }
 
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 }
@@ -8,6 +8,7 @@
 #define PokemonAutomation_VideoPipeline_SnapshotManager_H
 
 #include <map>
+#include <atomic>
 #include "Common/Cpp/Concurrency/Mutex.h"
 #include "Common/Cpp/Concurrency/ConditionVariable.h"
 #include "Common/Cpp/Logging/AbstractLogger.h"
@@ -19,6 +20,14 @@ namespace PokemonAutomation{
 
 class AsyncTask;
 
+
+//
+//  Converts frames from the QVideoFrameCache into VideoSnapshots on demand.
+//
+//  Converted snapshots are published into a small ring of slots. Readers
+//  (the inference threads) copy the latest one out without taking a lock.
+//  Only the conversion threads and snapshot_latest_blocking() take the lock.
+//
 class SnapshotManager{
 public:
     ~SnapshotManager();
@@ -35,15 +44,24 @@ private:
     bool try_dispatch_conversion(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept;
     void dispatch_conversion(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept;
 
-    bool push_new_screenshot(uint64_t seqnum, VideoSnapshot snapshot);
-
     struct ObjectsToGC{
         std::vector<AsyncTask> tasks_to_free;
         std::vector<VideoSnapshot> snapshots_to_free;
 
         void destroy_now();
     };
-    ObjectsToGC cleanup();
+    void cleanup(ObjectsToGC& objects_to_gc);
+
+    //  Lock-free. Returns false if nothing has been published yet.
+    bool read_latest(uint64_t& seqnum, VideoSnapshot& snapshot) const noexcept;
+
+    //  Must call under the lock. Returns false if a newer snapshot is
+    //  already published.
+    bool publish_snapshot(uint64_t seqnum, VideoSnapshot snapshot, ObjectsToGC& objects_to_gc);
+
+    //  Called by readers that see a newer frame than what's published.
+    //  Never blocks. Only one reader per frame will dispatch it.
+    void request_conversion(uint64_t seqnum) noexcept;
 
 private:
     Logger& m_logger;
@@ -53,13 +71,33 @@ private:
     ConditionVariable m_cv;
 
     std::map<uint64_t, AsyncTask> m_pending_conversions;
-    bool m_queued_convert = false;
-
-    //  Keep an archive of older snapshots. The idea here is that we don't want
-    //  snapshots to be destroyed in other places (such as the video pivot)
-    //  because it's expensive. So instead, we keep a reference here which we
-    //  will periodically clear out on the conversion threads.
-    std::map<uint64_t, VideoSnapshot> m_converted_snapshot_archive;
+    std::atomic<bool> m_queued_convert;
+
+    //  Highest seqnum a reader has claimed for dispatch.
+    std::atomic<uint64_t> m_requested_seqnum;
+
+    //  Published snapshots.
+    //
+    //  A reader bumps "readers" then checks that "generation" hasn't changed.
+    //  A writer clears "generation" then checks that "readers" is zero before
+    //  touching the slot. One of them always sees the other. Generation zero
+    //  means the slot can't be read.
+    struct SnapshotSlot{
+        std::atomic<uint64_t> generation{0};
+        std::atomic<uint32_t> readers{0};
+        uint64_t seqnum = 0;
+        VideoSnapshot snapshot;
+    };
+    static constexpr size_t SNAPSHOT_SLOTS = 4;
+    mutable SnapshotSlot m_slots[SNAPSHOT_SLOTS];
+    std::atomic<size_t> m_latest_slot;
+    uint64_t m_next_generation = 1;
+
+    //  We don't want snapshots to be destroyed in other places (such as the
+    //  video pivot) because it's expensive. So snapshots that are still
+    //  referenced when their slot is reused are kept here and cleared out
+    //  on the conversion threads once we hold the last reference.
+    std::vector<VideoSnapshot> m_retained_snapshots;
 
     SpinLock m_stats_lock;
     PeriodicStatsReporterI32 m_stats_conversion;
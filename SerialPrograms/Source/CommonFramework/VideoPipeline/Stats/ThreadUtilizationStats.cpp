@@ -5,6 +5,8 @@
  */
 
 //#include "Common/Cpp/PrettyPrint.h"
+#include <algorithm>
+#include "Common/Cpp/CpuAffinity/CpuAffinity.h"
 #include "Common/Cpp/Concurrency/ThreadPool.h"
 #include "ThreadUtilizationStats.h"
 
@@ -71,5 +73,56 @@ OverlayStatSnapshot ThreadPoolUtilizationStat::get_current(){
 
 
 
+ThreadPlacementStat::ThreadPlacementStat(ThreadAffinityGroup group, std::string label)
+    : m_group(group)
+    , m_label(std::move(label))
+    , m_window_start(current_time())
+{
+    ThreadAffinityPolicy::take_placement(m_group);
+}
+
+OverlayStatSnapshot ThreadPlacementStat::get_current(){
+    //  Placement changes quickly. Show the union over 1 second windows.
+    const std::chrono::seconds WINDOW(1);
+
+    std::lock_guard<Mutex> lg(m_lock);
+
+    for (size_t processor : ThreadAffinityPolicy::take_placement(m_group)){
+        m_window.emplace_back(processor);
+    }
+
+    WallClock now = current_time();
+    if (now - m_window_start < WINDOW){
+        return m_last;
+    }
+    m_window_start = now;
+
+    std::sort(m_window.begin(), m_window.end());
+    m_window.erase(std::unique(m_window.begin(), m_window.end()), m_window.end());
+    if (m_window.empty()){
+        m_last = OverlayStatSnapshot();
+        return m_last;
+    }
+
+    const std::vector<size_t>& assigned = ThreadAffinityPolicy::processors(m_group);
+    bool outside = !assigned.empty() && !std::includes(
+        assigned.begin(), assigned.end(),
+        m_window.begin(), m_window.end()
+    );
+
+    std::string text = m_label;
+    if (!assigned.empty()){
+        text += " " + processor_list_to_string(assigned) + " |";
+    }
+    text += " On: " + processor_list_to_string(m_window);
+
+    m_last = OverlayStatSnapshot{std::move(text), outside ? COLOR_ORANGE : COLOR_WHITE};
+    m_window.clear();
+    return m_last;
+}
+
+
+
+
 
 }
@@ -11,6 +11,7 @@
 #include "Common/Cpp/EventRateTracker.h"
 #include "Common/Cpp/Concurrency/Mutex.h"
 #include "Common/Cpp/CpuUtilization/CpuUtilization.h"
+#include "CommonFramework/Tools/ThreadAffinityPolicy.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
 
 namespace PokemonAutomation{
@@ -56,6 +57,25 @@ private:
 };
 
 
+//  Which cores the threads of an affinity group actually ran on. Shown in
+//  orange if any of them ran outside the cores assigned to the group.
+class ThreadPlacementStat : public OverlayStat{
+public:
+    ThreadPlacementStat(ThreadAffinityGroup group, std::string label);
+
+    virtual OverlayStatSnapshot get_current() override;
+
+private:
+    const ThreadAffinityGroup m_group;
+    std::string m_label;
+
+    Mutex m_lock;
+    WallClock m_window_start;
+    std::vector<size_t> m_window;
+    OverlayStatSnapshot m_last;
+};
+
+
 
 
 }
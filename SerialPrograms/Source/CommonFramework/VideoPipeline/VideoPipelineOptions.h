@@ -42,11 +42,20 @@ public:
             5
 #endif
         )
+        , FRAME_DRIVEN_INFERENCE(
+            "<b>Frame-Driven Inference:</b><br>"
+            "Run visual inference as soon as a new video frame arrives instead of polling at fixed intervals. "
+            "Each detector still runs at most once per frame and no faster than its own period.<br>"
+            "This option is not supported by all video frameworks. Unsupported frameworks will keep polling.",
+            LockMode::LOCK_WHILE_RUNNING,
+            false
+        )
     {
         PA_ADD_OPTION(SHOW_ALL_FPS);
         PA_ADD_OPTION(VIDEO_BACKEND);
 
         PA_ADD_OPTION(AUTO_RESET_SECONDS);
+        PA_ADD_OPTION(FRAME_DRIVEN_INFERENCE);
     }
 
 public:
@@ -54,6 +63,7 @@ public:
     VideoBackendOption VIDEO_BACKEND;
 
     SimpleIntegerOption<uint8_t> AUTO_RESET_SECONDS;
+    BooleanCheckBoxOption FRAME_DRIVEN_INFERENCE;
 };
 
 
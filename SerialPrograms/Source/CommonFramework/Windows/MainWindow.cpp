@@ -14,10 +14,12 @@
 #include <QPushButton>
 #include <QMessageBox>
 #include "Common/Cpp/ScopeExit.h"
+#include "Common/Cpp/PrettyPrint.h"
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Logging/MultiOutputLogger.h"
 #include "Common/Cpp/Filesystem/Filesystem.h"
 #include "Common/Cpp/CpuId/CpuId.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
@@ -266,6 +268,24 @@ MainWindow::MainWindow(QWidget* parent)
             }
         );
     }
+#ifdef PA_ENABLE_TRACING
+    {
+        QPushButton* trace = new QPushButton("Save Trace", support_box);
+        buttons->addWidget(trace);
+        connect(
+            trace, &QPushButton::clicked,
+            this, [](bool){
+                Filesystem::create_directories(Filesystem::Path(DEBUG_PATH()));
+                std::string path = DEBUG_PATH() + "Trace-" + now_to_filestring() + ".json";
+                if (Tracing::dump_chrome_trace(path)){
+                    global_logger_tagged().log("Saved trace to: " + path, COLOR_BLUE);
+                }else{
+                    global_logger_tagged().log("Unable to save trace to: " + path, COLOR_RED);
+                }
+            }
+        );
+    }
+#endif
 
     QVBoxLayout* right = new QVBoxLayout();
     m_right_panel_layout = right;
@@ -99,11 +99,14 @@ void InferenceSession::clear() noexcept{
             stopper.remove_cancel_listener(*this);
         }
         case InferenceType::VISUAL:{
-            StatAccumulatorI32 stats = m_stream.video_inference_pivot().remove_callback(
+            VisualInferencePivot::CallbackStats stats = m_stream.video_inference_pivot().remove_callback(
                 static_cast<VisualInferenceCallback&>(*item.first)
             );
             try{
-                stats.log(m_stream.logger(), item.first->label(), UNITS, DIVIDER);
+                stats.runtime.log(m_stream.logger(), item.first->label(), UNITS, DIVIDER);
+                if (stats.latency.count() != 0){
+                    stats.latency.log(m_stream.logger(), item.first->label() + " (Frame to Decision)", UNITS, DIVIDER);
+                }
             }catch (...){}
             break;
         }
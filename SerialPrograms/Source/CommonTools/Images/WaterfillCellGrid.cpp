@@ -0,0 +1,272 @@
+/*  Waterfill Cell Grid
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Exceptions.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "Kernels/Waterfill/Kernels_Waterfill_Session.h"
+#include "BinaryImage_FilterRgb32.h"
+#include "WaterfillCellGrid.h"
+
+namespace PokemonAutomation{
+
+using namespace Kernels::Waterfill;
+
+
+
+namespace{
+
+//  Same rounding as extract_box_reference().
+ImagePixelBox cell_pixel_box(const ImageViewRGB32& image, const ImageFloatBox& box){
+    size_t min_x = (size_t)(image.width() * box.x + 0.5);
+    size_t min_y = (size_t)(image.height() * box.y + 0.5);
+    size_t width = (size_t)(image.width() * box.width + 0.5);
+    size_t height = (size_t)(image.height() * box.height + 0.5);
+    return ImagePixelBox(min_x, min_y, min_x + width, min_y + height);
+}
+
+void shift_object(WaterfillObject& object, size_t dx, size_t dy){
+    object.body_x -= dx;
+    object.body_y -= dy;
+    object.min_x -= dx;
+    object.min_y -= dy;
+    object.max_x -= dx;
+    object.max_y -= dy;
+    object.sum_x -= (uint64_t)dx * object.area;
+    object.sum_y -= (uint64_t)dy * object.area;
+}
+
+}
+
+
+
+WaterfillCellGrid::WaterfillCellGrid(std::vector<ImageFloatBox> cells)
+    : m_cells(std::move(cells))
+{
+    for (size_t c = 0; c < m_cells.size(); c++){
+        const ImageFloatBox& cell = m_cells[c];
+        auto iter = std::find_if(
+            m_bands.begin(), m_bands.end(),
+            [&](const Band& band){
+                const ImageFloatBox& first = m_cells[band.cells[0]];
+                return first.y == cell.y && first.height == cell.height;
+            }
+        );
+        if (iter == m_bands.end()){
+            m_bands.emplace_back();
+            iter = m_bands.end() - 1;
+        }
+        iter->cells.emplace_back(c);
+    }
+    for (Band& band : m_bands){
+        std::sort(
+            band.cells.begin(), band.cells.end(),
+            [&](size_t a, size_t b){ return m_cells[a].x < m_cells[b].x; }
+        );
+    }
+}
+
+
+void WaterfillCellGrid::process(
+    const ImageViewRGB32& screen,
+    const std::vector<std::pair<uint32_t, uint32_t>>& filters,
+    size_t min_area
+){
+    m_cell_images.resize(m_cells.size());
+    m_objects.resize(m_cells.size());
+    for (std::vector<WaterfillCellObject>& objects : m_objects){
+        objects.clear();
+    }
+
+    std::vector<ImagePixelBox> boxes(m_cells.size());
+    for (size_t c = 0; c < m_cells.size(); c++){
+        boxes[c] = cell_pixel_box(screen, m_cells[c]);
+        m_cell_images[c] = screen.sub_image(
+            boxes[c].min_x, boxes[c].min_y,
+            boxes[c].width(), boxes[c].height()
+        );
+    }
+
+    std::unique_ptr<WaterfillSession> session = make_WaterfillSession();
+    WaterfillObject object;
+
+    for (const Band& band : m_bands){
+        ImagePixelBox region = boxes[band.cells[0]];
+        for (size_t cell : band.cells){
+            region.merge_with(boxes[cell]);
+        }
+        ImageViewRGB32 image = screen.sub_image(
+            region.min_x, region.min_y,
+            region.width(), region.height()
+        );
+
+        std::vector<PackedBinaryMatrix> matrices = compress_rgb32_to_binary_range(image, filters);
+        for (size_t f = 0; f < matrices.size(); f++){
+            session->set_source(matrices[f]);
+            auto finder = session->make_iterator(min_area);
+            while (finder->find_next(object, false)){
+                size_t min_x = region.min_x + object.min_x;
+                size_t min_y = region.min_y + object.min_y;
+                size_t max_x = region.min_x + object.max_x;
+                size_t max_y = region.min_y + object.max_y;
+
+                //  Right-most cell that starts at or before the object.
+                auto iter = std::upper_bound(
+                    band.cells.begin(), band.cells.end(), min_x,
+                    [&](size_t x, size_t cell){ return x < boxes[cell].min_x; }
+                );
+                if (iter == band.cells.begin()){
+                    continue;
+                }
+                size_t cell = *(iter - 1);
+                const ImagePixelBox& box = boxes[cell];
+
+                //  Exclude everything that touches the cell boundaries.
+                if (min_x <= box.min_x || min_y <= box.min_y ||
+                    max_x >= box.max_x || max_y >= box.max_y
+                ){
+                    continue;
+                }
+
+                shift_object(object, box.min_x - region.min_x, box.min_y - region.min_y);
+                m_objects[cell].emplace_back(WaterfillCellObject{f, object});
+            }
+        }
+    }
+}
+
+
+
+
+class Test_WaterfillCellGrid : public UnitTest{
+public:
+    Test_WaterfillCellGrid()
+        : UnitTest("CommonTools::WaterfillCellGrid - Matches Per-Cell Waterfill")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        const size_t WIDTH = 1280;
+        const size_t HEIGHT = 720;
+        ImageRGB32 image(WIDTH, HEIGHT);
+        image.fill(0xff404040);
+
+        auto fill = [&](size_t x, size_t y, size_t w, size_t h, uint32_t color){
+            for (size_t r = y; r < y + h; r++){
+                for (size_t c = x; c < x + w; c++){
+                    image.pixel(c, r) = color;
+                }
+            }
+        };
+
+        //  A sparse 4 x 6 grid with an odd first row, like a box with a
+        //  party row above it.
+        std::vector<ImageFloatBox> cells;
+        for (size_t row = 0; row < 4; row++){
+            double y = row == 0 ? 0.05 : 0.25 + 0.2 * (row - 1);
+            for (size_t col = 0; col < 6; col++){
+                cells.emplace_back(0.05 + 0.1 * col, y, 0.06, 0.1);
+            }
+        }
+
+        //  Something inside most cells. Different shades so different
+        //  filters pick them up.
+        for (size_t c = 0; c < cells.size(); c++){
+            if (c % 5 == 3){
+                continue;
+            }
+            ImagePixelBox box = cell_pixel_box(image, cells[c]);
+            uint32_t shade = 0x90 + (uint32_t)(c * 7 % 0x60);
+            uint32_t color = 0xff000000 | shade << 16 | shade << 8 | shade;
+            fill(box.min_x + 5 + c % 7, box.min_y + 6, 10 + c % 11, 12 + c % 5, color);
+            if (c % 4 == 0){
+                //  A second, smaller object.
+                fill(box.min_x + 40, box.min_y + 40, 6, 6, 0xffffffff);
+            }
+        }
+
+        //  Touches the left border of a cell.
+        {
+            ImagePixelBox box = cell_pixel_box(image, cells[8]);
+            fill(box.min_x, box.min_y + 30, 8, 8, 0xffffffff);
+        }
+        //  Spans two cells.
+        {
+            ImagePixelBox box = cell_pixel_box(image, cells[15]);
+            fill(box.min_x + 60, box.min_y + 50, 80, 10, 0xffffffff);
+        }
+        //  Outside all cells.
+        fill(20, 690, 20, 20, 0xffffffff);
+
+        const std::vector<std::pair<uint32_t, uint32_t>> FILTERS = {
+            {0xff808080, 0xffffffff},
+            {0xffa0a0a0, 0xffffffff},
+            {0xffe0e0e0, 0xffffffff},
+        };
+        const size_t MIN_AREA = 20;
+
+        WaterfillCellGrid grid(cells);
+        grid.process(image, FILTERS, MIN_AREA);
+
+        size_t total = 0;
+        for (size_t c = 0; c < cells.size(); c++){
+            ImageViewRGB32 crop = extract_box_reference(image, cells[c]);
+            const ImageViewRGB32& grid_crop = grid.cell_image(c);
+            if (crop.width() != grid_crop.width() || crop.height() != grid_crop.height()){
+                return "Cell " + std::to_string(c) + ": Crop mismatch.";
+            }
+
+            std::vector<WaterfillCellObject> expected;
+            std::vector<PackedBinaryMatrix> matrices = compress_rgb32_to_binary_range(crop, FILTERS);
+            for (size_t f = 0; f < matrices.size(); f++){
+                std::unique_ptr<WaterfillSession> session = make_WaterfillSession();
+                session->set_source(matrices[f]);
+                auto finder = session->make_iterator(MIN_AREA);
+                WaterfillObject object;
+                while (finder->find_next(object, false)){
+                    if (object.min_x == 0 || object.min_y == 0 ||
+                        object.max_x >= crop.width() || object.max_y >= crop.height()
+                    ){
+                        continue;
+                    }
+                    expected.emplace_back(WaterfillCellObject{f, object});
+                }
+            }
+
+            const std::vector<WaterfillCellObject>& actual = grid.objects(c);
+            if (actual.size() != expected.size()){
+                return "Cell " + std::to_string(c) + ": Expected " + std::to_string(expected.size()) +
+                    " objects. Got " + std::to_string(actual.size()) + ".";
+            }
+            for (size_t i = 0; i < actual.size(); i++){
+                const WaterfillObject& x = actual[i].object;
+                const WaterfillObject& y = expected[i].object;
+                if (actual[i].filter_index != expected[i].filter_index ||
+                    x.min_x != y.min_x || x.min_y != y.min_y ||
+                    x.max_x != y.max_x || x.max_y != y.max_y ||
+                    x.area != y.area || x.sum_x != y.sum_x || x.sum_y != y.sum_y
+                ){
+                    return "Cell " + std::to_string(c) + ": Object " + std::to_string(i) + " mismatch.";
+                }
+            }
+            total += actual.size();
+        }
+        logger.log("Objects found: " + std::to_string(total));
+        if (total == 0){
+            return "No objects found.";
+        }
+        return true;
+    }
+};
+
+
+
+void add_tests_WaterfillCellGrid(UnitTestDatabase& database){
+    database.add<Test_WaterfillCellGrid>();
+}
+
+
+
+}
@@ -0,0 +1,91 @@
+/*  Waterfill Cell Grid
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Waterfill a grid of cells (box slots, PC slots, etc...) in one pass
+ *  instead of cropping and waterfilling every cell separately.
+ *
+ *  Cells that share the same vertical span form a band. Each band is
+ *  binarized once with all the filters and waterfilled once per filter.
+ *  Every object found is then assigned to the cell that contains it.
+ *
+ *  The result is the same as doing it cell by cell, with one exception:
+ *  An object that is connected to pixels outside its cell is now seen as
+ *  one larger object and is dropped. Cell-by-cell it would have been cut
+ *  at the cell border. Detectors already throw out objects that touch the
+ *  cell border, so this only matters if the connection leaves the cell and
+ *  comes back in.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonTools_WaterfillCellGrid_H
+#define PokemonAutomation_CommonTools_WaterfillCellGrid_H
+
+#include <vector>
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "Kernels/Waterfill/Kernels_Waterfill_Types.h"
+
+namespace PokemonAutomation{
+
+
+
+struct WaterfillCellObject{
+    //  Index into the filters passed to process().
+    size_t filter_index;
+
+    //  Coordinates are relative to cell_image().
+    //  "object.object" is not kept.
+    Kernels::Waterfill::WaterfillObject object;
+};
+
+
+
+class WaterfillCellGrid{
+public:
+    WaterfillCellGrid(std::vector<ImageFloatBox> cells);
+
+    size_t cells() const{ return m_cells.size(); }
+    const ImageFloatBox& cell_box(size_t cell) const{ return m_cells[cell]; }
+
+    //  Binarize and waterfill all the cells of "screen". Objects smaller than
+    //  "min_area" pixels or touching the border of their cell are dropped.
+    //
+    //  "screen" must stay alive until you are done with the results.
+    void process(
+        const ImageViewRGB32& screen,
+        const std::vector<std::pair<uint32_t, uint32_t>>& filters,
+        size_t min_area
+    );
+
+    //  These are only valid after process().
+
+    //  The same crop that extract_box_reference(screen, cell_box(cell)) gives.
+    const ImageViewRGB32& cell_image(size_t cell) const{ return m_cell_images[cell]; }
+
+    //  Objects in "cell", ordered by filter, then in waterfill order.
+    const std::vector<WaterfillCellObject>& objects(size_t cell) const{ return m_objects[cell]; }
+
+
+private:
+    struct Band{
+        //  Into "m_cells". Sorted left to right.
+        std::vector<size_t> cells;
+    };
+
+    std::vector<ImageFloatBox> m_cells;
+    std::vector<Band> m_bands;
+
+    std::vector<ImageViewRGB32> m_cell_images;
+    std::vector<std::vector<WaterfillCellObject>> m_objects;
+};
+
+
+
+void add_tests_WaterfillCellGrid(UnitTestDatabase& database);
+
+
+
+}
+#endif
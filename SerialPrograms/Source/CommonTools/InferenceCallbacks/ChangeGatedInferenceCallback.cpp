@@ -0,0 +1,298 @@
+/*  Change-Gated Inference Callback
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <cmath>
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqr.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "ChangeGatedInferenceCallback.h"
+
+namespace PokemonAutomation{
+
+
+
+BoxSignature::BoxSignature(const ChangeGateConfig& config)
+    : m_boxes(config.boxes)
+    , m_row_step(config.row_step == 0 ? 1 : config.row_step)
+    , m_tolerance((float)config.tolerance)
+{
+    if (!m_boxes.empty()){
+        return;
+    }
+    size_t grid = config.grid_size == 0 ? 1 : config.grid_size;
+    double step = 1. / grid;
+    for (size_t r = 0; r < grid; r++){
+        for (size_t c = 0; c < grid; c++){
+            m_boxes.emplace_back(c * step, r * step, step, step);
+        }
+    }
+}
+
+void BoxSignature::compute(std::vector<Entry>& entries, const ImageViewRGB32& screen) const{
+    entries.resize(m_boxes.size());
+    for (size_t c = 0; c < m_boxes.size(); c++){
+        ImageViewRGB32 region = extract_box_reference(screen, m_boxes[c]);
+        size_t rows = (region.height() + m_row_step - 1) / m_row_step;
+
+        //  Pass the image as its own alpha so that transparent pixels are
+        //  excluded the same way as image_stats().
+        Kernels::PixelSums sums;
+        Kernels::pixel_sum_sqr(
+            sums, region.width(), rows,
+            region.data(), region.bytes_per_row() * m_row_step,
+            region.data(), region.bytes_per_row() * m_row_step
+        );
+
+        Entry& entry = entries[c];
+        if (sums.count == 0){
+            entry = Entry{};
+            continue;
+        }
+
+        double count = (double)sums.count;
+        const uint64_t sum[3] = {sums.sumR, sums.sumG, sums.sumB};
+        const uint64_t sqr[3] = {sums.sqrR, sums.sqrG, sums.sqrB};
+        for (size_t i = 0; i < 3; i++){
+            double average = sum[i] / count;
+            double variance = sqr[i] / count - average * average;
+            entry.average[i] = (float)average;
+            entry.stddev[i] = (float)std::sqrt(variance < 0 ? 0 : variance);
+        }
+    }
+}
+
+bool BoxSignature::matches(const ImageViewRGB32& screen) const{
+    if (m_entries.empty() || screen.width() != m_width || screen.height() != m_height){
+        return false;
+    }
+    compute(m_current, screen);
+    for (size_t c = 0; c < m_entries.size(); c++){
+        const Entry& x = m_entries[c];
+        const Entry& y = m_current[c];
+        for (size_t i = 0; i < 3; i++){
+            if (std::abs(x.average[i] - y.average[i]) > m_tolerance){
+                return false;
+            }
+            if (std::abs(x.stddev[i] - y.stddev[i]) > m_tolerance){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+void BoxSignature::store(const ImageViewRGB32& screen){
+    m_width = screen.width();
+    m_height = screen.height();
+    compute(m_entries, screen);
+}
+void BoxSignature::clear(){
+    m_width = 0;
+    m_height = 0;
+    m_entries.clear();
+}
+
+
+
+ChangeGatedInferenceCallback::ChangeGatedInferenceCallback(
+    VisualInferenceCallback& callback,
+    const ChangeGateConfig& config
+)
+    : VisualInferenceCallback(callback.label())
+    , m_callback(callback)
+    , m_max_staleness(config.max_staleness)
+    , m_signature(config)
+{}
+
+void ChangeGatedInferenceCallback::make_overlays(VideoOverlaySet& items) const{
+    m_callback.make_overlays(items);
+}
+
+template <typename Evaluate>
+bool ChangeGatedInferenceCallback::run(const ImageViewRGB32& frame, WallClock timestamp, Evaluate&& evaluate){
+    if (timestamp < m_last_evaluation + m_max_staleness && m_signature.matches(frame)){
+        m_skipped++;
+        return m_last_result;
+    }
+    m_last_result = evaluate();
+    m_signature.store(frame);
+    m_last_evaluation = timestamp;
+    m_evaluated++;
+    return m_last_result;
+}
+bool ChangeGatedInferenceCallback::process_frame(const VideoSnapshot& frame){
+    //  Forward the snapshot as-is in case the wrapped callback only
+    //  overrides this overload.
+    return run(*frame.frame, frame.timestamp, [&]{
+        return m_callback.process_frame(frame);
+    });
+}
+bool ChangeGatedInferenceCallback::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
+    return run(frame, timestamp, [&]{
+        return m_callback.process_frame(frame, timestamp);
+    });
+}
+void ChangeGatedInferenceCallback::invalidate(){
+    m_signature.clear();
+    m_last_evaluation = WallClock::min();
+}
+
+
+
+
+
+//  Counts how often the real detector runs.
+class CountingDetector : public StaticScreenDetector{
+public:
+    CountingDetector(size_t& count)
+        : m_count(count)
+    {}
+    virtual void make_overlays(VideoOverlaySet& items) const override{}
+    virtual bool detect(const ImageViewRGB32& screen) override{
+        m_count++;
+        return (screen.pixel(screen.width() / 4, screen.height() / 4) & 0x00ff0000) > 0x00800000;
+    }
+private:
+    size_t& m_count;
+};
+
+
+class Test_ChangeGatedDetector : public UnitTest{
+public:
+    Test_ChangeGatedDetector()
+        : UnitTest("CommonTools::ChangeGatedInference - Detector")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        const size_t WIDTH = 1920;
+        const size_t HEIGHT = 1080;
+
+        ChangeGateConfig config;
+        config.boxes.emplace_back(0.0, 0.0, 0.5, 0.5);
+        config.max_staleness = std::chrono::hours(1);
+
+        size_t count = 0;
+        ChangeGatedDetector<CountingDetector> detector(config, count);
+
+        ImageRGB32 image(WIDTH, HEIGHT);
+        image.fill(0xff202020);
+
+        //  First frame always runs.
+        if (detector.detect(image) || count != 1){
+            return "First frame must run the detector.";
+        }
+
+        //  Identical frames are skipped.
+        for (size_t c = 0; c < 10; c++){
+            detector.detect(image);
+        }
+        if (count != 1){
+            return "Identical frames should not run the detector.";
+        }
+
+        //  Changes outside the watched box are ignored.
+        for (size_t r = HEIGHT / 2 + 10; r < HEIGHT; r++){
+            for (size_t c = WIDTH / 2 + 10; c < WIDTH; c++){
+                image.pixel(c, r) = 0xffffffff;
+            }
+        }
+        detector.detect(image);
+        if (count != 1){
+            return "Change outside the watched box should not run the detector.";
+        }
+
+        //  Sub-tolerance noise is ignored.
+        for (size_t r = 0; r < HEIGHT / 2; r += 7){
+            image.pixel(r % (WIDTH / 2), r) = 0xff212121;
+        }
+        detector.detect(image);
+        if (count != 1){
+            return "Noise should not run the detector.";
+        }
+
+        //  A real change inside the box is picked up.
+        for (size_t r = 0; r < HEIGHT / 2; r++){
+            for (size_t c = 0; c < WIDTH / 2; c++){
+                image.pixel(c, r) = 0xffff0000;
+            }
+        }
+        if (!detector.detect(image) || count != 2){
+            return "Change inside the watched box must run the detector.";
+        }
+        if (!detector.detect(image) || count != 2){
+            return "Cached result is wrong.";
+        }
+
+        //  reset_state() forces a re-run.
+        detector.reset_state();
+        detector.detect(image);
+        if (count != 3){
+            return "reset_state() should invalidate the cache.";
+        }
+
+        if (detector.evaluated() != 3 || detector.skipped() != 13){
+            return "Unexpected counters.";
+        }
+        return true;
+    }
+};
+
+
+class Test_ChangeGatedCallback : public UnitTest{
+public:
+    Test_ChangeGatedCallback()
+        : UnitTest("CommonTools::ChangeGatedInference - Callback Staleness")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        size_t count = 0;
+        DetectorToFinder<CountingDetector> finder("Counting", std::chrono::milliseconds(0), count);
+
+        ChangeGateConfig config;
+        config.max_staleness = std::chrono::milliseconds(1000);
+        ChangeGatedInferenceCallback gated(finder, config);
+
+        ImageRGB32 image(640, 360);
+        image.fill(0xff808080);
+
+        //  Default config watches a grid over the whole screen.
+        WallClock start = current_time();
+        for (size_t c = 0; c < 100; c++){
+            gated.process_frame(image, start + std::chrono::milliseconds(50 * c));
+        }
+        //  Runs at 0, 1000, 2000, 3000 and 4000 ms.
+        if (count != 5){
+            return "Expected 5 evaluations from staleness. Got " + std::to_string(count);
+        }
+
+        for (size_t r = 0; r < 40; r++){
+            for (size_t c = 600; c < 640; c++){
+                image.pixel(c, r) = 0xff00ff00;
+            }
+        }
+        gated.process_frame(image, start + std::chrono::milliseconds(4960));
+        if (count != 6){
+            return "Change in a grid cell must run the callback.";
+        }
+
+        gated.invalidate();
+        gated.process_frame(image, start + std::chrono::milliseconds(4970));
+        if (count != 7){
+            return "invalidate() should force a re-run.";
+        }
+        return true;
+    }
+};
+
+
+
+void add_tests_ChangeGatedInference(UnitTestDatabase& database){
+    database.add<Test_ChangeGatedDetector>();
+    database.add<Test_ChangeGatedCallback>();
+}
+
+
+
+}
@@ -0,0 +1,193 @@
+/*  Change-Gated Inference Callback
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Skip re-running a detector on frames where nothing it looks at has changed.
+ *
+ *  Many callbacks poll a screen that stays static for seconds at a time
+ *  (menus, loading screens, waiting for a dialog). Each box being watched is
+ *  reduced to a cheap signature (average + stddev over a subset of rows).
+ *  If every signature is within tolerance of the one from the last real
+ *  evaluation, the previous result is returned instead.
+ *
+ *  A result is never reused for longer than "max_staleness". So a change
+ *  that the signature is too coarse to see will still be picked up
+ *  eventually.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonTools_ChangeGatedInferenceCallback_H
+#define PokemonAutomation_CommonTools_ChangeGatedInferenceCallback_H
+
+#include <vector>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "CommonTools/VisualDetector.h"
+#include "VisualInferenceCallback.h"
+
+namespace PokemonAutomation{
+
+
+
+struct ChangeGateConfig{
+    //  The boxes to watch. If empty, the whole screen is split into a
+    //  "grid_size" x "grid_size" grid.
+    std::vector<ImageFloatBox> boxes;
+    size_t grid_size = 8;
+
+    //  Only sample every Nth row of each box.
+    size_t row_step = 4;
+
+    //  Maximum change in the average or stddev of any channel (0 - 255)
+    //  that is still considered unchanged. Needs to be above the capture
+    //  noise of a static screen.
+    double tolerance = 1.0;
+
+    //  Re-run the detector at least this often even if nothing changed.
+    std::chrono::milliseconds max_staleness = std::chrono::milliseconds(2000);
+};
+
+
+
+//  Per-box signature of a frame.
+class BoxSignature{
+public:
+    BoxSignature(const ChangeGateConfig& config);
+
+    //  Returns true if "screen" matches the last frame passed to store().
+    bool matches(const ImageViewRGB32& screen) const;
+
+    void store(const ImageViewRGB32& screen);
+    void clear();
+
+private:
+    struct Entry{
+        float average[3];
+        float stddev[3];
+    };
+    void compute(std::vector<Entry>& entries, const ImageViewRGB32& screen) const;
+
+private:
+    std::vector<ImageFloatBox> m_boxes;
+    size_t m_row_step;
+    float m_tolerance;
+
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<Entry> m_entries;
+
+    //  Scratch space for matches().
+    mutable std::vector<Entry> m_current;
+};
+
+
+
+//  Wrap a StaticScreenDetector so that detect() returns the cached result
+//  when the screen hasn't changed.
+//
+//  Use with DetectorToFinder:
+//      DetectorToFinder<ChangeGatedDetector<SomeDetector>> finder(
+//          "label", std::chrono::milliseconds(250),
+//          ChangeGateConfig{}, <SomeDetector constructor args>...
+//      );
+//
+//  Since only detect() is gated, the finder still sees a result on every
+//  frame and its consecutive-detection timing is unchanged.
+template <typename Detector>
+class ChangeGatedDetector : public Detector{
+public:
+    template <class... Args>
+    ChangeGatedDetector(const ChangeGateConfig& config, Args&&... args)
+        : Detector(std::forward<Args>(args)...)
+        , m_max_staleness(config.max_staleness)
+        , m_signature(config)
+    {}
+
+    virtual bool detect(const ImageViewRGB32& screen) override{
+        WallClock now = current_time();
+        if (now < m_last_evaluation + m_max_staleness && m_signature.matches(screen)){
+            m_skipped++;
+            return m_last_result;
+        }
+        m_last_result = Detector::detect(screen);
+        m_signature.store(screen);
+        m_last_evaluation = now;
+        m_evaluated++;
+        return m_last_result;
+    }
+    virtual void commit_state() override{
+        Detector::commit_state();
+        invalidate();
+    }
+    virtual void reset_state() override{
+        Detector::reset_state();
+        invalidate();
+    }
+
+    //  Force the next call to detect() to run the real detector.
+    void invalidate(){
+        m_signature.clear();
+        m_last_evaluation = WallClock::min();
+    }
+
+    uint64_t evaluated() const{ return m_evaluated; }
+    uint64_t skipped() const{ return m_skipped; }
+
+private:
+    const std::chrono::milliseconds m_max_staleness;
+    BoxSignature m_signature;
+    WallClock m_last_evaluation = WallClock::min();
+    bool m_last_result = false;
+    uint64_t m_evaluated = 0;
+    uint64_t m_skipped = 0;
+};
+
+
+
+//  Wrap an existing callback so that process_frame() returns the cached
+//  result when the screen hasn't changed.
+//
+//  Only use this for callbacks whose result depends only on the current
+//  frame. Callbacks that track state across frames (e.g. DetectorToFinder
+//  waiting for a detection to hold for some duration) will not see the
+//  skipped frames. Gate the detector with ChangeGatedDetector instead.
+class ChangeGatedInferenceCallback : public VisualInferenceCallback{
+public:
+    ChangeGatedInferenceCallback(
+        VisualInferenceCallback& callback,
+        const ChangeGateConfig& config = ChangeGateConfig()
+    );
+
+    virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool process_frame(const VideoSnapshot& frame) override;
+    virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
+
+    //  Force the next frame to run the wrapped callback.
+    void invalidate();
+
+    uint64_t evaluated() const{ return m_evaluated; }
+    uint64_t skipped() const{ return m_skipped; }
+
+private:
+    template <typename Evaluate>
+    bool run(const ImageViewRGB32& frame, WallClock timestamp, Evaluate&& evaluate);
+
+private:
+    VisualInferenceCallback& m_callback;
+    const std::chrono::milliseconds m_max_staleness;
+    BoxSignature m_signature;
+    WallClock m_last_evaluation = WallClock::min();
+    bool m_last_result = false;
+    uint64_t m_evaluated = 0;
+    uint64_t m_skipped = 0;
+};
+
+
+
+void add_tests_ChangeGatedInference(UnitTestDatabase& database);
+
+
+
+}
+#endif
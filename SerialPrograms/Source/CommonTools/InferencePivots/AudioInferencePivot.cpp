@@ -5,6 +5,7 @@
  */
 
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "CommonFramework/AudioPipeline/AudioFeed.h"
 #include "AudioInferencePivot.h"
@@ -27,6 +28,7 @@ struct AudioInferencePivot::PeriodicCallback{
     uint64_t last_seqnum = ~(uint64_t)0;
 
     StatAccumulatorI32 stats;
+    const char* trace_label;
 
     PeriodicCallback(
         Cancellable& p_scope,
@@ -40,13 +42,18 @@ struct AudioInferencePivot::PeriodicCallback{
         , callback(p_callback)
         , period(p_period)
         , start_time(m_start_time)
+        , trace_label(Tracing::ENABLED ? Tracing::intern(p_callback.label()) : nullptr)
     {}
 };
 
 
-AudioInferencePivot::AudioInferencePivot(CancellableScope& scope, AudioFeed& feed)
+AudioInferencePivot::AudioInferencePivot(
+    CancellableScope& scope, AudioFeed& feed,
+    ThreadAffinityGroup affinity
+)
     : BusyPeriodicRunner(GlobalThreadPools::unlimited_pivot())
     , m_feed(feed)
+    , m_affinity(affinity)
 {
     attach(scope);
 }
@@ -90,6 +97,9 @@ StatAccumulatorI32 AudioInferencePivot::remove_callback(AudioInferenceCallback&
     return stats;
 }
 void AudioInferencePivot::run(void* event, bool is_back_to_back) noexcept{
+    PA_TRACE_SCOPE("AudioInferencePivot::run");
+    ThreadAffinityPolicy::pin_this_thread(m_affinity);
+    ThreadAffinityPolicy::report_placement();
     PeriodicCallback& callback = *(PeriodicCallback*)event;
     try{
         std::vector<AudioSpectrum> spectrums;
@@ -109,7 +119,11 @@ void AudioInferencePivot::run(void* event, bool is_back_to_back) noexcept{
         }
 
         WallClock time0 = current_time();
-        bool stop = callback.callback.process_spectrums(spectrums, m_feed);
+        bool stop;
+        {
+            PA_TRACE_SCOPE(callback.trace_label);
+            stop = callback.callback.process_spectrums(spectrums, m_feed);
+        }
         WallClock time1 = current_time();
         callback.stats += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
         if (stop){
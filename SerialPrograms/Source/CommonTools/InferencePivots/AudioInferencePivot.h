@@ -10,6 +10,7 @@
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Cpp/Concurrency/BusyPeriodicRunner.h"
 #include "CommonFramework/Tools/StatAccumulator.h"
+#include "CommonFramework/Tools/ThreadAffinityPolicy.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
 #include "CommonTools/InferenceCallbacks/AudioInferenceCallback.h"
 
@@ -21,7 +22,10 @@ class AudioFeed;
 
 class AudioInferencePivot final : public BusyPeriodicRunner, public OverlayStat{
 public:
-    AudioInferencePivot(CancellableScope& scope, AudioFeed& feed);
+    AudioInferencePivot(
+        CancellableScope& scope, AudioFeed& feed,
+        ThreadAffinityGroup affinity = ThreadAffinityGroup()
+    );
     virtual ~AudioInferencePivot();
 
     //  If this callback returns true:
@@ -47,6 +51,7 @@ private:
     struct PeriodicCallback;
 
     AudioFeed& m_feed;
+    const ThreadAffinityGroup m_affinity;
     SpinLock m_lock;
     std::map<AudioInferenceCallback*, PeriodicCallback> m_map;
 
@@ -5,8 +5,12 @@
  */
 
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Tracing/Tracing.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/TelemetryRecorder.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "CommonFramework/VideoPipeline/VideoPipelineOptions.h"
 #include "VisualInferencePivot.h"
 
 //#include <iostream>
@@ -23,7 +27,11 @@ struct VisualInferencePivot::PeriodicCallback{
     VisualInferenceCallback& callback;
     std::chrono::milliseconds period;
     WallClock last_timestamp;
-    StatAccumulatorI32 stats;
+    WallClock last_run;
+    CallbackStats stats;
+    TelemetryChannel& telemetry_runtime;
+    TelemetryChannel& telemetry_latency;
+    const char* trace_label;
 
     PeriodicCallback(
         Cancellable& p_scope,
@@ -37,18 +45,34 @@ struct VisualInferencePivot::PeriodicCallback{
         , callback(p_callback)
         , period(p_period)
         , last_timestamp(p_start_time)
+        , last_run(p_start_time)
+        , telemetry_runtime(TelemetryRecorder::instance().channel("Inference/" + p_callback.label() + " - Runtime (ms)"))
+        , telemetry_latency(TelemetryRecorder::instance().channel("Inference/" + p_callback.label() + " - Frame to Decision (ms)"))
+        , trace_label(Tracing::ENABLED ? Tracing::intern(p_callback.label()) : nullptr)
     {}
 };
 
 
 
-VisualInferencePivot::VisualInferencePivot(CancellableScope& scope, VideoFeed& feed)
+VisualInferencePivot::VisualInferencePivot(
+    CancellableScope& scope, VideoFeed& feed,
+    ThreadAffinityGroup affinity
+)
     : BusyPeriodicRunner(GlobalThreadPools::unlimited_pivot())
     , m_feed(feed)
+    , m_affinity(affinity)
+    , m_frame_driven(GlobalSettings::instance().VIDEO_PIPELINE->FRAME_DRIVEN_INFERENCE)
+    , m_frames_arriving(false)
 {
     attach(scope);
+    if (m_frame_driven){
+        m_feed.add_frame_listener(*this);
+    }
 }
 VisualInferencePivot::~VisualInferencePivot(){
+    if (m_frame_driven){
+        m_feed.remove_frame_listener(*this);
+    }
     detach();
     stop_thread();
 }
@@ -76,34 +100,79 @@ void VisualInferencePivot::add_callback(
         throw;
     }
 }
-StatAccumulatorI32 VisualInferencePivot::remove_callback(VisualInferenceCallback& callback){
+VisualInferencePivot::CallbackStats VisualInferencePivot::remove_callback(VisualInferenceCallback& callback){
     WriteSpinLock lg(m_lock, PA_CURRENT_FUNCTION);
     auto iter = m_map.find(&callback);
     if (iter == m_map.end()){
-        return StatAccumulatorI32();
+        return CallbackStats();
     }
-    StatAccumulatorI32 stats = iter->second.stats;
+    CallbackStats stats = iter->second.stats;
     BusyPeriodicRunner::remove_event(&iter->second);
     m_map.erase(iter);
     return stats;
 }
+void VisualInferencePivot::on_frame(std::shared_ptr<const VideoFrame> frame){
+    m_frames_arriving.store(true, std::memory_order_relaxed);
+    wake_parked_events();
+}
 void VisualInferencePivot::run(void* event, bool is_back_to_back) noexcept{
+    //  In frame-driven mode, still rerun callbacks on the same frame this
+    //  often. This covers a feed that has stopped delivering frames.
+    const std::chrono::milliseconds STALE_FRAME_PERIOD(200);
+
+    PA_TRACE_SCOPE("VisualInferencePivot::run");
+
+    //  Pivot threads are shared between consoles. This is free if the
+    //  thread is already on the right cores.
+    ThreadAffinityPolicy::pin_this_thread(m_affinity);
+    ThreadAffinityPolicy::report_placement();
+
     PeriodicCallback& callback = *(PeriodicCallback*)event;
     try{
-        //  Reuse the cached screenshot.
-        if (!is_back_to_back || callback.last_timestamp == m_last.timestamp){
-            m_last = m_feed.snapshot_recent_nonblocking(callback.last_timestamp);
+        WallClock now = current_time();
+        if (m_frame_driven && m_frames_arriving.load(std::memory_order_relaxed)){
+            //  Use the latest frame. Reuse the cached one if this callback
+            //  hasn't seen it yet.
+            if (!m_last || m_last.timestamp <= callback.last_timestamp){
+                m_last = m_feed.snapshot_latest_blocking();
+            }
+
+            //  Nothing new. Sleep until the next frame arrives.
+            if (m_last &&
+                m_last.timestamp <= callback.last_timestamp &&
+                now - callback.last_run < STALE_FRAME_PERIOD
+            ){
+                park_event(event, callback.last_run + STALE_FRAME_PERIOD);
+                return;
+            }
+        }else{
+            //  Reuse the cached screenshot.
+            if (!is_back_to_back || callback.last_timestamp == m_last.timestamp){
+                m_last = m_feed.snapshot_recent_nonblocking(callback.last_timestamp);
+            }
         }
 
         if (!m_last){
             return;
         }
 
+        bool new_frame = m_last.timestamp > callback.last_timestamp;
+
         WallClock time0 = current_time();
-        bool stop = callback.callback.process_frame(m_last);
+        bool stop;
+        {
+            PA_TRACE_SCOPE(callback.trace_label);
+            stop = callback.callback.process_frame(m_last);
+        }
         WallClock time1 = current_time();
-        callback.stats += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
+        callback.stats.runtime += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
+        callback.telemetry_runtime.record(time1 - time0);
+        if (new_frame && time1 > m_last.timestamp){
+            callback.stats.latency += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - m_last.timestamp).count();
+            callback.telemetry_latency.record(time1 - m_last.timestamp);
+        }
         callback.last_timestamp = m_last.timestamp;
+        callback.last_run = time1;
 
         if (stop){
             if (callback.set_when_triggered){
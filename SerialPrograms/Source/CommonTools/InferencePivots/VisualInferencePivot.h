@@ -10,6 +10,7 @@
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Cpp/Concurrency/BusyPeriodicRunner.h"
 #include "CommonFramework/Tools/StatAccumulator.h"
+#include "CommonFramework/Tools/ThreadAffinityPolicy.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
 #include "CommonTools/InferenceCallbacks/VisualInferenceCallback.h"
@@ -20,9 +21,34 @@ class VideoFeed;
 
 
 
-class VisualInferencePivot final : public BusyPeriodicRunner, public OverlayStat{
+//
+//  By default, every callback polls the video feed at its own period.
+//
+//  In frame-driven mode (VideoPipelineOptions::FRAME_DRIVEN_INFERENCE), the
+//  arrival of a new frame wakes up the pivot. Each callback then runs at most
+//  once per new frame and no faster than its period. If the feed doesn't
+//  report frames, this falls back to polling.
+//
+class VisualInferencePivot final
+    : public BusyPeriodicRunner
+    , public OverlayStat
+    , private VideoFrameListener
+{
 public:
-    VisualInferencePivot(CancellableScope& scope, VideoFeed& feed);
+    struct CallbackStats{
+        //  Time spent in process_frame().
+        StatAccumulatorI32 runtime;
+
+        //  From the timestamp of the frame to the end of process_frame().
+        //  Only counted the first time a callback sees a frame.
+        StatAccumulatorI32 latency;
+    };
+
+public:
+    VisualInferencePivot(
+        CancellableScope& scope, VideoFeed& feed,
+        ThreadAffinityGroup affinity = ThreadAffinityGroup()
+    );
     virtual ~VisualInferencePivot();
 
     //  If this callback returns true:
@@ -37,17 +63,22 @@ public:
         WallClock start_time
     );
 
-    //  Returns the latency stats for the callback. Units are microseconds.
-    StatAccumulatorI32 remove_callback(VisualInferenceCallback& callback);
+    //  Returns the stats for the callback. Units are microseconds.
+    CallbackStats remove_callback(VisualInferenceCallback& callback);
 
 private:
     virtual void run(void* event, bool is_back_to_back) noexcept override;
+    virtual void on_frame(std::shared_ptr<const VideoFrame> frame) override;
     virtual OverlayStatSnapshot get_current() override;
 
 private:
     struct PeriodicCallback;
 
     VideoFeed& m_feed;
+    const ThreadAffinityGroup m_affinity;
+    const bool m_frame_driven;
+    std::atomic<bool> m_frames_arriving;
+
     SpinLock m_lock;
     std::map<VisualInferenceCallback*, PeriodicCallback> m_map;
     VideoSnapshot m_last;
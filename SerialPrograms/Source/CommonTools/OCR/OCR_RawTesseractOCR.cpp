@@ -4,15 +4,24 @@
  *
  */
 
+#include <map>
 #include <memory>
+#include <algorithm>
+#include <exception>
 #include <QFile>
 #include <QDir>
 #include "3rdParty/TesseractPA/TesseractPA.h"
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/ScopeExit.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "OCR_RawTesseractOCR.h"
 
 #include <iostream>
@@ -35,7 +44,8 @@ bool tesseract_language_available(Language language){
 
 // Thread-safe object pool for TesseractAPI instances for a specific language.
 // Allows concurrent OCR operations by maintaining multiple Tesseract instances that can be
-// checked out, used, and returned. Instances are created lazily on demand.
+// checked out, used, and returned. Instances are created on demand up to the budget. Once
+// they are all busy, callers wait for one to be returned.
 class TesseractPool{
 public:
     TesseractPool(Language language)
@@ -49,49 +59,166 @@ public:
     // Checkout pattern: (1) acquire idle instance from pool (or create new one if none available),
     // (2) configure PSM, (3) run OCR without holding lock, (4) return instance to idle pool.
     std::string run(const ImageViewRGB32& image, int psm){
-        TesseractAPI* instance;
-        // Checkout: Try to get an idle instance, create new one if the idle pool is empty.
-        while (true){
-            {
-                WriteSpinLock lg(m_lock, "TesseractPool::run()");
-                if (!m_idle.empty()){
-                    instance = m_idle.back();
-                    m_idle.pop_back();
-                    break;
-                }
-            }
-            // No idle instance available - create a new one.
-            add_instance();
-        }
+        PA_TRACE_SCOPE("TesseractPool::run");
+        TesseractAPI* instance = checkout();
 
         // Configure PSM before OCR (safe to call between images on same instance).
         // PSM is page segmentation mode for Tessearct.
         instance->set_page_seg_mode(psm);
 
         // Perform OCR without holding the lock (allows concurrent OCR operations).
-//        auto start = current_time();
+        WallClock start = current_time();
+        ScopeExit return_instance([&]{
+            checkin(instance, current_time() - start);
+        });
         TesseractString str = instance->read32(
             (const unsigned char*)image.data(),
             image.width(),
             image.height(),
             image.bytes_per_row()
         );
-//        auto end = current_time();
-//        cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << endl;
-        // Checkin: Return instance to the idle pool.
-        {
-            WriteSpinLock lg(m_lock, "TesseractPool::run()");
-            m_idle.emplace_back(instance);
-        }
 
         return str.c_str() == nullptr
             ? std::string()
             : str.c_str();
     }
 
-    // Create a new TesseractAPI instance and add it to the pool.
-    // Thread-safe - can be called concurrently (using `m_lock` when modifying the pool).
-    void add_instance(){
+    // Pre-allocate a minimum number of instances to avoid lazy initialization during runtime.
+    // Useful for warming up the pool before heavy OCR workloads. The budget is raised to
+    // "instances" if it's lower. Instances are loaded in parallel.
+    void ensure_instances(size_t instances){
+        size_t missing;
+        {
+            std::lock_guard<Mutex> lg(m_lock);
+            m_min_budget = std::max(m_min_budget, instances);
+            size_t current = m_instances.size() + m_creating;
+            missing = current < instances ? instances - current : 0;
+            m_creating += missing;
+        }
+        if (missing == 0){
+            return;
+        }
+        std::vector<std::exception_ptr> errors(missing);
+        GlobalThreadPools::computation_normal().run_in_parallel(
+            [&](size_t index){
+                try{
+                    add_instance(create_instance());
+                }catch (...){
+                    std::lock_guard<Mutex> lg(m_lock);
+                    m_creating--;
+                    m_cv.notify_all();
+                    errors[index] = std::current_exception();
+                }
+            },
+            0, missing, 1
+        );
+        for (std::exception_ptr& error : errors){
+            if (error){
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    void set_budget(size_t max_instances){
+        std::lock_guard<Mutex> lg(m_lock);
+        m_budget = max_instances;
+        m_min_budget = 0;
+        m_cv.notify_all();
+    }
+
+    TesseractPoolStats stats(){
+        size_t default_budget = this->default_budget();
+        std::lock_guard<Mutex> lg(m_lock);
+        TesseractPoolStats ret = m_stats;
+        ret.instances = m_instances.size();
+        ret.budget = budget(default_budget);
+        ret.busy = m_instances.size() - m_idle.size();
+        return ret;
+    }
+
+#ifdef __APPLE__
+#ifdef UNIX_LINK_TESSERACT
+    ~TesseractPool(){
+        for (auto& api : m_instances){
+            api.release();
+        }
+    }
+#endif
+#endif
+
+private:
+    // One instance per thread of the larger computation pool. OCR is
+    // compute-bound so more than that won't read any faster.
+    static size_t default_budget(){
+        return std::max<size_t>(
+            std::max(
+                GlobalThreadPools::computation_normal().max_threads(),
+                GlobalThreadPools::computation_realtime().max_threads()
+            ),
+            1
+        );
+    }
+    size_t budget(size_t default_budget) const{
+        return std::max(m_budget == 0 ? default_budget : m_budget, m_min_budget);
+    }
+
+    // Take an idle instance. If there are none, create one if the budget allows.
+    // Otherwise wait for one to be returned.
+    TesseractAPI* checkout(){
+        const size_t default_budget = this->default_budget();
+        const WallClock start = current_time();
+        bool waited = false;
+        bool created = false;
+        TesseractAPI* instance = nullptr;
+
+        std::unique_lock<Mutex> lg(m_lock);
+        while (true){
+            if (!m_idle.empty()){
+                instance = m_idle.back();
+                m_idle.pop_back();
+                break;
+            }
+            if (m_instances.size() + m_creating < budget(default_budget)){
+                // Create instance outside lock (initialization is expensive).
+                m_creating++;
+                lg.unlock();
+                std::unique_ptr<TesseractAPI> api;
+                try{
+                    api = create_instance();
+                }catch (...){
+                    lg.lock();
+                    m_creating--;
+                    m_cv.notify_all();
+                    throw;
+                }
+                lg.lock();
+                m_creating--;
+                m_instances.emplace_back(std::move(api));
+                instance = m_instances.back().get();
+                created = true;
+                break;
+            }
+            waited = true;
+            m_cv.wait(lg);
+        }
+
+        WallDuration wait = current_time() - start;
+        m_stats.reads++;
+        m_stats.cold_reads += created;
+        m_stats.waits += waited;
+        m_stats.total_wait += wait;
+        m_stats.max_wait = std::max(m_stats.max_wait, wait);
+        m_stats.peak_busy = std::max(m_stats.peak_busy, m_instances.size() - m_idle.size());
+        return instance;
+    }
+    void checkin(TesseractAPI* instance, WallDuration busy){
+        std::lock_guard<Mutex> lg(m_lock);
+        m_idle.emplace_back(instance);
+        m_stats.total_busy += busy;
+        m_cv.notify_one();
+    }
+
+    std::unique_ptr<TesseractAPI> create_instance() const{
         //  Check for non-ascii characters in path.
         for (char ch : m_training_data_path){
             if (ch < 0){
@@ -105,62 +232,42 @@ public:
         global_logger_tagged().log(
             "Initializing TesseractAPI (" + m_language_code + "): " + m_training_data_path
         );
-        // Create instance outside lock (initialization is expensive).
         std::unique_ptr<TesseractAPI> api(
             new TesseractAPI(m_training_data_path.c_str(), m_language_code.c_str())
         );
         if (!api->valid()){
             throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, "Could not initialize TesseractAPI. Ensure that Tesseract has been downloaded.");
         }
-
-        // Add to pool under lock.
-        WriteSpinLock lg(m_lock, "TesseractPool::run()");
-
-        m_instances.emplace_back(std::move(api));
-        try{
-            m_idle.emplace_back(m_instances.back().get());
-        }catch (...){
-            m_instances.pop_back();
-            throw;
-        }
-    }
-
-    // Pre-allocate a minimum number of instances to avoid lazy initialization during runtime.
-    // Useful for warming up the pool before heavy OCR workloads.
-    void ensure_instances(size_t instances){
-        size_t current_instances;
-        while (true){
-            {
-                ReadSpinLock lg(m_lock, "TesseractPool::run()");
-                current_instances = m_instances.size();
-            }
-            if (current_instances >= instances){
-                break;
-            }
-            add_instance();
-        }
+        return api;
     }
 
-#ifdef __APPLE__
-#ifdef UNIX_LINK_TESSERACT
-    ~TesseractPool(){
-        for (auto& api : m_instances){
-            api.release();
-        }
+    // Add a new instance that was counted in `m_creating` to the idle pool.
+    void add_instance(std::unique_ptr<TesseractAPI> api){
+        std::lock_guard<Mutex> lg(m_lock);
+        m_creating--;
+        m_instances.emplace_back(std::move(api));
+        m_idle.emplace_back(m_instances.back().get());
+        m_cv.notify_one();
     }
-#endif
-#endif
 
 private:
     const std::string& m_language_code;
     const std::string m_training_data_path;
 
-    // Concurrency: m_lock protects both m_instances and m_idle vectors.
-    SpinLock m_lock;
+    // Concurrency: m_lock protects everything below.
+    Mutex m_lock;
+    ConditionVariable m_cv;
     // Owns all created Tesseract instances.
     std::vector<std::unique_ptr<TesseractAPI>> m_instances;
     // Current idle Tesseract instances in `m_instances`.
     std::vector<TesseractAPI*> m_idle;
+    // Instances being created outside the lock. They count towards the budget.
+    size_t m_creating = 0;
+    // 0 means the default budget.
+    size_t m_budget = 0;
+    // Raised by ensure_instances().
+    size_t m_min_budget = 0;
+    TesseractPoolStats m_stats;
 };
 
 // Global singleton managing TesseractPools for all languages.
@@ -178,6 +285,20 @@ struct OcrGlobals{
 };
 
 
+// Get or create the pool for this language (lock only during map access).
+static TesseractPool& get_pool(Language language){
+    OcrGlobals& globals = OcrGlobals::instance();
+    std::map<Language, TesseractPool>& ocr_pool = globals.ocr_pool;
+
+    WriteSpinLock lg(globals.ocr_pool_lock, "tesseract_ocr_read()");
+    auto iter = ocr_pool.find(language);
+    if (iter == ocr_pool.end()){
+        iter = ocr_pool.emplace(language, language).first;
+    }
+    return iter->second;
+}
+
+
 std::string tesseract_ocr_read(Language language, const ImageViewRGB32& image, PageSegMode psm){
 //    static size_t c = 0;
 //    image.save("ocr-" + std::to_string(c++) + ".png");
@@ -186,20 +307,8 @@ std::string tesseract_ocr_read(Language language, const ImageViewRGB32& image, P
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to call OCR without a language.");
     }
 
-    OcrGlobals& globals = OcrGlobals::instance();
-    std::map<Language, TesseractPool>& ocr_pool = globals.ocr_pool;
-
-    // Get or create the pool for this language (lock only during map access).
-    std::map<Language, TesseractPool>::iterator iter;
-    {
-        WriteSpinLock lg(globals.ocr_pool_lock, "tesseract_ocr_read()");
-        iter = ocr_pool.find(language);
-        if (iter == ocr_pool.end()){
-            iter = ocr_pool.emplace(language, language).first;
-        }
-    }
     // Delegate to pool (which has its own locking for instance management).
-    std::string ret = iter->second.run(image, static_cast<int>(psm));
+    std::string ret = get_pool(language).run(image, static_cast<int>(psm));
 
 //    global_logger_tagged().log(ret);
 
@@ -212,20 +321,22 @@ void ensure_tesseract_instances(Language language, size_t instances){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to call OCR without a language.");
     }
 
-    OcrGlobals& globals = OcrGlobals::instance();
-    std::map<Language, TesseractPool>& ocr_pool = globals.ocr_pool;
+    // Delegate to pool's ensure_instances (which handles its own locking).
+    get_pool(language).ensure_instances(instances);
+}
 
-    // Get or create the pool for this language.
-    std::map<Language, TesseractPool>::iterator iter;
-    {
-        WriteSpinLock lg(globals.ocr_pool_lock, "tesseract_ocr_read()");
-        iter = ocr_pool.find(language);
-        if (iter == ocr_pool.end()){
-            iter = ocr_pool.emplace(language, language).first;
-        }
+void set_tesseract_instance_budget(Language language, size_t max_instances){
+    if (language == Language::None){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to call OCR without a language.");
     }
-    // Delegate to pool's ensure_instances (which handles its own locking).
-    iter->second.ensure_instances(instances);
+    get_pool(language).set_budget(max_instances);
+}
+
+TesseractPoolStats tesseract_pool_stats(Language language){
+    if (language == Language::None){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to call OCR without a language.");
+    }
+    return get_pool(language).stats();
 }
 
 void clear_tesseract_cache(){
@@ -11,7 +11,10 @@
 #ifndef PokemonAutomation_CommonTools_OCR_RawTesseractOCR_H
 #define PokemonAutomation_CommonTools_OCR_RawTesseractOCR_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
+#include "Common/Cpp/Time.h"
 #include "CommonFramework/Language.h"
 
 namespace PokemonAutomation{
@@ -49,9 +52,11 @@ bool tesseract_language_available(Language language);
 //  OCR the image in the specified language.
 //  Main OCR entry point. Performs OCR on the image using the specified language.
 //  Thread-safe: internally uses a pool of Tesseract API instances, able to accept
-//  multiple concurrent calls without delay or queueing.
-//  It creates a new Tesseract instances if no available idle instance. You can
-//  call `ensure_tesseract_instances()` to pre-warm to pool with a given number of instances.
+//  multiple concurrent calls.
+//  It creates a new Tesseract instance if no idle instance is available, up to the
+//  instance budget of the language. Past that, calls wait for an instance to be
+//  returned. You can call `ensure_tesseract_instances()` to pre-warm the pool with
+//  a given number of instances.
 //
 //  psm: Page segmentation mode - controls how Tesseract interprets the image layout.
 //       Defaults to SINGLE_LINE
@@ -67,8 +72,33 @@ std::string tesseract_ocr_read(
 //  Avoids lazy initialization delays during runtime. Thread-safe.
 //  Call this if you expect to need to do many OCR instances in parallel and you
 //  want to preload the OCR instances.
+//  If "instances" is more than the budget, the budget is raised to it.
 void ensure_tesseract_instances(Language language, size_t instances);
 
+//  Set the most Tesseract instances that will be created for a language.
+//  0 restores the default, which is the size of the larger computation thread
+//  pool. Each instance costs a model load so there's no point in having more
+//  than can run at once.
+void set_tesseract_instance_budget(Language language, size_t max_instances);
+
+
+//  Usage of the Tesseract instance pool for a language.
+struct TesseractPoolStats{
+    size_t instances = 0;
+    size_t budget = 0;
+    size_t busy = 0;
+    size_t peak_busy = 0;
+
+    uint64_t reads = 0;
+    uint64_t waits = 0;         //  Reads that had to wait for an instance.
+    uint64_t cold_reads = 0;    //  Reads that had to load a new instance.
+
+    WallDuration total_wait = WallDuration::zero();
+    WallDuration max_wait = WallDuration::zero();
+    WallDuration total_busy = WallDuration::zero();
+};
+TesseractPoolStats tesseract_pool_stats(Language language);
+
 //  Clear all TesseractAPI instances for all languages. Used for cleanup or
 //  forcing re-initialization.
 //  This is not safe to call while in any OCR is still running!
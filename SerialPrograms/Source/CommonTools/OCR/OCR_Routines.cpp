@@ -4,6 +4,7 @@
  *
  */
 
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
@@ -34,6 +35,7 @@ bool ocr_language_available(Language language){
 
 
 std::string ocr_read(Language language, const ImageViewRGB32& image, PageSegMode psm){
+    PA_TRACE_SCOPE("OCR::ocr_read");
     std::string ocr_text = "";
     if (psm == PageSegMode::AUTO || psm == PageSegMode::SINGLE_BLOCK || psm == PageSegMode::SINGLE_COLUMN){
         // if using multiline detection, force Tesseract
@@ -4,7 +4,16 @@
  *
  */
 
+#include <atomic>
+#include <algorithm>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/ScopeExit.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/Thread.h"
 #include "CommonFramework/GlobalAutoPaths.h"
+#include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "Common/Cpp/TestRunners/UnitTestDatabase.h"
 // #include "Common/Cpp/Strings/Unicode.h"
@@ -25,6 +34,8 @@ void add_tests(UnitTestDatabase& database){
     add_tests_raw_OCR(database);
 }
 
+static const char* SENTENCE_1 = "You hurry to the Pokemon Center, shielding your";
+
 class Test_RawOCR : public UnitTest{
 public:
     Test_RawOCR(
@@ -53,6 +64,85 @@ private:
     std::string m_expected;
 };
 
+
+
+//  Many more callers than instances. Every read must still be correct and the
+//  pool must not grow past its budget.
+class Test_TesseractPoolContention : public UnitTest{
+public:
+    Test_TesseractPoolContention()
+        : UnitTest("OCR::RawOCR - Tesseract Pool Contention")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        if (!tesseract_language_available(Language::English)){
+            return UnitTestResult(UnitTestResult::SKIPPED, "English Tesseract data is not installed.");
+        }
+
+        const std::pair<std::string, std::string> cases[] = {
+            {"OCR/sentence-1-1.jpg", SENTENCE_1},
+            {"OCR/sentence-1-2.jpg", SENTENCE_1},
+            {"OCR/letter-i-tall-1.jpg", "I"},
+            {"OCR/letter-i-wide-1.jpg", "I"},
+        };
+        std::vector<ImageRGB32> images;
+        for (const auto& item : cases){
+            images.emplace_back(UNIT_TEST_RESOURCE_PATH() + item.first);
+        }
+
+        const size_t BUDGET = 2;
+        const size_t THREADS = 16;
+        const size_t READS_PER_THREAD = 8;
+
+        set_tesseract_instance_budget(Language::English, BUDGET);
+        ScopeExit restore([]{
+            set_tesseract_instance_budget(Language::English, 0);
+        });
+        TesseractPoolStats before = tesseract_pool_stats(Language::English);
+
+        std::atomic<size_t> wrong(0);
+        {
+            std::vector<Thread> threads;
+            for (size_t t = 0; t < THREADS; t++){
+                threads.emplace_back([&, t]{
+                    for (size_t c = 0; c < READS_PER_THREAD; c++){
+                        size_t index = (t + c) % images.size();
+                        std::string result = tesseract_ocr_read(Language::English, images[index]);
+                        if (normalize_utf32(result) != normalize_utf32(cases[index].second)){
+                            wrong++;
+                        }
+                    }
+                });
+            }
+        }
+
+        TesseractPoolStats after = tesseract_pool_stats(Language::English);
+        logger.log(
+            "Instances: " + std::to_string(after.instances) + ", peak busy: " + std::to_string(after.peak_busy) +
+            ", waits: " + std::to_string(after.waits - before.waits)
+        );
+
+        if (wrong.load() != 0){
+            return std::to_string(wrong.load()) + " reads were wrong.";
+        }
+        if (after.reads - before.reads != THREADS * READS_PER_THREAD){
+            return "Expected " + std::to_string(THREADS * READS_PER_THREAD) + " reads. Got " +
+                std::to_string(after.reads - before.reads) + ".";
+        }
+        //  Earlier tests may have already created more than the budget.
+        if (after.instances > std::max(BUDGET, before.instances)){
+            return "Pool grew past its budget: " + std::to_string(after.instances) + " instances.";
+        }
+        if (before.instances <= BUDGET && after.peak_busy > BUDGET){
+            return "More instances were busy than the budget allows.";
+        }
+        if (after.busy != 0){
+            return "Instances were not returned to the pool.";
+        }
+        return true;
+    }
+};
+
 void add_tests_raw_OCR(UnitTestDatabase& database){
     database.add<Test_RawOCR>("OCR/letter-i-tall-1.jpg", Language::English, "I");
     database.add<Test_RawOCR>("OCR/letter-i-tall-2.jpg", Language::English, "I");
@@ -68,6 +158,88 @@ void add_tests_raw_OCR(UnitTestDatabase& database){
     database.add<Test_RawOCR>("OCR/sentence-1-3-wide.jpg", Language::English, "You hurry to the Pokemon Center, shielding your");
     database.add<Test_RawOCR>("OCR/sentence-1-3-tall.jpg", Language::English, "You hurry to the Pokemon Center, shielding your");
     database.add<Test_RawOCR>("OCR/german-nature-sanft.png", Language::German, "Wesen: SANFT");
+    database.add<Test_TesseractPoolContention>();
+}
+
+
+
+void benchmark_TesseractPool(Logger& logger, size_t threads, size_t iterations){
+    if (!tesseract_language_available(Language::English)){
+        logger.log("English Tesseract data is not installed.", COLOR_RED);
+        return;
+    }
+    ImageRGB32 image(UNIT_TEST_RESOURCE_PATH() + "OCR/sentence-1-1.jpg");
+
+    auto microseconds = [](WallDuration duration){
+        return (double)std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+
+    //  First call with an empty pool pays the model load.
+    clear_tesseract_cache();
+    WallClock start = current_time();
+    tesseract_ocr_read(Language::English, image);
+    double cold = microseconds(current_time() - start);
+
+    clear_tesseract_cache();
+    start = current_time();
+    ensure_tesseract_instances(Language::English, threads);
+    double prewarm = microseconds(current_time() - start);
+    start = current_time();
+    tesseract_ocr_read(Language::English, image);
+    double warm = microseconds(current_time() - start);
+
+    logger.log(
+        "First call: cold = " + tostr_fixed(cold, 0) + " us, prewarmed = " + tostr_fixed(warm, 0) +
+        " us (prewarming " + std::to_string(threads) + " instances took " + tostr_fixed(prewarm, 0) + " us)"
+    );
+
+    //  Twice as many callers as the budget so some of them have to wait.
+    set_tesseract_instance_budget(Language::English, threads);
+    TesseractPoolStats before = tesseract_pool_stats(Language::English);
+
+    Mutex lock;
+    std::vector<double> latencies;
+    start = current_time();
+    {
+        std::vector<Thread> workers;
+        for (size_t t = 0; t < 2 * threads; t++){
+            workers.emplace_back([&]{
+                std::vector<double> local;
+                for (size_t c = 0; c < iterations; c++){
+                    WallClock read_start = current_time();
+                    tesseract_ocr_read(Language::English, image);
+                    local.emplace_back(microseconds(current_time() - read_start));
+                }
+                std::lock_guard<Mutex> lg(lock);
+                latencies.insert(latencies.end(), local.begin(), local.end());
+            });
+        }
+    }
+    double elapsed = microseconds(current_time() - start);
+    set_tesseract_instance_budget(Language::English, 0);
+
+    if (latencies.empty()){
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p){
+        return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))];
+    };
+
+    TesseractPoolStats after = tesseract_pool_stats(Language::English);
+    uint64_t reads = after.reads - before.reads;
+    logger.log(
+        std::to_string(2 * threads) + " callers, " + std::to_string(after.instances) + " instances: p50 = " +
+        tostr_fixed(percentile(0.50), 0) + " us, p99 = " + tostr_fixed(percentile(0.99), 0) +
+        " us, max = " + tostr_fixed(latencies.back(), 0) + " us"
+    );
+    logger.log(
+        "Waited: " + std::to_string(after.waits - before.waits) + " / " + std::to_string(reads) +
+        " reads, average wait = " + tostr_fixed(microseconds(after.total_wait - before.total_wait) / reads, 0) +
+        " us, utilization = " + tostr_fixed(
+            100. * microseconds(after.total_busy - before.total_busy) / (after.instances * elapsed), 0
+        ) + "%"
+    );
 }
 
 
@@ -18,6 +18,10 @@ void add_tests(UnitTestDatabase& database);
 
 void add_tests_raw_OCR(UnitTestDatabase& database);
 
+//  First-call latency with and without prewarming, and the read latency
+//  distribution when "threads" callers share the English Tesseract pool.
+void benchmark_TesseractPool(Logger& logger, size_t threads, size_t iterations);
+
 
 
 }
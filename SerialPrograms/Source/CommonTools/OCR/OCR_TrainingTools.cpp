@@ -6,10 +6,10 @@
 
 #include <QDirIterator>
 #include "Common/Cpp/PrettyPrint.h"
-#include "Common/Cpp/Concurrency/Backends/ThreadPool_Default.h"
+#include "Common/Cpp/Concurrency/ThreadPool.h"
 #include "CommonFramework/GlobalAutoPaths.h"
-#include "CommonFramework/Options/Environment/PerformanceOptions.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "OCR_SmallDictionaryMatcher.h"
 #include "OCR_LargeDictionaryMatcher.h"
 #include "OCR_TrainingTools.h"
@@ -95,89 +95,229 @@ TrainingSession::TrainingSession(
 }
 
 
-void TrainingSession::generate_small_dictionary(
-    const std::string& ocr_json_file,
-    const std::string& output_json_file,
-    bool incremental,
-    size_t threads,
+namespace{
+
+struct SampleOutcome{
+    enum class Type{
+        SKIPPED,
+        MATCHED,
+        MISSED,
+        MISMATCHED,
+    };
+    Type type = Type::SKIPPED;
+
+    //  What to log and at which threshold. Not used if matched.
+    StringMatchResult result;
+    double log_threshold = 0;
+
+    //  If non-empty, add this as a new candidate for the sample's token.
+    std::u32string candidate;
+
+    WallDuration time = WallDuration::zero();
+};
+
+struct LanguageSummary{
+    size_t samples = 0;
+    size_t skipped = 0;
+    size_t matched = 0;
+    size_t missed = 0;
+    size_t mismatched = 0;
+    WallDuration time = WallDuration::zero();
+};
+
+}
+
+
+
+void TrainingSession::evaluate(
+    const DictionaryMatcher& baseline,
+    DictionaryMatcher& trained,
     const std::vector<OCR::TextColorRange>& text_color_ranges,
     double max_log10p, double log10p_spread,
-    double min_text_ratio, double max_text_ratio
-){
-    m_logger.log("Generating OCR Data...");
+    double min_text_ratio, double max_text_ratio,
+    const std::function<void(Language)>& on_language_done
+) const{
+    //  Flatten all the languages into one list. Each language's samples are
+    //  contiguous so they can be run and merged one language at a time.
+    std::vector<std::pair<Language, const TrainingSample*>> jobs;
+    jobs.reserve(m_total_samples);
+    for (const auto& language : m_samples){
+        for (const TrainingSample& sample : language.second){
+            jobs.emplace_back(language.first, &sample);
+        }
+    }
 
-    OCR::SmallDictionaryMatcher baseline(ocr_json_file, !incremental);
-    OCR::SmallDictionaryMatcher trained(ocr_json_file, !incremental);
+    const bool parallel = allow_parallel_ocr();
+    ThreadPool& pool = GlobalThreadPools::computation_normal();
+    const size_t instances = parallel ? pool.max_threads() : 1;
+    for (const auto& language : m_samples){
+        ensure_ocr_instances(language.first, instances);
+        m_scope.throw_if_cancelled();
+    }
 
-    ThreadPool_Default task_runner(
-        [&](){ PerformanceOptions::instance().COMPUTE_PRIORITY.set_on_this_thread(m_logger); },
-        0, threads
+    m_logger.log(
+        "Evaluating " + tostr_u_commas(jobs.size()) + " samples" +
+        (parallel ? " on " + std::to_string(pool.max_threads()) + " threads..." : " serially...")
     );
 
-    std::atomic<size_t> matched(0);
-    std::atomic<size_t> failed(0);
-    for (const auto& language : m_samples){
-        const LanguageData& language_info = language_data(language.first);
-        m_logger.log("Starting Language: " + language_info.name);
-//        cout << (int)item.first << " : " << item.second.size() << endl;
-
-        task_runner.run_in_parallel(
-            [&](size_t index){
-                m_scope.throw_if_cancelled();
-
-                const TrainingSample& sample = language.second[index];
-
-                ImageRGB32 image(m_directory + sample.filepath);
-                if (!image){
-                    m_logger.log("Skipping: " + sample.filepath);
-                    return;
-                }
-
-                OCR::StringMatchResult result = baseline.match_substring_from_image_multifiltered(
-                    nullptr, language.first, image,
-                    text_color_ranges,
-                    0, log10p_spread,
-                    min_text_ratio, max_text_ratio
-                );
+    //  Each sample only writes to its own outcome. Everything that depends
+    //  on order is done afterwards so the results are the same regardless of
+    //  the thread count.
+    std::vector<SampleOutcome> outcomes(jobs.size());
+    auto run_sample = [&](size_t index){
+        m_scope.throw_if_cancelled();
 
-                OCR::StringMatchResult result0 = result;
-                result.clear_beyond_log10p(max_log10p);
-
-                if (result.results.empty()){
-                    failed++;
-                    result0.log(m_logger, max_log10p, sample.filepath);
-                    if (!result0.results.empty()){
-                        trained.add_candidate(
-                            language.first, sample.token,
-                            result0.results.begin()->second.normalized_text
-                        );
-                    }
-                    return;
-                }
+        Language language = jobs[index].first;
+        const TrainingSample& sample = *jobs[index].second;
+        SampleOutcome& outcome = outcomes[index];
 
-                for (const auto& item : result.results){
-                    if (item.second.token == sample.token){
-                        matched++;
-                        return;
-                    }
-                }
+        WallClock start = current_time();
 
-                result.log(m_logger, -99999, sample.filepath);
-                trained.add_candidate(
-                    language.first, sample.token,
-                    result0.results.begin()->second.normalized_text
-                );
-            },
-            0, language.second.size(), 1
+        ImageRGB32 image(m_directory + sample.filepath);
+        if (!image){
+            return;
+        }
+
+        StringMatchResult result = baseline.match_substring_from_image_multifiltered(
+            nullptr, language, image,
+            text_color_ranges,
+            0, log10p_spread,
+            min_text_ratio, max_text_ratio
         );
 
+        StringMatchResult result0 = result;
+        result.clear_beyond_log10p(max_log10p);
+
+        outcome.time = current_time() - start;
+
+        if (result.results.empty()){
+            outcome.type = SampleOutcome::Type::MISSED;
+            if (!result0.results.empty()){
+                outcome.candidate = result0.results.begin()->second.normalized_text;
+            }
+            outcome.result = std::move(result0);
+            outcome.log_threshold = max_log10p;
+            return;
+        }
+
+        for (const auto& item : result.results){
+            if (item.second.token == sample.token){
+                outcome.type = SampleOutcome::Type::MATCHED;
+                return;
+            }
+        }
+
+        outcome.type = SampleOutcome::Type::MISMATCHED;
+        outcome.candidate = result0.results.begin()->second.normalized_text;
+        outcome.result = std::move(result);
+        outcome.log_threshold = -99999;
+    };
+
+    WallClock start = current_time();
+    size_t matched = 0;
+    size_t failed = 0;
+    for (size_t begin = 0; begin < jobs.size();){
+        Language language = jobs[begin].first;
+        size_t end = begin;
+        while (end < jobs.size() && jobs[end].first == language){
+            end++;
+        }
+
+        //  Run one language at a time so that a finished language can be
+        //  saved before the next one starts. If the session is cancelled
+        //  part way through, the completed languages are not lost.
+        if (parallel){
+            pool.run_in_parallel(run_sample, begin, end, 1);
+        }else{
+            for (size_t c = begin; c < end; c++){
+                run_sample(c);
+            }
+        }
         m_scope.throw_if_cancelled();
+
+        //  Merge in sample order.
+        LanguageSummary summary;
+        for (size_t c = begin; c < end; c++){
+            const TrainingSample& sample = *jobs[c].second;
+            const SampleOutcome& outcome = outcomes[c];
+
+            summary.samples++;
+            summary.time += outcome.time;
+            switch (outcome.type){
+            case SampleOutcome::Type::SKIPPED:
+                summary.skipped++;
+                m_logger.log("Skipping: " + sample.filepath);
+                continue;
+            case SampleOutcome::Type::MATCHED:
+                summary.matched++;
+                continue;
+            case SampleOutcome::Type::MISSED:
+                summary.missed++;
+                break;
+            case SampleOutcome::Type::MISMATCHED:
+                summary.mismatched++;
+                break;
+            }
+
+            outcome.result.log(m_logger, outcome.log_threshold, sample.filepath);
+            if (!outcome.candidate.empty()){
+                trained.add_candidate(language, sample.token, outcome.candidate);
+            }
+        }
+        begin = end;
+
+        size_t evaluated = summary.samples - summary.skipped;
+        double seconds = std::chrono::duration_cast<Milliseconds>(summary.time).count() / 1000.;
+        m_logger.log(
+            language_data(language).name +
+            ": Samples = " + tostr_u_commas(summary.samples) +
+            ", Matched = " + tostr_u_commas(summary.matched) +
+            ", Missed = " + tostr_u_commas(summary.missed) +
+            ", Mismatched = " + tostr_u_commas(summary.mismatched) +
+            ", Accuracy = " + (evaluated == 0 ? "-" : tostr_fixed(100. * summary.matched / evaluated, 2) + "%") +
+            ", Throughput = " + (seconds == 0 ? "-" : tostr_fixed(evaluated / seconds, 1) + " samples/s/thread")
+        );
+        matched += summary.matched;
+        failed += summary.missed;
+
+        if (on_language_done){
+            on_language_done(language);
+        }
     }
+    WallDuration elapsed = current_time() - start;
 
+    double seconds = std::chrono::duration_cast<Milliseconds>(elapsed).count() / 1000.;
     m_logger.log("Languages: " + tostr_u_commas(m_samples.size()));
     m_logger.log("Samples: " + tostr_u_commas(m_total_samples));
     m_logger.log("Matched: " + tostr_u_commas(matched));
     m_logger.log("Missed: " + tostr_u_commas(failed));
+    m_logger.log(
+        "Time: " + tostr_fixed(seconds, 1) + " s" +
+        (seconds == 0 ? "" : " (" + tostr_fixed(m_total_samples / seconds, 1) + " samples/s)")
+    );
+}
+
+
+void TrainingSession::generate_small_dictionary(
+    const std::string& ocr_json_file,
+    const std::string& output_json_file,
+    bool incremental,
+    const std::vector<OCR::TextColorRange>& text_color_ranges,
+    double max_log10p, double log10p_spread,
+    double min_text_ratio, double max_text_ratio
+){
+    m_logger.log("Generating OCR Data...");
+
+    OCR::SmallDictionaryMatcher baseline(ocr_json_file, !incremental);
+    OCR::SmallDictionaryMatcher trained(ocr_json_file, !incremental);
+
+    evaluate(
+        baseline, trained,
+        text_color_ranges,
+        max_log10p, log10p_spread,
+        min_text_ratio, max_text_ratio,
+        nullptr
+    );
 
     trained.save(output_json_file);
 }
@@ -186,7 +326,6 @@ void TrainingSession::generate_large_dictionary(
     const std::string& ocr_json_directory,
     const std::string& output_prefix,
     bool incremental,
-    size_t threads,
     const std::vector<OCR::TextColorRange>& text_color_ranges,
     double max_log10p, double log10p_spread,
     double min_text_ratio, double max_text_ratio
@@ -196,84 +335,22 @@ void TrainingSession::generate_large_dictionary(
     OCR::LargeDictionaryMatcher baseline(ocr_json_directory + output_prefix, nullptr, !incremental);
     OCR::LargeDictionaryMatcher trained(ocr_json_directory + output_prefix, nullptr, !incremental);
 
-    ThreadPool_Default task_runner(
-        [&](){ PerformanceOptions::instance().COMPUTE_PRIORITY.set_on_this_thread(m_logger); },
-        0, threads
+    evaluate(
+        baseline, trained,
+        text_color_ranges,
+        max_log10p, log10p_spread,
+        min_text_ratio, max_text_ratio,
+        [&](Language language){
+            std::string json = output_prefix + language_data(language).code + ".json";
+            trained.save(language, json);
+        }
     );
-
-    std::atomic<size_t> matched(0);
-    std::atomic<size_t> failed(0);
-    for (const auto& language : m_samples){
-        const LanguageData& language_info = language_data(language.first);
-        m_logger.log("Starting Language: " + language_info.name);
-//        cout << (int)item.first << " : " << item.second.size() << endl;
-
-        task_runner.run_in_parallel(
-            [&](size_t index){
-                m_scope.throw_if_cancelled();
-
-                const TrainingSample& sample = language.second[index];
-
-                ImageRGB32 image(m_directory + sample.filepath);
-                if (!image){
-                    m_logger.log("Skipping: " + sample.filepath);
-                    return;
-                }
-
-                OCR::StringMatchResult result = baseline.match_substring_from_image_multifiltered(
-                    nullptr, language.first, image,
-                    text_color_ranges,
-                    0, log10p_spread,
-                    min_text_ratio, max_text_ratio
-                );
-
-                OCR::StringMatchResult result0 = result;
-                result.clear_beyond_log10p(max_log10p);
-
-                if (result.results.empty()){
-                    failed++;
-                    result0.log(m_logger, max_log10p, sample.filepath);
-                    if (!result0.results.empty()){
-                        trained.add_candidate(
-                            language.first, sample.token,
-                            result0.results.begin()->second.normalized_text
-                        );
-                    }
-                    return;
-                }
-
-                for (const auto& item : result.results){
-                    if (item.second.token == sample.token){
-                        matched++;
-                        return;
-                    }
-                }
-
-                result.log(m_logger, -99999, sample.filepath);
-                trained.add_candidate(
-                    language.first, sample.token,
-                    result0.results.begin()->second.normalized_text
-                );
-            },
-            0, language.second.size(), 1
-        );
-
-        std::string json = output_prefix + language_info.code + ".json";
-        trained.save(language.first, json);
-        m_scope.throw_if_cancelled();
-    }
-
-    m_logger.log("Languages: " + tostr_u_commas(m_samples.size()));
-    m_logger.log("Samples: " + tostr_u_commas(m_total_samples));
-    m_logger.log("Matched: " + tostr_u_commas(matched));
-    m_logger.log("Missed: " + tostr_u_commas(failed));
 }
 
 
 
 
 
-
 }
 }
 
@@ -10,9 +10,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 #include "Common/Cpp/Logging/AbstractLogger.h"
 #include "Common/Cpp/CancellableScope.h"
 #include "CommonFramework/Language.h"
+#include "OCR_DictionaryMatcher.h"
 #include "OCR_Routines.h"
 
 namespace PokemonAutomation{
@@ -39,7 +41,6 @@ public:
         const std::string& ocr_json_file,
         const std::string& output_json_file,
         bool incremental,
-        size_t threads,
         const std::vector<OCR::TextColorRange>& text_color_ranges,
         double max_log10p, double log10p_spread,
         double min_text_ratio = 0.01, double max_text_ratio = 0.50
@@ -48,12 +49,26 @@ public:
         const std::string& ocr_json_directory,
         const std::string& output_prefix,
         bool incremental,
-        size_t threads,
         const std::vector<OCR::TextColorRange>& text_color_ranges,
         double max_log10p, double log10p_spread,
         double min_text_ratio = 0.01, double max_text_ratio = 0.50
     ) const;
 
+private:
+    //  Run "baseline" on every sample and add the misses to "trained".
+    //  Samples are spread across GlobalThreadPools::computation_normal()
+    //  unless allow_parallel_ocr() says otherwise.
+    //  "on_language_done" (if set) is called after each language's misses
+    //  have been added to "trained".
+    void evaluate(
+        const DictionaryMatcher& baseline,
+        DictionaryMatcher& trained,
+        const std::vector<OCR::TextColorRange>& text_color_ranges,
+        double max_log10p, double log10p_spread,
+        double min_text_ratio, double max_text_ratio,
+        const std::function<void(Language)>& on_language_done
+    ) const;
+
 private:
     Logger& m_logger;
     CancellableScope& m_scope;
@@ -7,8 +7,9 @@
 #ifndef PokemonAutomation_CommonTools_DifferentialAnomalyDetector_H
 #define PokemonAutomation_CommonTools_DifferentialAnomalyDetector_H
 
-#include <deque>
+#include <stdint.h>
 #include "Common/Cpp/Time.h"
+#include "SlidingWindowStats.h"
 
 namespace PokemonAutomation{
 
@@ -23,14 +24,11 @@ public:
     double sigma(double x) const;
 
 private:
-    size_t m_window_size;
     double m_min_value;
     double m_max_value;
     double m_scale_to_fixedpoint;
     double m_scale_to_double;
-    uint64_t m_sum;
-    uint64_t m_sum_sqr;
-    std::deque<uint32_t> m_window;
+    SlidingWindowStats<uint32_t, uint64_t> m_window;
 };
 
 
@@ -44,18 +42,11 @@ public:
     double sigma(double x) const;
 
 private:
-    struct Frame{
-        WallClock timestamp;
-        uint32_t fixed_point_value;
-    };
-
-    size_t m_window_size;
     double m_max_value;
     double m_scale_to_fixedpoint;
     double m_scale_to_double;
-    uint64_t m_sum;
-    uint64_t m_sum_sqr;
-    std::deque<Frame> m_window;
+    WallClock m_last_timestamp;
+    SlidingWindowStats<uint32_t, uint64_t> m_window;
 };
 
 
@@ -0,0 +1,281 @@
+/*  Sliding Window Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <random>
+#include <algorithm>
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "TimeWindowStatTracker.h"
+#include "SlidingWindowStats.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+
+//  Streams that stress the min/max candidates in different ways.
+static uint32_t test_value(size_t pattern, size_t index, std::mt19937& rng){
+    switch (pattern){
+    case 0:     return rng();                       //  Random, full range.
+    case 1:     return rng() % 8;                   //  Lots of ties.
+    case 2:     return (uint32_t)index;             //  Increasing.
+    case 3:     return (uint32_t)(1000000 - index); //  Decreasing.
+    case 4:     return (uint32_t)(index % 37);      //  Sawtooth.
+    default:    return 12345;                       //  Constant.
+    }
+}
+static const size_t TEST_PATTERNS = 6;
+
+
+class Test_SlidingWindowStats : public UnitTest{
+public:
+    Test_SlidingWindowStats()
+        : UnitTest("CommonTools::TrendInference - SlidingWindowStats")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        std::mt19937 rng(0);
+        size_t checks = 0;
+        for (size_t window_size : {1, 2, 3, 7, 64, 1000}){
+            for (size_t pattern = 0; pattern < TEST_PATTERNS; pattern++){
+                scope.throw_if_cancelled();
+
+                SlidingWindowStats<uint32_t, uint64_t> stats(window_size);
+                std::deque<uint32_t> naive;
+                const size_t PUSHES = 3 * window_size + 50;
+                for (size_t c = 0; c < PUSHES; c++){
+                    //  Start over once in the middle.
+                    if (c == PUSHES / 2){
+                        stats.clear();
+                        naive.clear();
+                    }
+
+                    uint32_t x = test_value(pattern, c, rng);
+                    stats.push(x);
+                    naive.emplace_back(x);
+                    if (naive.size() > window_size){
+                        naive.pop_front();
+                    }
+
+                    uint64_t sum = 0;
+                    uint64_t sum_sqr = 0;
+                    for (uint32_t item : naive){
+                        sum += item;
+                        sum_sqr += (uint64_t)item * item;
+                    }
+                    uint32_t min = *std::min_element(naive.begin(), naive.end());
+                    uint32_t max = *std::max_element(naive.begin(), naive.end());
+
+                    const std::string where =
+                        " (window = " + std::to_string(window_size) +
+                        ", pattern = " + std::to_string(pattern) +
+                        ", push = " + std::to_string(c) + ")";
+                    if (stats.size() != naive.size() || stats.full() != (naive.size() == window_size)){
+                        return "Size is wrong." + where;
+                    }
+                    if (stats.sum() != sum || stats.sum_sqr() != sum_sqr){
+                        return "Sums are wrong." + where;
+                    }
+                    if (stats.min() != min || stats.max() != max){
+                        return "Min/max is wrong." + where;
+                    }
+                    if (stats.oldest() != naive.front() || stats.newest() != naive.back()){
+                        return "Oldest/newest is wrong." + where;
+                    }
+                    for (size_t i = 0; i < naive.size(); i++){
+                        if (stats[i] != naive[i]){
+                            return "Contents are wrong." + where;
+                        }
+                    }
+                    checks++;
+                }
+            }
+        }
+        logger.log("Checked " + std::to_string(checks) + " pushes.");
+        return true;
+    }
+};
+
+
+
+//  Sums the stats in the window.
+struct TestSumAccumulator{
+    using StatObject = uint64_t;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    void operator+=(uint64_t x){
+        count++;
+        sum += x;
+    }
+};
+
+
+//  Against the std::map that TimeWindowStatTracker used to have. Timestamps
+//  jitter so some arrive out of order and some are repeated.
+class Test_TimeWindowStatTracker : public UnitTest{
+public:
+    Test_TimeWindowStatTracker()
+        : UnitTest("CommonTools::TrendInference - TimeWindowStatTracker")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        using std::chrono::milliseconds;
+        using time_point = std::chrono::system_clock::time_point;
+
+        const milliseconds WINDOW(1000);
+        TimeWindowStatTracker<TestSumAccumulator> tracker(WINDOW);
+        std::map<time_point, uint64_t> naive;
+
+        auto naive_sum = [&](std::map<time_point, uint64_t>::const_iterator start, std::map<time_point, uint64_t>::const_iterator end){
+            TestSumAccumulator ret;
+            for (; start != end; ++start){
+                ret += start->second;
+            }
+            return ret;
+        };
+
+        std::mt19937 rng(0);
+        time_point now = time_point() + std::chrono::hours(1000);
+        for (size_t c = 0; c < 20000; c++){
+            if (c % 1024 == 0){
+                scope.throw_if_cancelled();
+            }
+
+            //  Mostly 16ms apart with the occasional stall.
+            now += milliseconds(c % 500 == 0 ? 3000 : 16);
+            time_point timestamp = now - milliseconds(rng() % 4 == 0 ? rng() % 40 : 0);
+            uint64_t value = rng() % 1000;
+
+            tracker.push(value, timestamp);
+            naive.emplace(timestamp, value);
+            time_point tail = timestamp - WINDOW;
+            while (!naive.empty() && naive.begin()->first < tail){
+                naive.erase(naive.begin());
+            }
+
+            const time_point newest = naive.rbegin()->first;
+            const milliseconds offset(rng() % 1200);
+            struct Check{
+                const char* name;
+                TestSumAccumulator actual;
+                TestSumAccumulator expected;
+            };
+            Check checks[] = {
+                {"accumulate_all()", tracker.accumulate_all(), naive_sum(naive.begin(), naive.end())},
+                {"accumulate_last()", tracker.accumulate_last(offset), naive_sum(naive.lower_bound(newest - offset), naive.end())},
+                {"accumulate_start_to_point(duration)", tracker.accumulate_start_to_point(offset), naive_sum(naive.begin(), naive.upper_bound(newest - offset))},
+                {"accumulate_start_to_point(time)", tracker.accumulate_start_to_point(newest - offset), naive_sum(naive.begin(), naive.upper_bound(newest - offset))},
+                {"accumulate(start, end)", tracker.accumulate(newest - offset - milliseconds(200), newest - offset), naive_sum(naive.lower_bound(newest - offset - milliseconds(200)), naive.upper_bound(newest - offset))},
+            };
+            for (const Check& check : checks){
+                if (check.actual.count != check.expected.count || check.actual.sum != check.expected.sum){
+                    return std::string(check.name) + " is wrong at push " + std::to_string(c) + ".";
+                }
+            }
+            if (tracker.oldest() != naive.begin()->second || tracker.newest() != naive.rbegin()->second){
+                return "Oldest/newest is wrong at push " + std::to_string(c) + ".";
+            }
+        }
+        return true;
+    }
+};
+
+
+
+void add_tests_SlidingWindowStats(UnitTestDatabase& database){
+    database.add<Test_SlidingWindowStats>();
+    database.add<Test_TimeWindowStatTracker>();
+}
+
+
+
+void benchmark_SlidingWindowStats(Logger& logger, size_t pushes){
+    std::vector<uint32_t> values(pushes);
+    std::mt19937 rng(0);
+    for (uint32_t& x : values){
+        x = rng() >> 8;
+    }
+
+    auto nanoseconds_per_push = [&](WallClock start){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(current_time() - start).count() / (double)pushes;
+    };
+
+    for (size_t window_size : {16, 64, 256, 1024}){
+        //  What AnomalyDetector used to do.
+        uint64_t checksum0 = 0;
+        WallClock start = current_time();
+        {
+            std::deque<uint32_t> window;
+            uint64_t sum = 0;
+            uint64_t sum_sqr = 0;
+            for (uint32_t x : values){
+                if (window.size() >= window_size){
+                    uint32_t old = window.front();
+                    window.pop_front();
+                    sum -= old;
+                    sum_sqr -= (uint64_t)old * old;
+                }
+                window.emplace_back(x);
+                sum += x;
+                sum_sqr += (uint64_t)x * x;
+                checksum0 += sum ^ sum_sqr;
+            }
+        }
+        double deque_sums = nanoseconds_per_push(start);
+
+        //  Same, plus scanning the window for min/max.
+        uint64_t checksum1 = 0;
+        start = current_time();
+        {
+            std::deque<uint32_t> window;
+            for (uint32_t x : values){
+                if (window.size() >= window_size){
+                    window.pop_front();
+                }
+                window.emplace_back(x);
+                auto minmax = std::minmax_element(window.begin(), window.end());
+                checksum1 += *minmax.first ^ *minmax.second;
+            }
+        }
+        double deque_minmax = nanoseconds_per_push(start);
+
+        uint64_t checksum2 = 0;
+        uint64_t checksum3 = 0;
+        start = current_time();
+        {
+            SlidingWindowStats<uint32_t, uint64_t> window(window_size);
+            for (uint32_t x : values){
+                window.push(x);
+                checksum2 += window.sum() ^ window.sum_sqr();
+                checksum3 += window.min() ^ window.max();
+            }
+        }
+        double ring = nanoseconds_per_push(start);
+
+        logger.log(
+            "Window = " + std::to_string(window_size) +
+            ": deque + sums = " + tostr_fixed(deque_sums, 1) +
+            " ns, deque + min/max scan = " + tostr_fixed(deque_minmax, 1) +
+            " ns, SlidingWindowStats (sums + min/max) = " + tostr_fixed(ring, 1) + " ns per push"
+        );
+        if (checksum0 != checksum2 || checksum1 != checksum3){
+            logger.log("Results don't match.", COLOR_RED);
+        }
+    }
+}
+
+
+
+}
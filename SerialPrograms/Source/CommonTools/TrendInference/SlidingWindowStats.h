@@ -0,0 +1,130 @@
+/*  Sliding Window Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  The last N values of a stream with O(1) sum, sum of squares, min and max.
+ *  Everything is kept in fixed-size ring buffers so pushing never allocates.
+ *
+ *  The sums are updated by adding the new value and subtracting the one that
+ *  falls out of the window. Use an integer (or fixed-point) "Value" and a
+ *  "Sum" wide enough to hold the window to keep them exact. Floating-point
+ *  sums will drift.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonTools_SlidingWindowStats_H
+#define PokemonAutomation_CommonTools_SlidingWindowStats_H
+
+#include <stddef.h>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Containers/CircularBuffer.h"
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace PokemonAutomation{
+
+
+template <typename Value, typename Sum = Value>
+class SlidingWindowStats{
+public:
+    SlidingWindowStats(size_t window_size)
+        : m_window(window_size)
+        , m_min(window_size)
+        , m_max(window_size)
+    {
+        if (window_size == 0){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "SlidingWindowStats: Window size cannot be zero.");
+        }
+    }
+
+    size_t window_size() const{ return m_window.capacity(); }
+    size_t size() const{ return m_window.size(); }
+    bool empty() const{ return m_window.empty(); }
+    bool full() const{ return m_window.full(); }
+
+    //  0 is the oldest value.
+    const Value& operator[](size_t index) const{ return m_window[index]; }
+    const Value& oldest() const{ return m_window.front(); }
+    const Value& newest() const{ return m_window.back(); }
+
+    const Sum& sum() const{ return m_sum; }
+    const Sum& sum_sqr() const{ return m_sum_sqr; }
+
+    //  The window must not be empty.
+    const Value& min() const{ return m_window[m_min.front() - m_first]; }
+    const Value& max() const{ return m_window[m_max.front() - m_first]; }
+
+    //  Add a value. If the window is full, the oldest value is dropped.
+    void push(const Value& x){
+        if (m_window.full()){
+            pop_oldest();
+        }
+        size_t index = m_first + m_window.size();
+        m_window.push_back(x);
+        m_sum += (Sum)x;
+        m_sum_sqr += (Sum)x * (Sum)x;
+
+        //  A value can never be the min while a newer one is smaller. So the
+        //  candidates are increasing from oldest to newest. (decreasing for max)
+        while (!m_min.empty() && !(m_window[m_min.back() - m_first] < x)){
+            m_min.pop_back();
+        }
+        m_min.push_back(index);
+        while (!m_max.empty() && !(x < m_window[m_max.back() - m_first])){
+            m_max.pop_back();
+        }
+        m_max.push_back(index);
+    }
+
+    void clear(){
+        m_window.clear();
+        m_min.clear();
+        m_max.clear();
+        m_first = 0;
+        m_sum = Sum();
+        m_sum_sqr = Sum();
+    }
+
+
+private:
+    void pop_oldest(){
+        const Value& x = m_window.front();
+        m_sum -= (Sum)x;
+        m_sum_sqr -= (Sum)x * (Sum)x;
+        if (m_min.front() == m_first){
+            m_min.pop_front();
+        }
+        if (m_max.front() == m_first){
+            m_max.pop_front();
+        }
+        m_window.pop_front();
+        m_first++;
+    }
+
+
+private:
+    CircularBuffer<Value> m_window;
+
+    //  # of values that have been dropped. Values are identified by the order
+    //  they were pushed in so "m_window[index - m_first]" is the value.
+    size_t m_first = 0;
+
+    Sum m_sum = Sum();
+    Sum m_sum_sqr = Sum();
+
+    //  Values that can still become the min/max.
+    CircularBuffer<size_t> m_min;
+    CircularBuffer<size_t> m_max;
+};
+
+
+
+void add_tests_SlidingWindowStats(UnitTestDatabase& database);
+
+//  Per-push cost of SlidingWindowStats vs. the std::deque + running sums
+//  that the anomaly detectors used to have.
+void benchmark_SlidingWindowStats(Logger& logger, size_t pushes);
+
+
+
+}
+#endif
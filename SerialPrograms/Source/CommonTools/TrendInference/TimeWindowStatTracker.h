@@ -8,11 +8,14 @@
 #define PokemonAutomation_CommonTools_TimeWindowStatTracker_H
 
 #include <chrono>
-#include <map>
+#include <utility>
+#include "Common/Cpp/Containers/CircularBuffer.h"
 
 namespace PokemonAutomation{
 
 
+//  The entries are kept oldest to newest in a ring buffer that grows when it
+//  fills up. Once it's big enough for the window, pushing doesn't allocate.
 template <typename StatAccumulator>
 class TimeWindowStatTracker{
     using milliseconds = std::chrono::milliseconds;
@@ -22,6 +25,7 @@ class TimeWindowStatTracker{
 public:
     TimeWindowStatTracker(milliseconds window)
         : m_window(window)
+        , m_history(16)
     {}
 
     milliseconds window() const{
@@ -29,42 +33,27 @@ public:
     }
 
     const StatObject& oldest() const{
-        return m_history.begin()->second;
+        return m_history.front().stats;
     }
     const StatObject& newest() const{
-        return m_history.rbegin()->second;
+        return m_history.back().stats;
     }
 
     system_clock::time_point push(
         const StatObject& stats,
         system_clock::time_point timestamp = system_clock::now()
     ){
-        m_history.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(timestamp),
-            std::forward_as_tuple(stats)
-        );
-
-        system_clock::time_point tail = timestamp - m_window;
-        while (!m_history.empty() && m_history.begin()->first < tail){
-            m_history.erase(m_history.begin());
-        }
-
-        return timestamp;
+        return push(StatObject(stats), timestamp);
     }
     system_clock::time_point push(
         StatObject&& stats,
         system_clock::time_point timestamp = system_clock::now()
     ){
-        m_history.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(timestamp),
-            std::forward_as_tuple(std::move(stats))
-        );
+        insert(timestamp, std::move(stats));
 
         system_clock::time_point tail = timestamp - m_window;
-        while (!m_history.empty() && m_history.begin()->first < tail){
-            m_history.erase(m_history.begin());
+        while (!m_history.empty() && m_history.front().timestamp < tail){
+            m_history.pop_front();
         }
 
         return timestamp;
@@ -72,7 +61,7 @@ public:
 
     //  Accumulate entire history.
     StatAccumulator accumulate_all() const{
-        return accumulate(m_history.begin(), m_history.end());
+        return accumulate(0, m_history.size());
     }
 
     //  Accumulate [latest - duration, latest].
@@ -81,9 +70,9 @@ public:
     ) const{
         return accumulate(
             m_history.empty()
-                ? m_history.end()
-                : m_history.lower_bound(m_history.rbegin()->first - duration),
-            m_history.end()
+                ? m_history.size()
+                : lower_bound(m_history.back().timestamp - duration),
+            m_history.size()
         );
     }
 
@@ -91,7 +80,7 @@ public:
     StatAccumulator accumulate_start_to_point(
         system_clock::time_point point
     ) const{
-        return accumulate(m_history.begin, m_history.upper_bound(point));
+        return accumulate(0, upper_bound(point));
     }
 
     //  Accumulate [oldest, latest - time_behind_latest].
@@ -99,10 +88,10 @@ public:
         milliseconds time_behind_latest
     ) const{
         return accumulate(
-            m_history.begin(),
+            0,
             m_history.empty()
-                ? m_history.end()
-                : m_history.upper_bound(m_history.rbegin()->first - time_behind_latest)
+                ? m_history.size()
+                : upper_bound(m_history.back().timestamp - time_behind_latest)
         );
     }
 
@@ -111,20 +100,68 @@ public:
         system_clock::time_point start,
         system_clock::time_point end
     ) const{
-        return accumulate(m_history.lower_bound(start), m_history.upper_bound(end));
+        return accumulate(lower_bound(start), upper_bound(end));
     }
 
 
 private:
-    using const_iterator_type = typename std::map<system_clock::time_point, StatObject>::const_iterator;
+    struct Entry{
+        system_clock::time_point timestamp;
+        StatObject stats;
+    };
+
+    //  Like std::map::emplace(), a timestamp that's already there is ignored.
+    void insert(system_clock::time_point timestamp, StatObject&& stats){
+        size_t index = m_history.empty() || m_history.back().timestamp < timestamp
+            ? m_history.size()
+            : lower_bound(timestamp);
+        if (index < m_history.size() && m_history[index].timestamp == timestamp){
+            return;
+        }
 
-    StatAccumulator accumulate(
-        const_iterator_type start,
-        const_iterator_type end
-    ) const{
+        if (m_history.full()){
+            CircularBuffer<Entry> bigger(2 * m_history.capacity());
+            while (!m_history.empty()){
+                bigger.push_back(std::move(m_history.front()));
+                m_history.pop_front();
+            }
+            m_history = std::move(bigger);
+        }
+
+        m_history.push_back(Entry{timestamp, std::move(stats)});
+
+        //  Out of order. Shift it back into place.
+        for (size_t c = m_history.size() - 1; c > index; c--){
+            std::swap(m_history[c], m_history[c - 1]);
+        }
+    }
+
+    //  Index of the first entry for which "before(timestamp)" is false.
+    template <typename Before>
+    size_t partition_point(Before&& before) const{
+        size_t low = 0;
+        size_t high = m_history.size();
+        while (low < high){
+            size_t mid = low + (high - low) / 2;
+            if (before(m_history[mid].timestamp)){
+                low = mid + 1;
+            }else{
+                high = mid;
+            }
+        }
+        return low;
+    }
+    size_t lower_bound(system_clock::time_point timestamp) const{
+        return partition_point([&](system_clock::time_point x){ return x < timestamp; });
+    }
+    size_t upper_bound(system_clock::time_point timestamp) const{
+        return partition_point([&](system_clock::time_point x){ return !(timestamp < x); });
+    }
+
+    StatAccumulator accumulate(size_t start, size_t end) const{
         StatAccumulator accumulator;
-        for (; start != end; ++start){
-            accumulator += start->second;
+        for (; start < end; start++){
+            accumulator += m_history[start].stats;
         }
         return accumulator;
     }
@@ -132,7 +169,7 @@ private:
 
 private:
     milliseconds m_window;
-    std::map<system_clock::time_point, StatObject> m_history;
+    CircularBuffer<Entry> m_history;
 
 };
 
@@ -4,6 +4,8 @@
  *
  */
 
+#include <deque>
+#include "Common/Cpp/Concurrency/Mutex.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/ImageTools/ImageDiff.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayScopes.h"
@@ -16,6 +18,46 @@
 namespace PokemonAutomation{
 
 
+//  Signatures of the last few frames so that detectors watching the same box
+//  of the same frame only sum it once.
+static std::shared_ptr<const ImageMatch::ImageSignature> frame_signature(
+    const VideoSnapshot& frame, const ImageFloatBox& box
+){
+    struct Entry{
+        std::weak_ptr<const ImageRGB32> frame;
+        const ImageRGB32* pointer;
+        ImageFloatBox box;
+        std::shared_ptr<const ImageMatch::ImageSignature> signature;
+    };
+    static const size_t MAX_ENTRIES = 16;
+    static Mutex lock;
+    static std::deque<Entry> cache;
+
+    auto same_box = [&](const ImageFloatBox& x){
+        return x.x == box.x && x.y == box.y && x.width == box.width && x.height == box.height;
+    };
+    {
+        std::lock_guard<Mutex> lg(lock);
+        for (const Entry& entry : cache){
+            //  The weak pointer can't match a new frame at a reused address.
+            if (entry.pointer == frame.frame.get() && !entry.frame.expired() && same_box(entry.box)){
+                return entry.signature;
+            }
+        }
+    }
+
+    std::shared_ptr<const ImageMatch::ImageSignature> signature =
+        std::make_shared<const ImageMatch::ImageSignature>(extract_box_reference(frame, box));
+
+    std::lock_guard<Mutex> lg(lock);
+    cache.emplace_back(Entry{frame.frame, frame.frame.get(), box, signature});
+    if (cache.size() > MAX_ENTRIES){
+        cache.pop_front();
+    }
+    return signature;
+}
+
+
 FrozenImageDetector::FrozenImageDetector(std::chrono::milliseconds timeout, double rmsd_threshold)
     : VisualInferenceCallback("FrozenImageDetector")
     , m_color(COLOR_CYAN)
@@ -36,19 +78,31 @@ FrozenImageDetector::FrozenImageDetector(
 void FrozenImageDetector::make_overlays(VideoOverlaySet& set) const{
     set.add(m_color, m_box);
 }
+bool FrozenImageDetector::changed(const ImageViewRGB32& current, const ImageMatch::ImageSignature& signature){
+    if (!m_previous_signature){
+        m_previous_signature = frame_signature(m_previous, m_box);
+    }
+
+    //  Most moving frames are decided here without touching the pixels again.
+    if (m_previous_signature->exceeds(signature, m_rmsd_threshold)){
+        return true;
+    }
+
+    double rmsd = ImageMatch::pixel_RMSD(extract_box_reference(m_previous, m_box), current);
+//    cout << "rmsd = " << rmsd << endl;
+    return rmsd > m_rmsd_threshold;
+}
 bool FrozenImageDetector::process_frame(const VideoSnapshot& frame){
     if (m_previous->width() != frame->width() || m_previous->height() != frame->height()){
         m_previous = frame;
+        m_previous_signature.reset();
         return false;
     }
 
-    double rmsd = ImageMatch::pixel_RMSD(
-        extract_box_reference(m_previous, m_box),
-        extract_box_reference(frame, m_box)
-    );
-//    cout << "rmsd = " << rmsd << endl;
-    if (rmsd > m_rmsd_threshold){
+    std::shared_ptr<const ImageMatch::ImageSignature> signature = frame_signature(frame, m_box);
+    if (changed(extract_box_reference(frame, m_box), *signature)){
         m_previous = frame;
+        m_previous_signature = std::move(signature);
         return false;
     }
 
@@ -56,7 +110,23 @@ bool FrozenImageDetector::process_frame(const VideoSnapshot& frame){
 //    return false;
 }
 bool FrozenImageDetector::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
-    return process_frame(VideoSnapshot(frame.copy(), timestamp));
+    if (m_previous->width() != frame.width() || m_previous->height() != frame.height()){
+        m_previous = VideoSnapshot(frame.copy(), timestamp);
+        m_previous_signature.reset();
+        return false;
+    }
+
+    //  Only copy the frame if it becomes the new reference.
+    ImageViewRGB32 current = extract_box_reference(frame, m_box);
+    std::shared_ptr<const ImageMatch::ImageSignature> signature =
+        std::make_shared<const ImageMatch::ImageSignature>(current);
+    if (changed(current, *signature)){
+        m_previous = VideoSnapshot(frame.copy(), timestamp);
+        m_previous_signature = std::move(signature);
+        return false;
+    }
+
+    return timestamp - m_previous.timestamp > m_timeout;
 }
 
 
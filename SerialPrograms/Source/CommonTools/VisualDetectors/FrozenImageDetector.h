@@ -8,9 +8,11 @@
 #ifndef PokemonAutomation_CommonTools_FrozenImageDetector_H
 #define PokemonAutomation_CommonTools_FrozenImageDetector_H
 
+#include <memory>
 #include "Common/Cpp/Color.h"
 //#include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "CommonFramework/ImageTools/ImageSignature.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "CommonTools/InferenceCallbacks/VisualInferenceCallback.h"
 
@@ -29,12 +31,17 @@ public:
     virtual bool process_frame(const VideoSnapshot& frame) override;
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
 
+private:
+    //  "current" is the box of the new frame.
+    bool changed(const ImageViewRGB32& current, const ImageMatch::ImageSignature& signature);
+
 private:
     Color m_color;
     ImageFloatBox m_box;
     std::chrono::milliseconds m_timeout;
     double m_rmsd_threshold;
     VideoSnapshot m_previous;
+    std::shared_ptr<const ImageMatch::ImageSignature> m_previous_signature;
 };
 
 
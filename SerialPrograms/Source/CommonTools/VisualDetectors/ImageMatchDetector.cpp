@@ -28,15 +28,16 @@ ImageMatchDetector::ImageMatchDetector(
     : m_reference_image(std::move(reference_image))
     , m_reference_image_cropped(extract_box_reference(*m_reference_image, box))
     , m_average_brightness(image_stats(m_reference_image_cropped).average)
+    , m_reference_signature(m_reference_image_cropped)
     , m_max_rmsd(max_rmsd)
     , m_scale_brightness(scale_brightness)
     , m_color(color)
     , m_box(box)
 {}
 
-double ImageMatchDetector::rmsd(const ImageViewRGB32& frame) const{
+ImageRGB32 ImageMatchDetector::prepare(const ImageViewRGB32& frame) const{
     if (!frame){
-        return 1000;
+        return ImageRGB32();
     }
     ImageViewRGB32 image = extract_box_reference(frame, m_box);
     ImageRGB32 scaled = image.scale_to(m_reference_image_cropped.width(), m_reference_image_cropped.height());
@@ -57,6 +58,13 @@ double ImageMatchDetector::rmsd(const ImageViewRGB32& frame) const{
         scale.bound(0.8, 1.2);
         ImageMatch::scale_brightness(scaled, scale);
     }
+    return scaled;
+}
+double ImageMatchDetector::rmsd(const ImageViewRGB32& frame) const{
+    if (!frame){
+        return 1000;
+    }
+    ImageRGB32 scaled = prepare(frame);
 
 //    cout << "asdf" << endl;
     double ret = ImageMatch::pixel_RMSD(m_reference_image_cropped, scaled);
@@ -68,7 +76,17 @@ void ImageMatchDetector::make_overlays(VideoOverlaySet& items) const{
     items.add(m_color, m_box);
 }
 bool ImageMatchDetector::detect(const ImageViewRGB32& screen){
-    return rmsd(screen) <= m_max_rmsd;
+    if (!screen){
+        return false;
+    }
+    ImageRGB32 scaled = prepare(screen);
+
+    //  Same result as "rmsd(screen) <= m_max_rmsd". Most non-matching frames
+    //  are rejected by the signatures.
+    if (m_reference_signature.exceeds(ImageMatch::ImageSignature(scaled), m_max_rmsd)){
+        return false;
+    }
+    return ImageMatch::pixel_RMSD(m_reference_image_cropped, scaled) <= m_max_rmsd;
 }
 
 
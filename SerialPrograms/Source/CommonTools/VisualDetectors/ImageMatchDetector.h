@@ -12,6 +12,7 @@
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "CommonFramework/ImageTools/FloatPixel.h"
+#include "CommonFramework/ImageTools/ImageSignature.h"
 #include "CommonTools/InferenceCallbacks/VisualInferenceCallback.h"
 #include "CommonTools/VisualDetector.h"
 
@@ -30,10 +31,16 @@ public:
     virtual void make_overlays(VideoOverlaySet& items) const override;
     virtual bool detect(const ImageViewRGB32& screen) override;
 
+private:
+    //  The box of the frame, scaled to the reference and brightness adjusted.
+    //  Null if the frame is null.
+    ImageRGB32 prepare(const ImageViewRGB32& frame) const;
+
 private:
     std::shared_ptr<const ImageRGB32> m_reference_image;
     ImageViewRGB32 m_reference_image_cropped;
     FloatPixel m_average_brightness;
+    ImageMatch::ImageSignature m_reference_signature;
 
     double m_max_rmsd;
     bool m_scale_brightness;
@@ -10,14 +10,23 @@
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/ProgramStats/StatsTracking.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/Tools/TelemetryFile.h"
+#include "CommonTools/InferenceCallbacks/ChangeGatedInferenceCallback.h"
+#include "CommonTools/Images/WaterfillCellGrid.h"
+#include "CommonTools/TrendInference/SlidingWindowStats.h"
 #include "CommonTools/VisualDetectors/BlackBorderDetector.h"
+#include "ML/Models/ML_YOLOv5Model.h"
+#include "ML/DataLabeling/ML_SegmentAnythingEmbeddingJob.h"
 #include "NintendoSwitch/Inference/NintendoSwitch_CheckOnlineDetector.h"
 #include "NintendoSwitch/Inference/NintendoSwitch_FailedToConnectDetector.h"
 #include "NintendoSwitch/Inference/NintendoSwitch_UpdatePopupDetector.h"
+#include "NintendoSwitch/Controllers/SysbotBase/SysbotBase3_CommandPipeline.h"
 #include "UnitTestRunner.h"
 
+#include "CommonFramework/Tests/CommonFramework_Tests.h"
 #include "CommonTools/OCR/OCR_Tests.h"
 #include "Kernels/Kernels_Tests.h"
+#include "PokemonBDSP/PokemonBDSP_Tests.h"
 #include "PokemonFRLG/PokemonFRLG_Tests.h"
 #include "PokemonHome/PokemonHome_Tests.h"
 #include "PokemonSwSh/PokemonSwSh_Tests.h"
@@ -37,11 +46,20 @@ UnitTestDatabase make_UNIT_TESTS_ALL(){
     UnitTestDatabase ret;
 
     add_tests_BlackBorderDetector(ret);
+    add_tests_ChangeGatedInference(ret);
+    add_tests_WaterfillCellGrid(ret);
+    add_tests_SlidingWindowStats(ret);
+    add_tests_TelemetryFile(ret);
+    CommonFramework::add_tests(ret);
     OCR::add_tests(ret);
     Kernels::add_tests(ret);
+    ML::add_tests_YOLOv5Model(ret);
+    ML::add_tests_SAMEmbeddingJob(ret);
     NintendoSwitch::add_tests_CheckOnlineDetector(ret);
     NintendoSwitch::add_tests_FailedToConnectDetector(ret);
     NintendoSwitch::add_tests_UpdatePopupDetector(ret);
+    NintendoSwitch::add_tests_SysbotBase3CommandPipeline(ret);
+    NintendoSwitch::PokemonBDSP::add_tests(ret);
     NintendoSwitch::PokemonFRLG::add_tests(ret);
     NintendoSwitch::PokemonHome::add_tests(ret);
     NintendoSwitch::PokemonSwSh::add_tests(ret);
@@ -7,6 +7,7 @@
 #include <string.h>
 #include "Common/PABotBase2/PABotBase2CC_MessageDumper.h"
 #include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Tracing/Tracing.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "PABotBase2_CommandQueueManager.h"
 
@@ -41,8 +42,11 @@ bool CommandQueueManager::cancel(std::exception_ptr exception) noexcept{
 
 void CommandQueueManager::wait_for_all(Cancellable* cancellable){
     std::unique_lock<Mutex> lg(m_lock);
-    while (!m_pending_commands.empty()){
+    while (!m_pending_commands.empty() || !m_pending_batch.empty() || m_batch_sending){
         throw_if_cancelled(cancellable);
+        if (try_push_pending_batch(cancellable, true)){
+            continue;
+        }
         cv_wait(cancellable, lg);
     }
 }
@@ -66,6 +70,8 @@ void CommandQueueManager::send_cancel() noexcept{
     {
         std::unique_lock<Mutex> lg(m_lock);
         m_pending_special = PABB2_MESSAGE_OPCODE_CQ_CANCEL;
+        m_pending_batch.clear();
+        m_batch_dropped = m_batch_sending;
         success = try_push_pending_specials();
     }
     if (success){
@@ -79,6 +85,8 @@ void CommandQueueManager::send_replace_on_next() noexcept{
         if (m_pending_special != PABB2_MESSAGE_OPCODE_CQ_CANCEL){
             m_pending_special = PABB2_MESSAGE_OPCODE_CQ_REPLACE_ON_NEXT;
         }
+        m_pending_batch.clear();
+        m_batch_dropped = m_batch_sending;
         success = try_push_pending_specials();
     }
     if (success){
@@ -88,6 +96,7 @@ void CommandQueueManager::send_replace_on_next() noexcept{
 
 
 uint8_t CommandQueueManager::send_command(Cancellable* cancellable, MessageHeader& command){
+    PA_TRACE_SCOPE("CommandQueueManager::send_command");
     {
         bool need_to_wait = false;
         std::unique_lock<Mutex> lg(m_lock);
@@ -99,6 +108,15 @@ uint8_t CommandQueueManager::send_command(Cancellable* cancellable, MessageHeade
             need_to_wait = true;
             throw_if_cancelled(cancellable);
 
+            //  Anything still in the batch goes first.
+            if (m_batch_sending){
+                continue;
+            }
+            if (!m_pending_batch.empty()){
+                need_to_wait = !try_push_pending_batch(cancellable, true);
+                continue;
+            }
+
             if (m_pending_commands.size() >= m_command_queue_size){
                 continue;
             }
@@ -129,6 +147,7 @@ uint8_t CommandQueueManager::send_command(Cancellable* cancellable, MessageHeade
             m_lock.lock();
 
             m_command_seqnum++;
+            PA_TRACE_COUNTER("PABotBase2 Pending Commands", m_pending_commands.size());
             break;
         }
     }
@@ -138,6 +157,51 @@ uint8_t CommandQueueManager::send_command(Cancellable* cancellable, MessageHeade
     m_cv.notify_all();
     return command.id;
 }
+void CommandQueueManager::send_batched_command(
+    Cancellable* cancellable,
+    uint8_t batch_opcode,
+    const void* entry, size_t entry_bytes
+){
+    {
+        std::unique_lock<Mutex> lg(m_lock);
+        try_push_pending_specials();
+        while (true){
+            throw_if_cancelled(cancellable);
+
+            if (m_batch_sending){
+                cv_wait(cancellable, lg);
+                continue;
+            }
+            if (m_pending_batch.empty()){
+                break;
+            }
+
+            const MessageHeader* header = (const MessageHeader*)m_pending_batch.data();
+            size_t entries = (m_pending_batch.size() - sizeof(MessageHeader)) / entry_bytes;
+            if (header->opcode == batch_opcode && entries < PABB2_MESSAGE_COMMAND_BATCH_MAX_ENTRIES){
+                break;
+            }
+
+            //  Can't add to the current batch. Send it first.
+            if (!try_push_pending_batch(cancellable, true)){
+                cv_wait(cancellable, lg);
+            }
+        }
+
+        if (m_pending_batch.empty()){
+            MessageHeader header;
+            header.message_bytes = sizeof(MessageHeader);
+            header.opcode = batch_opcode;
+            header.id = 0;
+            m_pending_batch.assign((const char*)&header, sizeof(MessageHeader));
+        }
+        m_pending_batch.append((const char*)entry, entry_bytes);
+        ((MessageHeader*)m_pending_batch.data())->message_bytes = (uint16_t)m_pending_batch.size();
+
+        try_push_pending_batch(cancellable, true);
+    }
+    m_cv.notify_all();
+}
 void CommandQueueManager::report_command_finished(const MessageHeader& finished_message){
     {
         std::lock_guard<Mutex> lg(m_lock);
@@ -155,6 +219,9 @@ void CommandQueueManager::report_command_finished(const MessageHeader& finished_
         );
         m_pending_commands.erase(iter);
         try_push_pending_specials();
+        try{
+            try_push_pending_batch(nullptr, false);
+        }catch (...){}
     }
     m_cv.notify_all();
 }
@@ -194,6 +261,76 @@ bool CommandQueueManager::try_push_pending_specials() noexcept{
     m_message_loggers.log_send(m_logger, LOG_EVERYTHING(), &message);
     return true;
 }
+bool CommandQueueManager::try_push_pending_batch(Cancellable* cancellable, bool blocking){
+    //  Must call under lock.
+    //  If not "blocking", this will not wait for room in the stream. It is
+    //  safe to call from the receive thread.
+    if (m_pending_batch.empty() || m_batch_sending){
+        return false;
+    }
+    if (m_pending_commands.size() >= m_command_queue_size){
+        return false;
+    }
+
+    uint8_t id = m_command_seqnum;
+    bool success = m_pending_commands.emplace(
+        id,
+        std::make_shared<CommandHandle>()
+    ).second;
+    if (!success){
+        return false;
+    }
+
+    //  Take the batch so nothing gets added to it while it's being sent.
+    std::string message = std::move(m_pending_batch);
+    m_pending_batch.clear();
+    ((MessageHeader*)message.data())->id = id;
+    m_batch_sending = true;
+    m_batch_dropped = false;
+
+    m_lock.unlock();
+
+    bool sent = false;
+    try{
+        if (blocking){
+            m_connection.reliable_send_all_or_nothing(
+                cancellable,
+                message.data(), message.size()
+            );
+            sent = true;
+        }else{
+            sent = m_connection.reliable_send_all_or_nothing(
+                nullptr,
+                message.data(), message.size(),
+                current_time()
+            );
+        }
+    }catch (...){
+        m_lock.lock();
+        m_batch_sending = false;
+        m_pending_commands.erase(id);
+        m_cv.notify_all();
+        throw;
+    }
+
+    m_lock.lock();
+    m_batch_sending = false;
+    m_cv.notify_all();
+
+    if (!sent){
+        m_pending_commands.erase(id);
+
+        //  Put it back unless it was cancelled while we were trying.
+        if (!m_batch_dropped){
+            m_pending_batch = std::move(message);
+        }
+        return false;
+    }
+
+    m_command_seqnum++;
+    m_message_loggers.log_send(m_logger, LOG_EVERYTHING(), (const MessageHeader*)message.data());
+    return true;
+}
 
 
 void CommandQueueManager::on_cancellable_cancel(
@@ -8,6 +8,7 @@
 #define PokemonAutomation_Controllers_PABotBase2_CommandQueue_H
 
 #include <map>
+#include <string>
 #include "Common/Cpp/Logging/AbstractLogger.h"
 #include "Common/Cpp/Concurrency/Mutex.h"
 #include "Common/Cpp/Concurrency/ConditionVariable.h"
@@ -53,11 +54,25 @@ public:
     void send_replace_on_next() noexcept;
 
     uint8_t send_command(Cancellable* cancellable, MessageHeader& command);
+
+    //  Send one entry of a batched command. (see PABB2_MESSAGE_COMMAND_BATCH_MAX_ENTRIES)
+    //
+    //  If a command slot is free, the entry is sent right away as a batch of
+    //  one. Otherwise it is appended to a pending batch that is sent as soon
+    //  as a slot frees up. This only blocks if the pending batch is full or
+    //  is for a different opcode.
+    void send_batched_command(
+        Cancellable* cancellable,
+        uint8_t batch_opcode,
+        const void* entry, size_t entry_bytes
+    );
+
     void report_command_finished(const MessageHeader& finished_message);
 
 
 private:
     bool try_push_pending_specials() noexcept;
+    bool try_push_pending_batch(Cancellable* cancellable, bool blocking);
 
     virtual void on_cancellable_cancel(
         Cancellable& cancellable,
@@ -79,6 +94,11 @@ private:
 
     uint8_t m_pending_special = PABB2_MESSAGE_OPCODE_INVALID;
 
+    //  Batched command that hasn't been sent yet. Empty if none.
+    std::string m_pending_batch;
+    bool m_batch_sending = false;
+    bool m_batch_dropped = false;
+
     SpinLock m_pending_commands_lock;
     struct CommandHandle{
         bool finished = false;
@@ -75,6 +75,9 @@ public:
     uint32_t device_protocol_version() const{
         return m_device_protocol;
     }
+    bool supports_command_batching() const{
+        return m_device_protocol % 100 >= PABB2_MESSAGE_MINOR_VERSION_COMMAND_BATCH;
+    }
     const std::vector<ControllerType>& controller_list() const{
         return m_controller_list;
     }
@@ -163,7 +163,7 @@ bool SerialPABotBase2_Connection::open_serial_port(){
     }
 
     m_unreliable_connection = std::make_unique<SerialConnection>(
-        GlobalThreadPools::unlimited_realtime(),
+        GlobalThreadPools::unlimited_serial_io(),
         m_device_name,
         115200
     );
@@ -255,7 +255,7 @@ bool SerialPABotBase2_Connection::open_serial_connection(){
     m_stream_connection = std::make_unique<PABotBase2::ReliableStreamConnection>(
         static_cast<CancellableScope*>(this),
         m_logger, LOG_EVERYTHING(),
-        GlobalThreadPools::unlimited_realtime(),
+        GlobalThreadPools::unlimited_serial_io(),
         *m_unreliable_connection,
         std::chrono::milliseconds(80),
         nullptr
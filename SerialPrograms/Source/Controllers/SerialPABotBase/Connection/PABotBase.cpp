@@ -9,6 +9,7 @@
 #include "Common/Cpp/PanicDump.h"
 #include "Common/Cpp/Concurrency/SpinPause.h"
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
+#include "CommonFramework/Tools/TelemetryRecorder.h"
 #include "Controllers/SerialPABotBase/Messages/SerialPABotBase_MessageWrappers_BaseProtocol_StaticRequests.h"
 #include "Controllers/SerialPABotBase/Messages/SerialPABotBase_MessageWrappers_BaseProtocol_CommandQueue.h"
 #include "PABotBase.h"
@@ -812,6 +813,9 @@ uint64_t PABotBase::try_issue_command(
 
     m_send_seq = seqnum + 1;
 
+    static TelemetryChannel& telemetry = TelemetryRecorder::instance().channel("Controller/PABotBase Command Queue Depth");
+    telemetry.record((double)m_pending_commands.size());
+
     PendingCommand& handle = ret.first->second;
 
     handle.silent_remove = silent_remove;
@@ -57,6 +57,43 @@ DiscordWebhookSender& DiscordWebhookSender::instance(){
     return sender;
 }
 
+//  Add the file to the attachments. If it couldn't be written, leave it out
+//  and remove the embed images that point to it instead. Otherwise the whole
+//  message fails.
+static void add_attachment(
+    JsonValue& json,
+    std::vector<DiscordFileAttachment>& attachments,
+    const PendingFileSend& file
+){
+    const std::string& filepath = file.filepath();
+    if (!filepath.empty()){
+        attachments.emplace_back(DiscordFileAttachment{file.filename(), filepath});
+        return;
+    }
+
+    JsonObject* obj = json.to_object();
+    JsonArray* embeds = obj == nullptr ? nullptr : obj->get_array("embeds");
+    if (embeds == nullptr){
+        return;
+    }
+    const std::string url = "attachment://" + file.filename();
+    for (JsonValue& item : *embeds){
+        JsonObject* embed = item.to_object();
+        const JsonObject* image = embed == nullptr ? nullptr : embed->get_object("image");
+        const std::string* image_url = image == nullptr ? nullptr : image->get_string("url");
+        if (image_url == nullptr || *image_url != url){
+            continue;
+        }
+        JsonObject stripped;
+        for (const auto& field : *embed){
+            if (field.first != "image"){
+                stripped[field.first] = field.second.clone();
+            }
+        }
+        item = std::move(stripped);
+    }
+}
+
 void DiscordWebhookSender::send(
     Logger& logger,
     const QUrl& url, std::chrono::milliseconds delay,
@@ -79,9 +116,7 @@ void DiscordWebhookSender::send(
             throttle();
             std::vector<DiscordFileAttachment> attachments;
             if (file){
-                attachments.emplace_back(
-                    DiscordFileAttachment{file->filename(), file->filepath()}
-                );
+                add_attachment(*json, attachments, *file);
             }
             internal_send(url, *json, attachments);
             if (finish_callback){
@@ -112,9 +147,7 @@ void DiscordWebhookSender::send(
             throttle();
             std::vector<DiscordFileAttachment> attachments;
             for (auto& file : files){
-                attachments.emplace_back(
-                    DiscordFileAttachment{file->filename(), file->filepath()}
-                );
+                add_attachment(*json, attachments, *file);
             }
             internal_send(url, *json, attachments);
             if (finish_callback){
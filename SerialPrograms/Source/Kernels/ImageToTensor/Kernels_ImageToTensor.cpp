@@ -0,0 +1,72 @@
+/*  Image to Tensor
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageToTensor.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void packed_rgb8_to_planar_float_Default(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+);
+void packed_rgb8_to_planar_float_x64_SSE41(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+);
+void packed_rgb8_to_planar_float_x64_AVX2(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+);
+void packed_rgb8_to_planar_float_arm64_NEON(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+);
+
+
+
+void packed_rgb8_to_planar_float(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+){
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        packed_rgb8_to_planar_float_x64_AVX2(width, height, image, bytes_per_row, planes, floats_per_row, floats_per_plane, scale);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        packed_rgb8_to_planar_float_x64_SSE41(width, height, image, bytes_per_row, planes, floats_per_row, floats_per_plane, scale);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        packed_rgb8_to_planar_float_arm64_NEON(width, height, image, bytes_per_row, planes, floats_per_row, floats_per_plane, scale);
+        return;
+    }
+#endif
+    packed_rgb8_to_planar_float_Default(width, height, image, bytes_per_row, planes, floats_per_row, floats_per_plane, scale);
+}
+
+
+
+
+}
+}
@@ -0,0 +1,31 @@
+/*  Image to Tensor
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageToTensor_H
+#define PokemonAutomation_Kernels_ImageToTensor_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+// Convert a packed 3-channel 8-bit image (eg. cv::Mat CV_8UC3) into three planes of floats, multiplying
+// every value by `scale`. This is the HWC -> CHW conversion that ML models take as input.
+// image: row-major, 3 bytes per pixel; advance to next row by a step size of `bytes_per_row`.
+// planes: channel `c` of pixel (x, y) is written to `planes[c * floats_per_plane + y * floats_per_row + x]`.
+// The result is bit-identical to `(float)value * scale` regardless of which instruction set is used.
+void packed_rgb8_to_planar_float(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+);
+
+
+}
+}
+#endif
@@ -0,0 +1,51 @@
+/*  Image to Tensor (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+PA_FORCE_INLINE void packed_rgb8_to_planar_float_Default(
+    size_t width, const uint8_t* image,
+    float* r, float* g, float* b,
+    float scale
+){
+    for (size_t c = 0; c < width; c++){
+        r[c] = (float)image[0] * scale;
+        g[c] = (float)image[1] * scale;
+        b[c] = (float)image[2] * scale;
+        image += 3;
+    }
+}
+void packed_rgb8_to_planar_float_Default(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+){
+    if (width == 0 || height == 0){
+        return;
+    }
+    for (size_t r = 0; r < height; r++){
+        packed_rgb8_to_planar_float_Default(
+            width, image,
+            planes, planes + floats_per_plane, planes + 2*floats_per_plane,
+            scale
+        );
+        image += bytes_per_row;
+        planes += floats_per_row;
+    }
+}
+
+
+
+
+}
+}
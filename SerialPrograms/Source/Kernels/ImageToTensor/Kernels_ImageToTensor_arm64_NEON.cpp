@@ -0,0 +1,76 @@
+/*  Image to Tensor (arm64 NEON)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_arm64_20_M1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <arm_neon.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+namespace{
+
+PA_FORCE_INLINE void store_u8x8_as_float(float* out, uint8x8_t in, float scale){
+    uint16x8_t in_u16x8 = vmovl_u8(in);
+    float32x4_t lo_f32x4 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(in_u16x8)));
+    float32x4_t hi_f32x4 = vcvtq_f32_u32(vmovl_high_u16(in_u16x8));
+    vst1q_f32(out + 0, vmulq_n_f32(lo_f32x4, scale));
+    vst1q_f32(out + 4, vmulq_n_f32(hi_f32x4, scale));
+}
+
+PA_FORCE_INLINE void packed_rgb8_to_planar_float_arm64_NEON(
+    size_t width, const uint8_t* image,
+    float* r, float* g, float* b,
+    float scale
+){
+    //  8 pixels at a time. vld3 splits the channels for us.
+    size_t c = 0;
+    for (; c + 8 <= width; c += 8){
+        uint8x8x3_t pixels = vld3_u8(image);
+        store_u8x8_as_float(r + c, pixels.val[0], scale);
+        store_u8x8_as_float(g + c, pixels.val[1], scale);
+        store_u8x8_as_float(b + c, pixels.val[2], scale);
+        image += 24;
+    }
+    for (; c < width; c++){
+        r[c] = (float)image[0] * scale;
+        g[c] = (float)image[1] * scale;
+        b[c] = (float)image[2] * scale;
+        image += 3;
+    }
+}
+
+}
+
+void packed_rgb8_to_planar_float_arm64_NEON(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+){
+    if (width == 0 || height == 0){
+        return;
+    }
+    for (size_t r = 0; r < height; r++){
+        packed_rgb8_to_planar_float_arm64_NEON(
+            width, image,
+            planes, planes + floats_per_plane, planes + 2*floats_per_plane,
+            scale
+        );
+        image += bytes_per_row;
+        planes += floats_per_row;
+    }
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,87 @@
+/*  Image to Tensor (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+PA_FORCE_INLINE void packed_rgb8_to_planar_float_x64_AVX2(
+    size_t width, const uint8_t* image,
+    float* r, float* g, float* b,
+    __m256 scale
+){
+    //  Each lane holds 4 pixels in its low 12 bytes.
+    const __m256i shuffle_r = _mm256_setr_epi8(
+        0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1,  9, -1, -1, -1,
+        0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1,  9, -1, -1, -1
+    );
+    const __m256i shuffle_g = _mm256_setr_epi8(
+        1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1,
+        1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1
+    );
+    const __m256i shuffle_b = _mm256_setr_epi8(
+        2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1,
+        2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1
+    );
+
+    //  8 pixels at a time. The upper 4 pixels are loaded from 4 bytes early
+    //  and shifted down so that we never read past the 24 bytes we need.
+    size_t c = 0;
+    for (; c + 8 <= width; c += 8){
+        __m128i lo = _mm_loadu_si128((const __m128i*)image);
+        __m128i hi = _mm_srli_si128(_mm_loadu_si128((const __m128i*)(image + 8)), 4);
+        __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        __m256 fr = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(pixels, shuffle_r));
+        __m256 fg = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(pixels, shuffle_g));
+        __m256 fb = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(pixels, shuffle_b));
+        _mm256_storeu_ps(r + c, _mm256_mul_ps(fr, scale));
+        _mm256_storeu_ps(g + c, _mm256_mul_ps(fg, scale));
+        _mm256_storeu_ps(b + c, _mm256_mul_ps(fb, scale));
+        image += 24;
+    }
+
+    float s = _mm256_cvtss_f32(scale);
+    for (; c < width; c++){
+        r[c] = (float)image[0] * s;
+        g[c] = (float)image[1] * s;
+        b[c] = (float)image[2] * s;
+        image += 3;
+    }
+}
+void packed_rgb8_to_planar_float_x64_AVX2(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+){
+    if (width == 0 || height == 0){
+        return;
+    }
+    __m256 vscale = _mm256_set1_ps(scale);
+    for (size_t r = 0; r < height; r++){
+        packed_rgb8_to_planar_float_x64_AVX2(
+            width, image,
+            planes, planes + floats_per_plane, planes + 2*floats_per_plane,
+            vscale
+        );
+        image += bytes_per_row;
+        planes += floats_per_row;
+    }
+}
+
+
+
+}
+}
+#endif
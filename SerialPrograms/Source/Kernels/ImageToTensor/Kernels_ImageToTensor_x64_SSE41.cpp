@@ -0,0 +1,79 @@
+/*  Image to Tensor (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <smmintrin.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+PA_FORCE_INLINE void packed_rgb8_to_planar_float_x64_SSE41(
+    size_t width, const uint8_t* image,
+    float* r, float* g, float* b,
+    __m128 scale
+){
+    const __m128i shuffle_r = _mm_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1,  9, -1, -1, -1);
+    const __m128i shuffle_g = _mm_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1);
+    const __m128i shuffle_b = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+
+    //  4 pixels at a time. Load exactly 12 bytes so we never read past the
+    //  end of the image.
+    size_t c = 0;
+    for (; c + 4 <= width; c += 4){
+        uint32_t last;
+        memcpy(&last, image + 8, sizeof(uint32_t));
+        __m128i pixels = _mm_loadl_epi64((const __m128i*)image);
+        pixels = _mm_insert_epi32(pixels, (int)last, 2);
+
+        __m128 fr = _mm_cvtepi32_ps(_mm_shuffle_epi8(pixels, shuffle_r));
+        __m128 fg = _mm_cvtepi32_ps(_mm_shuffle_epi8(pixels, shuffle_g));
+        __m128 fb = _mm_cvtepi32_ps(_mm_shuffle_epi8(pixels, shuffle_b));
+        _mm_storeu_ps(r + c, _mm_mul_ps(fr, scale));
+        _mm_storeu_ps(g + c, _mm_mul_ps(fg, scale));
+        _mm_storeu_ps(b + c, _mm_mul_ps(fb, scale));
+        image += 12;
+    }
+
+    float s = _mm_cvtss_f32(scale);
+    for (; c < width; c++){
+        r[c] = (float)image[0] * s;
+        g[c] = (float)image[1] * s;
+        b[c] = (float)image[2] * s;
+        image += 3;
+    }
+}
+void packed_rgb8_to_planar_float_x64_SSE41(
+    size_t width, size_t height,
+    const uint8_t* image, size_t bytes_per_row,
+    float* planes, size_t floats_per_row, size_t floats_per_plane,
+    float scale
+){
+    if (width == 0 || height == 0){
+        return;
+    }
+    __m128 vscale = _mm_set1_ps(scale);
+    for (size_t r = 0; r < height; r++){
+        packed_rgb8_to_planar_float_x64_SSE41(
+            width, image,
+            planes, planes + floats_per_plane, planes + 2*floats_per_plane,
+            vscale
+        );
+        image += bytes_per_row;
+        planes += floats_per_row;
+    }
+}
+
+
+
+}
+}
+#endif
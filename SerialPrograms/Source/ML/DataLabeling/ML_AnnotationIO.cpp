@@ -18,6 +18,7 @@
 #include "ML_ObjectAnnotation.h"
 
 #include <fstream>
+#include <filesystem>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -33,16 +34,39 @@ namespace PokemonAutomation{
 namespace ML{
 
 // save the image embedding as a file with path <image_filepath>.embedding
-void save_image_embedding_to_disk(const std::string& image_filepath, const std::vector<float>& embedding){
+bool save_image_embedding_to_disk(const std::string& image_filepath, const std::vector<float>& embedding){
     const std::string embedding_path = image_filepath + ".embedding";
-    std::ofstream fout(embedding_path, std::ios::binary);
-    // write embedding shape
-    fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_N_CHANNELS), sizeof(SAM_EMBEDDER_OUTPUT_N_CHANNELS));
-    fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_IMAGE_SIZE), sizeof(SAM_EMBEDDER_OUTPUT_IMAGE_SIZE));
-    fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_IMAGE_SIZE), sizeof(SAM_EMBEDDER_OUTPUT_IMAGE_SIZE));
-    fout.write(reinterpret_cast<const char*>(embedding.data()), sizeof(float) * embedding.size());
-    fout.close();
+    // Write to a temp file first so that a failed or interrupted write never
+    // leaves a partial embedding under the real name.
+    const std::string temp_path = embedding_path + ".tmp";
+    {
+        std::ofstream fout(temp_path, std::ios::binary);
+        if (!fout.is_open()){
+            std::cerr << "Unable to open " << temp_path << std::endl;
+            return false;
+        }
+        // write embedding shape
+        fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_N_CHANNELS), sizeof(SAM_EMBEDDER_OUTPUT_N_CHANNELS));
+        fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_IMAGE_SIZE), sizeof(SAM_EMBEDDER_OUTPUT_IMAGE_SIZE));
+        fout.write(reinterpret_cast<const char*>(&SAM_EMBEDDER_OUTPUT_IMAGE_SIZE), sizeof(SAM_EMBEDDER_OUTPUT_IMAGE_SIZE));
+        fout.write(reinterpret_cast<const char*>(embedding.data()), sizeof(float) * embedding.size());
+        fout.close();
+        if (!fout){
+            std::cerr << "Unable to write image embedding " << temp_path << std::endl;
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    Filesystem::rename(temp_path, embedding_path, ec);
+    if (ec){
+        std::cerr << "Unable to rename " << temp_path << " to " << embedding_path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
     std::cout << "Saved image embedding as " << embedding_path << std::endl;
+    return true;
 }
 
 
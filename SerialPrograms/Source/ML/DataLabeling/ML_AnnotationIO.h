@@ -20,7 +20,9 @@ namespace ML{
 bool load_image_embedding(const std::string& image_filepath, std::vector<float>& image_embedding);
 
 // Save the image embedding as a file with path <image_filepath>.embedding.
-void save_image_embedding_to_disk(const std::string& image_filepath, const std::vector<float>& embedding);
+// Return false if the file can't be written. An existing embedding file is
+// only replaced once the new one has been written completely.
+bool save_image_embedding_to_disk(const std::string& image_filepath, const std::vector<float>& embedding);
 
 // Find image paths stored in a folder. The search can be recursive into child folders or not.
 std::vector<std::string> find_images_in_folder(const std::string& folder_path, bool recursive);
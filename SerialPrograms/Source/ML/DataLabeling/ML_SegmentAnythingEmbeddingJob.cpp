@@ -0,0 +1,660 @@
+/*  ML Segment Anything Embedding Job
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Compute Segment Anything Model (SAM) image embeddings for a folder of images
+ */
+
+#include <string.h>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <iostream>
+#include <exception>
+#include <QDir>
+#include <QFileInfo>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/Filesystem/Filesystem.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "Common/Cpp/TestRunners/UnitTestTempFolder.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "ML_AnnotationIO.h"
+#include "ML_SegmentAnythingModelConstants.h"
+#include "ML_SegmentAnythingModel.h"
+#include "ML_SegmentAnythingEmbeddingJob.h"
+
+namespace PokemonAutomation{
+namespace ML{
+
+
+
+const char* const SAMEmbeddingManifest::FILENAME = "sam_embeddings_manifest.txt";
+
+SAMEmbeddingManifest::SAMEmbeddingManifest(const std::string& folder_path)
+    : m_folder(QDir(QString::fromStdString(folder_path)).absolutePath().toStdString() + "/")
+    , m_path(m_folder + FILENAME)
+{
+    std::string content;
+    if (!file_to_string(m_path, content)){
+        return;
+    }
+    m_existed = true;
+    m_missing_newline = !content.empty() && content.back() != '\n';
+
+    // Each line is 16 hex digits, a space, then the relative path. The last
+    // line is ignored if it isn't finished.
+    size_t line_start = 0;
+    while (true){
+        size_t line_end = content.find('\n', line_start);
+        if (line_end == std::string::npos){
+            break;
+        }
+        std::string line = content.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+        while (!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        if (line.size() < 18 || line[16] != ' '){
+            continue;
+        }
+        uint64_t hash = 0;
+        bool ok = true;
+        for (size_t c = 0; c < 16; c++){
+            char ch = line[c];
+            uint64_t digit;
+            if ('0' <= ch && ch <= '9'){
+                digit = ch - '0';
+            }else if ('a' <= ch && ch <= 'f'){
+                digit = ch - 'a' + 10;
+            }else{
+                ok = false;
+                break;
+            }
+            hash = (hash << 4) | digit;
+        }
+        if (ok){
+            m_entries[line.substr(17)] = hash;
+        }
+    }
+}
+
+std::string SAMEmbeddingManifest::relative_path(const std::string& image_path) const{
+    if (image_path.size() > m_folder.size() && image_path.compare(0, m_folder.size(), m_folder) == 0){
+        return image_path.substr(m_folder.size());
+    }
+    return image_path;
+}
+
+bool SAMEmbeddingManifest::contains(const std::string& relative_path) const{
+    return m_entries.find(relative_path) != m_entries.end();
+}
+bool SAMEmbeddingManifest::contains(const std::string& relative_path, uint64_t hash) const{
+    auto iter = m_entries.find(relative_path);
+    return iter != m_entries.end() && iter->second == hash;
+}
+
+void SAMEmbeddingManifest::append(const std::string& relative_path, uint64_t hash){
+    std::string line = tostr_hex_padded(16, hash) + " " + relative_path + "\n";
+    std::lock_guard<Mutex> lg(m_lock);
+    if (m_missing_newline){
+        line = "\n" + line;
+    }
+    FileIO file(m_path, FileMode::APPEND | FileMode::BINARY);
+    if (!file.is_open() || file.write(line) != line.size() || !file.flush()){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to write embedding manifest.", m_path);
+    }
+    m_missing_newline = false;
+}
+
+uint64_t SAMEmbeddingManifest::hash(const std::string& data){
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char ch : data){
+        hash ^= (uint8_t)ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+
+namespace{
+
+
+struct PreparedImage{
+    std::string path;
+    std::string relative_path;
+    uint64_t hash = 0;
+    cv::Mat image;  // Resized to the embedder input, RGB.
+    bool adopt = false; // Has an embedding from before the manifest. Only add it to the manifest.
+};
+
+struct EmbeddedBatch{
+    std::vector<PreparedImage> images;
+    std::vector<float> embeddings;
+};
+
+
+// Return false if the image doesn't need to be embedded.
+bool prepare_image(const SAMEmbeddingManifest& manifest, PreparedImage& item){
+    const bool has_embedding = Filesystem::exists(item.path + ".embedding");
+
+    std::string data;
+    if (!file_to_string(item.path, data)){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to read image file.", item.path);
+    }
+    item.hash = SAMEmbeddingManifest::hash(data);
+    if (has_embedding && !manifest.existed()){
+        // Embedded before there was a manifest.
+        item.adopt = true;
+        return false;
+    }
+    if (has_embedding && manifest.contains(item.relative_path, item.hash)){
+        return false;
+    }
+
+    cv::Mat image_bgr = cv::imdecode(cv::Mat(1, (int)data.size(), CV_8UC1, data.data()), cv::IMREAD_COLOR);
+    if (image_bgr.empty()){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Cannot open image file. Probably not an actual image?", item.path);
+    }
+    cv::Mat image;
+    if (image_bgr.channels() == 4){
+        cv::cvtColor(image_bgr, image, cv::COLOR_BGRA2RGB);
+    }else if (image_bgr.channels() == 3){
+        cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
+    }else{
+        throw FileException(
+            nullptr, PA_CURRENT_FUNCTION,
+            "Image has " + std::to_string(image_bgr.channels()) + " channels. Only support 3 or 4 channels.",
+            item.path
+        );
+    }
+
+    // resize to the shape for the ML model input
+    cv::resize(image, item.image, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
+    return true;
+}
+
+
+// Hands work from one stage of the job to the next. `push()` blocks while the
+// queue is full so that a fast stage can't run too far ahead.
+template <typename Type>
+class StageQueue{
+public:
+    StageQueue(size_t capacity)
+        : m_capacity(capacity)
+    {}
+
+    // Return false if the queue is closed.
+    bool push(Type&& item){
+        std::unique_lock<Mutex> lg(m_lock);
+        m_cv.wait(lg, [&]{ return m_closed || m_queue.size() < m_capacity; });
+        if (m_closed){
+            return false;
+        }
+        m_queue.emplace_back(std::move(item));
+        m_cv.notify_all();
+        return true;
+    }
+
+    // Return false once the queue is closed and empty.
+    bool pop(Type& item){
+        std::unique_lock<Mutex> lg(m_lock);
+        m_cv.wait(lg, [&]{ return m_closed || !m_queue.empty(); });
+        if (m_queue.empty()){
+            return false;
+        }
+        item = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_cv.notify_all();
+        return true;
+    }
+
+    void close(){
+        std::unique_lock<Mutex> lg(m_lock);
+        m_closed = true;
+        m_cv.notify_all();
+    }
+
+private:
+    const size_t m_capacity;
+    Mutex m_lock;
+    ConditionVariable m_cv;
+    std::deque<Type> m_queue;
+    bool m_closed = false;
+};
+
+
+}
+
+
+
+SAMEmbeddingJobStats run_sam_embedding_job(
+    const std::string& image_folder_path,
+    size_t batch_size,
+    const SAMEmbedderFunction& embed
+){
+    SAMEmbeddingJobStats stats;
+    WallClock start = current_time();
+
+    const bool recursive_search = true;
+    const std::vector<std::string> all_image_paths = find_images_in_folder(image_folder_path, recursive_search);
+    stats.images = all_image_paths.size();
+    if (all_image_paths.empty()){
+        return stats;
+    }
+    batch_size = std::max<size_t>(batch_size, 1);
+
+    SAMEmbeddingManifest manifest(image_folder_path);
+
+    Mutex error_lock;
+    std::exception_ptr error;
+    auto report_error = [&](std::exception_ptr e){
+        LockGuard<Mutex> lg(error_lock);
+        if (!error){
+            error = e;
+        }
+    };
+
+    // Images are read a chunk at a time in parallel, then regrouped into batches
+    // of images that need embedding.
+    StageQueue<std::vector<PreparedImage>> prepared(2);
+    StageQueue<EmbeddedBatch> embedded(2);
+
+    Thread reader([&]{
+        try{
+            const size_t chunk_size = std::max<size_t>(batch_size, 16);
+            std::vector<PreparedImage> pending;
+            for (size_t chunk_start = 0; chunk_start < all_image_paths.size(); chunk_start += chunk_size){
+                const size_t chunk_end = std::min(all_image_paths.size(), chunk_start + chunk_size);
+                std::vector<PreparedImage> items(chunk_end - chunk_start);
+                std::vector<char> needed(items.size());
+                std::vector<std::exception_ptr> errors(items.size());
+                GlobalThreadPools::computation_normal().run_in_parallel(
+                    [&](size_t index){
+                        PreparedImage& item = items[index];
+                        item.path = all_image_paths[chunk_start + index];
+                        item.relative_path = manifest.relative_path(item.path);
+                        try{
+                            needed[index] = prepare_image(manifest, item);
+                        }catch (...){
+                            errors[index] = std::current_exception();
+                        }
+                    },
+                    0, items.size(), 1
+                );
+
+                for (size_t c = 0; c < items.size(); c++){
+                    if (errors[c]){
+                        std::rethrow_exception(errors[c]);
+                    }
+                    if (needed[c]){
+                        pending.emplace_back(std::move(items[c]));
+                    }else{
+                        if (items[c].adopt){
+                            manifest.append(items[c].relative_path, items[c].hash);
+                        }
+                        stats.skipped++;
+                    }
+                }
+                while (pending.size() >= batch_size){
+                    std::vector<PreparedImage> batch(
+                        std::make_move_iterator(pending.begin()),
+                        std::make_move_iterator(pending.begin() + batch_size)
+                    );
+                    pending.erase(pending.begin(), pending.begin() + batch_size);
+                    if (!prepared.push(std::move(batch))){
+                        return;
+                    }
+                }
+            }
+            if (!pending.empty()){
+                prepared.push(std::move(pending));
+            }
+        }catch (...){
+            report_error(std::current_exception());
+        }
+        prepared.close();
+    });
+
+    Thread writer([&]{
+        try{
+            EmbeddedBatch batch;
+            std::vector<float> embedding;
+            while (embedded.pop(batch)){
+                const size_t embedding_size = batch.embeddings.size() / batch.images.size();
+                for (size_t c = 0; c < batch.images.size(); c++){
+                    const PreparedImage& item = batch.images[c];
+                    embedding.assign(
+                        batch.embeddings.begin() + c * embedding_size,
+                        batch.embeddings.begin() + (c + 1) * embedding_size
+                    );
+                    if (!save_image_embedding_to_disk(item.path, embedding)){
+                        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to write image embedding.", item.path + ".embedding");
+                    }
+                    manifest.append(item.relative_path, item.hash);
+                    stats.computed++;
+                }
+            }
+        }catch (...){
+            report_error(std::current_exception());
+            embedded.close();
+        }
+    });
+
+    try{
+        size_t embedded_count = 0;
+        std::vector<PreparedImage> batch;
+        std::vector<cv::Mat> images;
+        while (prepared.pop(batch)){
+            images.clear();
+            for (const PreparedImage& item : batch){
+                images.emplace_back(item.image);
+            }
+
+            EmbeddedBatch output;
+            embed(images, output.embeddings);
+            if (output.embeddings.empty() || output.embeddings.size() % images.size() != 0){
+                throw InternalProgramError(
+                    nullptr, PA_CURRENT_FUNCTION,
+                    "Embedder returned " + std::to_string(output.embeddings.size()) +
+                    " values for " + std::to_string(images.size()) + " images."
+                );
+            }
+
+            // The writer doesn't need the pixels.
+            images.clear();
+            for (PreparedImage& item : batch){
+                item.image.release();
+            }
+            embedded_count += batch.size();
+            std::cout << "Embedded " << embedded_count << " images, last one " << batch.back().path << std::endl;
+
+            output.images = std::move(batch);
+            if (!embedded.push(std::move(output))){
+                break;
+            }
+        }
+    }catch (...){
+        report_error(std::current_exception());
+    }
+    prepared.close();
+    embedded.close();
+    reader.join();
+    writer.join();
+
+    stats.seconds = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / 1000000.;
+    std::cout << "Embedded " << stats.computed << " images, skipped " << stats.skipped << " of " << stats.images
+              << " in " << tostr_fixed(stats.seconds, 1) << " s ("
+              << tostr_fixed(stats.computed / std::max(stats.seconds, 0.001), 2) << " images/s)" << std::endl;
+
+    if (error){
+        std::rethrow_exception(error);
+    }
+    return stats;
+}
+
+
+
+namespace{
+
+// Stand-in for the embedder: a few numbers that depend on every pixel.
+const size_t FAKE_EMBEDDING_SIZE = 8;
+void fake_embed(const std::vector<cv::Mat>& images, std::vector<float>& embeddings){
+    embeddings.clear();
+    for (const cv::Mat& image : images){
+        cv::Scalar mean = cv::mean(image);
+        cv::Scalar row_mean = cv::mean(image.row(image.rows / 2));
+        embeddings.insert(embeddings.end(), {
+            (float)mean[0], (float)mean[1], (float)mean[2],
+            (float)row_mean[0], (float)row_mean[1], (float)row_mean[2],
+            (float)image.rows, (float)image.cols,
+        });
+    }
+}
+
+bool has_fake_embedding(const std::string& image_path){
+    cv::Mat image_bgr = cv::imread(image_path);
+    cv::Mat image, resized;
+    cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
+    cv::resize(image, resized, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
+    std::vector<float> expected;
+    fake_embed({resized}, expected);
+
+    // The file has a 3 int header, then the embedding.
+    std::string file;
+    if (!file_to_string(image_path + ".embedding", file) || file.size() != 3 * sizeof(int) + FAKE_EMBEDDING_SIZE * sizeof(float)){
+        return false;
+    }
+    return memcmp(file.data() + 3 * sizeof(int), expected.data(), FAKE_EMBEDDING_SIZE * sizeof(float)) == 0;
+}
+
+void write_test_image(const std::string& path, size_t seed){
+    std::mt19937 rng((uint32_t)seed);
+    cv::Mat image(40 + (int)(rng() % 100), 40 + (int)(rng() % 100), CV_8UC3);
+    cv::randu(image, 0, 256);
+    cv::imwrite(path, image);
+}
+
+}
+
+
+class Test_SAMEmbeddingJob : public UnitTest{
+public:
+    Test_SAMEmbeddingJob()
+        : UnitTest("ML::SAM - Embedding Job")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        UnitTestTempFolder temp_folder("SAMEmbeddingJobTest");
+        if (temp_folder.empty()){
+            return UnitTestTempFolder::skipped();
+        }
+        const std::string folder = temp_folder.path().string();
+        QDir().mkpath(QString::fromStdString(folder + "/sub"));
+
+        const size_t IMAGES = 23;
+        std::vector<std::string> paths;
+        for (size_t c = 0; c < IMAGES; c++){
+            paths.emplace_back(folder + (c % 3 == 0 ? "/sub/" : "/") + "image-" + std::to_string(c) + ".png");
+            write_test_image(paths.back(), c);
+        }
+
+        size_t largest_batch = 0;
+        SAMEmbedderFunction embed = [&](const std::vector<cv::Mat>& images, std::vector<float>& embeddings){
+            largest_batch = std::max(largest_batch, images.size());
+            fake_embed(images, embeddings);
+        };
+        auto check_all = [&]() -> std::string{
+            for (const std::string& path : paths){
+                if (!has_fake_embedding(path)){
+                    return "Wrong or missing embedding: " + path;
+                }
+            }
+            return "";
+        };
+
+        // An image from before the manifest is trusted.
+        write_test_image(folder + "/old.png", 1000);
+        {
+            std::vector<float> embedding(FAKE_EMBEDDING_SIZE, -1);
+            save_image_embedding_to_disk(folder + "/old.png", embedding);
+        }
+
+        SAMEmbeddingJobStats stats = run_sam_embedding_job(folder, 4, embed);
+        if (stats.images != IMAGES + 1 || stats.computed != IMAGES || stats.skipped != 1){
+            return "First run: Computed " + std::to_string(stats.computed) + ", skipped " + std::to_string(stats.skipped) + ".";
+        }
+        if (largest_batch != 4){
+            return "Expected batches of 4. Largest was " + std::to_string(largest_batch) + ".";
+        }
+        std::string error = check_all();
+        if (!error.empty()){
+            return error;
+        }
+        scope.throw_if_cancelled();
+
+        // Nothing to do.
+        stats = run_sam_embedding_job(folder, 4, embed);
+        if (stats.computed != 0 || stats.skipped != IMAGES + 1){
+            return "Rerun: Computed " + std::to_string(stats.computed) + ".";
+        }
+
+        // Now that there is a manifest, an embedding that isn't in it is redone.
+        // (e.g. the job was stopped after writing it but before listing it)
+        paths.emplace_back(folder + "/unlisted.png");
+        write_test_image(paths.back(), 3000);
+        {
+            std::vector<float> embedding(FAKE_EMBEDDING_SIZE, -1);
+            save_image_embedding_to_disk(paths.back(), embedding);
+        }
+        stats = run_sam_embedding_job(folder, 4, embed);
+        if (stats.computed != 1 || stats.skipped != IMAGES + 1){
+            return "Unlisted embedding: Computed " + std::to_string(stats.computed) + ", skipped " + std::to_string(stats.skipped) + ".";
+        }
+        error = check_all();
+        if (!error.empty()){
+            return error;
+        }
+
+        // A changed image and a deleted embedding are redone. A torn manifest
+        // line is ignored.
+        write_test_image(paths[5], 2000);
+        Filesystem::remove(paths[9] + ".embedding");
+        {
+            FileIO file(folder + "/" + SAMEmbeddingManifest::FILENAME, FileMode::APPEND | FileMode::BINARY);
+            file.write(std::string("0123456789abcdef image-1"));
+        }
+        stats = run_sam_embedding_job(folder, 1, embed);
+        if (stats.computed != 2 || stats.skipped != IMAGES){
+            return "Resume: Computed " + std::to_string(stats.computed) + ", skipped " + std::to_string(stats.skipped) + ".";
+        }
+        error = check_all();
+        if (!error.empty()){
+            return error;
+        }
+        stats = run_sam_embedding_job(folder, 3, embed);
+        if (stats.computed != 0){
+            return "Rerun after resume: Computed " + std::to_string(stats.computed) + ".";
+        }
+        scope.throw_if_cancelled();
+
+        // An embedding that can't be written stops the job and isn't listed.
+        {
+            const std::string unwritable = folder + "/unwritable.png";
+            write_test_image(unwritable, 4000);
+            Filesystem::create_directories(unwritable + ".embedding.tmp");
+            try{
+                run_sam_embedding_job(folder, 4, embed);
+                return "Unwritable embedding did not throw.";
+            }catch (FileException&){}
+            std::string manifest;
+            file_to_string(folder + "/" + SAMEmbeddingManifest::FILENAME, manifest);
+            if (manifest.find("unwritable.png") != std::string::npos || Filesystem::exists(unwritable + ".embedding")){
+                return "Unwritable embedding was recorded.";
+            }
+            Filesystem::remove(unwritable + ".embedding.tmp");
+            Filesystem::remove(unwritable);
+        }
+
+        // A broken image stops the job.
+        string_to_file(folder + "/broken.png", "not an image");
+        try{
+            run_sam_embedding_job(folder, 4, embed);
+            return "Broken image did not throw.";
+        }catch (FileException&){}
+
+        // So does the embedder.
+        Filesystem::remove(folder + "/broken.png");
+        Filesystem::remove(paths[0] + ".embedding");
+        try{
+            run_sam_embedding_job(folder, 4, [](const std::vector<cv::Mat>&, std::vector<float>&){
+                throw std::runtime_error("Embedder failed.");
+            });
+            return "Embedder failure did not throw.";
+        }catch (std::runtime_error&){}
+
+        logger.log("Embedding job passed on " + std::to_string(IMAGES) + " images.");
+        return true;
+    }
+};
+
+
+void add_tests_SAMEmbeddingJob(UnitTestDatabase& database){
+    database.add<Test_SAMEmbeddingJob>();
+}
+
+
+
+void benchmark_SAMEmbeddingJob(
+    Logger& logger,
+    const std::string& embedding_model_path,
+    const std::string& image_folder_path,
+    size_t max_images
+){
+    std::vector<std::string> image_paths = find_images_in_folder(image_folder_path, true);
+    image_paths.resize(std::min(image_paths.size(), max_images));
+    if (image_paths.empty()){
+        logger.log("No images in " + image_folder_path);
+        return;
+    }
+
+    UnitTestTempFolder serial_temp("SAMEmbeddingSerial");
+    UnitTestTempFolder job_temp("SAMEmbeddingJob");
+    if (serial_temp.empty() || job_temp.empty()){
+        logger.log("No temp directory.");
+        return;
+    }
+    const std::string serial_folder = serial_temp.path().string();
+    const std::string job_folder = job_temp.path().string();
+    for (size_t c = 0; c < image_paths.size(); c++){
+        std::string name = "/image-" + std::to_string(c) + QFileInfo(QString::fromStdString(image_paths[c])).fileName().right(4).toStdString();
+        Filesystem::copy_file(image_paths[c], serial_folder + name);
+        Filesystem::copy_file(image_paths[c], job_folder + name);
+    }
+
+    SAMEmbedderSession session(embedding_model_path, false);
+
+    // One image at a time, the way it used to be done.
+    WallClock start = current_time();
+    std::vector<float> embedding;
+    for (const std::string& path : find_images_in_folder(serial_folder, true)){
+        cv::Mat image_bgr = cv::imread(path);
+        cv::Mat image, resized;
+        cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
+        cv::resize(image, resized, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
+        session.run(resized, embedding);
+        save_image_embedding_to_disk(path, embedding);
+    }
+    double serial_seconds = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / 1000000.;
+
+    SAMEmbeddingJobStats stats = run_sam_embedding_job(
+        job_folder, session.max_batch_size(),
+        [&](const std::vector<cv::Mat>& images, std::vector<float>& embeddings){
+            session.run(images, embeddings);
+        }
+    );
+
+    logger.log(
+        "SAM embeddings for " + std::to_string(image_paths.size()) + " images, batch size " +
+        std::to_string(session.max_batch_size()) + ": " +
+        tostr_fixed(image_paths.size() / serial_seconds, 3) + " images/s -> " +
+        tostr_fixed(stats.computed / stats.seconds, 3) + " images/s"
+    );
+}
+
+
+
+}
+}
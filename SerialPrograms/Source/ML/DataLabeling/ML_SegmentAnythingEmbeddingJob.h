@@ -0,0 +1,115 @@
+/*  ML Segment Anything Embedding Job
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Compute Segment Anything Model (SAM) image embeddings for a folder of images
+ */
+
+#ifndef PokemonAutomation_ML_SegmentAnythingEmbeddingJob_H
+#define PokemonAutomation_ML_SegmentAnythingEmbeddingJob_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/TestRunners/UnitTest.h"
+
+namespace cv{
+    class Mat;
+}
+
+namespace PokemonAutomation{
+namespace ML{
+
+
+// Record of which images in a folder already have embeddings, stored in the folder as
+// `SAMEmbeddingManifest::FILENAME`. Each line is the hash of the image file, then the
+// image path relative to the folder.
+// A line is only appended after its embedding file is written, so a job that is
+// interrupted only loses the images it was working on. Once a folder has a manifest,
+// an embedding file that isn't listed in it is not trusted.
+// `append()` is thread-safe.
+class SAMEmbeddingManifest{
+public:
+    static const char* const FILENAME;
+
+    // Load the manifest of the folder. If there is none, it is empty.
+    SAMEmbeddingManifest(const std::string& folder_path);
+
+    const std::string& path() const { return m_path; }
+
+    // Whether the manifest file existed when this was loaded.
+    bool existed() const { return m_existed; }
+
+    // Image path relative to the folder. This is what the manifest is keyed on.
+    std::string relative_path(const std::string& image_path) const;
+
+    // Whether the image is in the manifest at all.
+    bool contains(const std::string& relative_path) const;
+    // Whether the image is in the manifest with this hash.
+    bool contains(const std::string& relative_path, uint64_t hash) const;
+
+    // Append an entry to the file. This does not change what `contains()` returns.
+    // Throw FileException if the manifest can't be written.
+    void append(const std::string& relative_path, uint64_t hash);
+
+    // Hash of the contents of an image file.
+    static uint64_t hash(const std::string& data);
+
+private:
+    std::string m_folder;
+    std::string m_path;
+    std::map<std::string, uint64_t> m_entries;
+    bool m_existed = false;
+
+    Mutex m_lock;
+    bool m_missing_newline = false;
+};
+
+
+struct SAMEmbeddingJobStats{
+    size_t images = 0;      // Images found in the folder.
+    size_t skipped = 0;     // Images that were already embedded.
+    size_t computed = 0;    // Images embedded by this job.
+    double seconds = 0;
+};
+
+// Embed a batch of images. The images are already resized to the SAM embedder input size,
+// RGB channel order. Write the embeddings back to back into `embeddings`, the same size for
+// each image.
+using SAMEmbedderFunction = std::function<void(const std::vector<cv::Mat>& images, std::vector<float>& embeddings)>;
+
+// Compute embeddings for all the images in a folder (recursively) that don't have them yet.
+// Images are read and resized on the computation thread pool, embedded `batch_size` at a time
+// on the calling thread and saved by a writer thread, all at the same time.
+//
+// An image is skipped if it has an embedding file and the manifest lists it with the current
+// hash of the image. If the folder has no manifest yet, existing embedding files are trusted
+// and added to the new manifest.
+//
+// Throw if an image can't be read or `embed` throws. Embeddings finished before that are kept.
+SAMEmbeddingJobStats run_sam_embedding_job(
+    const std::string& image_folder_path,
+    size_t batch_size,
+    const SAMEmbedderFunction& embed
+);
+
+
+void add_tests_SAMEmbeddingJob(UnitTestDatabase& database);
+
+// Time the job against embedding images one at a time like before, on two copies of the
+// first `max_images` images in `image_folder_path`. The copies are deleted afterwards.
+void benchmark_SAMEmbeddingJob(
+    Logger& logger,
+    const std::string& embedding_model_path,
+    const std::string& image_folder_path,
+    size_t max_images
+);
+
+
+
+}
+}
+#endif
@@ -5,6 +5,7 @@
  *  Run Segment Anything Model (SAM) to segment objects on images
  */
 
+#include <string.h>
 #include <QDir>
 #include <QDirIterator>
 #include <fstream>
@@ -20,6 +21,7 @@
 #include "ML/Models/ML_ONNXRuntimeHelpers.h"
 #include "ML_SegmentAnythingModelConstants.h"
 #include "ML_SegmentAnythingModel.h"
+#include "ML_SegmentAnythingEmbeddingJob.h"
 #include "ML_AnnotationIO.h"
 
 namespace PokemonAutomation{
@@ -33,25 +35,41 @@ SAMEmbedderSession::SAMEmbedderSession(const std::string& model_path, bool use_g
     , output_names{session.GetOutputNames()}
     , input_shape{1, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT, SAM_EMBEDDER_INPUT_IMAGE_WIDTH, 3}
     , output_shape{1, SAM_EMBEDDER_OUTPUT_N_CHANNELS, SAM_EMBEDDER_OUTPUT_IMAGE_SIZE, SAM_EMBEDDER_OUTPUT_IMAGE_SIZE}
+    , max_batch(1)
     , model_input(SAM_EMBEDDER_INPUT_SIZE)
 {
-    std::cout << "Built SAM embedder session" << std::endl;
+    // A dynamic batch dimension shows up as -1.
+    std::vector<int64_t> input_dims = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    if (!input_dims.empty() && input_dims[0] < 0){
+        max_batch = SAM_EMBEDDER_MAX_BATCH_SIZE;
+    }
+    std::cout << "Built SAM embedder session, max batch size " << max_batch << std::endl;
 }
 
 void SAMEmbedderSession::run(cv::Mat& input_image, std::vector<float>& model_output){
-    assert(input_image.rows == SAM_EMBEDDER_INPUT_IMAGE_HEIGHT);
-    assert(input_image.cols == SAM_EMBEDDER_INPUT_IMAGE_WIDTH);
+    run(std::vector<cv::Mat>{input_image}, model_output);
+}
+
+void SAMEmbedderSession::run(const std::vector<cv::Mat>& input_images, std::vector<float>& model_output){
+    assert(!input_images.empty() && input_images.size() <= max_batch);
 
-    model_output.resize(SAM_EMBEDDER_OUTPUT_SIZE);
+    const size_t batch = input_images.size();
+    input_shape[0] = (int64_t)batch;
+    output_shape[0] = (int64_t)batch;
+    model_input.resize(batch * SAM_EMBEDDER_INPUT_SIZE);
+    model_output.resize(batch * SAM_EMBEDDER_OUTPUT_SIZE);
     auto input_tensor = create_tensor<uint8_t>(memory_info, model_input, input_shape);
     auto output_tensor = create_tensor<float>(memory_info, model_output, output_shape);
 
-    for (int row = 0, p_loc=0; row < SAM_EMBEDDER_INPUT_IMAGE_HEIGHT; row++){
-        for (int col = 0; col < SAM_EMBEDDER_INPUT_IMAGE_WIDTH; col++){
-            cv::Vec3b p = input_image.at<cv::Vec3b>(row, col);
-            model_input[p_loc++] = p[0];
-            model_input[p_loc++] = p[1];
-            model_input[p_loc++] = p[2];
+    const size_t row_bytes = 3 * SAM_EMBEDDER_INPUT_IMAGE_WIDTH;
+    uint8_t* p_loc = model_input.data();
+    for (const cv::Mat& input_image : input_images){
+        assert(input_image.rows == SAM_EMBEDDER_INPUT_IMAGE_HEIGHT);
+        assert(input_image.cols == SAM_EMBEDDER_INPUT_IMAGE_WIDTH);
+        assert(input_image.type() == CV_8UC3);
+        for (int row = 0; row < SAM_EMBEDDER_INPUT_IMAGE_HEIGHT; row++){
+            memcpy(p_loc, input_image.ptr<uint8_t>(row), row_bytes);
+            p_loc += row_bytes;
         }
     }
 
@@ -213,79 +231,42 @@ void compute_embeddings_for_folder(
             QString::fromStdString(e.message() + ". Try using CPU?"));
         return;
     }
-    std::vector<float> output_image_embedding;
-    for (size_t i = 0; i < all_image_paths.size(); i++){
-        const auto& image_path = all_image_paths[i];
-        std::cout << (i+1) << "/" << all_image_paths.size() << ": ";
-        const std::string embedding_path = image_path + ".embedding";
-        if (Filesystem::exists(embedding_path)){
-            std::cout << "skip already computed embedding " << embedding_path << "." << std::endl;
-            continue;
-        }
-        std::cout << "computing embedding for " << image_path << "..." << std::endl;
-        cv::Mat image_bgr = cv::imread(image_path);
-        if (image_bgr.empty()){
-            std::cerr << "Error: image empty. Probably the file is not an image?" << std::endl;
-            QMessageBox box;
-            box.warning(nullptr, "Unable To Open Image",
-                QString::fromStdString("Cannot open image file " + image_path + ". Probably not an actual image?"));
-            return;
-        }
-        cv::Mat image;
-        if (image_bgr.channels() == 4){
-            cv::cvtColor(image_bgr, image, cv::COLOR_BGRA2RGB);
-        } else if (image_bgr.channels() == 3){
-            cv::cvtColor(image_bgr, image, cv::COLOR_BGR2RGB);
-        }else{
-            std::cerr << "Error: wrong image channels. Only work with RGB or RGBA images." << std::endl;
-            QMessageBox box;
-            box.warning(nullptr, "Wrong Image Channels",
-                QString::fromStdString("Image has " + std::to_string(image_bgr.channels()) + " channels. Only support 3 or 4 channels."));
-            return;
-        }
-
-        cv::Mat resized_mat;  // resize to the shape for the ML model input
-        cv::resize(image, resized_mat, cv::Size(SAM_EMBEDDER_INPUT_IMAGE_WIDTH, SAM_EMBEDDER_INPUT_IMAGE_HEIGHT));
-
-        output_image_embedding.clear();
-
-        // fall back to CPU if fails with GPU.
-        for (size_t j = 0; j < 2; j++){
-            try{
-                // If fails with GPU, fall back to CPU.
-                // throw Ort::Exception("Testing.", ORT_FAIL);  // to simulate GPU/CPU failure
-                embedding_session->run(resized_mat, output_image_embedding);
-                break;
-            }catch (Ort::Exception& e){
-                if (use_gpu){
-                    std::cerr << "Warning: Embedding session failed using the GPU. Will reattempt with the CPU.\n" << e.what() << std::endl;
-                    use_gpu = false;
-                    embedding_session = make_unique<SAMEmbedderSession>(embedding_model_path, use_gpu);
-                }else{
-                    std::cerr << "Error: Embedding session failed even when using the CPU.\n" << e.what() << std::endl;
-                    QMessageBox box;
-                    box.warning(nullptr, "Error:",
-                        QString::fromStdString("Error: Embedding session failed."));
-                    return;
-                }
-            }catch (...){
-                std::cerr << "Error: Unknown error. Embedding session failed." << std::endl;
-                QMessageBox box;
-                box.warning(nullptr, "Error:",
-                    QString::fromStdString("Error: Unknown error. Embedding session failed."));
-                return;
-
-            }
-
-            if (j > 0){
-                std::cerr << "Internal Program Error: This section of code shouldn't be reachable." << std::endl;
-                QMessageBox box;
-                box.warning(nullptr, "Error:",
-                    QString::fromStdString("Internal Program Error: This section of code shouldn't be reachable."));
-                return;
+    // fall back to CPU if fails with GPU.
+    SAMEmbedderFunction embed = [&](const std::vector<cv::Mat>& images, std::vector<float>& embeddings){
+        try{
+            // throw Ort::Exception("Testing.", ORT_FAIL);  // to simulate GPU/CPU failure
+            embedding_session->run(images, embeddings);
+        }catch (Ort::Exception& e){
+            if (!use_gpu){
+                throw;
             }
+            std::cerr << "Warning: Embedding session failed using the GPU. Will reattempt with the CPU.\n" << e.what() << std::endl;
+            use_gpu = false;
+            embedding_session = make_unique<SAMEmbedderSession>(embedding_model_path, use_gpu);
+            embedding_session->run(images, embeddings);
         }
-        save_image_embedding_to_disk(image_path, output_image_embedding);
+    };
+
+    try{
+        run_sam_embedding_job(image_folder_path, embedding_session->max_batch_size(), embed);
+    }catch (Ort::Exception& e){
+        std::cerr << "Error: Embedding session failed even when using the CPU.\n" << e.what() << std::endl;
+        QMessageBox box;
+        box.warning(nullptr, "Error:",
+            QString::fromStdString("Error: Embedding session failed."));
+        return;
+    }catch (Exception& e){
+        std::cerr << "Error: " << e.message() << std::endl;
+        QMessageBox box;
+        box.warning(nullptr, "Error:",
+            QString::fromStdString("Error: " + e.message()));
+        return;
+    }catch (...){
+        std::cerr << "Error: Unknown error. Embedding session failed." << std::endl;
+        QMessageBox box;
+        box.warning(nullptr, "Error:",
+            QString::fromStdString("Error: Unknown error. Embedding session failed."));
+        return;
     }
     std::cout << "Done computing embeddings for images in folder " << image_folder_path << "." << std::endl;
 
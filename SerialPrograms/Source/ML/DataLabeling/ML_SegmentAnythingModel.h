@@ -23,7 +23,7 @@ namespace ML{
 
 // Compute embeddings for all images in a folder. Only support .png, .jpg and .jpeg filename extensions so far.
 // This can be very slow!
-// It skips existing embedding files.
+// It skips images already embedded. See run_sam_embedding_job() in ML_SegmentAnythingEmbeddingJob.h.
 void compute_embeddings_for_folder(const std::string& embedding_model_path, const std::string& image_folder_path, bool use_gpu_for_embedder_session);
 
 
@@ -36,6 +36,13 @@ public:
     // compute its image embedding as a vector<float> of size [SAM_EMBEDDER_OUTPUT_SIZE]
     // it has shape [1, SAM_EMBEDDER_OUTPUT_N_CHANNELS, SAM_EMBEDDER_OUTPUT_IMAGE_SIZE, SAM_EMBEDDER_OUTPUT_IMAGE_SIZE]
     void run(cv::Mat& input_image, std::vector<float>& output_image_embedding);
+
+    // Largest batch the batched `run()` accepts. This is 1 unless the model has a dynamic batch dimension.
+    size_t max_batch_size() const { return max_batch; }
+
+    // Same as above but on a batch of up to `max_batch_size()` images. The embeddings are
+    // written back to back: `output_image_embeddings` has size [images.size() * SAM_EMBEDDER_OUTPUT_SIZE].
+    void run(const std::vector<cv::Mat>& input_images, std::vector<float>& output_image_embeddings);
     
 private:
     Ort::Session session;
@@ -43,8 +50,9 @@ private:
     Ort::RunOptions run_options;
     std::vector<std::string> input_names, output_names;
 
-    const std::array<int64_t, 4> input_shape;
-    const std::array<int64_t, 4> output_shape;
+    std::array<int64_t, 4> input_shape;
+    std::array<int64_t, 4> output_shape;
+    size_t max_batch;
 
     std::vector<uint8_t> model_input;
 };
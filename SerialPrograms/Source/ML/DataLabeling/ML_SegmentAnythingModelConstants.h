@@ -16,6 +16,8 @@ const int SAM_EMBEDDER_OUTPUT_IMAGE_SIZE = 64;
 
 const int SAM_EMBEDDER_INPUT_SIZE = SAM_EMBEDDER_INPUT_IMAGE_HEIGHT * SAM_EMBEDDER_INPUT_IMAGE_WIDTH * 3;
 const int SAM_EMBEDDER_OUTPUT_SIZE = SAM_EMBEDDER_OUTPUT_N_CHANNELS * SAM_EMBEDDER_OUTPUT_IMAGE_SIZE * SAM_EMBEDDER_OUTPUT_IMAGE_SIZE;
+// Batch size used when the embedder model has a dynamic batch dimension.
+const int SAM_EMBEDDER_MAX_BATCH_SIZE = 4;
 
 const int SAM_N_INPUT_TENSORS = 6;
 const int SAM_N_OUTPUT_TENSORS = 3;
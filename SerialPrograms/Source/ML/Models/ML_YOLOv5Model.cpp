@@ -9,12 +9,23 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <array>
+#include <cmath>
+#include <random>
+#include <iterator>
+#include <algorithm>
+#include <string.h>
 //#include <iostream>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/dnn.hpp>
 #include "3rdParty/ONNX/OnnxToolsPA.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "CommonFramework/Logging/Logger.h"
+#include "Kernels/ImageToTensor/Kernels_ImageToTensor.h"
 #include "ML/Models/ML_ONNXRuntimeHelpers.h"
 #include "ML_YOLOv5Model.h"
 
@@ -93,15 +104,18 @@ std::vector<std::string> parse_yolo_metadata_names(const std::string& metadata_v
 }
 
 
-std::tuple<int, int, double, double> resize_image_with_border(
-    const cv::Mat& input_image,
-    cv::Mat& output_image,
-    int target_width, int target_height,
-    cv::Scalar border_color = cv::Scalar(0,0,0)
-){
-    int original_width = input_image.cols;
-    int original_height = input_image.rows;
+struct LetterboxGeometry{
+    int width;
+    int height;
+    int border_left;
+    int border_top;
+};
 
+// Where an image of the given size goes when fitted into the target size, keeping its aspect ratio.
+LetterboxGeometry letterbox_geometry(
+    int original_width, int original_height,
+    int target_width, int target_height
+){
     double scale_x = static_cast<double>(target_width) / original_width;
     double scale_y = static_cast<double>(target_height) / original_height;
     double scale = std::min(scale_x, scale_y);
@@ -115,12 +129,30 @@ std::tuple<int, int, double, double> resize_image_with_border(
         throw std::runtime_error("Input Image too small: " + std::to_string(original_width) + " x " + std::to_string(original_height));
     }
 
+    return LetterboxGeometry{
+        new_width, new_height,
+        (target_width - new_width) / 2,
+        (target_height - new_height) / 2,
+    };
+}
+
+
+std::tuple<int, int, double, double> resize_image_with_border(
+    const cv::Mat& input_image,
+    cv::Mat& output_image,
+    int target_width, int target_height,
+    cv::Scalar border_color = cv::Scalar(0,0,0)
+){
+    LetterboxGeometry geometry = letterbox_geometry(input_image.cols, input_image.rows, target_width, target_height);
+    int new_width = geometry.width;
+    int new_height = geometry.height;
+
     cv::Mat resized_image;
     cv::resize(input_image, resized_image, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR); // INTER_AREA for shrinking
 
-    int border_top = (target_height - new_height) / 2;
+    int border_top = geometry.border_top;
     int border_bottom = target_height - new_height - border_top;
-    int border_left = (target_width - new_width) / 2;
+    int border_left = geometry.border_left;
     int border_right = target_width - new_width - border_left;
 
     cv::copyMakeBorder(resized_image, output_image, border_top, border_bottom, border_left, border_right, cv::BORDER_CONSTANT, border_color);
@@ -132,12 +164,156 @@ std::tuple<int, int, double, double> resize_image_with_border(
 }
 
 
+
+YOLOv5InputTensor::YOLOv5InputTensor(int image_size)
+    : m_image_size(image_size)
+    , m_data(3 * (size_t)image_size * image_size)
+{}
+
+std::tuple<int, int, double, double> YOLOv5InputTensor::load(const cv::Mat& input_image){
+    CV_Assert(input_image.depth() == CV_8U);
+    CV_Assert(input_image.channels() == 3);
+
+    LetterboxGeometry geometry = letterbox_geometry(input_image.cols, input_image.rows, m_image_size, m_image_size);
+
+    // Same as cv::Mat::convertTo(image_float, CV_32F, 1.0 / 255.0).
+    const float scale = (float)(1.0 / 255.0);
+
+    // The border is the same as long as the frame size doesn't change.
+    if (geometry.width != m_width || geometry.height != m_height){
+        std::fill(m_data.begin(), m_data.end(), (float)114 * scale);
+        m_width = geometry.width;
+        m_height = geometry.height;
+    }
+
+    const cv::Mat* image = &input_image;
+    if (geometry.width != input_image.cols || geometry.height != input_image.rows){
+        cv::resize(input_image, m_resized, cv::Size(geometry.width, geometry.height), 0, 0, cv::INTER_LINEAR);
+        image = &m_resized;
+    }
+
+    const size_t plane_size = (size_t)m_image_size * m_image_size;
+    Kernels::packed_rgb8_to_planar_float(
+        geometry.width, geometry.height,
+        image->data, image->step,
+        m_data.data() + (size_t)geometry.border_top * m_image_size + geometry.border_left,
+        m_image_size, plane_size,
+        scale
+    );
+
+    return std::make_tuple(
+        geometry.border_left, geometry.border_top,
+        1.0 / geometry.width, 1.0 / geometry.height
+    );
+}
+
+
+
+YOLOv5Decoder::YOLOv5Decoder(size_t label_count, float score_threshold, float nms_threshold)
+    : m_label_count(label_count)
+    , m_score_threshold(score_threshold)
+    , m_nms_threshold(nms_threshold)
+{}
+
+// Same as the overlap cv::dnn::NMSBoxes() computes on the cv::Rect of the two boxes:
+// 1 - cv::jaccardDistance(a, b).
+float pixel_box_overlap(const YOLOv5Decoder::PixelBox& a, const YOLOv5Decoder::PixelBox& b){
+    int area_a = a.width * a.height;
+    int area_b = b.width * b.height;
+    if (area_a + area_b <= 0){
+        return 1.f;
+    }
+
+    double intersection = 0;
+    if (a.width > 0 && a.height > 0 && b.width > 0 && b.height > 0){
+        int width = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+        int height = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+        if (width > 0 && height > 0){
+            intersection = width * height;
+        }
+    }
+
+    return 1.f - static_cast<float>(1.0 - intersection / (area_a + area_b - intersection));
+}
+
+const std::vector<YOLOv5Decoder::PixelBox>& YOLOv5Decoder::decode(const float* output, size_t candidates){
+    const size_t cand_size = m_label_count + 5;
+
+    m_candidates.clear();
+    for (size_t i = 0; i < candidates; i++){
+        const float* row = output + cand_size * i;
+
+        // The label confidences are sigmoid outputs in [0.0, 1.0], so the score can't be
+        // higher than the objectness. Almost every row stops here.
+        float sc = row[4];
+        if (!(sc > m_score_threshold)){
+            continue;
+        }
+
+        float max_score = 0.0;
+        size_t pred_label = 0;  // predicted label
+        for (size_t j_label = 0; j_label < m_label_count; j_label++){
+            float score = row[5 + j_label];
+            if (score > max_score){
+                max_score = score;
+                pred_label = j_label;
+            }
+        }
+        float score = max_score * sc;
+        if (!(score > m_score_threshold)){
+            continue;
+        }
+
+        float cx = row[0];
+        float cy = row[1];
+        float w = row[2];
+        float h = row[3];
+
+        PixelBox box;
+        box.score = score;
+        box.x = (int)(cx - w / 2 + 0.5);
+        box.y = (int)(cy - h / 2 + 0.5);
+        box.width = int(w + 0.5);
+        box.height = int(h + 0.5);
+        box.label_idx = pred_label;
+        m_candidates.emplace_back(box);
+    }
+
+    // Highest score first. Ties stay in row order.
+    std::stable_sort(
+        m_candidates.begin(), m_candidates.end(),
+        [](const PixelBox& a, const PixelBox& b){ return a.score > b.score; }
+    );
+
+    m_kept.clear();
+    for (const PixelBox& box : m_candidates){
+        bool keep = true;
+        for (const PixelBox& kept : m_kept){
+            if (m_class_aware && kept.label_idx != box.label_idx){
+                continue;
+            }
+            if (!(pixel_box_overlap(box, kept) <= m_nms_threshold)){
+                keep = false;
+                break;
+            }
+        }
+        if (keep){
+            m_kept.emplace_back(box);
+        }
+    }
+    return m_kept;
+}
+
+
+
+
 YOLOv5Session::YOLOv5Session(const std::string& model_path, bool use_gpu)
     : m_session{create_session(model_path, ML_MODEL_CACHE_PATH() + "YOLOv5", use_gpu)}
     , m_memory_info{Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU)}
     , m_input_names{m_session.GetInputNames()}
     , m_output_names{m_session.GetOutputNames()}
-    , m_model_input(3*YOLO5_INPUT_IMAGE_SIZE*YOLO5_INPUT_IMAGE_SIZE)
+    , m_model_input(YOLO5_INPUT_IMAGE_SIZE)
+    , m_decoder(0)
 {
     // Extract YOLO labels from model metadata
     try{
@@ -181,39 +357,16 @@ YOLOv5Session::YOLOv5Session(const std::string& model_path, bool use_gpu)
         );
     }
     m_model_output.resize(YOLO5_NUM_CANDIDATES * m_output_shape[2]);
+    m_decoder = YOLOv5Decoder(m_label_names.size());
 }
 
 // input: rgb color order
 void YOLOv5Session::run(const cv::Mat& input_image, std::vector<YOLOv5Session::DetectionBox>& output_boxes){
-    CV_Assert(input_image.depth() == CV_8U);
-    CV_Assert(input_image.channels() == 3);
-
-    cv::Mat image_resized;
-
     int x_shift = 0, y_shift = 0;
     double x_scale = 1.0, y_scale = 1.0;
-    std::tie(x_shift, y_shift, x_scale, y_scale) = resize_image_with_border(input_image, image_resized,
-        YOLO5_INPUT_IMAGE_SIZE, YOLO5_INPUT_IMAGE_SIZE, cv::Scalar(114, 114, 114));
+    std::tie(x_shift, y_shift, x_scale, y_scale) = m_model_input.load(input_image);
 
-    // Declare a destination Mat for float32
-    cv::Mat image_float;
-
-    // Convert the uint8_image to image_float
-    // The third argument (alpha) is a scaling factor.
-    // For normalization to [0.0, 1.0], use 1.0 / 255.0.
-    // For retaining original values (0-255), use 1.0.
-    image_resized.convertTo(image_float, CV_32F, 1.0 / 255.0); 
-
-    for (int c = 0, i = 0; c < 3; c++){
-        for (int row = 0; row < image_float.rows; row++){
-            for (int col = 0; col < image_float.cols; col++){
-                float pixel_value = image_float.at<cv::Vec3f>(row, col)[c];
-                m_model_input[i++] = pixel_value;
-            }
-        }
-    }
-
-    auto input_tensor = create_tensor<float>(m_memory_info, m_model_input, m_input_shape);
+    auto input_tensor = create_tensor<float>(m_memory_info, m_model_input.data(), m_input_shape);
     auto output_tensor = create_tensor<float>(m_memory_info, m_model_output, m_output_shape);
 
     const char* input_name_c = m_input_names[0].data();
@@ -224,54 +377,25 @@ void YOLOv5Session::run(const cv::Mat& input_image, std::vector<YOLOv5Session::D
     // auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
     // std::cout << "Yolov5 inference time: " << milliseconds << " ms" << std::endl;
 
-    const size_t cand_size = m_label_names.size() + 5;
+    const std::vector<YOLOv5Decoder::PixelBox>& pixel_boxes = m_decoder.decode(m_model_output.data(), YOLO5_NUM_CANDIDATES);
 
-    std::vector<cv::Rect> pixel_boxes;
-    std::vector<int> indices;
-    std::vector<float> scores;
-    std::vector<size_t> labels;
-
-    for (int i = 0; i < YOLO5_NUM_CANDIDATES; i++){
-        float cx = m_model_output[cand_size*i];
-        float cy = m_model_output[cand_size*i+1];
-        float w = m_model_output[cand_size*i+2];
-        float h = m_model_output[cand_size*i+3];
-        float sc = m_model_output[cand_size*i+4];
-
-        float max_score = 0.0;
-        size_t pred_label = 0;  // predicted label
-        for (size_t j_label = 0; j_label < m_label_names.size(); j_label++){
-            float score = m_model_output[cand_size*i+5+j_label];
-            if (score > max_score){
-                max_score = score;
-                pred_label = j_label;
-            }
-        }
-        scores.push_back(max_score * sc); // sc is like a global confidence scale?
-        pixel_boxes.emplace_back((int)(cx - w / 2 + 0.5), (int)(cy - h / 2 + 0.5), int(w + 0.5), int(h + 0.5));
-        indices.push_back(i);
-        labels.push_back(pred_label);
-    }
-
-    cv::dnn::NMSBoxes(pixel_boxes, scores, 0.2f, 0.45f, indices);
-
-    // std::cout << "num found pixel_boxes " << indices.size() << std::endl;
+    // std::cout << "num found pixel_boxes " << pixel_boxes.size() << std::endl;
     // return;
 
-    for (int index : indices)
+    for (const YOLOv5Decoder::PixelBox& pixel_box : pixel_boxes)
     {
         // Note the model predicts on (640x640) images, we need to convert the detected pixel_boxes back to
         // the full frame dimension.
-        double x = (pixel_boxes[index].x - x_shift) * x_scale;
-        double y = (pixel_boxes[index].y - y_shift) * y_scale;
-        double w = pixel_boxes[index].width * x_scale;
-        double h = pixel_boxes[index].height * y_scale;
-        // std::cout << scores[index] << " " <<  x << " " << y << " " << w << " " << h << std::endl;
+        double x = (pixel_box.x - x_shift) * x_scale;
+        double y = (pixel_box.y - y_shift) * y_scale;
+        double w = pixel_box.width * x_scale;
+        double h = pixel_box.height * y_scale;
+        // std::cout << pixel_box.score << " " <<  x << " " << y << " " << w << " " << h << std::endl;
 
         YOLOv5Session::DetectionBox b;
         b.box = ImageFloatBox(x, y, w, h);
-        b.score = scores[index];
-        b.label_idx = labels[index];
+        b.score = pixel_box.score;
+        b.label_idx = pixel_box.label_idx;
         output_boxes.push_back(b);
     }
 }
@@ -296,5 +420,320 @@ const YOLOv5Session::DetectionBox* find_detection(const std::vector<YOLOv5Sessio
 }
 
 
+
+// The original pre/post-processing. The tests check against these.
+
+std::tuple<int, int, double, double> reference_load_input(
+    const cv::Mat& input_image, std::vector<float>& model_input, int image_size
+){
+    cv::Mat image_resized;
+    std::tuple<int, int, double, double> ret = resize_image_with_border(
+        input_image, image_resized,
+        image_size, image_size, cv::Scalar(114, 114, 114)
+    );
+
+    cv::Mat image_float;
+    image_resized.convertTo(image_float, CV_32F, 1.0 / 255.0);
+
+    model_input.resize(3 * (size_t)image_size * image_size);
+    for (int c = 0, i = 0; c < 3; c++){
+        for (int row = 0; row < image_float.rows; row++){
+            for (int col = 0; col < image_float.cols; col++){
+                model_input[i++] = image_float.at<cv::Vec3f>(row, col)[c];
+            }
+        }
+    }
+    return ret;
+}
+
+// With `class_aware`, run cv::dnn::NMSBoxes() on each label separately.
+void reference_decode(
+    const float* output, size_t candidates, size_t label_count, bool class_aware,
+    std::vector<YOLOv5Decoder::PixelBox>& boxes
+){
+    const size_t cand_size = label_count + 5;
+
+    std::vector<cv::Rect> pixel_boxes;
+    std::vector<int> indices;
+    std::vector<float> scores;
+    std::vector<size_t> labels;
+
+    for (size_t i = 0; i < candidates; i++){
+        float cx = output[cand_size*i];
+        float cy = output[cand_size*i+1];
+        float w = output[cand_size*i+2];
+        float h = output[cand_size*i+3];
+        float sc = output[cand_size*i+4];
+
+        float max_score = 0.0;
+        size_t pred_label = 0;
+        for (size_t j_label = 0; j_label < label_count; j_label++){
+            float score = output[cand_size*i+5+j_label];
+            if (score > max_score){
+                max_score = score;
+                pred_label = j_label;
+            }
+        }
+        scores.push_back(max_score * sc);
+        pixel_boxes.emplace_back((int)(cx - w / 2 + 0.5), (int)(cy - h / 2 + 0.5), int(w + 0.5), int(h + 0.5));
+        indices.push_back((int)i);
+        labels.push_back(pred_label);
+    }
+
+    if (!class_aware){
+        cv::dnn::NMSBoxes(pixel_boxes, scores, 0.2f, 0.45f, indices);
+    }else{
+        indices.clear();
+        for (size_t label = 0; label < label_count; label++){
+            std::vector<cv::Rect> label_boxes;
+            std::vector<float> label_scores;
+            std::vector<int> label_rows;
+            for (size_t i = 0; i < candidates; i++){
+                if (labels[i] == label){
+                    label_boxes.emplace_back(pixel_boxes[i]);
+                    label_scores.emplace_back(scores[i]);
+                    label_rows.emplace_back((int)i);
+                }
+            }
+            std::vector<int> kept;
+            cv::dnn::NMSBoxes(label_boxes, label_scores, 0.2f, 0.45f, kept);
+            for (int index : kept){
+                indices.emplace_back(label_rows[index]);
+            }
+        }
+        std::sort(indices.begin(), indices.end(), [&](int a, int b){
+            return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+        });
+    }
+
+    boxes.clear();
+    for (int index : indices){
+        const cv::Rect& rect = pixel_boxes[index];
+        boxes.emplace_back(YOLOv5Decoder::PixelBox{
+            scores[index], rect.x, rect.y, rect.width, rect.height, labels[index]
+        });
+    }
+}
+
+
+// Raw output that looks like a real frame: most rows have low objectness and the
+// rest are clustered around a few objects. Confidences are quantized to get ties.
+std::vector<float> make_synthetic_output(std::mt19937& rng, size_t candidates, size_t label_count){
+    std::uniform_real_distribution<float> unit(0, 1);
+    std::normal_distribution<float> jitter(0, 6);
+
+    std::vector<std::array<float, 4>> objects(24);
+    for (std::array<float, 4>& object : objects){
+        object = {640 * unit(rng), 640 * unit(rng), 8 + 200 * unit(rng), 8 + 200 * unit(rng)};
+    }
+
+    const size_t cand_size = label_count + 5;
+    std::vector<float> output(candidates * cand_size);
+    for (size_t i = 0; i < candidates; i++){
+        float* row = &output[cand_size * i];
+        const std::array<float, 4>& object = objects[rng() % objects.size()];
+        row[0] = object[0] + jitter(rng);
+        row[1] = object[1] + jitter(rng);
+        row[2] = object[2] + jitter(rng);
+        row[3] = object[3] + jitter(rng);
+        if (rng() % 64 == 0){
+            row[2] = -row[2];
+        }
+        row[4] = rng() % 32 == 0
+            ? std::round(unit(rng) * 32) / 32
+            : unit(rng) * 0.25f;
+        for (size_t j_label = 0; j_label < label_count; j_label++){
+            row[5 + j_label] = std::round(unit(rng) * 16) / 16;
+        }
+    }
+    return output;
+}
+
+
+class Test_YOLOv5InputTensor : public UnitTest{
+public:
+    Test_YOLOv5InputTensor()
+        : UnitTest("ML::YOLOv5 - Input Tensor")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        const int IMAGE_SIZE = 640;
+        std::mt19937 rng(0);
+
+        // The same tensor is reused for everything so that changing the frame
+        // size must refill the border.
+        YOLOv5InputTensor tensor(IMAGE_SIZE);
+        std::vector<float> expected;
+
+        const int sizes[][2] = {
+            {1920, 1080}, {1280, 720}, {1920, 1080}, {640, 640}, {640, 480},
+            {480, 640}, {641, 639}, {37, 1000}, {1, 1}, {1920, 1080},
+        };
+        for (const auto& size : sizes){
+            scope.throw_if_cancelled();
+
+            // Crop out of a larger image so that rows aren't contiguous.
+            cv::Mat full(size[1] + 2, size[0] + 5, CV_8UC3);
+            cv::randu(full, 0, 256);
+            cv::Mat image = full(cv::Rect(3, 1, size[0], size[1]));
+
+            std::tuple<int, int, double, double> expected_shift = reference_load_input(image, expected, IMAGE_SIZE);
+            std::tuple<int, int, double, double> shift = tensor.load(image);
+
+            std::string name = std::to_string(size[0]) + " x " + std::to_string(size[1]);
+            if (shift != expected_shift){
+                return name + ": Mismatched letterbox shift or scale.";
+            }
+            if (tensor.data().size() != expected.size() ||
+                memcmp(tensor.data().data(), expected.data(), expected.size() * sizeof(float)) != 0
+            ){
+                return name + ": Mismatched input tensor.";
+            }
+        }
+        logger.log("Checked " + std::to_string(std::size(sizes)) + " frame sizes.");
+        return true;
+    }
+};
+
+
+class Test_YOLOv5Decoder : public UnitTest{
+public:
+    Test_YOLOv5Decoder()
+        : UnitTest("ML::YOLOv5 - Decoder")
+    {}
+
+    static std::string compare(
+        const std::vector<YOLOv5Decoder::PixelBox>& boxes,
+        const std::vector<YOLOv5Decoder::PixelBox>& expected
+    ){
+        if (boxes.size() != expected.size()){
+            return "Expected " + std::to_string(expected.size()) + " boxes. Got " + std::to_string(boxes.size()) + ".";
+        }
+        for (size_t c = 0; c < boxes.size(); c++){
+            const YOLOv5Decoder::PixelBox& x = boxes[c];
+            const YOLOv5Decoder::PixelBox& y = expected[c];
+            if (memcmp(&x.score, &y.score, sizeof(float)) != 0 ||
+                x.x != y.x || x.y != y.y || x.width != y.width || x.height != y.height ||
+                x.label_idx != y.label_idx
+            ){
+                return "Mismatched box at index " + std::to_string(c) + ".";
+            }
+        }
+        return "";
+    }
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        const size_t CANDIDATES = 25200;
+        std::mt19937 rng(0);
+        std::vector<YOLOv5Decoder::PixelBox> expected;
+
+        size_t total = 0;
+        for (size_t label_count : {1, 3, 80}){
+            // Reuse the decoder to make sure nothing leaks between frames.
+            YOLOv5Decoder decoder(label_count);
+            for (size_t trial = 0; trial < 4; trial++){
+                scope.throw_if_cancelled();
+                std::vector<float> output = make_synthetic_output(rng, CANDIDATES, label_count);
+                std::string name = std::to_string(label_count) + " labels, trial " + std::to_string(trial);
+
+                decoder.set_class_aware(false);
+                reference_decode(output.data(), CANDIDATES, label_count, false, expected);
+                std::string error = compare(decoder.decode(output.data(), CANDIDATES), expected);
+                if (!error.empty()){
+                    return name + ": " + error;
+                }
+                total += expected.size();
+
+                decoder.set_class_aware(true);
+                reference_decode(output.data(), CANDIDATES, label_count, true, expected);
+                error = compare(decoder.decode(output.data(), CANDIDATES), expected);
+                if (!error.empty()){
+                    return name + " (class-aware): " + error;
+                }
+            }
+
+            // Nothing detected.
+            std::vector<float> empty(CANDIDATES * (label_count + 5));
+            decoder.set_class_aware(false);
+            if (!decoder.decode(empty.data(), CANDIDATES).empty()){
+                return "Detected boxes in an empty output.";
+            }
+        }
+        logger.log("Matched " + std::to_string(total) + " boxes.");
+        return true;
+    }
+};
+
+
+void add_tests_YOLOv5Model(UnitTestDatabase& database){
+    database.add<Test_YOLOv5InputTensor>();
+    database.add<Test_YOLOv5Decoder>();
+}
+
+
+
+void benchmark_YOLOv5Session(Logger& logger, const std::string& model_path, size_t iterations){
+    const int IMAGE_SIZE = 640;
+    const size_t CANDIDATES = 25200;
+    const size_t LABELS = 3;
+
+    auto elapsed_us = [](WallClock start){
+        return (double)std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count();
+    };
+    auto report = [&](const std::string& name, double reference_us, double new_us){
+        logger.log(
+            name + ": " +
+            tostr_fixed(reference_us / iterations, 1) + " us -> " +
+            tostr_fixed(new_us / iterations, 1) + " us per frame"
+        );
+    };
+
+    std::mt19937 rng(0);
+    cv::Mat frame(1080, 1920, CV_8UC3);
+    cv::randu(frame, 0, 256);
+
+    std::vector<float> reference_input;
+    WallClock start = current_time();
+    for (size_t c = 0; c < iterations; c++){
+        reference_load_input(frame, reference_input, IMAGE_SIZE);
+    }
+    double reference_us = elapsed_us(start);
+    YOLOv5InputTensor input(IMAGE_SIZE);
+    start = current_time();
+    for (size_t c = 0; c < iterations; c++){
+        input.load(frame);
+    }
+    report("Preprocess 1920 x 1080", reference_us, elapsed_us(start));
+
+    std::vector<float> output = make_synthetic_output(rng, CANDIDATES, LABELS);
+    std::vector<YOLOv5Decoder::PixelBox> reference_boxes;
+    start = current_time();
+    for (size_t c = 0; c < iterations; c++){
+        reference_decode(output.data(), CANDIDATES, LABELS, false, reference_boxes);
+    }
+    reference_us = elapsed_us(start);
+    YOLOv5Decoder decoder(LABELS);
+    start = current_time();
+    for (size_t c = 0; c < iterations; c++){
+        decoder.decode(output.data(), CANDIDATES);
+    }
+    report("Decode " + std::to_string(CANDIDATES) + " candidates", reference_us, elapsed_us(start));
+
+    if (model_path.empty()){
+        return;
+    }
+    YOLOv5Session session(model_path, false);
+    std::vector<YOLOv5Session::DetectionBox> detections;
+    session.run(frame, detections);
+    start = current_time();
+    for (size_t c = 0; c < iterations; c++){
+        detections.clear();
+        session.run(frame, detections);
+    }
+    logger.log("YOLOv5Session::run() on CPU: " + tostr_fixed(elapsed_us(start) / iterations / 1000, 3) + " ms per frame");
+}
+
+
+
 }
 }
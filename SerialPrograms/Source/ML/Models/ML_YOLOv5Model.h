@@ -9,14 +9,75 @@
 #define PokemonAutomation_ML_YOLOv5Model_H
 
 
+#include <tuple>
 #include <opencv2/core/mat.hpp>
 #include <onnxruntime_cxx_api.h>
+#include "Common/Cpp/TestRunners/UnitTest.h"
 #include "CommonFramework/ImageTools/ImageBoxes.h"
 
 namespace PokemonAutomation{
 namespace ML{
 
 
+// The letterboxed, normalized, planar (CHW) input tensor of a YOLOv5 model.
+// It is kept between frames: only the image area is rewritten each frame and the
+// gray border is only refilled when the frame size changes.
+class YOLOv5InputTensor{
+public:
+    YOLOv5InputTensor(int image_size);
+
+    // Fit `input_image` (rgb color order, 8-bit) into the tensor.
+    // Return the x, y shift of the image inside the tensor and the x, y scale to
+    // map tensor pixels back to [0.0, 1.0] of the input image.
+    std::tuple<int, int, double, double> load(const cv::Mat& input_image);
+
+    std::vector<float>& data(){ return m_data; }
+    const std::vector<float>& data() const{ return m_data; }
+
+private:
+    const int m_image_size;
+    int m_width = 0;
+    int m_height = 0;
+    cv::Mat m_resized;
+    std::vector<float> m_data;
+};
+
+
+// Decode the raw YOLOv5 output into boxes in model input pixels, then run NMS.
+// The buffers are kept between frames.
+class YOLOv5Decoder{
+public:
+    struct PixelBox{
+        float score;
+        int x;
+        int y;
+        int width;
+        int height;
+        size_t label_idx;
+    };
+
+    YOLOv5Decoder(size_t label_count, float score_threshold = 0.2f, float nms_threshold = 0.45f);
+
+    // If true, a box can only be suppressed by a box of the same label.
+    // Default is false: any overlapping box of higher score suppresses it.
+    void set_class_aware(bool class_aware){ m_class_aware = class_aware; }
+
+    // `output` is `candidates` rows of: cx, cy, w, h, objectness, then one confidence per label.
+    // Return the boxes that survive NMS, highest score first.
+    // The result is the same as scoring every row and running cv::dnn::NMSBoxes() on them.
+    const std::vector<PixelBox>& decode(const float* output, size_t candidates);
+
+private:
+    size_t m_label_count;
+    float m_score_threshold;
+    float m_nms_threshold;
+    bool m_class_aware = false;
+
+    std::vector<PixelBox> m_candidates;
+    std::vector<PixelBox> m_kept;
+};
+
+
 class YOLOv5Session{
 public:
     struct DetectionBox{
@@ -37,6 +98,9 @@ public:
     const std::vector<std::string>& get_label_names() const { return m_label_names; }
     // Return SIZE_MAX if no such label name exists.
     size_t label_index(const std::string& label_name) const;
+
+    // See YOLOv5Decoder::set_class_aware().
+    void set_class_aware_nms(bool class_aware){ m_decoder.set_class_aware(class_aware); }
     
 private:
     const int YOLO5_INPUT_IMAGE_SIZE = 640;
@@ -52,14 +116,22 @@ private:
     const std::array<int64_t, 4> m_input_shape{1, 3, YOLO5_INPUT_IMAGE_SIZE, YOLO5_INPUT_IMAGE_SIZE};
     std::array<int64_t, 3> m_output_shape{1, YOLO5_NUM_CANDIDATES, 0};
 
-    std::vector<float> m_model_input;
+    YOLOv5InputTensor m_model_input;
     std::vector<float> m_model_output;
+    YOLOv5Decoder m_decoder;
 };
 
 // Find the first detection matching the given label ID from a YOLOv5Session detection output.
 const YOLOv5Session::DetectionBox* find_detection(const std::vector<YOLOv5Session::DetectionBox>& detection, size_t label_idx);
 
 
+void add_tests_YOLOv5Model(UnitTestDatabase& database);
+
+// Time the pre/post-processing against the original implementation. If `model_path`
+// is not empty, also time YOLOv5Session::run() on that model on the CPU.
+void benchmark_YOLOv5Session(Logger& logger, const std::string& model_path, size_t iterations);
+
+
 }
 }
 #endif
@@ -113,6 +113,28 @@ void PABotBase2_OemController::add_message_loggers(PABotBase2::MessageLogger& me
             return str;
         }
     );
+    message_logger.add_message(
+        "PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH",
+        PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH,
+        sizeof(MessageHeader) + sizeof(Message_Command_NS1_OemController_ButtonsEntry),
+        sizeof(Message_Command_NS1_OemController_ButtonsBatch),
+        [](const MessageHeader*){ return false; },
+        [](const MessageHeader* header){
+            const auto* message = (const Message_Command_NS1_OemController_ButtonsBatch*)header;
+            size_t entries = (header->message_bytes - sizeof(MessageHeader)) / sizeof(Message_Command_NS1_OemController_ButtonsEntry);
+            std::string str;
+            str += "id = " + std::to_string(message->id);
+            str += ", ms = {";
+            for (size_t c = 0; c < entries; c++){
+                if (c != 0){
+                    str += ", ";
+                }
+                str += std::to_string(message->entries[c].milliseconds);
+            }
+            str += "}";
+            return str;
+        }
+    );
 }
 
 
@@ -465,6 +487,27 @@ void PABotBase2_OemController::issue_report(
     //  Divide the controller state into smaller chunks of 65535 milliseconds.
     Milliseconds time_left = std::chrono::duration_cast<Milliseconds>(duration);
 
+    PABotBase2::DeviceHandle& device = m_connection.device();
+
+    //  If the device supports it, let the command queue pack consecutive
+    //  states into one message. This keeps the device queue full of states
+    //  instead of being limited to one state per slot.
+    if (device.supports_command_batching()){
+        PABotBase2::Message_Command_NS1_OemController_ButtonsEntry entry;
+        entry.buttons = buttons;
+        while (time_left > Milliseconds::zero()){
+            Milliseconds current = std::min(time_left, 65535ms);
+            entry.milliseconds = (uint16_t)current.count();
+            device.command_queue().send_batched_command(
+                cancellable,
+                PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH,
+                &entry, sizeof(entry)
+            );
+            time_left -= current;
+        }
+        return;
+    }
+
     PABotBase2::Message_Command_NS1_OemController_Buttons request;
     request.message_bytes = sizeof(request);
     request.opcode = PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS;
@@ -473,7 +516,7 @@ void PABotBase2_OemController::issue_report(
     while (time_left > Milliseconds::zero()){
         Milliseconds current = std::min(time_left, 65535ms);
         request.milliseconds = current.count();
-        m_connection.device().command_queue().send_command(cancellable, request);
+        device.command_queue().send_command(cancellable, request);
         time_left -= current;
     }
 }
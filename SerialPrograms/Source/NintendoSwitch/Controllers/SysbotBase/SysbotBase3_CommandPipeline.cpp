@@ -0,0 +1,595 @@
+/*  sys-botbase 3 Command Pipeline
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <thread>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Logging/AbstractLogger.h"
+#include "Common/Cpp/Sockets/ClientSocket.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "SysbotBase3_FakeServer.h"
+#include "SysbotBase3_CommandPipeline.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+Sysbotbase3_CommandPipeline::Sysbotbase3_CommandPipeline(
+    Logger& logger,
+    SendFunction send,
+    size_t window
+)
+    : m_logger(logger)
+    , m_send(std::move(send))
+    , m_window(std::max<size_t>(window, 1))
+{}
+
+void Sysbotbase3_CommandPipeline::stop(){
+    std::lock_guard<Mutex> lg(m_lock);
+    m_stopping = true;
+    m_cv.notify_all();
+}
+uint64_t Sysbotbase3_CommandPipeline::in_flight() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_next_seqnum - m_next_expected_seqnum_ack;
+}
+Sysbotbase3_CommandPipeline::Stats Sysbotbase3_CommandPipeline::stats() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_stats;
+}
+
+
+
+void Sysbotbase3_CommandPipeline::push(
+    Cancellable* cancellable,
+    Milliseconds duration,
+    const Sysbotbase3_ControllerState& state
+){
+    std::unique_lock<Mutex> lg(m_lock);
+
+    //  Wait until there is space. Whatever is buffered needs to go out first
+    //  or we'll be waiting for acks that will never come.
+    //
+    //  Once the window is full, wait for a quarter of it to drain. Otherwise
+    //  every ack lets out one command and each one becomes its own write.
+    //
+    //  A pending replace will drop everything in flight so it doesn't need to
+    //  wait.
+    if (!m_pending_replace && m_next_seqnum - m_next_expected_seqnum_ack >= m_window){
+        flush_unprotected();
+        const size_t resume = m_window - std::max<size_t>(m_window / 4, 1);
+        m_cv.wait(lg, [this, cancellable, resume]{
+            if (cancellable && cancellable->cancelled()){
+                return true;
+            }
+            return m_stopping
+                || m_pending_replace
+                || m_next_seqnum - m_next_expected_seqnum_ack <= resume;
+        });
+    }
+
+    if (cancellable){
+        cancellable->throw_if_cancelled();
+    }
+    if (m_stopping){
+        throw InvalidConnectionStateException("");
+    }
+
+    if (m_pending_replace){
+        m_pending_replace = false;
+        m_next_expected_seqnum_ack = m_next_seqnum;
+        m_in_flight.clear();
+        m_unsent = 0;
+        m_idle = true;
+        m_buffer += "cqReplaceOnNext\r\n";
+    }
+
+    Sysbotbase3_ControllerCommand command;
+    command.milliseconds = duration.count();
+    command.seqnum = m_next_seqnum++;
+    command.state = state;
+
+    char hex[64];
+    command.write_to_hex(hex);
+    m_buffer += "cqControllerState ";
+    m_buffer.append(hex, sizeof(hex));
+    m_buffer += "\r\n";
+
+    m_in_flight.emplace_back(InFlight{command.seqnum, duration, WallClock::max(), false});
+    m_unsent++;
+    m_stats.commands++;
+}
+void Sysbotbase3_CommandPipeline::flush(){
+    std::lock_guard<Mutex> lg(m_lock);
+    flush_unprotected();
+}
+void Sysbotbase3_CommandPipeline::flush_unprotected(){
+    if (m_buffer.empty()){
+        return;
+    }
+
+    //  Send while holding the lock so that a cancel can't get ahead of the
+    //  commands it is supposed to cancel.
+    WallClock now = current_time();
+    size_t first = m_in_flight.size() - m_unsent;
+    for (size_t c = first; c < m_in_flight.size(); c++){
+        m_in_flight[c].sent = now;
+    }
+    if (m_unsent > 0){
+        //  Only the first one can start right away. The rest queue behind it.
+        m_in_flight[first].idle = m_idle || first == 0;
+        m_idle = false;
+    }
+    m_unsent = 0;
+
+    m_stats.writes++;
+    m_stats.bytes += m_buffer.size();
+
+    std::string data;
+    data.swap(m_buffer);
+    m_send(data);
+}
+uint64_t Sysbotbase3_CommandPipeline::cancel(){
+    std::lock_guard<Mutex> lg(m_lock);
+    if (m_stopping){
+        throw InvalidConnectionStateException("");
+    }
+
+    uint64_t queued = m_next_seqnum - m_next_expected_seqnum_ack;
+    m_next_expected_seqnum_ack = m_next_seqnum;
+    m_in_flight.clear();
+    m_unsent = 0;
+    m_idle = true;
+
+    m_buffer = "cqCancel\r\n";
+    flush_unprotected();
+
+    m_cv.notify_all();
+    return queued;
+}
+uint64_t Sysbotbase3_CommandPipeline::replace_on_next(){
+    std::lock_guard<Mutex> lg(m_lock);
+    if (m_stopping){
+        throw InvalidConnectionStateException("");
+    }
+    m_pending_replace = true;
+    m_cv.notify_all();
+    return m_next_seqnum - m_next_expected_seqnum_ack;
+}
+void Sysbotbase3_CommandPipeline::wait_for_all(Cancellable* cancellable){
+    std::unique_lock<Mutex> lg(m_lock);
+    flush_unprotected();
+    while (true){
+        if (m_stopping){
+            throw InvalidConnectionStateException("");
+        }
+        if (cancellable){
+            cancellable->throw_if_cancelled();
+        }
+        if (m_next_seqnum == m_next_expected_seqnum_ack){
+            return;
+        }
+        m_cv.wait(lg);
+    }
+}
+
+
+
+bool Sysbotbase3_CommandPipeline::on_message(const std::string& message, WallClock timestamp){
+    const std::string TOKEN = "cqCommandFinished";
+    auto pos = message.find(TOKEN);
+    if (pos == std::string::npos){
+        return false;
+    }
+
+    const char* ptr = message.c_str();
+    ptr += pos;
+    ptr += TOKEN.size();
+    while (*ptr == ' ' || *ptr == '\t'){
+        ptr++;
+    }
+    if (*ptr == '\0'){
+        return false;
+    }
+    uint64_t parsed = std::atoll(ptr);
+
+    std::lock_guard<Mutex> lg(m_lock);
+
+    //  Old ack
+    if (parsed < m_next_expected_seqnum_ack){
+        m_logger.log(
+            "Received Old Ack: Expected = " + std::to_string(m_next_expected_seqnum_ack) +
+            ", Actual = " + std::to_string(parsed),
+            COLOR_DARKGREEN
+        );
+        return true;
+    }
+
+    //  Ack is ahead of what has been dispatched.
+    if (parsed >= m_next_seqnum){
+        m_logger.log(
+            "Received Future Ack: Expected = " + std::to_string(m_next_expected_seqnum_ack) +
+            ", Actual = " + std::to_string(parsed),
+            COLOR_RED
+        );
+        return true;
+    }
+
+    while (!m_in_flight.empty() && m_in_flight.front().seqnum < parsed){
+        m_in_flight.pop_front();
+    }
+    if (!m_in_flight.empty() && m_in_flight.front().seqnum == parsed){
+        const InFlight& command = m_in_flight.front();
+
+        //  Only use commands that didn't have to wait behind anything on the
+        //  console. Otherwise the sample includes the time spent in its queue.
+        if (command.idle && command.sent != WallClock::max()){
+            WallDuration sample = timestamp - command.sent - command.duration;
+            if (sample > WallDuration::zero()){
+                add_rtt_sample(sample);
+            }
+        }
+        m_in_flight.pop_front();
+    }
+
+    m_next_expected_seqnum_ack = parsed + 1;
+    m_cv.notify_all();
+    return true;
+}
+void Sysbotbase3_CommandPipeline::add_rtt_sample(WallDuration sample){
+    Stats& stats = m_stats;
+    stats.rtt_last = sample;
+    stats.rtt_min = std::min(stats.rtt_min, sample);
+    if (stats.rtt_samples == 0){
+        stats.rtt_smoothed = sample;
+        stats.rtt_variation = sample / 2;
+    }else{
+        WallDuration error = stats.rtt_smoothed > sample
+            ? stats.rtt_smoothed - sample
+            : sample - stats.rtt_smoothed;
+        stats.rtt_variation = (3 * stats.rtt_variation + error) / 4;
+        stats.rtt_smoothed = (7 * stats.rtt_smoothed + sample) / 8;
+    }
+    stats.rtt_samples++;
+}
+
+
+
+
+
+//  A pipeline that talks to a fake sys-botbase over a real socket.
+class LoopbackPipeline : private ClientSocket::Listener{
+public:
+    LoopbackPipeline(Logger& logger, uint16_t port, size_t window)
+        : pipeline(
+            logger,
+            [this](const std::string& data){ m_socket.send(data.data(), data.size()); },
+            window
+        )
+        , m_socket(GlobalThreadPools::unlimited_realtime())
+    {
+        m_socket.add_listener(*this);
+        m_socket.connect("127.0.0.1", port);
+    }
+    ~LoopbackPipeline(){
+        pipeline.stop();
+        m_socket.close();
+    }
+
+    bool wait_for_connect(){
+        WallClock deadline = current_time() + std::chrono::seconds(5);
+        while (current_time() < deadline){
+            switch (m_socket.state()){
+            case ClientSocket::State::CONNECTED:
+                return true;
+            case ClientSocket::State::CONNECTING:
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    //  Same as Sysbotbase3_CommandPipeline::wait_for_all(), but gives up
+    //  instead of hanging the test if the acks never come.
+    bool wait_for_acks(WallDuration timeout = std::chrono::seconds(10)){
+        pipeline.flush();
+        WallClock deadline = current_time() + timeout;
+        while (pipeline.in_flight() != 0){
+            if (current_time() > deadline){
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    Sysbotbase3_CommandPipeline pipeline;
+
+private:
+    virtual void on_receive_data(const void* data, size_t bytes) override{
+        WallClock now = current_time();
+        const char* ptr = (const char*)data;
+        for (size_t c = 0; c < bytes; c++){
+            char ch = ptr[c];
+            if (ch == '\r'){
+                continue;
+            }
+            if (ch != '\n'){
+                m_line += ch;
+                continue;
+            }
+            pipeline.on_message(m_line, now);
+            m_line.clear();
+        }
+    }
+
+    std::string m_line;
+    ClientSocket m_socket;
+};
+
+
+//  How long the console sat idle between consecutive commands.
+struct IdleTime{
+    WallDuration total = WallDuration::zero();
+    WallDuration max = WallDuration::zero();
+};
+static IdleTime idle_time(
+    const std::vector<FakeSysbotBase3Server::ExecutedCommand>& executed,
+    size_t start, size_t end
+){
+    IdleTime ret;
+    for (size_t c = start + 1; c < end; c++){
+        WallDuration gap = executed[c].started - executed[c - 1].finished;
+        ret.total += gap;
+        ret.max = std::max(ret.max, gap);
+    }
+    return ret;
+}
+
+static std::string to_ms(WallDuration duration){
+    return tostr_fixed(std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000., 3) + " ms";
+}
+
+
+
+class Test_SysbotBase3CommandPipeline : public UnitTest{
+public:
+    Test_SysbotBase3CommandPipeline()
+        : UnitTest("NintendoSwitch::SysbotBase3 - Command Pipeline")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        const WallDuration LATENCY = std::chrono::milliseconds(10);
+        const size_t BATCHES = 10;
+        const size_t BATCH_SIZE = 20;
+
+        FakeSysbotBase3Server server(LATENCY);
+        if (server.port() == 0){
+            return UnitTestResult(UnitTestResult::SKIPPED, "Unable to open a loopback socket.");
+        }
+
+        //  Each batch is one schedule. The window is larger than a batch so
+        //  each one should go out in a single write.
+        {
+            LoopbackPipeline client(logger, server.port(), 64);
+            if (!client.wait_for_connect()){
+                return "Unable to connect to the fake server.";
+            }
+            for (size_t b = 0; b < BATCHES; b++){
+                scope.throw_if_cancelled();
+                for (size_t c = 0; c < BATCH_SIZE; c++){
+                    Sysbotbase3_ControllerState state;
+                    state.buttons = c & 1;
+                    client.pipeline.push(&scope, Milliseconds(5), state);
+                }
+                if (!client.wait_for_acks()){
+                    return "Timed out waiting for acks.";
+                }
+            }
+
+            Sysbotbase3_CommandPipeline::Stats stats = client.pipeline.stats();
+            std::vector<FakeSysbotBase3Server::ExecutedCommand> executed = server.executed();
+            if (executed.size() != BATCHES * BATCH_SIZE){
+                return "Expected " + std::to_string(BATCHES * BATCH_SIZE) + " commands. Got " + std::to_string(executed.size()) + ".";
+            }
+            for (size_t c = 0; c < executed.size(); c++){
+                if (executed[c].seqnum != c + 1){
+                    return "Commands executed out of order.";
+                }
+            }
+            if (stats.commands != BATCHES * BATCH_SIZE || stats.writes != BATCHES){
+                return "Expected one write per batch. Got " + std::to_string(stats.writes) + " writes.";
+            }
+
+            //  Commands in the same batch run back to back.
+            for (size_t b = 0; b < BATCHES; b++){
+                IdleTime idle = idle_time(executed, b * BATCH_SIZE, (b + 1) * BATCH_SIZE);
+                if (idle.max > std::chrono::milliseconds(1)){
+                    return "Console went idle inside a batch: " + to_ms(idle.max);
+                }
+            }
+
+            //  Every batch starts with an idle console so each one gives
+            //  exactly one sample. The RTT can't be less than the simulated latency.
+            if (stats.rtt_samples != BATCHES){
+                return "Expected " + std::to_string(BATCHES) + " RTT samples. Got " + std::to_string(stats.rtt_samples) + ".";
+            }
+            if (stats.rtt_min < 2 * LATENCY || stats.rtt_min > 2 * LATENCY + std::chrono::milliseconds(30)){
+                return "RTT is out of range: " + to_ms(stats.rtt_min);
+            }
+            logger.log(
+                "RTT: min = " + to_ms(stats.rtt_min) +
+                ", smoothed = " + to_ms(stats.rtt_smoothed) +
+                " (" + std::to_string(stats.rtt_samples) + " samples)"
+            );
+        }
+
+        //  A small window is never exceeded.
+        server.clear_history();
+        {
+            const size_t WINDOW = 4;
+            LoopbackPipeline client(logger, server.port(), WINDOW);
+            if (!client.wait_for_connect()){
+                return "Unable to connect to the fake server.";
+            }
+            for (size_t c = 0; c < 40; c++){
+                client.pipeline.push(&scope, Milliseconds(5), Sysbotbase3_ControllerState());
+                if (client.pipeline.in_flight() > WINDOW){
+                    return "In-flight window exceeded: " + std::to_string(client.pipeline.in_flight());
+                }
+            }
+            if (!client.wait_for_acks()){
+                return "Timed out waiting for acks.";
+            }
+            if (server.executed().size() != 40){
+                return "Expected 40 commands. Got " + std::to_string(server.executed().size()) + ".";
+            }
+        }
+
+        return true;
+    }
+};
+
+
+
+class Test_SysbotBase3CommandPipelineCancel : public UnitTest{
+public:
+    Test_SysbotBase3CommandPipelineCancel()
+        : UnitTest("NintendoSwitch::SysbotBase3 - Command Pipeline Cancel")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        FakeSysbotBase3Server server(std::chrono::milliseconds(5));
+        if (server.port() == 0){
+            return UnitTestResult(UnitTestResult::SKIPPED, "Unable to open a loopback socket.");
+        }
+        LoopbackPipeline client(logger, server.port(), 64);
+        if (!client.wait_for_connect()){
+            return "Unable to connect to the fake server.";
+        }
+
+        //  Cancel in the middle of a long queue.
+        for (size_t c = 0; c < 20; c++){
+            client.pipeline.push(&scope, Milliseconds(50), Sysbotbase3_ControllerState());
+        }
+        client.pipeline.flush();
+        WallClock deadline = current_time() + std::chrono::seconds(5);
+        while (server.executed().empty()){
+            if (current_time() > deadline){
+                return "Nothing was executed.";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (client.pipeline.cancel() == 0){
+            return "Cancel didn't drop anything.";
+        }
+        if (client.pipeline.in_flight() != 0){
+            return "Commands are still in flight after cancelling.";
+        }
+
+        client.pipeline.push(&scope, Milliseconds(5), Sysbotbase3_ControllerState());
+        if (!client.wait_for_acks()){
+            return "Timed out waiting for the command after the cancel.";
+        }
+        std::vector<FakeSysbotBase3Server::ExecutedCommand> executed = server.executed();
+        if (server.cancels() != 1 || executed.size() >= 20 || executed.back().seqnum != 21){
+            return "Cancel didn't clear the console's queue.";
+        }
+
+        //  Replace a long queue with a short command. It shouldn't wait for
+        //  the queue to drain.
+        for (size_t c = 0; c < 20; c++){
+            client.pipeline.push(&scope, Milliseconds(50), Sysbotbase3_ControllerState());
+        }
+        client.pipeline.flush();
+        client.pipeline.replace_on_next();
+        client.pipeline.push(&scope, Milliseconds(5), Sysbotbase3_ControllerState());
+        if (!client.wait_for_acks(std::chrono::milliseconds(500))){
+            return "Replaced commands were not dropped.";
+        }
+        executed = server.executed();
+        if (executed.back().seqnum != 42){
+            return "Expected the replacement to finish last.";
+        }
+
+        return true;
+    }
+};
+
+
+
+void add_tests_SysbotBase3CommandPipeline(UnitTestDatabase& database){
+    database.add<Test_SysbotBase3CommandPipeline>();
+    database.add<Test_SysbotBase3CommandPipelineCancel>();
+}
+
+
+
+void benchmark_SysbotBase3CommandPipeline(Logger& logger, size_t commands){
+    //  Roughly what a mash looks like. 8 commands per schedule.
+    const Milliseconds DURATION(8);
+    const size_t SCHEDULE_SIZE = 8;
+
+    for (int latency : {1, 10, 40}){
+        FakeSysbotBase3Server server{Milliseconds(latency)};
+        if (server.port() == 0){
+            logger.log("Unable to open a loopback socket.", COLOR_RED);
+            return;
+        }
+        for (size_t window : {1, 4, 16, 64}){
+            server.clear_history();
+            LoopbackPipeline client(logger, server.port(), window);
+            if (!client.wait_for_connect()){
+                logger.log("Unable to connect to the fake server.", COLOR_RED);
+                return;
+            }
+
+            WallClock start = current_time();
+            for (size_t c = 0; c < commands; c++){
+                client.pipeline.push(nullptr, DURATION, Sysbotbase3_ControllerState());
+                if ((c + 1) % SCHEDULE_SIZE == 0){
+                    client.pipeline.flush();
+                }
+            }
+            if (!client.wait_for_acks(std::chrono::seconds(60))){
+                logger.log("Timed out waiting for acks.", COLOR_RED);
+                return;
+            }
+            WallDuration elapsed = current_time() - start;
+
+            Sysbotbase3_CommandPipeline::Stats stats = client.pipeline.stats();
+            std::vector<FakeSysbotBase3Server::ExecutedCommand> executed = server.executed();
+            IdleTime idle = idle_time(executed, 0, executed.size());
+            double seconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000000.;
+
+            logger.log(
+                "Latency = " + std::to_string(latency) + " ms, window = " + std::to_string(window) +
+                ": " + tostr_fixed(commands / seconds, 1) + " commands/s (ideal " + tostr_fixed(1000. / DURATION.count(), 1) + ")" +
+                ", idle between commands: avg = " + to_ms(executed.size() > 1 ? idle.total / (int64_t)(executed.size() - 1) : WallDuration::zero()) +
+                ", max = " + to_ms(idle.max) +
+                ", writes = " + std::to_string(stats.writes) +
+                ", RTT = " + (stats.rtt_samples == 0 ? std::string("?") : to_ms(stats.rtt_smoothed))
+            );
+        }
+    }
+}
+
+
+
+}
+}
@@ -0,0 +1,152 @@
+/*  sys-botbase 3 Command Pipeline
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Flow control for the sbb3 controller command queue.
+ *
+ *  Commands are buffered and sent together when the caller flushes or when the
+ *  in-flight window fills up. The console acks each command with
+ *  "cqCommandFinished <seqnum>" when it finishes. No more than "window"
+ *  commands are ever unacked.
+ *
+ *  The acks also give us the round trip time. A command that the console
+ *  started as soon as it arrived is acked "RTT + duration" after it was sent.
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_SysbotBase3_CommandPipeline_H
+#define PokemonAutomation_NintendoSwitch_SysbotBase3_CommandPipeline_H
+
+#include <stdint.h>
+#include <string>
+#include <deque>
+#include <functional>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "SysbotBase3_ControllerState.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+class Cancellable;
+class UnitTestDatabase;
+
+namespace NintendoSwitch{
+
+
+
+class Sysbotbase3_CommandPipeline{
+public:
+    using SendFunction = std::function<void(const std::string& data)>;
+
+    struct Stats{
+        uint64_t commands = 0;
+        uint64_t writes = 0;
+        uint64_t bytes = 0;
+
+        //  Round trip time measured from the command acks. (RFC 6298 style)
+        uint64_t rtt_samples = 0;
+        WallDuration rtt_last = WallDuration::zero();
+        WallDuration rtt_min = WallDuration::max();
+        WallDuration rtt_smoothed = WallDuration::zero();
+        WallDuration rtt_variation = WallDuration::zero();
+    };
+
+public:
+    Sysbotbase3_CommandPipeline(Logger& logger, SendFunction send, size_t window);
+
+    size_t window() const{ return m_window; }
+
+    //  Wake up everything that is waiting. Anything that tries to queue a
+    //  command after this will throw.
+    void stop();
+
+    //  Commands that have been pushed, but not acked.
+    uint64_t in_flight() const;
+
+    Stats stats() const;
+
+
+public:
+    //  Buffer a command. If the window is full, flush what's buffered and wait
+    //  until a quarter of the window has drained.
+    void push(
+        Cancellable* cancellable,
+        Milliseconds duration,
+        const Sysbotbase3_ControllerState& state
+    );
+
+    //  Send everything that has been buffered in a single write.
+    void flush();
+
+    //  Drop everything that is buffered or in flight and tell the console to
+    //  do the same. Returns the # of commands that were dropped.
+    uint64_t cancel();
+
+    //  The next command will replace everything that is queued on the
+    //  console. Returns the # of commands that will be replaced.
+    uint64_t replace_on_next();
+
+    //  Flush and wait until everything has been acked.
+    void wait_for_all(Cancellable* cancellable);
+
+    //  Feed a line that was received from the console.
+    //  Returns true if it was a command ack.
+    bool on_message(const std::string& message, WallClock timestamp);
+
+
+private:
+    struct InFlight{
+        uint64_t seqnum;
+        WallDuration duration;
+        WallClock sent;
+
+        //  The console had nothing ahead of this when it was sent.
+        bool idle;
+    };
+
+    void flush_unprotected();
+    void add_rtt_sample(WallDuration sample);
+
+
+private:
+    Logger& m_logger;
+    SendFunction m_send;
+    const size_t m_window;
+
+    mutable Mutex m_lock;
+    ConditionVariable m_cv;
+
+    bool m_stopping = false;
+    bool m_pending_replace = false;
+
+    //  The console's queue is known to be empty. (after a cancel or replace)
+    bool m_idle = true;
+
+    uint64_t m_next_seqnum = 1;
+    uint64_t m_next_expected_seqnum_ack = 1;
+
+    //  Everything that hasn't been acked. The last "m_unsent" are still in
+    //  "m_buffer".
+    std::deque<InFlight> m_in_flight;
+    std::string m_buffer;
+    size_t m_unsent = 0;
+
+    Stats m_stats;
+};
+
+
+
+void add_tests_SysbotBase3CommandPipeline(UnitTestDatabase& database);
+
+//  Drive the pipeline against a loopback fake sys-botbase with simulated
+//  latency. Reports the achieved command rate and how much the console sat
+//  idle between commands for different window sizes.
+void benchmark_SysbotBase3CommandPipeline(Logger& logger, size_t commands);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,319 @@
+/*  Fake sys-botbase 3 Server
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <cerrno>
+#include <algorithm>
+#ifdef _WIN32
+#include <winsock2.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "SysbotBase3_ControllerState.h"
+#include "SysbotBase3_FakeServer.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+static const NativeSocket NO_SOCKET = INVALID_SOCKET;
+static void close_native_socket(NativeSocket socket){
+    closesocket(socket);
+}
+static void set_non_blocking(NativeSocket socket){
+    u_long non_blocking = 1;
+    ioctlsocket(socket, FIONBIO, &non_blocking);
+}
+static bool would_block(){
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+#else
+using NativeSocket = int;
+static const NativeSocket NO_SOCKET = -1;
+static void close_native_socket(NativeSocket socket){
+    ::close(socket);
+}
+static void set_non_blocking(NativeSocket socket){
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+}
+static bool would_block(){
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+#endif
+
+
+//  Wait up to "timeout" for the socket to become readable.
+static void wait_readable(NativeSocket socket, std::chrono::microseconds timeout){
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(socket, &set);
+    timeval tv;
+    tv.tv_sec = (long)(timeout.count() / 1000000);
+    tv.tv_usec = (long)(timeout.count() % 1000000);
+    select((int)socket + 1, &set, nullptr, nullptr, &tv);
+}
+
+
+
+FakeSysbotBase3Server::FakeSysbotBase3Server(WallDuration latency)
+    : m_latency(latency)
+    , m_listen_socket((intptr_t)NO_SOCKET)
+{
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0){
+        return;
+    }
+#endif
+
+    NativeSocket listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == NO_SOCKET){
+        return;
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+#ifdef _WIN32
+    int length = sizeof(address);
+#else
+    socklen_t length = sizeof(address);
+#endif
+    if (::bind(listener, (sockaddr*)&address, sizeof(address)) != 0 ||
+        ::listen(listener, 1) != 0 ||
+        ::getsockname(listener, (sockaddr*)&address, &length) != 0
+    ){
+        close_native_socket(listener);
+        return;
+    }
+    set_non_blocking(listener);
+
+    m_listen_socket = (intptr_t)listener;
+    m_port = ntohs(address.sin_port);
+
+    m_network_thread = Thread([this]{ network_loop(); });
+    m_execute_thread = Thread([this]{ execute_loop(); });
+}
+FakeSysbotBase3Server::~FakeSysbotBase3Server(){
+    {
+        std::lock_guard<Mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    m_network_thread.join();
+    m_execute_thread.join();
+    if ((NativeSocket)m_listen_socket != NO_SOCKET){
+        close_native_socket((NativeSocket)m_listen_socket);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+std::vector<FakeSysbotBase3Server::ExecutedCommand> FakeSysbotBase3Server::executed() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_executed;
+}
+uint64_t FakeSysbotBase3Server::cancels() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    return m_cancels;
+}
+void FakeSysbotBase3Server::clear_history(){
+    std::lock_guard<Mutex> lg(m_lock);
+    m_executed.clear();
+    m_cancels = 0;
+}
+
+
+
+void FakeSysbotBase3Server::reply(std::string message, WallClock sent){
+    m_outbox.emplace(sent + m_latency, std::move(message) + "\r\n");
+}
+void FakeSysbotBase3Server::process_line(const std::string& line, WallClock arrived){
+    const std::string COMMAND = "cqControllerState ";
+    if (line.rfind(COMMAND, 0) == 0 && line.size() >= COMMAND.size() + 64){
+        Sysbotbase3_ControllerCommand command;
+        command.parse_from_hex(line.c_str() + COMMAND.size());
+        if (m_replace_on_next){
+            m_replace_on_next = false;
+            m_queue.clear();
+            m_interrupt = true;
+        }
+        m_queue.emplace_back(QueuedCommand{
+            command.seqnum,
+            std::chrono::milliseconds(command.milliseconds),
+            arrived
+        });
+        m_cv.notify_all();
+        return;
+    }
+    if (line == "cqReplaceOnNext"){
+        m_replace_on_next = true;
+        return;
+    }
+    if (line == "cqCancel"){
+        m_queue.clear();
+        m_interrupt = true;
+        m_cancels++;
+        m_cv.notify_all();
+        return;
+    }
+    if (line == "getVersion"){
+        reply("3.0.0", arrived);
+        return;
+    }
+    if (line.rfind("ping", 0) == 0){
+        reply(line, arrived);
+        return;
+    }
+}
+
+
+void FakeSysbotBase3Server::network_loop(){
+    NativeSocket listener = (NativeSocket)m_listen_socket;
+    NativeSocket client = NO_SOCKET;
+
+    std::string line;
+    char buffer[4096];
+
+    while (true){
+        {
+            std::lock_guard<Mutex> lg(m_lock);
+            if (m_stopping){
+                break;
+            }
+        }
+
+        if (client == NO_SOCKET){
+            client = ::accept(listener, nullptr, nullptr);
+            if (client == NO_SOCKET){
+                wait_readable(listener, std::chrono::milliseconds(1));
+                continue;
+            }
+            set_non_blocking(client);
+        }
+
+        //  Receive. Everything is stamped with when it will "arrive".
+        while (true){
+            auto bytes = ::recv(client, buffer, sizeof(buffer), 0);
+            if (bytes <= 0){
+                if (bytes == 0 || !would_block()){
+                    close_native_socket(client);
+                    client = NO_SOCKET;
+                }
+                break;
+            }
+            WallClock arrival = current_time() + m_latency;
+            std::lock_guard<Mutex> lg(m_lock);
+            for (decltype(bytes) c = 0; c < bytes; c++){
+                char ch = buffer[c];
+                if (ch == '\r'){
+                    continue;
+                }
+                if (ch != '\n'){
+                    line += ch;
+                    continue;
+                }
+                m_inbox.emplace_back(arrival, std::move(line));
+                line.clear();
+            }
+        }
+
+        //  Deliver whatever is due in either direction.
+        std::string send;
+        WallClock next = current_time() + std::chrono::milliseconds(1);
+        {
+            std::lock_guard<Mutex> lg(m_lock);
+            WallClock now = current_time();
+            while (!m_inbox.empty() && m_inbox.front().first <= now){
+                process_line(m_inbox.front().second, m_inbox.front().first);
+                m_inbox.pop_front();
+            }
+            while (!m_outbox.empty() && m_outbox.begin()->first <= now){
+                send += m_outbox.begin()->second;
+                m_outbox.erase(m_outbox.begin());
+            }
+            if (!m_inbox.empty()){
+                next = std::min(next, m_inbox.front().first);
+            }
+            if (!m_outbox.empty()){
+                next = std::min(next, m_outbox.begin()->first);
+            }
+        }
+        if (client != NO_SOCKET && !send.empty()){
+            ::send(client, send.data(), (int)send.size(), 0);
+        }
+
+        WallClock now = current_time();
+        if (client != NO_SOCKET && next > now){
+            wait_readable(client, std::chrono::duration_cast<std::chrono::microseconds>(next - now));
+        }
+    }
+
+    if (client != NO_SOCKET){
+        close_native_socket(client);
+    }
+}
+
+
+void FakeSysbotBase3Server::execute_loop(){
+    std::unique_lock<Mutex> lg(m_lock);
+    while (true){
+        m_cv.wait(lg, [this]{ return m_stopping || !m_queue.empty(); });
+        if (m_stopping){
+            return;
+        }
+
+        QueuedCommand command = m_queue.front();
+        m_queue.pop_front();
+        m_interrupt = false;
+
+        //  The console can't start a command before it arrives or before the
+        //  previous one is done.
+        WallClock started = std::max(command.arrived, m_last_finish);
+        WallClock finished = started + command.duration;
+
+        m_cv.wait_until(lg, finished, [this]{ return m_stopping || m_interrupt; });
+        if (m_stopping){
+            return;
+        }
+        if (m_interrupt){
+            m_last_finish = current_time();
+            continue;
+        }
+
+        m_last_finish = finished;
+        m_executed.emplace_back(ExecutedCommand{
+            command.seqnum,
+            command.duration,
+            command.arrived,
+            started,
+            finished,
+        });
+        reply("cqCommandFinished " + std::to_string(command.seqnum), finished);
+    }
+}
+
+
+
+}
+}
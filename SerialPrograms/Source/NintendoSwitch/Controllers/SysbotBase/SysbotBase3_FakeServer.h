@@ -0,0 +1,99 @@
+/*  Fake sys-botbase 3 Server
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A loopback stand-in for the sbb3 command queue for tests and
+ *  benchmarks. It accepts one connection on 127.0.0.1.
+ *
+ *  Everything sent in either direction is delayed by "latency". Commands are
+ *  run back to back on a virtual clock, so the console only goes idle when the
+ *  next command hasn't arrived yet. Each one is acked with
+ *  "cqCommandFinished <seqnum>" when it finishes.
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_SysbotBase3_FakeServer_H
+#define PokemonAutomation_NintendoSwitch_SysbotBase3_FakeServer_H
+
+#include <stdint.h>
+#include <string>
+#include <deque>
+#include <map>
+#include <vector>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+#include "Common/Cpp/Concurrency/ConditionVariable.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+class FakeSysbotBase3Server{
+public:
+    struct ExecutedCommand{
+        uint64_t seqnum;
+        WallDuration duration;
+        WallClock arrived;
+        WallClock started;
+        WallClock finished;
+    };
+
+public:
+    FakeSysbotBase3Server(WallDuration latency);
+    ~FakeSysbotBase3Server();
+
+    //  Zero if the server couldn't be started.
+    uint16_t port() const{ return m_port; }
+
+    //  Commands that ran to completion, in order.
+    std::vector<ExecutedCommand> executed() const;
+    uint64_t cancels() const;
+    void clear_history();
+
+
+private:
+    struct QueuedCommand{
+        uint64_t seqnum;
+        WallDuration duration;
+        WallClock arrived;
+    };
+
+    void network_loop();
+    void execute_loop();
+
+    void process_line(const std::string& line, WallClock arrived);
+    void reply(std::string message, WallClock sent);
+
+
+private:
+    const WallDuration m_latency;
+    intptr_t m_listen_socket;
+    uint16_t m_port = 0;
+
+    mutable Mutex m_lock;
+    ConditionVariable m_cv;
+    bool m_stopping = false;
+
+    //  Received, but still "on the wire".
+    std::deque<std::pair<WallClock, std::string>> m_inbox;
+    std::multimap<WallClock, std::string> m_outbox;
+
+    std::deque<QueuedCommand> m_queue;
+    bool m_replace_on_next = false;
+    bool m_interrupt = false;
+    WallClock m_last_finish = WallClock::min();
+
+    std::vector<ExecutedCommand> m_executed;
+    uint64_t m_cancels = 0;
+
+    Thread m_network_thread;
+    Thread m_execute_thread;
+};
+
+
+
+}
+}
+#endif
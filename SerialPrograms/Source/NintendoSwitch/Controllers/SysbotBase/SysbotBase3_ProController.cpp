@@ -5,6 +5,7 @@
  */
 
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
 #include "Common/Cpp/Options/BooleanCheckBoxOption.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "Controllers/JoystickTools.h"
@@ -27,10 +28,11 @@ ProController_SysbotBase3::ProController_SysbotBase3(
     : ProController(logger)
     , ControllerWithScheduler(logger, logging_throttler())
     , m_connection(connection)
-    , m_stopping(false)
-    , m_pending_replace(false)
-    , m_next_seqnum(1)
-    , m_next_expected_seqnum_ack(1)
+    , m_pipeline(
+        logger,
+        [&connection](const std::string& data){ connection.write_data(data); },
+        QUEUE_SIZE
+    )
 {
     if (!connection.is_ready()){
         return;
@@ -39,46 +41,38 @@ ProController_SysbotBase3::ProController_SysbotBase3(
 }
 ProController_SysbotBase3::~ProController_SysbotBase3(){
     m_connection.remove_listener(*this);
+    m_pipeline.stop();
+
+    Sysbotbase3_CommandPipeline::Stats stats = m_pipeline.stats();
+    if (stats.commands == 0){
+        return;
+    }
+    std::string str = "sys-botbase3: Sent " + std::to_string(stats.commands) +
+        " commands in " + std::to_string(stats.writes) + " writes.";
+    if (stats.rtt_samples > 0){
+        str += " Round Trip: min = " + tostr_fixed(std::chrono::duration_cast<std::chrono::microseconds>(stats.rtt_min).count() / 1000., 3) +
+            " ms, avg = " + tostr_fixed(std::chrono::duration_cast<std::chrono::microseconds>(stats.rtt_smoothed).count() / 1000., 3) + " ms";
+    }
+    m_logger.log(str);
 }
 
 void ProController_SysbotBase3::cancel_all_commands(){
     std::lock_guard<Mutex> lg(m_state_lock);
-    if (m_stopping){
-        throw InvalidConnectionStateException("");
-    }
-
-    uint64_t queued = m_next_seqnum - m_next_expected_seqnum_ack;
-    m_next_expected_seqnum_ack = m_next_seqnum;
 
-    m_connection.write_data("cqCancel\r\n");
+    uint64_t queued = m_pipeline.cancel();
     if (LOG_EVERYTHING()){
         m_logger.log("sys-botbase3: cqCancel");
     }
 
     m_scheduler.clear_on_next();
-    m_cv.notify_all();
     m_logger.log("cancel_all_commands(): Command Queue Size = " + std::to_string(queued), COLOR_DARKGREEN);
 }
 void ProController_SysbotBase3::replace_on_next_command(){
     std::lock_guard<Mutex> lg(m_state_lock);
-    if (m_stopping){
-        throw InvalidConnectionStateException("");
-    }
-
-    uint64_t queued = m_next_seqnum - m_next_expected_seqnum_ack;
-//    m_next_expected_seqnum_ack = m_next_seqnum;
-
-    m_pending_replace = true;
 
-#if 0
-    m_connection.write_data("cqReplaceOnNext\r\n");
-    if (LOG_EVERYTHING()){
-        m_logger.log("sys-botbase3: cqReplaceOnNext");
-    }
-#endif
+    uint64_t queued = m_pipeline.replace_on_next();
 
     m_scheduler.clear_on_next();
-    m_cv.notify_all();
     m_logger.log("replace_on_next_command(): Command Queue Size = " + std::to_string(queued), COLOR_DARKGREEN);
 }
 void ProController_SysbotBase3::wait_for_all(Cancellable* cancellable){
@@ -89,91 +83,41 @@ void ProController_SysbotBase3::wait_for_all(Cancellable* cancellable){
 
     //    cout << "wait_for_all() - start" << endl;
 
-        if (m_stopping){
-            throw InvalidConnectionStateException("");
-        }
         m_scheduler.issue_wait_for_all(schedule);
     }
     execute_schedule(cancellable, schedule);
 
-    std::unique_lock<Mutex> lg1(m_state_lock);
-    while (true){
-        if (m_stopping){
-            throw InvalidConnectionStateException("");
-        }
-        if (cancellable){
-            cancellable->throw_if_cancelled();
-        }
-        if (m_next_seqnum == m_next_expected_seqnum_ack){
-            break;
-        }
-        m_cv.wait(lg1);
-    }
+    m_pipeline.wait_for_all(cancellable);
 
 //    cout << "wait_for_all() - done" << endl;
 }
 
 
-void ProController_SysbotBase3::on_message(const std::string& message){
-    const std::string TOKEN = "cqCommandFinished";
-    auto pos = message.find(TOKEN);
-    if (pos == std::string::npos){
+void ProController_SysbotBase3::on_message(const std::string& message, WallClock timestamp){
+    if (!m_pipeline.on_message(message, timestamp)){
         return;
     }
-
-    const char* ptr = message.c_str();
-    ptr += pos;
-    ptr += TOKEN.size();
-    uint64_t parsed;
-    while (true){
-        char ch = *ptr;
-        switch (ch){
-        case '\0':
-            return;
-        case ' ':
-        case '\t':
-            ptr++;
-            continue;
-        }
-        parsed = std::atoll(ptr);
-        break;
-    }
-
-    std::lock_guard<Mutex> lg(m_state_lock);
-
-//    cout << "parsed = " << parsed << endl;
-//    cout << "m_next_seqnum = " << m_next_seqnum << endl;
-//    cout << "m_next_expected_seqnum_ack = " << m_next_expected_seqnum_ack << endl;
-
     if (LOG_EVERYTHING()){
         m_logger.log(
-            "Command Finished: " + std::to_string(parsed) +
-            " (queue size = " + std::to_string(m_next_seqnum - m_next_expected_seqnum_ack) + ")"
-        );
-    }
-
-    //  Old ack
-    if (parsed < m_next_expected_seqnum_ack){
-        m_logger.log(
-            "Received Old Ack: Expected = " + std::to_string(m_next_expected_seqnum_ack) +
-            ", Actual = " + std::to_string(parsed),
-            COLOR_DARKGREEN
+            "Command Finished: " + message +
+            " (queue size = " + std::to_string(m_pipeline.in_flight()) + ")"
         );
-        return;
-    }
-
-    //  Ack is ahead of what has been dispatched.
-    if (parsed >= m_next_seqnum){
-        m_logger.log(
-            "Received Future Ack: Expected = " + std::to_string(m_next_expected_seqnum_ack) +
-            ", Actual = " + std::to_string(parsed),
-            COLOR_RED
-        );
-        return;
     }
+}
 
-    m_next_expected_seqnum_ack = parsed + 1;
-    m_cv.notify_all();
+void ProController_SysbotBase3::execute_schedule(
+    Cancellable* cancellable,
+    const SuperscalarScheduler::Schedule& schedule
+){
+    //  Send the whole schedule in one write. The pipeline will send early if
+    //  the command queue fills up.
+    try{
+        ControllerWithScheduler::execute_schedule(cancellable, schedule);
+    }catch (...){
+        m_pipeline.flush();
+        throw;
+    }
+    m_pipeline.flush();
 }
 
 void ProController_SysbotBase3::execute_state(
@@ -183,9 +127,6 @@ void ProController_SysbotBase3::execute_state(
     if (cancellable){
         cancellable->throw_if_cancelled();
     }
-    if (m_stopping){
-        throw InvalidConnectionStateException("");
-    }
 
     SwitchControllerState controller_state;
     for (auto& item : entry.state){
@@ -248,51 +189,20 @@ void ProController_SysbotBase3::execute_state(
         right_y = JoystickTools::linear_float_to_s16(fy);
     }
 
-    std::string message;
-    if (m_pending_replace){
-        m_pending_replace = false;
-        m_next_expected_seqnum_ack = m_next_seqnum;
-        message += "cqReplaceOnNext\r\n";
-    }
-
-    //  Wait until there is space.
-    std::unique_lock<Mutex> lg(m_state_lock);
-    m_cv.wait(lg, [this, cancellable]{
-        if (cancellable && cancellable->cancelled()){
-            return true;
-        }
-        return m_stopping || m_next_seqnum - m_next_expected_seqnum_ack < QUEUE_SIZE;
-    });
-
-    if (cancellable){
-        cancellable->throw_if_cancelled();
-    }
-
-    Sysbotbase3_ControllerCommand command;
-    command.milliseconds = std::chrono::duration_cast<Milliseconds>(entry.duration).count();
-    command.seqnum = m_next_seqnum++;
-    command.state.buttons = nx_button;
-    command.state.left_joystick_x = left_x;
-    command.state.left_joystick_y = left_y;
-    command.state.right_joystick_x = right_x;
-    command.state.right_joystick_y = right_y;
-
-    {
-        std::string command_message;
-        command_message.resize(64);
-        command.write_to_hex(command_message.data());
-        message += "cqControllerState " + command_message + "\r\n";
-    }
-
-    m_connection.write_data(message);
+    Sysbotbase3_ControllerState state;
+    state.buttons = nx_button;
+    state.left_joystick_x = left_x;
+    state.left_joystick_y = left_y;
+    state.right_joystick_x = right_x;
+    state.right_joystick_y = right_y;
 
     //  Do not log the contents of the command due to privacy concerns.
     //  (people entering passwords)
-#if 0
-    if (LOG_EVERYTHING()){
-        m_logger.log("sys-botbase3: " + message);
-    }
-#endif
+    m_pipeline.push(
+        cancellable,
+        std::chrono::duration_cast<Milliseconds>(entry.duration),
+        state
+    );
 }
 
 
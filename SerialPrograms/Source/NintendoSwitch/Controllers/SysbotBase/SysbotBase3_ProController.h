@@ -8,12 +8,12 @@
 #ifndef PokemonAutomation_NintendoSwitch_ProController_SysbotBase3_H
 #define PokemonAutomation_NintendoSwitch_ProController_SysbotBase3_H
 
-#include "Common/Cpp/Concurrency/ConditionVariable.h"
 #include "NintendoSwitch/NintendoSwitch_Settings.h"
 //#include "NintendoSwitch/Controllers/NintendoSwitch_VirtualControllerState.h"
 #include "NintendoSwitch/Controllers/Procon/NintendoSwitch_ProController.h"
 #include "NintendoSwitch/Controllers/NintendoSwitch_ControllerWithScheduler.h"
 #include "SysbotBase_Connection.h"
+#include "SysbotBase3_CommandPipeline.h"
 
 namespace PokemonAutomation{
 namespace NintendoSwitch{
@@ -214,22 +214,20 @@ public:
 
 
 private:
-    virtual void on_message(const std::string& message) override;
+    virtual void on_message(const std::string& message, WallClock timestamp) override;
     virtual void execute_state(
         Cancellable* cancellable,
         const SuperscalarScheduler::ScheduleEntry& entry
     ) override;
+    virtual void execute_schedule(
+        Cancellable* cancellable,
+        const SuperscalarScheduler::Schedule& schedule
+    ) override;
 
 
 private:
     SysbotBase::TcpSysbotBase_Connection& m_connection;
-
-    bool m_stopping;
-    bool m_pending_replace;
-    uint64_t m_next_seqnum;
-    uint64_t m_next_expected_seqnum_ack;
-
-    ConditionVariable m_cv;
+    Sysbotbase3_CommandPipeline m_pipeline;
 };
 
 
@@ -198,7 +198,7 @@ void TcpSysbotBase_Connection::process_message(const std::string& message, WallC
         m_logger.log("Received: " + message, COLOR_DARKGREEN);
     }
 
-    m_listeners.run_method(&Listener::on_message, message);
+    m_listeners.run_method(&Listener::on_message, message, timestamp);
 
     //  Version #
     std::string str = message;
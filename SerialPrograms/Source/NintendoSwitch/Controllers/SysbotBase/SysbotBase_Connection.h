@@ -25,7 +25,8 @@ namespace SysbotBase{
 class TcpSysbotBase_Connection : public ControllerConnection, private ClientSocket::Listener{
 public:
     struct Listener{
-        virtual void on_message(const std::string& message) = 0;
+        //  "timestamp" is when the message was received.
+        virtual void on_message(const std::string& message, WallClock timestamp) = 0;
     };
 
     void add_listener(Listener& listener){
@@ -13,6 +13,7 @@
 #include <set>
 #include <mutex>
 #include <fstream>
+#include <filesystem>
 #include <condition_variable>
 #include <QImage>
 #include <QDir>
@@ -114,6 +115,17 @@
 #include "PokemonSV/Inference/PokemonSV_StatHexagonReader.h"
 #include "PokemonBDSP/Inference/ShinyDetection/PokemonBDSP_ShinySparkleSet.h"
 #include "PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedCalc.h"
+#include "PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedIndex.h"
+#include "PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_MatchupTables.h"
+#include "CommonFramework/ProgramStats/StatsDatabase.h"
+#include "CommonFramework/Tests/Json_Tests.h"
+#include "CommonFramework/Tools/ImageEncoder.h"
+#include "ML/Models/ML_YOLOv5Model.h"
+#include "ML/DataLabeling/ML_SegmentAnythingEmbeddingJob.h"
+#include "CommonTools/OCR/OCR_Tests.h"
+#include "CommonFramework/ImageTools/ImageSignature.h"
+#include "CommonTools/TrendInference/SlidingWindowStats.h"
+#include "NintendoSwitch/Controllers/SysbotBase/SysbotBase3_CommandPipeline.h"
 #include "PokemonSV/Inference/Battles/PokemonSV_BattleBallReader.h"
 #include "Common/Cpp/Containers/CircularBuffer.h"
 #include "Common/Cpp/Sockets/ClientSocket.h"
@@ -144,6 +156,9 @@
 #include "Common/PABotBase2/ReliableConnectionLayer/PABotBase2CC_ReliableStreamConnection.h"
 #include "Common/PABotBase2/ReliableConnectionLayer/PABotBase2FW_ReliableStreamConnection.h"
 #include "Common/Cpp/StreamConnections/MockDevice.h"
+#include "Common/PABotBase2/PABotBase2FW_CommandBatch.h"
+#include "Common/PABotBase2/Controllers/PABotBase2_Controller_NS1_OemController.h"
+#include "Controllers/PABotBase2/PABotBase2_DeviceHandle.h"
 #include "CommonTools/Random.h"
 #include "CommonTools/OCR/OCR_TextMatcher.h"
 #include "Integrations/PybindSwitchController.h"
@@ -366,6 +381,258 @@ void stress_test(Logger& logger, CancellableScope& scope){
 }
 
 
+
+//  Device side of the command queue. Finishes every command as soon as it
+//  arrives so that only the messaging overhead is measured.
+class MockCommandQueueDevice{
+public:
+    void run(ReliableStreamConnectionPolling& connection){
+        using namespace PABotBase2;
+
+        uint8_t buffer[256];
+        while (size_t bytes = connection.reliable_recv(buffer, sizeof(buffer))){
+            m_buffer.insert(m_buffer.end(), buffer, buffer + bytes);
+        }
+
+        while (m_buffer.size() >= sizeof(MessageHeader)){
+            const MessageHeader* header = (const MessageHeader*)m_buffer.data();
+            if (m_buffer.size() < header->message_bytes){
+                break;
+            }
+            switch (header->opcode){
+            case PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS:
+                states.fetch_add(1, std::memory_order_relaxed);
+                m_finished.emplace_back(header->id);
+                break;
+            case PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH:{
+                CommandBatchCursor<Message_Command_NS1_OemController_ButtonsEntry> cursor;
+                cursor.reset(header);
+                while (!cursor.done()){
+                    states.fetch_add(1, std::memory_order_relaxed);
+                    cursor.advance();
+                }
+                m_finished.emplace_back(header->id);
+                break;
+            }
+            }
+            m_buffer.erase(m_buffer.begin(), m_buffer.begin() + header->message_bytes);
+        }
+
+        while (!m_finished.empty()){
+            Message_u32 message;
+            message.message_bytes = sizeof(message);
+            message.opcode = PABB2_MESSAGE_OPCODE_CQ_COMMAND_FINISHED;
+            message.id = m_finished.front();
+            message.data = 0;
+            if (!connection.reliable_send_all_or_nothing(&message, sizeof(message))){
+                break;
+            }
+            m_finished.pop_front();
+        }
+    }
+
+    std::atomic<uint64_t> states{0};
+
+private:
+    std::vector<uint8_t> m_buffer;
+    std::deque<uint8_t> m_finished;
+};
+
+//  Compare controller states/second sent one per command vs. batched.
+void command_throughput_test(Logger& logger, CancellableScope& scope){
+    using namespace std::chrono_literals;
+    using namespace PABotBase2;
+
+    MockDevice device(GlobalThreadPools::unlimited_normal());
+    MockCommandQueueDevice mock_queue;
+    device.set_device_handler([&](ReliableStreamConnectionPolling& connection){
+        mock_queue.run(connection);
+    });
+
+    ReliableStreamConnection connection(
+        &scope,
+        logger, false,
+        GlobalThreadPools::unlimited_realtime(),
+        device.host_side_connection(),
+        100ms,
+        &device.print_lock()
+    );
+
+    connection.reset();
+    connection.send_request(PABB2_CONNECTION_OPCODE_ASK_VERSION);
+    connection.wait_for_pending();
+    connection.send_request(PABB2_CONNECTION_OPCODE_ASK_PACKET_SIZE);
+    connection.wait_for_pending();
+    connection.send_request(PABB2_CONNECTION_OPCODE_ASK_BUFFER_SLOTS);
+    connection.wait_for_pending();
+
+    DeviceHandle handle(&scope, logger, connection);
+    CommandQueueManager& queue = handle.command_queue();
+
+    const size_t STATES = 20000;
+
+    auto report = [&](const char* label, WallClock start){
+        double seconds = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / 1000000.;
+        logger.log(
+            std::string(label) + ": " + tostr_fixed(STATES / seconds, 0) + " states/s" +
+            " (device received " + std::to_string(mock_queue.states.exchange(0)) + ")"
+        );
+    };
+
+    {
+        Message_Command_NS1_OemController_Buttons request;
+        memset(&request, 0, sizeof(request));
+        request.message_bytes = sizeof(request);
+        request.opcode = PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS;
+        request.milliseconds = 8;
+
+        WallClock start = current_time();
+        for (size_t c = 0; c < STATES; c++){
+            queue.send_command(&scope, request);
+        }
+        queue.wait_for_all(&scope);
+        report("One state per command", start);
+    }
+    {
+        Message_Command_NS1_OemController_ButtonsEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.milliseconds = 8;
+
+        WallClock start = current_time();
+        for (size_t c = 0; c < STATES; c++){
+            queue.send_batched_command(
+                &scope,
+                PABB2_MESSAGE_CMD_NS1_OEM_CONTROLLER_BUTTONS_BATCH,
+                &entry, sizeof(entry)
+            );
+        }
+        queue.wait_for_all(&scope);
+        report("Batched", start);
+    }
+}
+
+
+
+//  Item printer seeds/second, single thread and across the compute pool.
+void item_printer_seed_index_benchmark(Logger& logger, CancellableScope& scope){
+    using namespace NintendoSwitch::PokemonSV::ItemPrinter;
+
+    ThreadPool& pool = GlobalThreadPools::computation_normal();
+
+    const int64_t SINGLE_SEEDS = 1000000;
+    const int64_t PARALLEL_SEEDS = 32000000;
+
+    ItemPrinterSeedIndexParameters parameters;
+    parameters.first_seed = 1700000000;
+    parameters.last_seed = parameters.first_seed + PARALLEL_SEEDS - 1;
+
+    //  Load the prize tables.
+    calculate_prize_ids(0, PrintMode::Regular);
+    calculate_prize_ids(0, PrintMode::BallBonus);
+
+    WallClock start = current_time();
+    for (int64_t seed = parameters.first_seed; seed < parameters.first_seed + SINGLE_SEEDS; seed++){
+        calculate_prize_ids(seed, PrintMode::Regular, parameters.jobs);
+        calculate_prize_ids(seed, PrintMode::ItemBonus, parameters.jobs);
+        calculate_prize_ids(seed, PrintMode::BallBonus, parameters.jobs);
+    }
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / 1000000.;
+    logger.log("Single thread: " + tostr_fixed(SINGLE_SEEDS / seconds, 0) + " seeds/s");
+
+    start = current_time();
+    ItemPrinterSeedIndex index = ItemPrinterSeedIndex::build(pool, parameters, &scope);
+    seconds = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / 1000000.;
+    logger.log(
+        "Index build: " + tostr_fixed(PARALLEL_SEEDS / seconds, 0) + " seeds/s, " +
+        tostr_fixed(PARALLEL_SEEDS / seconds / pool.max_threads(), 0) + " seeds/s per core"
+    );
+
+    //  Scale up to the full range of the Switch clock.
+    double full = (double)(ItemPrinterSeedIndexParameters().last_seed - ItemPrinterSeedIndexParameters().first_seed + 1);
+    logger.log(
+        "Keys: " + std::to_string(index.keys()) +
+        ", Postings: " + std::to_string(index.postings()) +
+        ", Full calendar: ~" + tostr_fixed(index.postings() * (full / PARALLEL_SEEDS) * sizeof(uint32_t) / 1000000, 0) + " MB, ~" +
+        tostr_fixed(full / (PARALLEL_SEEDS / seconds), 0) + " s"
+    );
+
+    uint16_t ability_patch = (uint16_t)item_slug_to_id("ability-patch");
+    start = current_time();
+    std::vector<ItemPrinterSeedHit> hits = index.best_seeds(PrintMode::ItemBonus, ability_patch, 1, 10);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count();
+    logger.log("Best 10 ability patch seeds: " + std::to_string(elapsed) + " us");
+    for (const ItemPrinterSeedHit& hit : hits){
+        logger.log("    " + std::to_string(hit.seed) + ": x" + std::to_string(hit.quantity));
+    }
+}
+
+
+
+//  Stats file update latency as the file grows. Rewriting the whole file
+//  (the old update) vs. appending to the journal.
+void stats_file_update_benchmark(Logger& logger){
+    namespace fs = std::filesystem;
+
+    class Stats : public StatsTracker{
+    public:
+        Stats(uint64_t resets){
+            m_display_order.emplace_back("Resets");
+            m_display_order.emplace_back("Shinies");
+            m_stats["Resets"] = resets;
+            m_stats["Shinies"] = resets / 8192;
+        }
+    };
+
+    const size_t UPDATES = 200;
+
+    fs::path base = fs::temp_directory_path() / "PokemonAutomation-StatsBenchmark";
+    fs::create_directories(base);
+    const std::string rewrite_path = (base / "Rewrite.txt").string();
+    const std::string journal_path = (base / "Journal.txt").string();
+
+    for (size_t lines : {1000, 10000, 100000}){
+        fs::remove(rewrite_path);
+        fs::remove(journal_path);
+        fs::remove(journal_path + ".journal");
+        {
+            StatSet set;
+            for (size_t c = 0; c < lines; c++){
+                Stats stats(c);
+                set["Program-" + std::to_string(c % 20)] += stats;
+            }
+            set.save_to_file(rewrite_path);
+            set.save_to_file(journal_path);
+        }
+
+        WallClock start = current_time();
+        for (size_t c = 0; c < UPDATES; c++){
+            Stats stats(c);
+            StatSet set;
+            set.open_from_file(rewrite_path);
+            set["Program-0"] += stats;
+            set.save_to_file(rewrite_path);
+        }
+        double rewrite = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)UPDATES;
+
+        start = current_time();
+        for (size_t c = 0; c < UPDATES; c++){
+            Stats stats(c);
+            StatSet::update_file(journal_path, "Program-0", stats);
+        }
+        double journal = std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count() / (double)UPDATES;
+
+        logger.log(
+            std::to_string(lines) + " lines (" + tostr_bytes(fs::file_size(rewrite_path)) + "): " +
+            "rewrite = " + tostr_fixed(rewrite, 1) + " us, journal = " + tostr_fixed(journal, 1) + " us"
+        );
+    }
+
+    std::error_code ec;
+    fs::remove_all(base, ec);
+}
+
+
+
 std::mutex print_lock;
 
 
@@ -476,6 +743,54 @@ void TestProgramComputer::program(ProgramEnvironment& env, CancellableScope& sco
     stress_test(logger, scope);
 #endif
 
+#if 0
+    command_throughput_test(logger, scope);
+#endif
+
+#if 0
+    item_printer_seed_index_benchmark(logger, scope);
+#endif
+
+#if 0
+    NintendoSwitch::PokemonSwSh::MaxLairInternal::benchmark_MaxLairMatchupTables(logger, 100);
+#endif
+
+#if 0
+    stats_file_update_benchmark(logger);
+#endif
+
+#if 0
+    CommonFramework::benchmark_JsonLoad(logger, 10);
+#endif
+
+#if 0
+    benchmark_ImageEncoder(logger, 20);
+#endif
+
+#if 0
+    ML::benchmark_YOLOv5Session(logger, RESOURCE_PATH() + "PokemonSV/YOLO/A0-lab.onnx", 100);
+#endif
+
+#if 0
+    ML::benchmark_SAMEmbeddingJob(logger, RESOURCE_PATH() + "ML/sam_embedder_cpu.onnx", "DataSets/SAM", 32);
+#endif
+
+#if 0
+    OCR::benchmark_TesseractPool(logger, 4, 20);
+#endif
+
+#if 0
+    ImageMatch::benchmark_ImageSignature(logger, 200);
+#endif
+
+#if 0
+    benchmark_SlidingWindowStats(logger, 1000000);
+#endif
+
+#if 0
+    benchmark_SysbotBase3CommandPipeline(logger, 500);
+#endif
+
 
 
 #if 0
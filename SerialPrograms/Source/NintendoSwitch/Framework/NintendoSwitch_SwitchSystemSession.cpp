@@ -31,6 +31,7 @@ bool SwitchSystemSession::try_shutdown(){
     m_audio.remove_state_listener(m_history);
 
     ProgramTracker::instance().remove_console(m_console_id);
+    m_overlay.remove_stat(m_history);
     m_overlay.remove_stat(*m_main_thread_utilization);
     m_overlay.remove_stat(*m_cpu_utilization);
     m_overlay.remove_stat(m_memory_usage->m_process);
@@ -69,6 +70,7 @@ SwitchSystemSession::SwitchSystemSession(
     m_overlay.add_stat(m_memory_usage->m_process);
     m_overlay.add_stat(*m_cpu_utilization);
     m_overlay.add_stat(*m_main_thread_utilization);
+    m_overlay.add_stat(m_history);
 
     m_history.start(m_audio.input_format(), m_video.current_source() != nullptr);
 
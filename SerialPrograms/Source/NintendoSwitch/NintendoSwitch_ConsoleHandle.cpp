@@ -22,6 +22,7 @@ namespace NintendoSwitch{
 
 //ConsoleHandle::ConsoleHandle(ConsoleHandle&& x) = default;
 ConsoleHandle::~ConsoleHandle(){
+    overlay().remove_stat(*m_inference_placement);
     overlay().remove_stat(*m_thread_utilization);
     overlay().remove_stat(*m_normal_inference_utilization);
     overlay().remove_stat(*m_realtime_inference_utilization);
@@ -58,10 +59,17 @@ ConsoleHandle::ConsoleHandle(
             "Program Thread:"
         )
     )
+    , m_inference_placement(
+        new ThreadPlacementStat(
+            ThreadAffinityGroup::console(index),
+            "Inference Cores:"
+        )
+    )
 {
     overlay.add_stat(*m_realtime_inference_utilization);
     overlay.add_stat(*m_normal_inference_utilization);
     overlay.add_stat(*m_thread_utilization);
+    overlay.add_stat(*m_inference_placement);
 }
 
 
@@ -16,6 +16,7 @@ namespace PokemonAutomation{
     class ThreadHandle;
     class ThreadUtilizationStat;
     class ThreadPoolUtilizationStat;
+    class ThreadPlacementStat;
 namespace NintendoSwitch{
 
 class ConsoleHandle : public VideoStream{
@@ -64,6 +65,7 @@ private:
     std::unique_ptr<ThreadPoolUtilizationStat> m_realtime_inference_utilization;
     std::unique_ptr<ThreadPoolUtilizationStat> m_normal_inference_utilization;
     std::unique_ptr<ThreadUtilizationStat> m_thread_utilization;
+    std::unique_ptr<ThreadPlacementStat> m_inference_placement;
 };
 
 
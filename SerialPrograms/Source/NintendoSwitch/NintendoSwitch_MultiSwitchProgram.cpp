@@ -31,7 +31,7 @@ MultiSwitchProgramEnvironment::MultiSwitchProgramEnvironment(
     , consoles(std::move(p_switches))
 {
     for (ConsoleHandle& console : consoles){
-        console.initialize_inference_threads(scope);
+        console.initialize_inference_threads(scope, ThreadAffinityGroup::console(console.index()));
     }
 }
 
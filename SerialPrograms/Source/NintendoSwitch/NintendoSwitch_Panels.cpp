@@ -24,6 +24,7 @@
 
 #include "DevPrograms/BoxDraw.h"
 #include "Programs/NintendoSwitch_SnapshotDumper.h"
+#include "Programs/NintendoSwitch_InputLatencyCalibrator.h"
 
 #include "Programs/NintendoSwitch_MenuStabilityTester.h"
 #include "DevPrograms/TestProgramComputer.h"
@@ -75,6 +76,7 @@ std::vector<PanelEntry> PanelListFactory::make_panels() const{
     ret.emplace_back("---- Testing ----");
     ret.emplace_back(make_single_switch_program<BoxDraw_Descriptor, BoxDraw>());
     ret.emplace_back(make_single_switch_program<SnapshotDumper_Descriptor, SnapshotDumper>());
+    ret.emplace_back(make_single_switch_program<InputLatencyCalibrator_Descriptor, InputLatencyCalibrator>());
 
     if (STATIC_GLOBALS.DEVELOPER_MODE){
         ret.emplace_back("---- Developer Tools ----");
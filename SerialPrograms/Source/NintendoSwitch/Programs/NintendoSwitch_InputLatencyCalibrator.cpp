@@ -0,0 +1,254 @@
+/*  Input Latency Calibrator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "CommonFramework/Exceptions/OperationFailedException.h"
+#include "CommonFramework/ProgramStats/StatsTracking.h"
+#include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "CommonFramework/VideoPipeline/VideoSession.h"
+#include "CommonTools/InferenceCallbacks/ChangeGatedInferenceCallback.h"
+#include "Controllers/ControllerTypeStrings.h"
+#include "NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.h"
+#include "NintendoSwitch/Inference/NintendoSwitch_HomeMenuDetector.h"
+#include "NintendoSwitch/Programs/NintendoSwitch_GameEntry.h"
+#include "NintendoSwitch_InputLatencyCalibrator.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+InputLatencyCalibrator_Descriptor::InputLatencyCalibrator_Descriptor()
+    : SingleSwitchProgramDescriptor(
+        "NintendoSwitch:InputLatencyCalibrator",
+        "Nintendo Switch", "Input Latency Calibrator",
+        "",
+        "Measure the delay from a button press to the first video frame that shows it.",
+        ProgramControllerClass::StandardController_NoRestrictions,
+        FeedbackType::REQUIRED,
+        AllowCommandsWhenRunning::DISABLE_COMMANDS
+    )
+{}
+
+struct InputLatencyCalibrator_Descriptor::Stats : public StatsTracker{
+public:
+    Stats()
+        : trials(m_stats["Trials"])
+        , failed(m_stats["Failed"])
+    {
+        m_display_order.emplace_back("Trials");
+        m_display_order.emplace_back("Failed", HIDDEN_IF_ZERO);
+    }
+
+public:
+    std::atomic<uint64_t>& trials;
+    std::atomic<uint64_t>& failed;
+};
+std::unique_ptr<StatsTracker> InputLatencyCalibrator_Descriptor::make_stats() const{
+    return std::unique_ptr<StatsTracker>(new Stats());
+}
+
+
+
+InputLatencyCalibrator::InputLatencyCalibrator()
+    : TRIALS(
+        "<b>Trials:</b><br>How many times to open the Home menu.",
+        LockMode::LOCK_WHILE_RUNNING,
+        50, 1
+    )
+    , SETTLE_DELAY(
+        "<b>Settle Delay:</b><br>Wait this long after returning to the game before the next trial.",
+        LockMode::LOCK_WHILE_RUNNING,
+        "2000 ms"
+    )
+    , SAVE_RESULTS(
+        "<b>Save Results:</b><br>Save the measurements for this console, controller and capture card.",
+        LockMode::LOCK_WHILE_RUNNING,
+        true
+    )
+{
+    PA_ADD_OPTION(TRIALS);
+    PA_ADD_OPTION(SETTLE_DELAY);
+    PA_ADD_OPTION(SAVE_RESULTS);
+}
+
+
+
+std::string input_latency_key(ConsoleHandle& console){
+    std::string capture = "Unknown";
+    VideoSession* session = dynamic_cast<VideoSession*>(&console.video());
+    if (session != nullptr){
+        std::shared_ptr<const VideoSourceDescriptor> descriptor = session->descriptor();
+        if (descriptor){
+            capture = descriptor->display_name();
+        }
+    }
+
+    AbstractController& controller = console.controller();
+    return
+        ConsoleType_strings(console.state().console_type()) + " / " +
+        CONTROLLER_CLASS_STRINGS().get_string(controller.controller_class()) + " / " +
+        capture;
+}
+std::optional<InputLatencyHistogram> measured_input_latency(ConsoleHandle& console){
+    return InputLatencyDatabase::instance().get(input_latency_key(console));
+}
+
+
+
+namespace{
+
+//  Generous enough to ignore capture noise. Opening Home changes the whole
+//  screen.
+ChangeGateConfig make_signature_config(){
+    ChangeGateConfig config;
+    config.tolerance = 5.0;
+    return config;
+}
+
+//  Wait until the screen has stopped changing so that the first change after
+//  the button press can be attributed to it.
+void wait_for_static_screen(
+    ConsoleHandle& console, ProControllerContext& context,
+    BoxSignature& signature
+){
+    const std::chrono::milliseconds STABLE_TIME(500);
+    const WallClock deadline = current_time() + std::chrono::seconds(10);
+
+    VideoSnapshot snapshot = console.video().snapshot();
+    signature.store(snapshot);
+    WallClock stable_since = snapshot.timestamp;
+
+    while (true){
+        context.wait_for(std::chrono::milliseconds(10));
+        snapshot = console.video().snapshot();
+        if (!signature.matches(snapshot)){
+            signature.store(snapshot);
+            stable_since = snapshot.timestamp;
+        }else if (snapshot.timestamp - stable_since >= STABLE_TIME){
+            return;
+        }
+        if (current_time() > deadline){
+            throw UserSetupError(
+                console,
+                "The screen never stopped changing. "
+                "Start this program in a game on a screen that isn't animated."
+            );
+        }
+    }
+}
+
+struct TrialResult{
+    //  Press to the first frame that changed.
+    std::optional<std::chrono::microseconds> changed;
+    //  Press to the first frame with the Home menu.
+    std::optional<std::chrono::microseconds> detected;
+};
+
+TrialResult run_trial(
+    ConsoleHandle& console, ProControllerContext& context,
+    BoxSignature& signature
+){
+    const std::chrono::milliseconds TIMEOUT(2000);
+
+    TrialResult result;
+    HomeMenuDetector detector(console, COLOR_RED);
+
+    //  Start timing only once the queue is empty so the press goes out
+    //  immediately.
+    context.wait_for_all_requests();
+    WallClock issued = current_time();
+    pbf_press_button(context, BUTTON_HOME, 80ms, 0ms);
+
+    WallClock last_frame = WallClock::min();
+    while (current_time() - issued < TIMEOUT){
+        VideoSnapshot snapshot = console.video().snapshot();
+        if (!snapshot || snapshot.timestamp == last_frame){
+            context.wait_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        last_frame = snapshot.timestamp;
+
+        //  Captured before the press was sent.
+        if (snapshot.timestamp < issued){
+            continue;
+        }
+
+        std::chrono::microseconds latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(snapshot.timestamp - issued);
+
+        if (!result.changed && !signature.matches(snapshot)){
+            result.changed = latency;
+        }
+        if (detector.detect_only(snapshot)){
+            result.detected = latency;
+            break;
+        }
+    }
+
+    context.wait_for_all_requests();
+    return result;
+}
+
+}
+
+
+
+void InputLatencyCalibrator::program(SingleSwitchProgramEnvironment& env, ProControllerContext& context){
+    InputLatencyCalibrator_Descriptor::Stats& stats = env.current_stats<InputLatencyCalibrator_Descriptor::Stats>();
+    ConsoleHandle& console = env.console;
+
+    std::string key = input_latency_key(console);
+    env.log("Calibrating: " + key);
+
+    BoxSignature signature(make_signature_config());
+    InputLatencyHistogram changed;
+    InputLatencyHistogram detected;
+
+    for (uint16_t c = 0; c < TRIALS; c++){
+        wait_for_static_screen(console, context, signature);
+
+        TrialResult result = run_trial(console, context, signature);
+        stats.trials++;
+
+        if (result.changed && result.detected){
+            changed.add(*result.changed);
+            detected.add(*result.detected);
+            env.log(
+                "Trial " + std::to_string(c + 1) +
+                ": Frame changed after " + std::to_string(result.changed->count() / 1000) +
+                " ms. Home detected after " + std::to_string(result.detected->count() / 1000) + " ms."
+            );
+        }else{
+            stats.failed++;
+            env.log("Trial " + std::to_string(c + 1) + ": Home menu was not detected.", COLOR_RED);
+            if (stats.failed.load() > (uint64_t)TRIALS / 2 + 1){
+                OperationFailedException::fire(
+                    ErrorReport::NO_ERROR_REPORT,
+                    "Unable to detect the Home menu after pressing Home.",
+                    console
+                );
+            }
+            go_home(console, context);
+        }
+        env.update_stats();
+
+        resume_game_from_home(console, context);
+        context.wait_for(SETTLE_DELAY);
+    }
+
+    env.log("Press to first changed frame:\n" + changed.dump(std::chrono::milliseconds(8)), COLOR_BLUE);
+    env.log("Press to Home menu detected:\n" + detected.dump(std::chrono::milliseconds(8)), COLOR_BLUE);
+
+    if (SAVE_RESULTS && !changed.empty()){
+        InputLatencyDatabase::instance().set(key, std::move(changed));
+        env.log("Saved input latency for: " + key);
+    }
+}
+
+
+
+}
+}
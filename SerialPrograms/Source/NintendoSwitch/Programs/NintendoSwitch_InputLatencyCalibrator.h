@@ -0,0 +1,59 @@
+/*  Input Latency Calibrator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Measure how long it takes from pressing a button to the first captured
+ *  frame that shows the result. The result is saved per console, controller
+ *  and capture card so programs can look it up with measured_input_latency().
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_InputLatencyCalibrator_H
+#define PokemonAutomation_NintendoSwitch_InputLatencyCalibrator_H
+
+#include <optional>
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
+#include "Common/Cpp/Options/TimeDurationOption.h"
+#include "CommonFramework/Tools/InputLatencyDatabase.h"
+#include "NintendoSwitch/NintendoSwitch_SingleSwitchProgram.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+class InputLatencyCalibrator_Descriptor : public SingleSwitchProgramDescriptor{
+public:
+    InputLatencyCalibrator_Descriptor();
+
+    struct Stats;
+    virtual std::unique_ptr<StatsTracker> make_stats() const override;
+};
+
+
+
+class InputLatencyCalibrator : public SingleSwitchProgramInstance{
+public:
+    InputLatencyCalibrator();
+
+    virtual void program(SingleSwitchProgramEnvironment& env, ProControllerContext& context) override;
+
+private:
+    SimpleIntegerOption<uint16_t> TRIALS;
+    MillisecondsOption SETTLE_DELAY;
+    BooleanCheckBoxOption SAVE_RESULTS;
+};
+
+
+
+//  "<console type> / <controller> / <capture source>"
+std::string input_latency_key(ConsoleHandle& console);
+
+//  The last calibration for this console setup. Null if it was never run.
+std::optional<InputLatencyHistogram> measured_input_latency(ConsoleHandle& console);
+
+
+
+}
+}
+#endif
@@ -4,7 +4,6 @@
  *
  */
 
-#include <thread>
 #include "CommonFramework/Tools/ProgramEnvironment.h"
 #include "CommonTools/OCR/OCR_TrainingTools.h"
 #include "Pokemon/Pokemon_Strings.h"
@@ -34,15 +33,9 @@ TrainIVCheckerOCR::TrainIVCheckerOCR()
         "IVCheckerOCR/",
         "IVCheckerOCR/"
     )
-    , THREADS(
-        "<b>Worker Threads:</b>",
-        LockMode::LOCK_WHILE_RUNNING,
-        std::thread::hardware_concurrency()
-    )
 {
     PA_ADD_OPTION(DIRECTORY);
     PA_ADD_OPTION(MODE);
-    PA_ADD_OPTION(THREADS);
 }
 
 
@@ -52,7 +45,7 @@ void TrainIVCheckerOCR::program(ProgramEnvironment& env, CancellableScope& scope
     session.generate_small_dictionary(
         "Pokemon/IVCheckerOCR.json",
         "IVCheckerOCR.json",
-        MODE == TrainOCRMode::INCREMENTAL, THREADS,
+        MODE == TrainOCRMode::INCREMENTAL,
         OCR::BLACK_TEXT_FILTERS(),
         IvJudgeReader::MAX_LOG10P,
         IvJudgeReader::MAX_LOG10P_SPREAD
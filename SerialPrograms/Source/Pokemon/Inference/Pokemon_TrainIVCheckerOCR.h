@@ -7,7 +7,6 @@
 #ifndef PokemonAutomation_PokemonSwSh_TrainIVCheckerOCR_H
 #define PokemonAutomation_PokemonSwSh_TrainIVCheckerOCR_H
 
-#include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Options/StringOption.h"
 #include "CommonTools/Options/TrainOCRModeOption.h"
 #include "ComputerPrograms/ComputerProgram.h"
@@ -32,7 +31,6 @@ public:
 private:
     StringOption DIRECTORY;
     TrainOCRModeOption MODE;
-    SimpleIntegerOption<uint32_t> THREADS;  //  Can't use "size_t" due to integer type ambiguity.
 
 };
 
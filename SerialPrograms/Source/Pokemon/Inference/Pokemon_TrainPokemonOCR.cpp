@@ -4,7 +4,6 @@
  *
  */
 
-#include <thread>
 #include "Common/Cpp/Json/JsonArray.h"
 #include "Common/Cpp/Json/JsonObject.h"
 #include "CommonFramework/Tools/ProgramEnvironment.h"
@@ -38,15 +37,9 @@ TrainPokemonOCR::TrainPokemonOCR()
         "PokemonNameOCR/",
         "PokemonNameOCR/"
     )
-    , THREADS(
-        "<b>Worker Threads:</b>",
-        LockMode::LOCK_WHILE_RUNNING,
-        std::thread::hardware_concurrency()
-    )
 {
     PA_ADD_OPTION(DIRECTORY);
     PA_ADD_OPTION(MODE);
-    PA_ADD_OPTION(THREADS);
 }
 
 
@@ -73,7 +66,6 @@ void TrainPokemonOCR::program(ProgramEnvironment& env, CancellableScope& scope){
         "Pokemon/PokemonNameOCR/",
         "PokemonOCR-",
         MODE == TrainOCRMode::INCREMENTAL,
-        THREADS,
         OCR::BLACK_OR_WHITE_TEXT_FILTERS(),
         PokemonNameReader::MAX_LOG10P + 1.0,
         PokemonNameReader::MAX_LOG10P_SPREAD
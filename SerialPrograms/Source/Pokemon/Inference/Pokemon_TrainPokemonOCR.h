@@ -7,7 +7,6 @@
 #ifndef PokemonAutomation_Pokemon_TrainPokemonOCR_H
 #define PokemonAutomation_Pokemon_TrainPokemonOCR_H
 
-#include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Options/StringOption.h"
 #include "CommonTools/Options/TrainOCRModeOption.h"
 #include "ComputerPrograms/ComputerProgram.h"
@@ -32,7 +31,6 @@ public:
 private:
     StringOption DIRECTORY;
     TrainOCRModeOption MODE;
-    SimpleIntegerOption<uint32_t> THREADS;  //  Can't use "size_t" due to integer type ambiguity.
 
 };
 
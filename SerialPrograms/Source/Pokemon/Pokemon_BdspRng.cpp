@@ -5,10 +5,14 @@
  */
 
 #include <array>
+#include <atomic>
+#include <algorithm>
 #include <utility>
 #include "Common/Cpp/CancellableScope.h"
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "Pokemon_BdspRngScan.h"
 #include "Pokemon_BdspRng.h"
 
 namespace PokemonAutomation{
@@ -20,6 +24,13 @@ const size_t STATIC_SEARCH_WINDOW = 64;
 
 const uint64_t CANCEL_CHECK_INTERVAL = 65536;
 
+//  Below this many advances, scan on the calling thread only.
+const uint64_t PARALLEL_SCAN_THRESHOLD = (uint64_t)1 << 18;
+
+//  Each lane of the prefilter runs this many advances at a time. Between
+//  segments, the scanner checks for cancellation and early exit.
+const uint64_t SCAN_SEGMENT_STEPS = 4096;
+
 
 uint64_t bdsp_splitmix64(uint64_t seed){
     seed = 0xBF58476D1CE4E5B9 * (seed ^ (seed >> 30));
@@ -345,6 +356,65 @@ static bool iv_in_range(const IvRange& range, uint8_t iv){
 }
 
 
+bool BdspStaticFilter::matches(const BdspPokemonResult& result) const{
+    if ((uint8_t)result.shiny < (uint8_t)min_shiny){
+        return false;
+    }
+    if (!iv_in_range(ivs.hp, result.ivs.hp) ||
+        !iv_in_range(ivs.attack, result.ivs.attack) ||
+        !iv_in_range(ivs.defense, result.ivs.defense) ||
+        !iv_in_range(ivs.spatk, result.ivs.spatk) ||
+        !iv_in_range(ivs.spdef, result.ivs.spdef) ||
+        !iv_in_range(ivs.speed, result.ivs.speed)
+    ){
+        return false;
+    }
+    if (result.nature >= 32 || (natures & ((uint32_t)1 << result.nature)) == 0){
+        return false;
+    }
+    return (genders & (1 << (uint8_t)result.gender)) != 0;
+}
+
+
+//  Returns false if nothing can pass the filter.
+static bool make_prefilter(
+    BdspStaticPrefilter& prefilter,
+    const BdspStaticFilter& filter,
+    const BdspStaticTemplate& tmpl
+){
+    if (filter.min_shiny != BdspShiny::None){
+        if (tmpl.shiny_locked && !tmpl.roamer){
+            return false;
+        }
+        prefilter.shiny = filter.min_shiny == BdspShiny::Square ? 2 : 1;
+    }
+
+    const IvRange* ranges[6] = {
+        &filter.ivs.hp, &filter.ivs.attack, &filter.ivs.defense,
+        &filter.ivs.spatk, &filter.ivs.spdef, &filter.ivs.speed,
+    };
+    for (size_t c = 0; c < 6; c++){
+        int low = std::max<int>(ranges[c]->low, 0);
+        int high = ranges[c]->high < 0 ? 31 : std::min<int>(ranges[c]->high, 31);
+        if (low > high){
+            return false;
+        }
+        prefilter.iv_min[c] = (uint8_t)low;
+        prefilter.iv_max[c] = (uint8_t)high;
+        if (low > 0 || high < 31){
+            prefilter.check_ivs = true;
+        }
+    }
+
+    //  With guaranteed IVs, the IV rolls no longer sit at fixed offsets.
+    if (tmpl.guaranteed_ivs != 0){
+        prefilter.check_ivs = false;
+    }
+
+    return (filter.natures & ((1u << 25) - 1)) != 0 && (filter.genders & 0x07) != 0;
+}
+
+
 BdspStaticSearcher::BdspStaticSearcher(
     const Xorshift128State& base_state,
     BdspStaticTemplate tmpl,
@@ -419,6 +489,192 @@ std::vector<BdspRngHit> BdspStaticSearcher::scan(
 
 
 
+struct BdspStaticSearcher::ScanChunk{
+    uint64_t min_advances;
+    uint64_t max_advances;
+    const BdspStaticFilter* filter;
+    const BdspStaticPrefilter* prefilter;
+    bool stop_at_first;
+    Cancellable* cancellable;
+
+    //  Lowest advance with a hit in any chunk. Only used with "stop_at_first".
+    std::atomic<uint64_t>* first_hit;
+
+    std::vector<BdspRngHit> hits;
+
+    //  Returns true if everything from "advances" on can be skipped.
+    bool past_first_hit(uint64_t advances) const{
+        return stop_at_first && advances > first_hit->load(std::memory_order_relaxed);
+    }
+    //  Returns true if the chunk should stop.
+    bool add_hit(const BdspRngHit& hit){
+        hits.emplace_back(hit);
+        if (!stop_at_first){
+            return false;
+        }
+        uint64_t current = first_hit->load(std::memory_order_relaxed);
+        while (hit.advances < current && !first_hit->compare_exchange_weak(current, hit.advances));
+        return true;
+    }
+};
+
+void BdspStaticSearcher::scan_chunk(ScanChunk& chunk) const{
+    const BdspStaticFilter& filter = *chunk.filter;
+
+    Xorshift128 rng(m_base_state);
+    rng.advance(chunk.min_advances);
+
+    //  Nothing for the prefilter to reject. Generate every advance.
+    if (m_template.roamer || !chunk.prefilter->enabled()){
+        Xorshift128List<STATIC_SEARCH_WINDOW> list(rng);
+        for (uint64_t advances = chunk.min_advances; advances <= chunk.max_advances; advances++, list.advance_state()){
+            if ((advances % CANCEL_CHECK_INTERVAL) == 0){
+                if (chunk.cancellable != nullptr){
+                    chunk.cancellable->throw_if_cancelled();
+                }
+                if (chunk.past_first_hit(advances)){
+                    return;
+                }
+            }
+            BdspPokemonResult result = m_template.roamer
+                ? bdsp_generate_roamer(rng, m_template, m_tsv, m_synchronize_nature)
+                : generate_static_impl(WindowSource{list}, m_template, m_tsv, m_synchronize_nature);
+            if (filter.matches(result) && chunk.add_hit(BdspRngHit{advances, rng.state(), result})){
+                return;
+            }
+            rng.next();
+        }
+        return;
+    }
+
+    const size_t lanes = bdsp_static_prefilter_lanes();
+    const Gf2Matrix128 segment_jump = xorshift128_transition_power(SCAN_SEGMENT_STEPS);
+    Gf2Matrix128 tail_jump;
+
+    std::vector<Xorshift128State> states(lanes);
+    std::vector<BdspScanCandidate> candidates;
+    Xorshift128State base = rng.state();
+
+    uint64_t start = chunk.min_advances;
+    while (true){
+        if (chunk.cancellable != nullptr){
+            chunk.cancellable->throw_if_cancelled();
+        }
+        if (chunk.past_first_hit(start)){
+            return;
+        }
+
+        //  Lane L covers [start + L * stride, start + (L + 1) * stride).
+        //  The last segment is split evenly and may overshoot the end.
+        uint64_t remaining = chunk.max_advances - start + 1;
+        uint64_t stride = SCAN_SEGMENT_STEPS;
+        const Gf2Matrix128* jump = &segment_jump;
+        if (remaining < lanes * SCAN_SEGMENT_STEPS){
+            stride = (remaining + lanes - 1) / lanes;
+            tail_jump = xorshift128_transition_power(stride);
+            jump = &tail_jump;
+        }
+
+        Gf2Vec128 vector = xorshift128_state_to_vector(base);
+        states[0] = base;
+        for (size_t lane = 1; lane < lanes; lane++){
+            vector = *jump * vector;
+            states[lane] = xorshift128_state_from_vector(vector);
+        }
+
+        candidates.clear();
+        bdsp_static_prefilter(candidates, *chunk.prefilter, states.data(), start, stride, stride);
+        std::sort(
+            candidates.begin(), candidates.end(),
+            [](const BdspScanCandidate& x, const BdspScanCandidate& y){
+                return x.advances < y.advances;
+            }
+        );
+
+        for (const BdspScanCandidate& candidate : candidates){
+            if (candidate.advances > chunk.max_advances){
+                break;
+            }
+            BdspPokemonResult result = bdsp_generate_static(
+                Xorshift128(candidate.state), m_template, m_tsv, m_synchronize_nature
+            );
+            if (filter.matches(result) && chunk.add_hit(BdspRngHit{candidate.advances, candidate.state, result})){
+                return;
+            }
+        }
+
+        if (remaining <= lanes * stride){
+            return;
+        }
+
+        //  The last lane has ended where the next segment starts.
+        base = states[lanes - 1];
+        start += lanes * stride;
+    }
+}
+
+std::vector<BdspRngHit> BdspStaticSearcher::scan(
+    uint64_t min_advances, uint64_t max_advances,
+    const BdspStaticFilter& filter,
+    bool stop_at_first,
+    Cancellable* cancellable
+) const{
+    std::vector<BdspRngHit> hits;
+    if (min_advances > max_advances){
+        return hits;
+    }
+
+    BdspStaticPrefilter prefilter;
+    if (!make_prefilter(prefilter, filter, m_template)){
+        return hits;
+    }
+
+    std::atomic<uint64_t> first_hit(UINT64_MAX);
+
+    ThreadPool& pool = GlobalThreadPools::computation_normal();
+    uint64_t span = max_advances - min_advances;
+    uint64_t chunk_size = std::max<uint64_t>(
+        PARALLEL_SCAN_THRESHOLD,
+        span / (pool.max_threads() * 4) + 1
+    );
+
+    std::vector<ScanChunk> chunks;
+    for (uint64_t start = min_advances;;){
+        uint64_t end = max_advances - start < chunk_size ? max_advances : start + chunk_size - 1;
+        chunks.emplace_back(ScanChunk{
+            start, end,
+            &filter, &prefilter,
+            stop_at_first, cancellable,
+            &first_hit,
+            {}
+        });
+        if (end == max_advances){
+            break;
+        }
+        start = end + 1;
+    }
+
+    if (chunks.size() == 1){
+        scan_chunk(chunks[0]);
+    }else{
+        pool.run_in_parallel(
+            [&](size_t index){ scan_chunk(chunks[index]); },
+            0, chunks.size(), 1
+        );
+    }
+
+    for (ScanChunk& chunk : chunks){
+        if (stop_at_first && !chunk.hits.empty()){
+            hits.emplace_back(chunk.hits[0]);
+            return hits;
+        }
+        hits.insert(hits.end(), chunk.hits.begin(), chunk.hits.end());
+    }
+    return hits;
+}
+
+
+
 
 
 }
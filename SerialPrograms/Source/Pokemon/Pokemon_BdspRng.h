@@ -115,6 +115,27 @@ BdspPokemonResult bdsp_generate(
 );
 
 
+//  Search criteria for BdspStaticSearcher::scan().
+//  Unlike an arbitrary accept function, the scanner can look inside this to
+//  reject most advances without generating the full Pokemon.
+struct BdspStaticFilter{
+    //  Accept only results at least this shiny. Square counts as more shiny
+    //  than star.
+    BdspShiny min_shiny = BdspShiny::None;
+
+    //  -1 means unbounded.
+    IvRanges ivs;
+
+    //  Bit N set accepts game nature N. See bdsp_nature_name().
+    uint32_t natures = (1u << 25) - 1;
+
+    //  Bit N set accepts (BdspGender)N.
+    uint8_t genders = 0x07;
+
+    bool matches(const BdspPokemonResult& result) const;
+};
+
+
 struct BdspRngHit{
     uint64_t advances = 0;
     Xorshift128State state;
@@ -142,6 +163,21 @@ public:
         Cancellable* cancellable = nullptr
     ) const;
 
+    //  Same as above, but much faster on large ranges. Static encounters are
+    //  checked several advances at a time with SIMD, and ranges large enough
+    //  to be worth it are split across the computation thread pool.
+    //  Returns the same hits in the same order as the accept function version.
+    std::vector<BdspRngHit> scan(
+        uint64_t min_advances, uint64_t max_advances,
+        const BdspStaticFilter& filter,
+        bool stop_at_first = false,
+        Cancellable* cancellable = nullptr
+    ) const;
+
+private:
+    struct ScanChunk;
+    void scan_chunk(ScanChunk& chunk) const;
+
 private:
     Xorshift128State m_base_state;
     BdspStaticTemplate m_template;
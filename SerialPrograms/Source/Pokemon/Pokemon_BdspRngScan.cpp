@@ -0,0 +1,124 @@
+/*  BDSP RNG Scan
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Pokemon_BdspRngScan.h"
+
+namespace PokemonAutomation{
+namespace Pokemon{
+
+
+void bdsp_static_prefilter_x64_AVX2(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+);
+void bdsp_static_prefilter_x64_AVX512(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+);
+
+
+
+const size_t DEFAULT_LANES = 4;
+
+
+void bdsp_static_prefilter_Default(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+){
+    for (size_t lane = 0; lane < DEFAULT_LANES; lane++){
+        //  The next 9 outputs: EC, TID/SID, PID, then 6 IVs.
+        Xorshift128 rng(states[lane]);
+        uint32_t window[9];
+        for (uint32_t& x : window){
+            x = rng.next();
+        }
+
+        uint64_t advance = first_advance + lane * lane_stride;
+        for (uint64_t step = 0; step < steps; step++, advance++){
+            bool ok = true;
+            if (filter.shiny != 0){
+                uint32_t x = bdsp_gen_transform(window[1]) ^ bdsp_gen_transform(window[2]);
+                x = (x ^ (x >> 16)) & 0xffff;
+                ok = filter.shiny == 1 ? x < 16 : x == 0;
+            }
+            if (ok && filter.check_ivs){
+                for (size_t c = 0; c < 6; c++){
+                    uint32_t iv = bdsp_gen_transform(window[3 + c]) & 31;
+                    if (iv < filter.iv_min[c] || iv > filter.iv_max[c]){
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+            if (ok){
+                Xorshift128 state(window[0], window[1], window[2], window[3]);
+                state.rewind(4);
+                candidates.emplace_back(BdspScanCandidate{advance, state.state()});
+            }
+
+            for (size_t c = 0; c < 8; c++){
+                window[c] = window[c + 1];
+            }
+            window[8] = rng.next();
+        }
+
+        rng.rewind(9);
+        states[lane] = rng.state();
+    }
+}
+
+
+
+size_t bdsp_static_prefilter_lanes(){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        return 16;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        return 8;
+    }
+#endif
+    return DEFAULT_LANES;
+}
+
+void bdsp_static_prefilter(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        bdsp_static_prefilter_x64_AVX512(candidates, filter, states, first_advance, lane_stride, steps);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        bdsp_static_prefilter_x64_AVX2(candidates, filter, states, first_advance, lane_stride, steps);
+        return;
+    }
+#endif
+    bdsp_static_prefilter_Default(candidates, filter, states, first_advance, lane_stride, steps);
+}
+
+
+
+}
+}
@@ -0,0 +1,67 @@
+/*  BDSP RNG Scan
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Multi-lane prefilter used by BdspStaticSearcher::scan().
+ *
+ *  Each lane is an independent Xorshift128 that is stepped in lockstep with
+ *  the others. For every advance, a lane checks the parts of a static
+ *  encounter that sit at fixed offsets in the RNG stream: shiny and (if
+ *  there are no guaranteed IVs) the IVs. Advances that pass are reported as
+ *  candidates. They still need to be confirmed by generating the Pokemon.
+ *
+ */
+
+#ifndef PokemonAutomation_Pokemon_BdspRngScan_H
+#define PokemonAutomation_Pokemon_BdspRngScan_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "Pokemon_Xorshift128.h"
+
+namespace PokemonAutomation{
+namespace Pokemon{
+
+
+struct BdspStaticPrefilter{
+    //  0 = Don't check.
+    //  1 = Star or square.
+    //  2 = Square only.
+    uint8_t shiny = 0;
+
+    //  Only valid if the template has no guaranteed IVs.
+    bool check_ivs = false;
+    uint8_t iv_min[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t iv_max[6] = {31, 31, 31, 31, 31, 31};
+
+    bool enabled() const{ return shiny != 0 || check_ivs; }
+};
+
+struct BdspScanCandidate{
+    uint64_t advances;
+    Xorshift128State state;     //  The state at "advances".
+};
+
+
+//  Number of lanes used by bdsp_static_prefilter() on this CPU.
+size_t bdsp_static_prefilter_lanes();
+
+//  "states" has bdsp_static_prefilter_lanes() entries. Lane L starts at
+//  advance "first_advance + L * lane_stride" with "states[L]".
+//
+//  Check "steps" advances on every lane, appending the ones that pass to
+//  "candidates". On return, each entry of "states" has been moved forward
+//  by "steps" advances.
+void bdsp_static_prefilter(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+);
+
+
+}
+}
+#endif
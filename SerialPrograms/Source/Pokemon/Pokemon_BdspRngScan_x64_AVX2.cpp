@@ -0,0 +1,140 @@
+/*  BDSP RNG Scan (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Pokemon_BdspRngScan.h"
+
+namespace PokemonAutomation{
+namespace Pokemon{
+
+
+namespace{
+
+struct Xorshift128x8{
+    //  x_n = f(x_{n-4}) ^ g(x_{n-1})
+    static PA_FORCE_INLINE __m256i next(__m256i x4, __m256i x1){
+        __m256i t = _mm256_xor_si256(x4, _mm256_slli_epi32(x4, 11));
+        t = _mm256_xor_si256(t, _mm256_srli_epi32(t, 8));
+        t = _mm256_xor_si256(t, x1);
+        return _mm256_xor_si256(t, _mm256_srli_epi32(x1, 19));
+    }
+
+    //  bdsp_gen_transform()
+    static PA_FORCE_INLINE __m256i gen(__m256i raw){
+        __m256i wrap = _mm256_cmpeq_epi32(raw, _mm256_set1_epi32(-1));
+        raw = _mm256_add_epi32(raw, _mm256_set1_epi32((int32_t)0x80000000));
+        return _mm256_sub_epi32(raw, wrap);
+    }
+};
+
+}
+
+
+void bdsp_static_prefilter_x64_AVX2(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+){
+    const size_t LANES = 8;
+
+    alignas(32) uint32_t s[4][LANES];
+    for (size_t lane = 0; lane < LANES; lane++){
+        s[0][lane] = states[lane].s0;
+        s[1][lane] = states[lane].s1;
+        s[2][lane] = states[lane].s2;
+        s[3][lane] = states[lane].s3;
+    }
+
+    //  The next 9 outputs: EC, TID/SID, PID, then 6 IVs.
+    __m256i w[9];
+    {
+        __m256i s0 = _mm256_load_si256((const __m256i*)s[0]);
+        __m256i s1 = _mm256_load_si256((const __m256i*)s[1]);
+        __m256i s2 = _mm256_load_si256((const __m256i*)s[2]);
+        __m256i s3 = _mm256_load_si256((const __m256i*)s[3]);
+        w[0] = Xorshift128x8::next(s0, s3);
+        w[1] = Xorshift128x8::next(s1, w[0]);
+        w[2] = Xorshift128x8::next(s2, w[1]);
+        w[3] = Xorshift128x8::next(s3, w[2]);
+        for (size_t c = 4; c < 9; c++){
+            w[c] = Xorshift128x8::next(w[c - 4], w[c - 1]);
+        }
+    }
+
+    const __m256i SHINY_MASK = _mm256_set1_epi32(filter.shiny == 1 ? 0xfff0 : 0xffff);
+    const __m256i IV_MASK = _mm256_set1_epi32(31);
+    __m256i iv_min[6];
+    __m256i iv_max[6];
+    for (size_t c = 0; c < 6; c++){
+        iv_min[c] = _mm256_set1_epi32(filter.iv_min[c]);
+        iv_max[c] = _mm256_set1_epi32(filter.iv_max[c]);
+    }
+
+    alignas(32) uint32_t window[4][LANES];
+    for (uint64_t step = 0; step < steps; step++){
+        __m256i ok = _mm256_set1_epi32(-1);
+        if (filter.shiny != 0){
+            __m256i x = _mm256_xor_si256(Xorshift128x8::gen(w[1]), Xorshift128x8::gen(w[2]));
+            x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+            x = _mm256_and_si256(x, SHINY_MASK);
+            ok = _mm256_cmpeq_epi32(x, _mm256_setzero_si256());
+        }
+        if (filter.check_ivs){
+            for (size_t c = 0; c < 6; c++){
+                __m256i iv = _mm256_and_si256(Xorshift128x8::gen(w[3 + c]), IV_MASK);
+                __m256i bad = _mm256_or_si256(
+                    _mm256_cmpgt_epi32(iv_min[c], iv),
+                    _mm256_cmpgt_epi32(iv, iv_max[c])
+                );
+                ok = _mm256_andnot_si256(bad, ok);
+            }
+        }
+
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(ok));
+        if (mask != 0){
+            for (size_t c = 0; c < 4; c++){
+                _mm256_store_si256((__m256i*)window[c], w[c]);
+            }
+            for (size_t lane = 0; lane < LANES; lane++){
+                if ((mask & (1 << lane)) == 0){
+                    continue;
+                }
+                Xorshift128 state(window[0][lane], window[1][lane], window[2][lane], window[3][lane]);
+                state.rewind(4);
+                candidates.emplace_back(BdspScanCandidate{
+                    first_advance + lane * lane_stride + step, state.state()
+                });
+            }
+        }
+
+        __m256i next = Xorshift128x8::next(w[5], w[8]);
+        for (size_t c = 0; c < 8; c++){
+            w[c] = w[c + 1];
+        }
+        w[8] = next;
+    }
+
+    //  The generator is 9 outputs ahead of the window start.
+    for (size_t c = 0; c < 4; c++){
+        _mm256_store_si256((__m256i*)s[c], w[5 + c]);
+    }
+    for (size_t lane = 0; lane < LANES; lane++){
+        Xorshift128 rng(s[0][lane], s[1][lane], s[2][lane], s[3][lane]);
+        rng.rewind(9);
+        states[lane] = rng.state();
+    }
+}
+
+
+
+}
+}
+#endif
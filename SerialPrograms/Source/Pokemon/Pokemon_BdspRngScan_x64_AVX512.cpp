@@ -0,0 +1,134 @@
+/*  BDSP RNG Scan (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Pokemon_BdspRngScan.h"
+
+namespace PokemonAutomation{
+namespace Pokemon{
+
+
+namespace{
+
+struct Xorshift128x16{
+    //  x_n = f(x_{n-4}) ^ g(x_{n-1})
+    static PA_FORCE_INLINE __m512i next(__m512i x4, __m512i x1){
+        __m512i t = _mm512_xor_si512(x4, _mm512_slli_epi32(x4, 11));
+        t = _mm512_xor_si512(t, _mm512_srli_epi32(t, 8));
+        return _mm512_ternarylogic_epi32(t, x1, _mm512_srli_epi32(x1, 19), 0x96);
+    }
+
+    //  bdsp_gen_transform()
+    static PA_FORCE_INLINE __m512i gen(__m512i raw){
+        __mmask16 wrap = _mm512_cmpeq_epi32_mask(raw, _mm512_set1_epi32(-1));
+        raw = _mm512_add_epi32(raw, _mm512_set1_epi32((int32_t)0x80000000));
+        return _mm512_mask_add_epi32(raw, wrap, raw, _mm512_set1_epi32(1));
+    }
+};
+
+}
+
+
+void bdsp_static_prefilter_x64_AVX512(
+    std::vector<BdspScanCandidate>& candidates,
+    const BdspStaticPrefilter& filter,
+    Xorshift128State* states,
+    uint64_t first_advance, uint64_t lane_stride,
+    uint64_t steps
+){
+    const size_t LANES = 16;
+
+    alignas(64) uint32_t s[4][LANES];
+    for (size_t lane = 0; lane < LANES; lane++){
+        s[0][lane] = states[lane].s0;
+        s[1][lane] = states[lane].s1;
+        s[2][lane] = states[lane].s2;
+        s[3][lane] = states[lane].s3;
+    }
+
+    //  The next 9 outputs: EC, TID/SID, PID, then 6 IVs.
+    __m512i w[9];
+    {
+        __m512i s0 = _mm512_load_si512(s[0]);
+        __m512i s1 = _mm512_load_si512(s[1]);
+        __m512i s2 = _mm512_load_si512(s[2]);
+        __m512i s3 = _mm512_load_si512(s[3]);
+        w[0] = Xorshift128x16::next(s0, s3);
+        w[1] = Xorshift128x16::next(s1, w[0]);
+        w[2] = Xorshift128x16::next(s2, w[1]);
+        w[3] = Xorshift128x16::next(s3, w[2]);
+        for (size_t c = 4; c < 9; c++){
+            w[c] = Xorshift128x16::next(w[c - 4], w[c - 1]);
+        }
+    }
+
+    const __m512i SHINY_MASK = _mm512_set1_epi32(filter.shiny == 1 ? 0xfff0 : 0xffff);
+    const __m512i IV_MASK = _mm512_set1_epi32(31);
+    __m512i iv_min[6];
+    __m512i iv_max[6];
+    for (size_t c = 0; c < 6; c++){
+        iv_min[c] = _mm512_set1_epi32(filter.iv_min[c]);
+        iv_max[c] = _mm512_set1_epi32(filter.iv_max[c]);
+    }
+
+    alignas(64) uint32_t window[4][LANES];
+    for (uint64_t step = 0; step < steps; step++){
+        __mmask16 ok = 0xffff;
+        if (filter.shiny != 0){
+            __m512i x = _mm512_xor_si512(Xorshift128x16::gen(w[1]), Xorshift128x16::gen(w[2]));
+            x = _mm512_xor_si512(x, _mm512_srli_epi32(x, 16));
+            ok = _mm512_testn_epi32_mask(x, SHINY_MASK);
+        }
+        if (filter.check_ivs){
+            for (size_t c = 0; c < 6; c++){
+                __m512i iv = _mm512_and_si512(Xorshift128x16::gen(w[3 + c]), IV_MASK);
+                ok = _mm512_mask_cmpge_epu32_mask(ok, iv, iv_min[c]);
+                ok = _mm512_mask_cmple_epu32_mask(ok, iv, iv_max[c]);
+            }
+        }
+
+        if (ok != 0){
+            for (size_t c = 0; c < 4; c++){
+                _mm512_store_si512(window[c], w[c]);
+            }
+            for (size_t lane = 0; lane < LANES; lane++){
+                if ((ok & (1 << lane)) == 0){
+                    continue;
+                }
+                Xorshift128 state(window[0][lane], window[1][lane], window[2][lane], window[3][lane]);
+                state.rewind(4);
+                candidates.emplace_back(BdspScanCandidate{
+                    first_advance + lane * lane_stride + step, state.state()
+                });
+            }
+        }
+
+        __m512i next = Xorshift128x16::next(w[5], w[8]);
+        for (size_t c = 0; c < 8; c++){
+            w[c] = w[c + 1];
+        }
+        w[8] = next;
+    }
+
+    //  The generator is 9 outputs ahead of the window start.
+    for (size_t c = 0; c < 4; c++){
+        _mm512_store_si512(s[c], w[5 + c]);
+    }
+    for (size_t lane = 0; lane < LANES; lane++){
+        Xorshift128 rng(s[0][lane], s[1][lane], s[2][lane], s[3][lane]);
+        rng.rewind(9);
+        states[lane] = rng.state();
+    }
+}
+
+
+
+}
+}
+#endif
@@ -4,16 +4,132 @@
  *
  */
 
+#include <random>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/CancellableScope.h"
 #include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "Pokemon/Pokemon_BdspRng.h"
 #include "PokemonBDSP_Tests.h"
 
 namespace PokemonAutomation{
 namespace NintendoSwitch{
 namespace PokemonBDSP{
 
+using namespace Pokemon;
+
+
+
+//  The filter-based scanner must return exactly what the accept function
+//  scanner does.
+class Test_BdspStaticScan : public UnitTest{
+public:
+    Test_BdspStaticScan()
+        : UnitTest("PokemonBDSP::BdspStaticSearcher - Filter Scan")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        std::mt19937_64 rng(0);
+
+        WallDuration time_scalar = WallDuration::zero();
+        WallDuration time_filter = WallDuration::zero();
+        for (size_t iteration = 0; iteration < 24; iteration++){
+            Xorshift128State state((uint32_t)rng(), (uint32_t)rng(), (uint32_t)rng(), (uint32_t)rng());
+
+            BdspStaticTemplate tmpl;
+            tmpl.level = 50;
+            tmpl.guaranteed_ivs = iteration % 3 == 0 ? 3 : 0;
+            tmpl.shiny_locked = iteration % 7 == 3;
+            tmpl.roamer = iteration % 9 == 4;
+            tmpl.gender_ratio = iteration % 2 == 0 ? 255 : 127;
+            uint8_t synchronize = iteration % 5 == 0 ? 3 : BDSP_NO_SYNCHRONIZE;
+            BdspStaticSearcher searcher(state, tmpl, (uint16_t)rng(), synchronize);
+
+            BdspStaticFilter filter;
+            switch (iteration % 4){
+            case 0:
+                filter.min_shiny = BdspShiny::Star;
+                break;
+            case 1:
+                filter.ivs.hp = {31, 31};
+                filter.ivs.attack = {0, 5};
+                filter.ivs.speed = {20, -1};
+                break;
+            case 2:
+                filter.min_shiny = BdspShiny::Star;
+                filter.ivs.spatk = {30, 31};
+                filter.natures = 0x1f;
+                break;
+            case 3:
+                filter.natures = 1 << 3;
+                filter.genders = 1 << (uint8_t)BdspGender::Female;
+                filter.ivs.hp = {31, 31};
+                filter.ivs.defense = {31, 31};
+                break;
+            }
+
+            //  Alternate between ranges that stay on one thread and ranges
+            //  that get split up.
+            uint64_t min_advances = rng() % 5000;
+            uint64_t max_advances = min_advances + (iteration % 2 == 0 ? 30000 : 1000000);
+
+            for (bool stop_at_first : {false, true}){
+                scope.throw_if_cancelled();
+
+                WallClock time0 = current_time();
+                std::vector<BdspRngHit> expected = searcher.scan(
+                    min_advances, max_advances,
+                    [&](const BdspPokemonResult& result){ return filter.matches(result); },
+                    stop_at_first
+                );
+                WallClock time1 = current_time();
+                std::vector<BdspRngHit> actual = searcher.scan(
+                    min_advances, max_advances, filter, stop_at_first, &scope
+                );
+                WallClock time2 = current_time();
+                time_scalar += time1 - time0;
+                time_filter += time2 - time1;
+
+                std::string error = compare(expected, actual);
+                if (!error.empty()){
+                    return "Iteration " + std::to_string(iteration) + ": " + error;
+                }
+            }
+        }
+
+        logger.log(
+            "Accept function: " + std::to_string(std::chrono::duration_cast<Milliseconds>(time_scalar).count()) +
+            " ms, filter: " + std::to_string(std::chrono::duration_cast<Milliseconds>(time_filter).count()) + " ms"
+        );
+        return true;
+    }
+
+private:
+    static std::string compare(const std::vector<BdspRngHit>& expected, const std::vector<BdspRngHit>& actual){
+        if (expected.size() != actual.size()){
+            return "Expected " + std::to_string(expected.size()) + " hits. Got " + std::to_string(actual.size()) + ".";
+        }
+        for (size_t c = 0; c < expected.size(); c++){
+            const BdspRngHit& x = expected[c];
+            const BdspRngHit& y = actual[c];
+            if (x.advances != y.advances ||
+                x.state != y.state ||
+                x.result.ec != y.result.ec ||
+                x.result.pid != y.result.pid ||
+                x.result.height != y.result.height ||
+                x.result.weight != y.result.weight ||
+                x.result.to_string() != y.result.to_string()
+            ){
+                return "Mismatch at advance " + std::to_string(x.advances) + ".";
+            }
+        }
+        return "";
+    }
+};
+
 
 
 void add_tests(UnitTestDatabase& database){
+    database.add<Test_BdspStaticScan>();
 }
 
 
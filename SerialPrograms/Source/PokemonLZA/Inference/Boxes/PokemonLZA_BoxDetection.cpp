@@ -19,6 +19,7 @@
 #include "CommonTools/ImageMatch/SubObjectTemplateMatcher.h"
 #include "CommonTools/ImageMatch/WaterfillTemplateMatcher.h"
 #include "CommonTools/Images/BinaryImage_FilterRgb32.h"
+#include "CommonTools/Images/WaterfillCellGrid.h"
 #include "CommonTools/Images/WaterfillUtilities.h"
 #include "Kernels/Waterfill/Kernels_Waterfill.h"
 #include "Kernels/Waterfill/Kernels_Waterfill_Session.h"
@@ -161,19 +162,45 @@ const BoxCellSelectionArrowGreenPartMatcher& BoxCellSelectionArrowGreenPartMatch
 }
 
 
-BoxDetector::BoxDetector(Color color, VideoOverlay* overlay)
-    : m_color(color)
-    , m_plus_button(color, ButtonType::ButtonPlus, {0.581, 0.940, 0.310, 0.046}, overlay)
-{
+namespace{
+// all 6 x 6 potential locations of the arrow interiors on box view
+std::vector<ImageFloatBox> make_arrow_boxes(){
+    std::vector<ImageFloatBox> ret;
     for (size_t row = 0; row < 6; row++){
         double y = (row == 0 ? 0.122 : 0.333 + (0.797 - 0.331)/ 4.0 * (row-1));
         for (size_t col = 0; col < 6; col++){
             double x = 0.058 + col * (0.386 - 0.059)/5.0;
-            m_arrow_boxes.emplace_back(x, y, 0.018, 0.026);
-            // m_lifted_arrow_boxes.emplace_back(x+0.011, y-0.010, 0.023, 0.032);
-            m_gaps_for_lifted.emplace_back(x+0.011, y+0.010, 0.023, 0.004);
+            ret.emplace_back(x, y, 0.018, 0.026);
         }
     }
+    return ret;
+}
+
+// The arrow's white interior has color between rgb [220, 220, 220] to [255, 255, 255]
+// The arrow's green border has color between rgb [170, 230, 50] to [190, 255, 80]
+const std::vector<std::pair<uint32_t, uint32_t>> ARROW_INTERIOR_FILTERS = {
+    {0xff808080, 0xffffffff},
+    {0xff909090, 0xffffffff},
+    {0xffa0a0a0, 0xffffffff},
+    {0xffb0b0b0, 0xffffffff},
+    {0xffc0c0c0, 0xffffffff},
+    {0xffd0d0d0, 0xffffffff},
+    {0xffe0e0e0, 0xffffffff},
+    {0xfff0f0f0, 0xffffffff},
+};
+}
+
+
+BoxDetector::BoxDetector(Color color, VideoOverlay* overlay)
+    : m_color(color)
+    , m_plus_button(color, ButtonType::ButtonPlus, {0.581, 0.940, 0.310, 0.046}, overlay)
+    , m_arrow_boxes(make_arrow_boxes())
+    , m_arrow_grid(m_arrow_boxes)
+{
+    for (const ImageFloatBox& box : m_arrow_boxes){
+        // m_lifted_arrow_boxes.emplace_back(box.x+0.011, box.y-0.010, 0.023, 0.032);
+        m_gaps_for_lifted.emplace_back(box.x+0.011, box.y+0.010, 0.023, 0.004);
+    }
 }
 
 void BoxDetector::make_overlays(VideoOverlaySet& items) const{
@@ -236,7 +263,7 @@ bool BoxDetector::detect_at_cell(uint8_t cell_idx, const ImageViewRGB32& screen)
         return stats.stddev.sum() > 80;
     }
 
-    ImageViewRGB32 image_crop = extract_box_reference(screen, m_arrow_boxes[cell_idx]);
+    const ImageViewRGB32& image_crop = m_arrow_grid.cell_image(cell_idx);
 #endif
 
     // The box curosr either is not holding a pokemon, or it is holding a pokemon but the background of the cursor
@@ -244,96 +271,56 @@ bool BoxDetector::detect_at_cell(uint8_t cell_idx, const ImageViewRGB32& screen)
     // In both cases, we try to use waterfill to find the white interior of the arrow and then match the full arrow
     // tempalte image around the found white interior: 
 
-    // The arrow's white interior has color between rgb [220, 220, 220] to [255, 255, 255]
-    // The arrow's green border has color between rgb [170, 230, 50] to [190, 255, 80]
-    std::vector<std::pair<uint32_t, uint32_t>> filters = {
-        {0xff808080, 0xffffffff},
-        {0xff909090, 0xffffffff},
-        {0xffa0a0a0, 0xffffffff},
-        {0xffb0b0b0, 0xffffffff},
-        {0xffc0c0c0, 0xffffffff},
-        {0xffd0d0d0, 0xffffffff},
-        {0xffe0e0e0, 0xffffffff},
-        {0xfff0f0f0, 0xffffffff},
-    };
-    std::vector<PackedBinaryMatrix> matrices = compress_rgb32_to_binary_range(image_crop, filters);
-
+    // The whole grid was binarized and waterfilled by detect(). Only objects
+    // with at least 1/60 of the crop area that don't touch the crop boundary
+    // are left.
     const size_t total_crop_area = image_crop.width() * image_crop.height();
-    const size_t min_area = static_cast<size_t>(total_crop_area / 60.0);
     const size_t max_area = static_cast<size_t>(total_crop_area / 10.0);
 
     int saved_object_id = 0;
     if (debug_switch){
-        cout << "detect_at_cell() area threshold " << min_area << " - " << max_area << endl;
+        cout << "detect_at_cell() area threshold " << total_crop_area / 60 << " - " << max_area << endl;
         cout << "input image size " << image_crop.width() << "x" << image_crop.height() << endl;
         cout << "Saving image_crop to input_image_crop.png" << endl;
         image_crop.save("input_image_crop.png");
     }
 
-    bool detected = false;
     auto& matcher = BoxCellSelectionArrowMatcher::matcher();
-    for (size_t i_matrix = 0; i_matrix < matrices.size(); i_matrix++){
-        PackedBinaryMatrix& matrix = matrices[i_matrix];
-
-        std::unique_ptr<WaterfillSession> session = make_WaterfillSession();
-        Kernels::Waterfill::WaterfillObject object;
-
-        session->set_source(matrix);
-        auto finder = session->make_iterator(min_area);
-        const bool keep_object_matrix = false;
-        while (finder->find_next(object, keep_object_matrix)){
-            //  Exclude everything that touches the boundaries.
-            if (object.min_x == 0 ||
-                object.min_y == 0 ||
-                object.max_x >= image_crop.width() ||
-                object.max_y >= image_crop.height()
-                ){
-#if 0
-                cout << "object.min_x = " << object.min_x << ", object.min_y = " << object.min_y
-                    << ", object.max_x = " << object.max_x << ", object.max_y = " << object.max_y
-                    << " : " << image_crop.width() << " x " << image_crop.height() << endl;
-#endif
-                continue;
-            }
+    for (const WaterfillCellObject& item : m_arrow_grid.objects(cell_idx)){
+        const Kernels::Waterfill::WaterfillObject& object = item.object;
 
-            if (debug_switch){
-                cout << "Find object: area " << object.area << ", save to found_subobject" << saved_object_id << ".png" << endl;
-                ImagePixelBox box(object);
-                extract_box_reference(image_crop, box).save("found_subobject" + std::to_string(saved_object_id++) + ".png");
-            }
-            if (object.area > max_area){
-                continue;
-            }
+        if (debug_switch){
+            cout << "Find object: area " << object.area << ", save to found_subobject" << saved_object_id << ".png" << endl;
+            ImagePixelBox box(object);
+            extract_box_reference(image_crop, box).save("found_subobject" + std::to_string(saved_object_id++) + ".png");
+        }
+        if (object.area > max_area){
+            continue;
+        }
 
-            ImagePixelBox found_arrow_box;
+        ImagePixelBox found_arrow_box;
 
-            if (debug_switch){
-                double rmsd_value = matcher.rmsd(found_arrow_box, image_crop, object);
-                cout << "rmsd_value: " << rmsd_value << endl;
+        if (debug_switch){
+            double rmsd_value = matcher.rmsd(found_arrow_box, image_crop, object);
+            cout << "rmsd_value: " << rmsd_value << endl;
 #if 0
-                if (!matcher.check_aspect_ratio(object.width(), object.height())){
-                    cout << "aspect ratio check failed" << endl;
-                }
-                if (!matcher.check_area_ratio(object.area_ratio())){
-                    cout << "area ratio check failed: candidate object " << object.area_ratio() << " template " << matcher.m_subobject_area_ratio << endl;
-                }
-#endif
+            if (!matcher.check_aspect_ratio(object.width(), object.height())){
+                cout << "aspect ratio check failed" << endl;
             }
-
-            if (matcher.matches(found_arrow_box, image_crop, object)){
-                if (debug_switch){
-                    cout << "detected!!!!!" << endl;
-                }
-                detected = true;
-                break;
+            if (!matcher.check_area_ratio(object.area_ratio())){
+                cout << "area ratio check failed: candidate object " << object.area_ratio() << " template " << matcher.m_subobject_area_ratio << endl;
             }
+#endif
         }
 
-        if (detected){
-            break;
+        if (matcher.matches(found_arrow_box, image_crop, object)){
+            if (debug_switch){
+                cout << "detected!!!!!" << endl;
+            }
+            return true;
         }
     }
-    return detected;
+    return false;
 }
 
 
@@ -343,6 +330,14 @@ bool BoxDetector::detect(const ImageViewRGB32& screen){
     }
     m_found_row = m_found_col = BoxCursorCoordinates::INVALID;
 
+    // Binarize and waterfill all the cells at once. detect_at_cell() then
+    // only needs to look at the objects in its own cell.
+    if (!m_holding_pokemon){
+        ImageViewRGB32 first_cell = extract_box_reference(screen, m_arrow_boxes[0]);
+        const size_t min_area = static_cast<size_t>(first_cell.width() * first_cell.height() / 60.0);
+        m_arrow_grid.process(screen, ARROW_INTERIOR_FILTERS, min_area);
+    }
+
     bool arrow_found = false;
     for (uint8_t row = 0, cell_idx = 0; row < 6; row++){
         for (uint8_t col = 0; col < 6; col++, cell_idx++){
@@ -11,6 +11,7 @@
 #include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "CommonTools/VisualDetector.h"
 #include "CommonTools/InferenceCallbacks/VisualInferenceCallback.h"
+#include "CommonTools/Images/WaterfillCellGrid.h"
 #include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "PokemonLZA/Inference/PokemonLZA_ButtonDetector.h"
 
@@ -68,6 +69,7 @@ public:
 
 private:
     // called for each box cell to check if the selection arrow is above that cell
+    // unless holding a pokemon, requires `m_arrow_grid` to be processed for `screen`
     bool detect_at_cell(uint8_t cell_idx, const ImageViewRGB32& screen);
 
     bool m_holding_pokemon = false;
@@ -76,6 +78,8 @@ private:
     ButtonDetector m_plus_button;
     // all 6 x 6 potential locations of the arrow interiors on box view
     std::vector<ImageFloatBox> m_arrow_boxes;
+    // waterfill results of all of "m_arrow_boxes" for the current frame
+    WaterfillCellGrid m_arrow_grid;
     // all 6 x 6 potential locations of the arrow interiors on box view when lifting/holding a pokemon
     // std::vector<ImageFloatBox> m_lifted_arrow_boxes;
     // all 6 x 6 gaps between box rows to detect when lifting/holding a pokemon
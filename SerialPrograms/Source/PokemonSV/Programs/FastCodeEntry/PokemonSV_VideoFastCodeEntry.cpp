@@ -137,6 +137,9 @@ VideoFastCodeEntry_Descriptor::VideoFastCodeEntry_Descriptor()
         1, 4, 1
     )
 {}
+std::vector<ProgramDescriptor::OcrPrewarm> VideoFastCodeEntry_Descriptor::ocr_prewarm() const{
+    return {{Language::English, 6}};
+}
 
 VideoFastCodeEntry::VideoFastCodeEntry()
     : SCREEN_WATCHER("Capture Box:")
@@ -168,7 +171,6 @@ VideoFastCodeEntry::VideoFastCodeEntry()
 
     //  Preload
     GlobalThreadPools::computation_realtime().ensure_threads(6);
-    OCR::ensure_ocr_instances(Language::English, 6);
     preload_code_templates();
 }
 void VideoFastCodeEntry::update_active_consoles(size_t switch_count){
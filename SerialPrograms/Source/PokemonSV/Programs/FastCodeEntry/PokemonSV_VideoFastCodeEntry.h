@@ -48,6 +48,8 @@ void wait_for_video_code_and_join(
 class VideoFastCodeEntry_Descriptor : public MultiSwitchProgramDescriptor{
 public:
     VideoFastCodeEntry_Descriptor();
+
+    virtual std::vector<OcrPrewarm> ocr_prewarm() const override;
 };
 
 
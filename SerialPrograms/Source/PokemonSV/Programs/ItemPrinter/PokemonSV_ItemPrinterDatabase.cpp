@@ -418,8 +418,9 @@ const ItemPrinterEnumOption* option_lookup_by_seed(int64_t seed){
 
 
 
-DateSeed get_date_seed(int64_t seed){
-    //  This is the function that we would replace with Kurt's seed calculator.
+const std::map<int64_t, DateSeed>& date_seed_database(){
+    //  For anything not listed here, use calculate_seed_prizes() or search
+    //  an ItemPrinterSeedIndex.
 
     static const std::map<int64_t, DateSeed> DATABASE{
         {2346161588, {2346161588, {"calcium"}}},
@@ -657,9 +658,12 @@ DateSeed get_date_seed(int64_t seed){
 //        {1717461428 + 2, {1717461428 + 2, {}, }},
 
     };
-
-    auto iter = DATABASE.find(seed);
-    if (iter != DATABASE.end()){
+    return DATABASE;
+}
+DateSeed get_date_seed(int64_t seed){
+    const std::map<int64_t, DateSeed>& database = date_seed_database();
+    auto iter = database.find(seed);
+    if (iter != database.end()){
         return iter->second;
     }
 
@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_PokemonSV_ItemPrinterDatabase_H
 #define PokemonAutomation_PokemonSV_ItemPrinterDatabase_H
 
+#include <map>
 #include "Common/Cpp/Options/EnumDropdownDatabase.h"
 #include "PokemonSV_ItemPrinterTools.h"
 
@@ -119,6 +120,9 @@ struct DateSeed{
 };
 DateSeed get_date_seed(int64_t seed);
 
+//  The hardcoded seeds used by get_date_seed().
+const std::map<int64_t, DateSeed>& date_seed_database();
+
 
 }
 }
@@ -11,6 +11,7 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/Json/JsonArray.h"
@@ -29,7 +30,7 @@ namespace PokemonSV{
 namespace ItemPrinter{
 
 
-const char* item_id_to_slug(int item_id){
+static const std::map<int, const char*>& item_slug_database(){
     //  Taken from: https://github.com/kwsch/ItemPrinterDeGacha/blob/main/ItemPrinterDeGacha.Core/Resources/text/items_en.txt
     static const std::map<int, const char*> database{
         {1, "master-ball"},
@@ -227,6 +228,10 @@ const char* item_id_to_slug(int item_id){
 
         {2549, "stellar-tera-shard"},
     };
+    return database;
+}
+const char* item_id_to_slug(int item_id){
+    const std::map<int, const char*>& database = item_slug_database();
     auto iter = database.find(item_id);
     if (iter != database.end()){
         return iter->second;
@@ -234,9 +239,25 @@ const char* item_id_to_slug(int item_id){
         return nullptr;
     }
 }
+int item_slug_to_id(const std::string& slug){
+    static const std::map<std::string, int> database = []{
+        std::map<std::string, int> ret;
+        for (const auto& item : item_slug_database()){
+            ret.emplace(item.second, item.first);
+        }
+        return ret;
+    }();
+    auto iter = database.find(slug);
+    if (iter != database.end()){
+        return iter->second;
+    }else{
+        return -1;
+    }
+}
 
 struct ItemPrinterItemData{
     const char* slug;
+    uint16_t item_id;
     uint16_t weight;
     uint8_t min_quantity;
     uint8_t max_quantity;
@@ -266,6 +287,7 @@ std::vector<ItemPrinterItemData> make_item_prize_list(){
         }
         ret.emplace_back(ItemPrinterItemData{
             slug,
+            (uint16_t)item_id,
             (uint16_t)entry.get_integer_throw("EmergePercent", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMin", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMax", path)
@@ -299,6 +321,7 @@ std::vector<ItemPrinterItemData> make_ball_prize_list(){
         }
         ret.emplace_back(ItemPrinterItemData{
             slug,
+            (uint16_t)item_id,
             (uint16_t)entry.get_integer_throw("EmergePercent", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMin", path),
             (uint8_t)entry.get_integer_throw("LotteryItemNumMax", path)
@@ -349,14 +372,10 @@ std::vector<const ItemPrinterItemData*> make_ball_prize_table(){
 }
 
 
-enum class PrintMode{
-    Regular = 0,
-    ItemBonus = 1,
-    BallBonus = 2,
-};
-
-
-std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
+//  Run the printer for "prints" prints and call "callback(item, quantity)"
+//  for each one.
+template <typename Callback>
+PA_FORCE_INLINE void run_printer(int64_t seed, PrintMode mode, size_t prints, Callback&& callback){
     static const std::vector<const ItemPrinterItemData*> ITEM_TABLE = make_item_prize_table();
     static const std::vector<const ItemPrinterItemData*> BALL_TABLE = make_ball_prize_table();
 
@@ -367,8 +386,7 @@ std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
     Pokemon::Xoroshiro128Plus rand(seed, 0x82A2B175229D6A5B);
 
     PrintMode return_mode = PrintMode::Regular;
-    std::array<std::string, 10> ret;
-    for (size_t c = 0; c < 10; c++){
+    for (size_t c = 0; c < prints; c++){
         //  Always check for next bonus mode, even if not possible.
         uint64_t roll = rand.nextInt(1000);
         bool bonus = roll < 20;
@@ -376,12 +394,17 @@ std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
         //  Determine the item to print.
         uint64_t item_roll = rand.nextInt(table.size());
         const ItemPrinterItemData& item = *table[item_roll];
-        ret[c] = item.slug;
 
-        //  Determine quantity.
+        //  Determine quantity. The item bonus doubles it.
+        uint16_t quantity = item.min_quantity;
         if (item.min_quantity != item.max_quantity){
-            rand.nextInt(item.max_quantity - item.min_quantity + 1);
+            quantity += (uint16_t)rand.nextInt(item.max_quantity - item.min_quantity + 1);
         }
+        if (mode == PrintMode::ItemBonus){
+            quantity *= 2;
+        }
+
+        callback(item, quantity);
 
         //  If we're lucky enough to get a bonus mode, pick one.
         //  Assume the player has both modes unlocked.
@@ -391,7 +414,23 @@ std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
         }
 
     }
+}
 
+
+std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode){
+    std::array<std::string, 10> ret;
+    size_t c = 0;
+    run_printer(seed, mode, 10, [&](const ItemPrinterItemData& item, uint16_t){
+        ret[c++] = item.slug;
+    });
+    return ret;
+}
+std::array<ItemPrinterPrize, 10> calculate_prize_ids(int64_t seed, PrintMode mode, size_t prints){
+    std::array<ItemPrinterPrize, 10> ret{};
+    size_t c = 0;
+    run_printer(seed, mode, std::min<size_t>(prints, 10), [&](const ItemPrinterItemData& item, uint16_t quantity){
+        ret[c++] = ItemPrinterPrize{item.item_id, quantity};
+    });
     return ret;
 }
 
@@ -20,6 +20,29 @@ namespace PokemonSV{
 namespace ItemPrinter{
 
 
+enum class PrintMode{
+    Regular = 0,
+    ItemBonus = 1,
+    BallBonus = 2,
+};
+
+struct ItemPrinterPrize{
+    uint16_t item_id = 0;     //  Game item ID. 0 means no prize.
+    uint16_t quantity = 0;
+};
+
+
+//  Game item ID <-> slug. Returns nullptr/-1 if unknown.
+const char* item_id_to_slug(int item_id);
+int item_slug_to_id(const std::string& slug);
+
+
+std::array<std::string, 10> calculate_prizes(int64_t seed, PrintMode mode);
+
+//  Same as above, but returns item IDs and quantities for only the first
+//  "prints" prints. This doesn't allocate, so use it for bulk searches.
+std::array<ItemPrinterPrize, 10> calculate_prize_ids(int64_t seed, PrintMode mode, size_t prints = 10);
+
 DateSeed calculate_seed_prizes(int64_t seed);
 
 
@@ -0,0 +1,491 @@
+/*  Item Printer Seed Index
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <QFile>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/Filesystem/FileIO.h"
+#include "Common/Cpp/Concurrency/ThreadPool.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "PokemonSV_ItemPrinterDatabase.h"
+#include "PokemonSV_ItemPrinterSeedIndex.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+namespace PokemonSV{
+namespace ItemPrinter{
+
+
+
+//  File layout:
+//      Header
+//      KeyEntry[key_count]     sorted by key
+//      uint32_t[posting_count] seeds, sorted within each key
+struct ItemPrinterSeedIndex::Header{
+    char magic[8];
+    uint32_t version;
+    uint32_t key_count;
+    uint64_t posting_count;
+    int64_t first_seed;
+    int64_t last_seed;
+    uint8_t jobs;
+    uint8_t min_prints;
+    uint8_t reserved[6];
+};
+struct ItemPrinterSeedIndex::KeyEntry{
+    uint32_t key;
+    uint32_t count;
+    uint64_t offset;    //  Into the seed array.
+};
+
+const char INDEX_MAGIC[8] = {'P', 'A', 'S', 'V', 'I', 'P', 'S', 'I'};
+const uint32_t INDEX_VERSION = 1;
+
+const size_t INDEX_CHUNK_SIZE = (size_t)1 << 20;
+const size_t INDEX_MAX_QUANTITY = 0xfff;
+
+const PrintMode INDEX_MODES[] = {
+    PrintMode::Regular,
+    PrintMode::ItemBonus,
+    PrintMode::BallBonus,
+};
+
+
+//  [25:24] mode, [23:12] item ID, [11:0] quantity
+inline uint32_t make_index_key(PrintMode mode, uint16_t item_id, size_t quantity){
+    return (uint32_t)mode << 24
+        | (uint32_t)(item_id & 0xfff) << 12
+        | (uint32_t)std::min(quantity, INDEX_MAX_QUANTITY);
+}
+
+
+
+ItemPrinterSeedIndex::ItemPrinterSeedIndex() = default;
+ItemPrinterSeedIndex::~ItemPrinterSeedIndex() = default;
+ItemPrinterSeedIndex::ItemPrinterSeedIndex(ItemPrinterSeedIndex&& x) = default;
+ItemPrinterSeedIndex& ItemPrinterSeedIndex::operator=(ItemPrinterSeedIndex&& x) = default;
+
+
+void ItemPrinterSeedIndex::attach(const void* data, size_t bytes, const std::string& path){
+    static_assert(sizeof(Header) == 48);
+    static_assert(sizeof(KeyEntry) == 16);
+
+    if (bytes < sizeof(Header)){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Item printer seed index is truncated.", path);
+    }
+    const Header& header = *(const Header*)data;
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Not an item printer seed index.", path);
+    }
+    if (header.version != INDEX_VERSION){
+        throw FileException(
+            nullptr, PA_CURRENT_FUNCTION,
+            "Unsupported item printer seed index version: " + std::to_string(header.version),
+            path
+        );
+    }
+    uint64_t expected = sizeof(Header)
+        + (uint64_t)header.key_count * sizeof(KeyEntry)
+        + header.posting_count * sizeof(uint32_t);
+    if (expected != bytes){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Item printer seed index has the wrong size.", path);
+    }
+
+    m_data = (const char*)data;
+    m_bytes = bytes;
+    m_parameters.first_seed = header.first_seed;
+    m_parameters.last_seed = header.last_seed;
+    m_parameters.jobs = header.jobs;
+    m_parameters.min_prints = header.min_prints;
+    m_keys = (const KeyEntry*)(m_data + sizeof(Header));
+    m_key_count = header.key_count;
+    m_seeds = (const uint32_t*)(m_keys + m_key_count);
+    m_posting_count = (size_t)header.posting_count;
+
+    for (size_t c = 0; c < m_key_count; c++){
+        const KeyEntry& entry = m_keys[c];
+        if (entry.offset + entry.count > m_posting_count || (c > 0 && m_keys[c - 1].key >= entry.key)){
+            m_data = nullptr;
+            throw FileException(nullptr, PA_CURRENT_FUNCTION, "Item printer seed index is corrupt.", path);
+        }
+    }
+}
+
+
+
+//  Seeds for one chunk of the range. Each is (key << 32) | seed.
+struct ItemPrinterSeedIndexChunk{
+    int64_t first_seed;
+    int64_t last_seed;
+    std::vector<uint64_t> postings;
+};
+
+void scan_chunk(
+    ItemPrinterSeedIndexChunk& chunk,
+    const ItemPrinterSeedIndexParameters& parameters,
+    Cancellable* cancellable
+){
+    for (int64_t seed = chunk.first_seed; seed <= chunk.last_seed; seed++){
+        if (cancellable != nullptr && (seed & 0xffff) == 0){
+            cancellable->throw_if_cancelled();
+        }
+        for (PrintMode mode : INDEX_MODES){
+            std::array<ItemPrinterPrize, 10> prizes = calculate_prize_ids(seed, mode, parameters.jobs);
+
+            //  Combine repeats of the same item.
+            uint16_t items[10];
+            size_t quantities[10];
+            uint8_t prints[10];
+            size_t distinct = 0;
+            for (size_t c = 0; c < parameters.jobs; c++){
+                size_t index = 0;
+                while (index < distinct && items[index] != prizes[c].item_id){
+                    index++;
+                }
+                if (index == distinct){
+                    items[index] = prizes[c].item_id;
+                    quantities[index] = 0;
+                    prints[index] = 0;
+                    distinct++;
+                }
+                quantities[index] += prizes[c].quantity;
+                prints[index]++;
+            }
+
+            for (size_t c = 0; c < distinct; c++){
+                if (prints[c] < parameters.min_prints){
+                    continue;
+                }
+                uint64_t key = make_index_key(mode, items[c], quantities[c]);
+                chunk.postings.emplace_back(key << 32 | (uint64_t)seed);
+            }
+        }
+    }
+}
+
+ItemPrinterSeedIndex ItemPrinterSeedIndex::build(
+    ThreadPool& pool,
+    const ItemPrinterSeedIndexParameters& parameters,
+    Cancellable* cancellable
+){
+    if (parameters.first_seed < 0 ||
+        parameters.last_seed > (int64_t)UINT32_MAX ||
+        parameters.first_seed > parameters.last_seed
+    ){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid seed range.");
+    }
+    if (parameters.jobs < 1 || parameters.jobs > 10 ||
+        parameters.min_prints < 1 || parameters.min_prints > parameters.jobs
+    ){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid jobs or min_prints.");
+    }
+
+    //  Load the prize tables before going parallel.
+    calculate_prize_ids(parameters.first_seed, PrintMode::Regular);
+    calculate_prize_ids(parameters.first_seed, PrintMode::BallBonus);
+
+    std::vector<ItemPrinterSeedIndexChunk> chunks;
+    for (int64_t start = parameters.first_seed;;){
+        int64_t end = parameters.last_seed - start < (int64_t)INDEX_CHUNK_SIZE
+            ? parameters.last_seed
+            : start + INDEX_CHUNK_SIZE - 1;
+        chunks.emplace_back(ItemPrinterSeedIndexChunk{start, end, {}});
+        if (end == parameters.last_seed){
+            break;
+        }
+        start = end + 1;
+    }
+
+    if (chunks.size() == 1){
+        scan_chunk(chunks[0], parameters, cancellable);
+    }else{
+        pool.run_in_parallel(
+            [&](size_t index){ scan_chunk(chunks[index], parameters, cancellable); },
+            0, chunks.size(), 1
+        );
+    }
+    if (cancellable != nullptr){
+        cancellable->throw_if_cancelled();
+    }
+
+    //  Merge. Sorting the combined value sorts by key, then by seed.
+    std::vector<uint64_t> postings;
+    {
+        size_t total = 0;
+        for (const ItemPrinterSeedIndexChunk& chunk : chunks){
+            total += chunk.postings.size();
+        }
+        postings.reserve(total);
+        for (ItemPrinterSeedIndexChunk& chunk : chunks){
+            postings.insert(postings.end(), chunk.postings.begin(), chunk.postings.end());
+            chunk.postings = std::vector<uint64_t>();
+        }
+    }
+    std::sort(postings.begin(), postings.end());
+
+    std::vector<KeyEntry> keys;
+    for (size_t c = 0; c < postings.size(); c++){
+        uint32_t key = (uint32_t)(postings[c] >> 32);
+        if (keys.empty() || keys.back().key != key){
+            keys.emplace_back(KeyEntry{key, 0, c});
+        }
+        keys.back().count++;
+    }
+
+    size_t bytes = sizeof(Header) + keys.size() * sizeof(KeyEntry) + postings.size() * sizeof(uint32_t);
+
+    ItemPrinterSeedIndex ret;
+    ret.m_buffer.resize((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    char* data = (char*)ret.m_buffer.data();
+
+    Header& header = *(Header*)data;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.key_count = (uint32_t)keys.size();
+    header.posting_count = postings.size();
+    header.first_seed = parameters.first_seed;
+    header.last_seed = parameters.last_seed;
+    header.jobs = parameters.jobs;
+    header.min_prints = parameters.min_prints;
+
+    memcpy(data + sizeof(Header), keys.data(), keys.size() * sizeof(KeyEntry));
+    uint32_t* seeds = (uint32_t*)(data + sizeof(Header) + keys.size() * sizeof(KeyEntry));
+    for (size_t c = 0; c < postings.size(); c++){
+        seeds[c] = (uint32_t)postings[c];
+    }
+
+    ret.attach(data, bytes, "");
+    return ret;
+}
+
+
+
+ItemPrinterSeedIndex ItemPrinterSeedIndex::open(const std::string& path){
+    ItemPrinterSeedIndex ret;
+    ret.m_file.reset(new QFile(QString::fromStdString(path)));
+    if (!ret.m_file->open(QIODevice::ReadOnly)){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to open item printer seed index.", path);
+    }
+    qint64 bytes = ret.m_file->size();
+    const uchar* data = bytes == 0 ? nullptr : ret.m_file->map(0, bytes);
+    if (data == nullptr){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to map item printer seed index.", path);
+    }
+    ret.attach(data, (size_t)bytes, path);
+    return ret;
+}
+void ItemPrinterSeedIndex::save(const std::string& path) const{
+    FileIO file(path, FileMode::WRITE | FileMode::BINARY);
+    if (!file.is_open() || file.write(m_data, m_bytes) != m_bytes || !file.flush()){
+        throw FileException(nullptr, PA_CURRENT_FUNCTION, "Unable to write item printer seed index.", path);
+    }
+}
+
+
+
+const uint32_t* ItemPrinterSeedIndex::seeds(
+    PrintMode mode, uint16_t item_id, uint16_t quantity,
+    size_t& count
+) const{
+    count = 0;
+    uint32_t key = make_index_key(mode, item_id, quantity);
+    const KeyEntry* end = m_keys + m_key_count;
+    const KeyEntry* iter = std::lower_bound(
+        m_keys, end, key,
+        [](const KeyEntry& entry, uint32_t key){ return entry.key < key; }
+    );
+    if (iter == end || iter->key != key){
+        return nullptr;
+    }
+    count = iter->count;
+    return m_seeds + iter->offset;
+}
+std::vector<ItemPrinterSeedHit> ItemPrinterSeedIndex::best_seeds(
+    PrintMode mode, uint16_t item_id, uint16_t min_quantity,
+    size_t max_results
+) const{
+    std::vector<ItemPrinterSeedHit> ret;
+
+    //  All quantities for this item are adjacent. Walk them from the top.
+    uint32_t lo = make_index_key(mode, item_id, min_quantity);
+    uint32_t hi = make_index_key(mode, item_id, INDEX_MAX_QUANTITY);
+    const KeyEntry* begin = std::lower_bound(
+        m_keys, m_keys + m_key_count, lo,
+        [](const KeyEntry& entry, uint32_t key){ return entry.key < key; }
+    );
+    const KeyEntry* iter = std::upper_bound(
+        begin, m_keys + m_key_count, hi,
+        [](uint32_t key, const KeyEntry& entry){ return key < entry.key; }
+    );
+    while (iter != begin && ret.size() < max_results){
+        --iter;
+        uint16_t quantity = (uint16_t)(iter->key & 0xfff);
+        const uint32_t* seeds = m_seeds + iter->offset;
+        size_t count = std::min<size_t>(iter->count, max_results - ret.size());
+        for (size_t c = 0; c < count; c++){
+            ret.emplace_back(ItemPrinterSeedHit{seeds[c], quantity});
+        }
+    }
+    return ret;
+}
+
+
+
+
+//  The index must agree with the hardcoded seeds.
+class Test_ItemPrinterSeedIndex : public UnitTest{
+public:
+    Test_ItemPrinterSeedIndex()
+        : UnitTest("PokemonSV::ItemPrinterSeedIndex - Hardcoded Seeds")
+    {}
+
+    static bool contains(
+        const ItemPrinterSeedIndex& index,
+        PrintMode mode, uint16_t item_id, uint16_t quantity,
+        int64_t seed
+    ){
+        size_t count;
+        const uint32_t* seeds = index.seeds(mode, item_id, quantity, count);
+        return seeds != nullptr && std::binary_search(seeds, seeds + count, (uint32_t)seed);
+    }
+
+    static bool contains_any(
+        const ItemPrinterSeedIndex& index,
+        PrintMode mode, uint16_t item_id,
+        int64_t seed
+    ){
+        for (const ItemPrinterSeedHit& hit : index.best_seeds(mode, item_id, 1, SIZE_MAX)){
+            if (hit.seed == seed){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //  Same rule as ItemPrinterRNG::results_approximately_match().
+    static std::string check_date_seed(
+        const ItemPrinterSeedIndex& index,
+        PrintMode mode, const std::array<std::string, 10>& expected,
+        int64_t seed
+    ){
+        size_t total = 0;
+        size_t mismatches = 0;
+        for (const std::string& slug : expected){
+            if (slug.empty()){
+                continue;
+            }
+            total++;
+            int item_id = item_slug_to_id(slug);
+            if (item_id < 0){
+                return "Unknown slug: " + slug;
+            }
+            if (!contains_any(index, mode, (uint16_t)item_id, seed)){
+                mismatches++;
+            }
+        }
+        if (mismatches * 5 > total){
+            return "Seed " + std::to_string(seed) + ": " + std::to_string(mismatches) +
+                " of " + std::to_string(total) + " prizes are not in the index.";
+        }
+        return "";
+    }
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        ThreadPool& pool = GlobalThreadPools::computation_normal();
+
+        //  Every hardcoded prize list must show up in an index of the first
+        //  5 prints with nothing filtered out.
+        for (const auto& item : date_seed_database()){
+            const DateSeed& expected = item.second;
+
+            ItemPrinterSeedIndexParameters parameters;
+            parameters.first_seed = item.first;
+            parameters.last_seed = item.first;
+            parameters.jobs = 5;
+            parameters.min_prints = 1;
+            ItemPrinterSeedIndex index = ItemPrinterSeedIndex::build(pool, parameters, &scope);
+
+            std::string error = check_date_seed(index, PrintMode::ItemBonus, expected.item_bonus, item.first);
+            if (error.empty()){
+                error = check_date_seed(index, PrintMode::BallBonus, expected.ball_bonus, item.first);
+            }
+            if (!error.empty()){
+                logger.log(error, COLOR_RED);
+                return false;
+            }
+        }
+
+        //  The prebuilt options list the total quantity for their job count.
+        //  Their seeds must be under exactly that quantity.
+        for (size_t c = (size_t)PrebuiltOptions::ABILITY_PATCH; c <= (size_t)PrebuiltOptions::STELLAR_TERA; c++){
+            PrebuiltOptions value = (PrebuiltOptions)c;
+            if (value == PrebuiltOptions::ASSORTED_BALLS_1 ||
+                value == PrebuiltOptions::ASSORTED_BALLS_2 ||
+                value == PrebuiltOptions::ASSORTED_BALLS_3
+            ){
+                continue;
+            }
+            const ItemPrinterEnumOption& option = option_lookup_by_enum(value);
+            const std::string& slug = PrebuiltOptions_Database().find(value)->slug;
+            int item_id = item_slug_to_id(slug);
+            if (item_id < 0){
+                logger.log("Unknown slug: " + slug, COLOR_RED);
+                return false;
+            }
+            PrintMode mode = slug.find("-ball") != std::string::npos
+                ? PrintMode::BallBonus
+                : PrintMode::ItemBonus;
+
+            ItemPrinterSeedIndexParameters parameters;
+            parameters.first_seed = option.seed - 100;
+            parameters.last_seed = option.seed + 100;
+            parameters.jobs = (uint8_t)option.jobs;
+            parameters.min_prints = 1;
+            ItemPrinterSeedIndex index = ItemPrinterSeedIndex::build(pool, parameters, &scope);
+
+            if (!contains(index, mode, (uint16_t)item_id, option.quantity_obtained, option.seed)){
+                logger.log(
+                    slug + ": Seed " + std::to_string(option.seed) + " is not indexed under quantity " +
+                    std::to_string(option.quantity_obtained) + ".",
+                    COLOR_RED
+                );
+                return false;
+            }
+
+            //  Quantity order, then seed order.
+            std::vector<ItemPrinterSeedHit> hits = index.best_seeds(mode, (uint16_t)item_id, 1, SIZE_MAX);
+            for (size_t i = 1; i < hits.size(); i++){
+                if (hits[i - 1].quantity < hits[i].quantity ||
+                    (hits[i - 1].quantity == hits[i].quantity && hits[i - 1].seed >= hits[i].seed)
+                ){
+                    logger.log(slug + ": best_seeds() is out of order.", COLOR_RED);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+
+void add_tests_ItemPrinterSeedIndex(UnitTestDatabase& database){
+    database.add<Test_ItemPrinterSeedIndex>();
+}
+
+
+
+}
+}
+}
+}
@@ -0,0 +1,131 @@
+/*  Item Printer Seed Index
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Inverted index from (print mode, item, quantity) to every date seed that
+ *  prints it. This is built by running every seed in a date range through
+ *  the seed calculator. Use it to find the best date for an item instead of
+ *  being limited to the hardcoded seeds in the database.
+ *
+ *  The index is a flat little-endian image with no pointers. A saved index
+ *  is memory mapped and used in place.
+ *
+ */
+
+#ifndef PokemonAutomation_PokemonSV_ItemPrinterSeedIndex_H
+#define PokemonAutomation_PokemonSV_ItemPrinterSeedIndex_H
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Common/Cpp/TestRunners/UnitTest.h"
+#include "PokemonSV_ItemPrinterSeedCalc.h"
+
+class QFile;
+
+namespace PokemonAutomation{
+
+class Cancellable;
+class ThreadPool;
+
+namespace NintendoSwitch{
+namespace PokemonSV{
+namespace ItemPrinter{
+
+
+
+struct ItemPrinterSeedIndexParameters{
+    //  Seeds are seconds since epoch. The default is the full range of the
+    //  Switch clock. (2000-01-01 00:00:00 to 2060-12-31 23:59:59)
+    int64_t first_seed = 946684800;
+    int64_t last_seed = 2871763199;
+
+    //  Number of prints in the job. Quantities are summed over these.
+    uint8_t jobs = 5;
+
+    //  Only index an item if it's printed at least this many times in the
+    //  job. Without this, the full calendar is hundreds of GB.
+    uint8_t min_prints = 3;
+};
+
+struct ItemPrinterSeedHit{
+    int64_t seed;
+    uint16_t quantity;
+};
+
+
+
+class ItemPrinterSeedIndex{
+public:
+    ItemPrinterSeedIndex();
+    ~ItemPrinterSeedIndex();
+    ItemPrinterSeedIndex(ItemPrinterSeedIndex&& x);
+    ItemPrinterSeedIndex& operator=(ItemPrinterSeedIndex&& x);
+    ItemPrinterSeedIndex(const ItemPrinterSeedIndex&) = delete;
+    void operator=(const ItemPrinterSeedIndex&) = delete;
+
+    //  Sweep every seed in the range across the thread pool.
+    static ItemPrinterSeedIndex build(
+        ThreadPool& pool,
+        const ItemPrinterSeedIndexParameters& parameters,
+        Cancellable* cancellable = nullptr
+    );
+
+    //  Memory map a saved index. Throws FileException if the file can't be
+    //  opened or isn't a valid index.
+    static ItemPrinterSeedIndex open(const std::string& path);
+    void save(const std::string& path) const;
+
+
+public:
+    bool empty() const{ return m_data == nullptr; }
+    const ItemPrinterSeedIndexParameters& parameters() const{ return m_parameters; }
+    size_t keys() const{ return m_key_count; }
+    size_t postings() const{ return m_posting_count; }
+
+    //  All seeds that print exactly "quantity" of this item, sorted.
+    //  Returns nullptr if there are none.
+    const uint32_t* seeds(
+        PrintMode mode, uint16_t item_id, uint16_t quantity,
+        size_t& count
+    ) const;
+
+    //  Seeds that print at least "min_quantity" of this item. Highest
+    //  quantity first, then earliest seed.
+    std::vector<ItemPrinterSeedHit> best_seeds(
+        PrintMode mode, uint16_t item_id, uint16_t min_quantity,
+        size_t max_results
+    ) const;
+
+
+private:
+    struct Header;
+    struct KeyEntry;
+
+    void attach(const void* data, size_t bytes, const std::string& path);
+
+    std::vector<uint64_t> m_buffer;     //  Built in memory.
+    std::unique_ptr<QFile> m_file;      //  Mapped from disk.
+
+    const char* m_data = nullptr;
+    size_t m_bytes = 0;
+
+    ItemPrinterSeedIndexParameters m_parameters;
+    const KeyEntry* m_keys = nullptr;
+    size_t m_key_count = 0;
+    const uint32_t* m_seeds = nullptr;
+    size_t m_posting_count = 0;
+};
+
+
+
+void add_tests_ItemPrinterSeedIndex(UnitTestDatabase& database);
+
+
+
+}
+}
+}
+}
+#endif
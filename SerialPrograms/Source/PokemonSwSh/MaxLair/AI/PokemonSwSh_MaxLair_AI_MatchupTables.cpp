@@ -0,0 +1,601 @@
+/*  Max Lair AI Matchup Tables
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <cmath>
+#include <random>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/CancellableScope.h"
+#include "Common/Cpp/TestRunners/UnitTestDatabase.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "PokemonSwSh/Resources/PokemonSwSh_MaxLairDatabase.h"
+#include "PokemonSwSh/PkmnLib/PokemonSwSh_PkmnLib_Pokemon.h"
+#include "PokemonSwSh/PkmnLib/PokemonSwSh_PkmnLib_Matchup.h"
+#include "PokemonSwSh_MaxLair_AI.h"
+#include "PokemonSwSh_MaxLair_AI_Tools.h"
+#include "PokemonSwSh_MaxLair_AI_PathMatchup.h"
+#include "PokemonSwSh_MaxLair_AI_RentalBossMatchup.h"
+#include "PokemonSwSh_MaxLair_AI_MatchupTables.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+namespace PokemonSwSh{
+namespace MaxLairInternal{
+
+
+
+namespace{
+
+//  The original average over all bosses of a type. Throws if a boss is
+//  missing from either database.
+double type_vs_boss_type_slow(PokemonType type, PokemonType boss_type){
+    using namespace papkmnlib;
+
+    Type pkmnlib_type = serial_type_to_pkmnlib(boss_type);
+
+    double weight = 0;
+    size_t count = 0;
+    for (const auto& item : all_bosses_by_dex()){
+        const Pokemon& boss = get_pokemon(item.second);
+        if (boss_type == PokemonType::NONE || boss.has_type(pkmnlib_type)){
+            weight += type_vs_boss(type, boss.name());
+            count++;
+        }
+    }
+
+    return weight / (double)count;
+}
+
+}
+
+
+
+const MatchupTables& MatchupTables::instance(){
+    static MatchupTables tables;
+    return tables;
+}
+
+MatchupTables::MatchupTables(){
+    using namespace papkmnlib;
+
+    for (const auto& item : all_rental_pokemon()){
+        m_rental_indices.emplace(item.first, m_rental_slugs.size());
+        m_rental_slugs.emplace_back(item.first);
+    }
+    for (const auto& item : all_boss_pokemon()){
+        m_boss_indices.emplace(item.first, m_boss_slugs.size());
+        m_boss_slugs.emplace_back(item.first);
+    }
+
+    const size_t rental_count = rentals();
+    const size_t boss_count = bosses();
+
+    //  Missing entries stay NaN. Reading one falls back to the string lookup
+    //  so it throws the same error as before.
+    m_rental_vs_boss.resize(rental_count * boss_count, NAN);
+    for (size_t rental = 0; rental < rental_count; rental++){
+        for (size_t boss = 0; boss < boss_count; boss++){
+            try{
+                m_rental_vs_boss[rental * boss_count + boss] =
+                    rental_vs_boss_matchup(m_rental_slugs[rental], m_boss_slugs[boss]);
+            }catch (InternalProgramError&){}
+        }
+    }
+
+    m_type_vs_boss.resize(TYPES * boss_count, NAN);
+    for (size_t type = 1; type < TYPES; type++){
+        for (size_t boss = 0; boss < boss_count; boss++){
+            try{
+                m_type_vs_boss[type * boss_count + boss] =
+                    MaxLairInternal::type_vs_boss((PokemonType)type, m_boss_slugs[boss]);
+            }catch (InternalProgramError&){}
+        }
+    }
+
+    //  This one can be NaN legitimately. (no bosses of that type)
+    m_type_vs_boss_type.resize(TYPES * TYPES, 0);
+    m_type_vs_boss_type_valid.resize(TYPES * TYPES, false);
+    for (size_t type = 1; type < TYPES; type++){
+        for (size_t boss_type = 0; boss_type < TYPES; boss_type++){
+            try{
+                m_type_vs_boss_type[type * TYPES + boss_type] =
+                    type_vs_boss_type_slow((PokemonType)type, (PokemonType)boss_type);
+                m_type_vs_boss_type_valid[type * TYPES + boss_type] = true;
+            }catch (InternalProgramError&){}
+        }
+    }
+}
+
+size_t MatchupTables::rental_index(const std::string& slug) const{
+    auto iter = m_rental_indices.find(slug);
+    return iter == m_rental_indices.end() ? NOT_FOUND : iter->second;
+}
+size_t MatchupTables::boss_index(const std::string& slug) const{
+    auto iter = m_boss_indices.find(slug);
+    return iter == m_boss_indices.end() ? NOT_FOUND : iter->second;
+}
+
+double MatchupTables::rental_vs_boss(size_t rental, size_t boss) const{
+    double score = m_rental_vs_boss[rental * bosses() + boss];
+    if (std::isnan(score)){
+        return rental_vs_boss_matchup(m_rental_slugs[rental], m_boss_slugs[boss]);
+    }
+    return score;
+}
+double MatchupTables::type_vs_boss(PokemonType type, size_t boss) const{
+    if ((size_t)type >= TYPES){
+        return MaxLairInternal::type_vs_boss(type, m_boss_slugs[boss]);
+    }
+    double score = m_type_vs_boss[(size_t)type * bosses() + boss];
+    if (std::isnan(score)){
+        return MaxLairInternal::type_vs_boss(type, m_boss_slugs[boss]);
+    }
+    return score;
+}
+double MatchupTables::type_vs_boss_type(PokemonType type, PokemonType boss_type) const{
+    size_t index = (size_t)type * TYPES + (size_t)boss_type;
+    if ((size_t)type >= TYPES || (size_t)boss_type >= TYPES || !m_type_vs_boss_type_valid[index]){
+        return type_vs_boss_type_slow(type, boss_type);
+    }
+    return m_type_vs_boss_type[index];
+}
+
+void MatchupTables::build_simulated() const{
+    std::call_once(m_simulated_once, [this]{
+        using namespace papkmnlib;
+
+        const size_t rental_count = rentals();
+        const size_t boss_count = bosses();
+
+        //  Bosses are looked up the same way as get_boss_candidates().
+        std::vector<const Pokemon*> rental_pokemon;
+        std::vector<const Pokemon*> boss_pokemon;
+        for (const auto& item : all_rental_pokemon()){
+            rental_pokemon.emplace_back(&item.second);
+        }
+        for (const std::string& slug : m_boss_slugs){
+            boss_pokemon.emplace_back(&get_pokemon(slug));
+        }
+
+        std::vector<double> table(rental_count * boss_count);
+        GlobalThreadPools::computation_normal().run_in_parallel(
+            [&](size_t rental){
+                for (size_t boss = 0; boss < boss_count; boss++){
+                    table[rental * boss_count + boss] =
+                        evaluate_matchup(*rental_pokemon[rental], *boss_pokemon[boss], {}, 4);
+                }
+            },
+            0, rental_count, 1
+        );
+        m_simulated = std::move(table);
+    });
+}
+double MatchupTables::rental_vs_boss_simulated(size_t rental, size_t boss) const{
+    build_simulated();
+    return m_simulated[rental * bosses() + boss];
+}
+
+
+
+
+//
+//  The implementations from before the tables. Only used to check that
+//  decisions don't change.
+//
+
+namespace{
+
+class SilentLogger : public Logger{
+public:
+    virtual void log(const std::string& msg, Color color) override{}
+};
+
+
+double reference_rental_vs_boss(
+    const std::string& rental,
+    const std::vector<const papkmnlib::Pokemon*>& bosses
+){
+    using namespace papkmnlib;
+
+    if (bosses.empty()){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Boss list cannot be empty.");
+    }
+    double score = 0;
+    if (rental.empty()){
+        for (const Pokemon* boss : bosses){
+            for (const auto& candidate : all_rental_pokemon()){
+                score += rental_vs_boss_matchup(candidate.first, boss->name());
+            }
+        }
+        score /= bosses.size() * all_rental_pokemon().size();
+    }else{
+        for (const Pokemon* boss : bosses){
+            score += rental_vs_boss_matchup(rental, boss->name());
+        }
+        score /= bosses.size();
+    }
+    return score;
+}
+double reference_evaluate_hypothetical_team(
+    const GlobalState& state,
+    const papkmnlib::Pokemon* team[4],
+    const std::vector<const papkmnlib::Pokemon*>& boss_candidates_on_path
+){
+    uint8_t lives = 4;
+
+    double total = 0;
+    for (size_t c = 0; c < 4; c++){
+        double score = reference_rental_vs_boss(
+            team[c] == nullptr ? "" : team[c]->name(),
+            boss_candidates_on_path
+        );
+        if (team[c] != nullptr){
+            double hp = team[c]->hp_ratio();
+            if (hp >= 0){
+                score *= (hp + lives - 1) / lives;
+            }
+        }
+        if (state.players[c].console_id < 0){
+            score *= 0.5;
+        }
+        total += score;
+    }
+    return total;
+}
+
+int8_t reference_select_starter(const GlobalState& state, const std::string options[3]){
+    using namespace papkmnlib;
+
+    std::vector<const Pokemon*> bosses = get_boss_candidates(state);
+    if (bosses.empty()){
+        return 0;
+    }
+    std::multimap<double, uint8_t, std::greater<double>> rank;
+    for (uint8_t c = 0; c < 3; c++){
+        if (options[c].empty()){
+            continue;
+        }
+        double score = 0;
+        for (const Pokemon* boss : bosses){
+            score += rental_vs_boss_matchup(options[c], boss->name());
+        }
+        score /= bosses.size();
+        rank.emplace(score, c);
+    }
+    if (rank.empty()){
+        return 0;
+    }
+    return rank.begin()->second;
+}
+
+std::vector<PathNode> reference_select_path(const GlobalState& state){
+    std::vector<std::vector<PathNode>> paths = generate_paths(state.path, state.wins, state.path_side);
+    if (paths.empty()){
+        return {};
+    }
+    const double weights[] = {1, 2, 3};
+    std::multimap<double, std::vector<PathNode>, std::greater<double>> rank;
+    for (const std::vector<PathNode>& path : paths){
+        double weight = 0;
+        size_t battle_index = 3 - path.size();
+        size_t node_index = 0;
+        for (; battle_index < 3; node_index++, battle_index++){
+            double score = state.boss.empty()
+                ? type_vs_boss_type_slow(path[node_index].type, state.path.boss)
+                : type_vs_boss(path[node_index].type, state.boss);
+            weight += score * weights[battle_index];
+        }
+        rank.emplace(weight, path);
+    }
+    return std::move(rank.begin()->second);
+}
+
+int8_t reference_swap(
+    const GlobalState& state,
+    const papkmnlib::Pokemon* replacement
+){
+    using namespace papkmnlib;
+
+    std::vector<const Pokemon*> boss_candidates_on_path = get_boss_candidates(state);
+
+    std::unique_ptr<Pokemon> current_team[4];
+    for (size_t c = 0; c < 4; c++){
+        current_team[c] = convert_player_to_pkmnlib(state.players[c]);
+    }
+
+    std::multimap<double, int8_t, std::greater<double>> rank;
+    for (int8_t c = -1; c < 4; c++){
+        const Pokemon* hypothetical_team[4];
+        for (size_t i = 0; i < 4; i++){
+            hypothetical_team[i] = current_team[i].get();
+        }
+        if (c >= 0){
+            hypothetical_team[c] = replacement;
+        }
+        rank.emplace(
+            reference_evaluate_hypothetical_team(state, hypothetical_team, boss_candidates_on_path),
+            c
+        );
+    }
+    return rank.begin()->second;
+}
+const papkmnlib::Pokemon* reference_professor_rental(const GlobalState& state){
+    using namespace papkmnlib;
+
+    std::multimap<double, const Pokemon*> list;
+    for (const Pokemon* boss : get_boss_candidates(state)){
+        for (const auto& rental : all_rental_pokemon()){
+            if (state.seen.find(rental.first) != state.seen.end()){
+                continue;
+            }
+            list.emplace(evaluate_matchup(rental.second, *boss, {}, 4), &rental.second);
+        }
+    }
+    if (list.empty()){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Opponent candidate list is empty.");
+    }
+    size_t midpoint = list.size() / 2;
+    for (size_t c = 0; c < midpoint; c++){
+        list.erase(list.begin());
+    }
+    return list.begin()->second;
+}
+
+
+
+GlobalState random_lobby_state(std::mt19937& rng){
+    const MatchupTables& tables = MatchupTables::instance();
+
+    auto random_int = [&](int min, int max){
+        return std::uniform_int_distribution<int>(min, max)(rng);
+    };
+    auto chance = [&](double probability){
+        return std::uniform_real_distribution<double>(0, 1)(rng) < probability;
+    };
+    auto random_type = [&](bool allow_none){
+        return (PokemonType)random_int(allow_none ? 0 : 1, (int)MatchupTables::TYPES - 1);
+    };
+
+    GlobalState state;
+    state.path.path_type = (int8_t)random_int(0, 2);
+    state.path.boss = random_type(true);
+    for (PokemonType& type : state.path.mon1){
+        type = random_type(false);
+    }
+    for (PokemonType& type : state.path.mon2){
+        type = random_type(false);
+    }
+    for (PokemonType& type : state.path.mon3){
+        type = random_type(false);
+    }
+    state.wins = (uint8_t)random_int(0, 2);
+    state.path_side = (int8_t)random_int(-1, 1);
+    if (chance(0.5)){
+        state.boss = tables.boss_slug(random_int(0, (int)tables.bosses() - 1));
+    }
+
+    for (size_t c = 0; c < 4; c++){
+        PlayerState& player = state.players[c];
+        player.console_id = chance(0.5) ? (int8_t)c : -1;
+        if (chance(0.9)){
+            player.pokemon = tables.rental_slug(random_int(0, (int)tables.rentals() - 1));
+            state.add_seen(player.pokemon);
+        }
+        Health health;
+        health.hp = chance(0.2) ? -1 : std::uniform_real_distribution<double>(0, 1)(rng);
+        health.dead = (int8_t)random_int(-1, 1);
+        player.health = health;
+    }
+    for (size_t c = 0; c < tables.rentals(); c++){
+        if (chance(0.1)){
+            state.add_seen(tables.rental_slug(c));
+        }
+    }
+
+    std::vector<std::vector<PathNode>> paths = generate_paths(state.path, state.wins, state.path_side);
+    if (!paths.empty()){
+        state.last_best_path = paths[random_int(0, (int)paths.size() - 1)];
+    }
+
+    return state;
+}
+
+bool same_path(const std::vector<PathNode>& x, const std::vector<PathNode>& y){
+    if (x.size() != y.size()){
+        return false;
+    }
+    for (size_t c = 0; c < x.size(); c++){
+        if (x[c].path_slot != y[c].path_slot || x[c].type != y[c].type){
+            return false;
+        }
+    }
+    return true;
+}
+bool same_score(double x, double y){
+    return x == y || (std::isnan(x) && std::isnan(y));
+}
+
+}
+
+
+
+class Test_MaxLairMatchupTables : public UnitTest{
+public:
+    Test_MaxLairMatchupTables()
+        : UnitTest("PokemonSwSh::MaxLair - Matchup Tables")
+    {}
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        using namespace papkmnlib;
+
+        const size_t STATES = 200;
+        const size_t PROFESSOR_STATES = 8;
+
+        SilentLogger silent;
+        std::mt19937 rng(42);
+
+        for (size_t type = 1; type < MatchupTables::TYPES; type++){
+            for (size_t boss_type = 0; boss_type < MatchupTables::TYPES; boss_type++){
+                double expected = type_vs_boss_type_slow((PokemonType)type, (PokemonType)boss_type);
+                double actual = type_vs_boss((PokemonType)type, (PokemonType)boss_type);
+                if (!same_score(expected, actual)){
+                    logger.log(
+                        "type_vs_boss(" + std::to_string(type) + ", " + std::to_string(boss_type) + ") changed.",
+                        COLOR_RED
+                    );
+                    return false;
+                }
+            }
+        }
+
+        for (size_t c = 0; c < STATES; c++){
+            scope.throw_if_cancelled();
+            GlobalState state = random_lobby_state(rng);
+            std::string prefix = "State " + std::to_string(c) + ": ";
+
+            //  Team score against the boss candidates.
+            std::vector<const Pokemon*> bosses = get_boss_candidates(state);
+            std::unique_ptr<Pokemon> team[4];
+            const Pokemon* team_ptrs[4];
+            for (size_t i = 0; i < 4; i++){
+                team[i] = convert_player_to_pkmnlib(state.players[i]);
+                team_ptrs[i] = team[i].get();
+            }
+            double expected_score = reference_evaluate_hypothetical_team(state, team_ptrs, bosses);
+            double actual_score = evaluate_hypothetical_team(
+                state, team_ptrs, get_rental_candidates_on_path_pkmnlib(state), bosses
+            );
+            if (!same_score(expected_score, actual_score)){
+                logger.log(prefix + "Team score changed.", COLOR_RED);
+                return false;
+            }
+
+            std::string options[3];
+            for (std::string& option : options){
+                if (std::uniform_int_distribution<int>(0, 9)(rng) != 0){
+                    option = MatchupTables::instance().rental_slug(
+                        std::uniform_int_distribution<size_t>(0, MatchupTables::instance().rentals() - 1)(rng)
+                    );
+                }
+            }
+            if (reference_select_starter(state, options) != select_starter(silent, state, 0, options)){
+                logger.log(prefix + "Starter changed.", COLOR_RED);
+                return false;
+            }
+
+            if (!same_path(reference_select_path(state), select_path(silent, state, 0))){
+                logger.log(prefix + "Path changed.", COLOR_RED);
+                return false;
+            }
+
+            if (!options[1].empty()){
+                int8_t expected = reference_swap(state, &get_pokemon(options[1]));
+                for (size_t player = 0; player < 4; player++){
+                    bool actual = should_swap_with_newly_caught(silent, state, player, options);
+                    if (actual != (expected == (int8_t)player)){
+                        logger.log(prefix + "Catch swap changed.", COLOR_RED);
+                        return false;
+                    }
+                }
+            }
+
+            if (c < PROFESSOR_STATES){
+                int8_t expected = reference_swap(state, reference_professor_rental(state));
+                for (size_t player = 0; player < 4; player++){
+                    bool actual = should_swap_with_professor(silent, state, player);
+                    if (actual != (expected == (int8_t)player)){
+                        logger.log(prefix + "Professor swap changed.", COLOR_RED);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+void add_tests_MaxLairMatchupTables(UnitTestDatabase& database){
+    database.add<Test_MaxLairMatchupTables>();
+}
+
+
+
+void benchmark_MaxLairMatchupTables(Logger& logger, size_t states){
+    using namespace papkmnlib;
+
+    auto elapsed_us = [](WallClock start){
+        return (double)std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count();
+    };
+
+    WallClock start = current_time();
+    const MatchupTables& tables = MatchupTables::instance();
+    logger.log("Build tables: " + tostr_fixed(elapsed_us(start) / 1000, 3) + " ms");
+
+    start = current_time();
+    tables.rental_vs_boss_simulated(0, 0);
+    logger.log(
+        "Build simulated tensor (" + std::to_string(tables.rentals()) + " x " +
+        std::to_string(tables.bosses()) + "): " + tostr_fixed(elapsed_us(start) / 1000, 3) + " ms"
+    );
+
+    std::mt19937 rng(0);
+    std::vector<GlobalState> lobbies;
+    for (size_t c = 0; c < states; c++){
+        lobbies.emplace_back(random_lobby_state(rng));
+    }
+    const std::string options[3] = {tables.rental_slug(0), tables.rental_slug(1), tables.rental_slug(2)};
+
+    SilentLogger silent;
+    auto report = [&](const char* name, double reference_us, double tables_us){
+        logger.log(
+            std::string(name) + ": " +
+            tostr_fixed(reference_us / states, 3) + " us -> " +
+            tostr_fixed(tables_us / states, 3) + " us per decision"
+        );
+    };
+
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        reference_select_path(state);
+    }
+    double reference_us = elapsed_us(start);
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        select_path(silent, state, 0);
+    }
+    report("Path", reference_us, elapsed_us(start));
+
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        reference_swap(state, &get_pokemon(options[1]));
+    }
+    reference_us = elapsed_us(start);
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        should_swap_with_newly_caught(silent, state, 0, options);
+    }
+    report("Catch Swap", reference_us, elapsed_us(start));
+
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        reference_swap(state, reference_professor_rental(state));
+    }
+    reference_us = elapsed_us(start);
+    start = current_time();
+    for (const GlobalState& state : lobbies){
+        should_swap_with_professor(silent, state, 0);
+    }
+    report("Professor Swap", reference_us, elapsed_us(start));
+}
+
+
+
+}
+}
+}
+}
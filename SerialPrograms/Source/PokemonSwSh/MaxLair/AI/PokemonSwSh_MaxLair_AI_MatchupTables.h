@@ -0,0 +1,105 @@
+/*  Max Lair AI Matchup Tables
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Dense index-keyed copies of the matchup LUTs. Rentals are indexed in
+ *  all_rental_pokemon() order and bosses in all_boss_pokemon() order.
+ *
+ *  The AI reads these instead of the nested string maps. Every value is
+ *  identical to what the string-keyed lookups return and all the callers
+ *  sum in the same order, so decisions don't change.
+ *
+ */
+
+#ifndef PokemonAutomation_PokemonSwSh_MaxLair_AI_MatchupTables_H
+#define PokemonAutomation_PokemonSwSh_MaxLair_AI_MatchupTables_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "Common/Cpp/TestRunners/UnitTest.h"
+#include "Pokemon/Pokemon_Types.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+namespace PokemonSwSh{
+namespace MaxLairInternal{
+using namespace Pokemon;
+
+
+
+class MatchupTables{
+public:
+    static const size_t NOT_FOUND = (size_t)0 - 1;
+    static const size_t TYPES = (size_t)PokemonType::FAIRY + 1;
+
+    static const MatchupTables& instance();
+
+    size_t rentals() const{ return m_rental_slugs.size(); }
+    size_t bosses() const{ return m_boss_slugs.size(); }
+
+    const std::string& rental_slug(size_t rental) const{ return m_rental_slugs[rental]; }
+    const std::string& boss_slug(size_t boss) const{ return m_boss_slugs[boss]; }
+
+    //  Returns NOT_FOUND if the slug isn't a rental/boss.
+    size_t rental_index(const std::string& slug) const;
+    size_t boss_index(const std::string& slug) const;
+
+
+public:
+    //  Same as rental_vs_boss_matchup(rental, boss).
+    double rental_vs_boss(size_t rental, size_t boss) const;
+
+    //  Same as type_vs_boss(type, boss).
+    double type_vs_boss(PokemonType type, size_t boss) const;
+
+    //  Same as type_vs_boss(type, boss_type). (average over all bosses of
+    //  that type)
+    double type_vs_boss_type(PokemonType type, PokemonType boss_type) const;
+
+    //  Same as evaluate_matchup(rental, boss, {}, 4). This is a full damage
+    //  calculation so it is built on first use across the computation pool.
+    double rental_vs_boss_simulated(size_t rental, size_t boss) const;
+
+
+private:
+    MatchupTables();
+    void build_simulated() const;
+
+    std::vector<std::string> m_rental_slugs;
+    std::vector<std::string> m_boss_slugs;
+    std::map<std::string, size_t> m_rental_indices;
+    std::map<std::string, size_t> m_boss_indices;
+
+    //  [rental][boss]. NaN if missing from the LUT.
+    std::vector<double> m_rental_vs_boss;
+
+    //  [type][boss]. NaN if missing from the LUT.
+    std::vector<double> m_type_vs_boss;
+
+    //  [type][boss type]
+    std::vector<double> m_type_vs_boss_type;
+    std::vector<bool> m_type_vs_boss_type_valid;
+
+    //  [rental][boss]
+    mutable std::once_flag m_simulated_once;
+    mutable std::vector<double> m_simulated;
+};
+
+
+
+void add_tests_MaxLairMatchupTables(UnitTestDatabase& database);
+
+//  Time the decisions against the string-keyed implementations over random
+//  lobby states.
+void benchmark_MaxLairMatchupTables(Logger& logger, size_t states);
+
+
+
+}
+}
+}
+}
+#endif
@@ -12,6 +12,7 @@
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "PokemonSwSh/Resources/PokemonSwSh_MaxLairDatabase.h"
 #include "PokemonSwSh/PkmnLib/PokemonSwSh_PkmnLib_Pokemon.h"
+#include "PokemonSwSh_MaxLair_AI_MatchupTables.h"
 #include "PokemonSwSh_MaxLair_AI_PathMatchup.h"
 
 namespace PokemonAutomation{
@@ -94,21 +95,7 @@ double type_vs_boss(PokemonType type, const std::string& boss_slug){
     return iter1->second;
 }
 double type_vs_boss(PokemonType type, PokemonType boss_type){
-    using namespace papkmnlib;
-
-    Type pkmnlib_type = serial_type_to_pkmnlib(boss_type);
-
-    double weight = 0;
-    size_t count = 0;
-    for (const auto& item : all_bosses_by_dex()){
-        const Pokemon& boss = get_pokemon(item.second);
-        if (boss_type == PokemonType::NONE || boss.has_type(pkmnlib_type)){
-            weight += type_vs_boss(type, boss.name());
-            count++;
-        }
-    }
-
-    return weight / (double)count;
+    return MatchupTables::instance().type_vs_boss_type(type, boss_type);
 }
 
 
@@ -227,8 +214,8 @@ std::vector<std::vector<PathNode>> generate_paths(
 }
 
 
-template <typename Boss>
-double evaluate_path(const Boss& boss, const std::vector<PathNode>& path){
+template <typename TypeVsBoss>
+double evaluate_path(TypeVsBoss&& type_vs_boss, const std::vector<PathNode>& path){
     if (path.size() > 3){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Path is longer than 3: " + std::to_string(path.size()));
     }
@@ -238,7 +225,7 @@ double evaluate_path(const Boss& boss, const std::vector<PathNode>& path){
     size_t battle_index = 3 - path.size();
     size_t node_index = 0;
     for (; battle_index < 3; node_index++, battle_index++){
-        weight += type_vs_boss(path[node_index].type, boss) * weights[battle_index];
+        weight += type_vs_boss(path[node_index].type) * weights[battle_index];
     }
     return weight;
 }
@@ -262,15 +249,28 @@ std::vector<PathNode> select_path(
         return {};
     }
 
+    //  There are at most a dozen paths and each one is 3 table reads. This
+    //  is cheaper than dispatching to a thread pool.
+    const MatchupTables& tables = MatchupTables::instance();
+    size_t boss_index = boss.empty() ? MatchupTables::NOT_FOUND : tables.boss_index(boss);
+
     std::multimap<double, std::vector<PathNode>, std::greater<double>> rank;
-    if (boss.empty()){
-        for (const std::vector<PathNode>& path : paths){
-            rank.emplace(evaluate_path(pathmap.boss, path), path);
-        }
-    }else{
-        for (const std::vector<PathNode>& path : paths){
-            rank.emplace(evaluate_path(boss, path), path);
+    for (const std::vector<PathNode>& path : paths){
+        double score;
+        if (boss.empty()){
+            score = evaluate_path([&](PokemonType type){
+                return tables.type_vs_boss_type(type, pathmap.boss);
+            }, path);
+        }else if (boss_index != MatchupTables::NOT_FOUND){
+            score = evaluate_path([&](PokemonType type){
+                return tables.type_vs_boss(type, boss_index);
+            }, path);
+        }else{
+            score = evaluate_path([&](PokemonType type){
+                return type_vs_boss(type, boss);
+            }, path);
         }
+        rank.emplace(score, path);
     }
     std::string str = "Available Paths:\n";
     for (const auto& path : rank){
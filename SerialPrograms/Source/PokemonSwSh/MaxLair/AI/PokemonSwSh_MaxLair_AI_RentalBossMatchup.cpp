@@ -10,6 +10,7 @@
 #include "Common/Cpp/Json/JsonObject.h"
 #include "CommonFramework/GlobalAutoPaths.h"
 #include "PokemonSwSh/PkmnLib/PokemonSwSh_PkmnLib_Pokemon.h"
+#include "PokemonSwSh_MaxLair_AI_MatchupTables.h"
 #include "PokemonSwSh_MaxLair_AI_RentalBossMatchup.h"
 
 namespace PokemonAutomation{
@@ -60,16 +61,31 @@ double rental_vs_boss_matchup(const std::string& rental, const std::string& boss
 double rental_vs_boss_matchup(const std::string& rental, const std::vector<std::string>& bosses){
     using namespace papkmnlib;
 
+    const MatchupTables& tables = MatchupTables::instance();
+    size_t rental_index = tables.rental_index(rental);
+
     double score = 0;
     if (bosses.empty()){
-        const auto& all_bosses = all_boss_pokemon();
-        for (const auto& boss : all_bosses){
-            score += rental_vs_boss_matchup(rental, boss.second.name());
+        if (rental_index == MatchupTables::NOT_FOUND){
+            const auto& all_bosses = all_boss_pokemon();
+            for (const auto& boss : all_bosses){
+                score += rental_vs_boss_matchup(rental, boss.second.name());
+            }
+        }else{
+            //  Table columns are in all_boss_pokemon() order.
+            for (size_t boss = 0; boss < tables.bosses(); boss++){
+                score += tables.rental_vs_boss(rental_index, boss);
+            }
         }
         score /= bosses.size();
     }else{
         for (const std::string& boss : bosses){
-            score += rental_vs_boss_matchup(rental, boss);
+            size_t boss_index = tables.boss_index(boss);
+            if (rental_index == MatchupTables::NOT_FOUND || boss_index == MatchupTables::NOT_FOUND){
+                score += rental_vs_boss_matchup(rental, boss);
+            }else{
+                score += tables.rental_vs_boss(rental_index, boss_index);
+            }
         }
         score /= bosses.size();
     }
@@ -9,6 +9,7 @@
 #include "PokemonSwSh/PkmnLib/PokemonSwSh_PkmnLib_Matchup.h"
 #include "PokemonSwSh_MaxLair_AI.h"
 #include "PokemonSwSh_MaxLair_AI_Tools.h"
+#include "PokemonSwSh_MaxLair_AI_MatchupTables.h"
 
 #include <iostream>
 using std::cout;
@@ -51,13 +52,20 @@ bool should_swap_with_professor(
 
 
     //  Find the "average" rental against this boss.
+    const MatchupTables& tables = MatchupTables::instance();
     std::multimap<double, const Pokemon*> list;
     for (const Pokemon* boss : boss_candidates_on_path){
+        size_t boss_index = tables.boss_index(boss->name());
+        size_t rental_index = 0;
         for (const auto& rental : all_rental_pokemon()){
+            size_t index = rental_index++;
             if (state.seen.find(rental.first) != state.seen.end()){
                 continue;
             }
-            list.emplace(evaluate_matchup(rental.second, *boss, {}, lives), &rental.second);
+            double score = boss_index == MatchupTables::NOT_FOUND
+                ? evaluate_matchup(rental.second, *boss, {}, lives)
+                : tables.rental_vs_boss_simulated(index, boss_index);
+            list.emplace(score, &rental.second);
         }
     }
     if (list.empty()){
@@ -12,6 +12,7 @@
 #include "PokemonSwSh_MaxLair_AI_Tools.h"
 #include "PokemonSwSh_MaxLair_AI_PathMatchup.h"
 #include "PokemonSwSh_MaxLair_AI_RentalBossMatchup.h"
+#include "PokemonSwSh_MaxLair_AI_MatchupTables.h"
 
 #include <iostream>
 using std::cout;
@@ -97,17 +98,35 @@ double rental_vs_boss_matchup(const std::string& rental, const std::vector<const
     if (bosses.empty()){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Boss list cannot be empty.");
     }
+    const MatchupTables& tables = MatchupTables::instance();
+
+    //  Same summation order as the string lookups so the scores are
+    //  bit-identical.
     double score = 0;
     if (rental.empty()){
         for (const Pokemon* boss : bosses){
-            for (const auto& candidate : all_rental_pokemon()){
-                score += rental_vs_boss_matchup(candidate.first, boss->name());
+            size_t boss_index = tables.boss_index(boss->name());
+            if (boss_index == MatchupTables::NOT_FOUND){
+                for (const auto& candidate : all_rental_pokemon()){
+                    score += rental_vs_boss_matchup(candidate.first, boss->name());
+                }
+                continue;
+            }
+            //  Table rows are in all_rental_pokemon() order.
+            for (size_t candidate = 0; candidate < tables.rentals(); candidate++){
+                score += tables.rental_vs_boss(candidate, boss_index);
             }
         }
         score /= bosses.size() * all_rental_pokemon().size();
     }else{
+        size_t rental_index = tables.rental_index(rental);
         for (const Pokemon* boss : bosses){
-            score += rental_vs_boss_matchup(rental, boss->name());
+            size_t boss_index = tables.boss_index(boss->name());
+            if (rental_index == MatchupTables::NOT_FOUND || boss_index == MatchupTables::NOT_FOUND){
+                score += rental_vs_boss_matchup(rental, boss->name());
+            }else{
+                score += tables.rental_vs_boss(rental_index, boss_index);
+            }
         }
         score /= bosses.size();
     }
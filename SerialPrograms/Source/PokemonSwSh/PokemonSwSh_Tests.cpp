@@ -12,6 +12,7 @@
 #include "PokemonSwSh/Inference/PokemonSwSh_YCommDetector.h"
 #include "PokemonSwSh/Inference/PokemonSwSh_SelectionArrowFinder.h"
 #include "PokemonSwSh/MaxLair/Inference/PokemonSwSh_MaxLair_Detect_BattleMenu.h"
+#include "PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_MatchupTables.h"
 #include "PokemonSwSh_Tests.h"
 
 namespace PokemonAutomation{
@@ -28,6 +29,7 @@ void add_tests(UnitTestDatabase& database){
     NintendoSwitch::PokemonSwSh::add_tests_YCommDetector(database);
     NintendoSwitch::PokemonSwSh::add_tests_SelectionArrowFinder(database);
     NintendoSwitch::PokemonSwSh::MaxLairInternal::add_tests_MaxLairBattleMenuDetector(database);
+    NintendoSwitch::PokemonSwSh::MaxLairInternal::add_tests_MaxLairMatchupTables(database);
 }
 
 
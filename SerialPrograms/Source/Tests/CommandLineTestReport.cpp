@@ -0,0 +1,180 @@
+/*  Command Line Test Report
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "CommandLineTestReport.h"
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+namespace PokemonAutomation{
+
+
+//  Ignore slowdowns smaller than this. Detectors that run in a fraction of a
+//  millisecond are too noisy to compare by ratio alone.
+const std::chrono::microseconds MIN_REGRESSION(1000);
+
+
+namespace{
+
+int64_t to_micros(WallDuration duration){
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+std::string tostr_ms(int64_t micros){
+    return tostr_fixed(micros / 1000., 3) + " ms";
+}
+
+}
+
+
+
+void CommandLineTestReport::add_file(
+    const std::string& detector,
+    const std::string& file_path,
+    int result,
+    WallDuration wall_time,
+    WallDuration cpu_time
+){
+    std::lock_guard<Mutex> lg(m_lock);
+    DetectorStats& stats = m_detectors[detector];
+    if (result < 0){
+        stats.skipped++;
+    }else if (result == 0){
+        stats.passed++;
+    }else{
+        stats.failed++;
+        m_failed_files.emplace_back(file_path);
+    }
+    stats.wall_time += wall_time;
+    stats.cpu_time += cpu_time;
+    if (stats.max_wall_time < wall_time){
+        stats.max_wall_time = wall_time;
+        stats.slowest_file = file_path;
+    }
+}
+
+void CommandLineTestReport::set_total_wall_time(WallDuration wall_time){
+    std::lock_guard<Mutex> lg(m_lock);
+    m_total_wall_time = wall_time;
+}
+
+size_t CommandLineTestReport::passed() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    size_t ret = 0;
+    for (const auto& item : m_detectors){
+        ret += item.second.passed;
+    }
+    return ret;
+}
+size_t CommandLineTestReport::failed() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    size_t ret = 0;
+    for (const auto& item : m_detectors){
+        ret += item.second.failed;
+    }
+    return ret;
+}
+std::vector<std::string> CommandLineTestReport::failed_files() const{
+    std::lock_guard<Mutex> lg(m_lock);
+    std::vector<std::string> ret = m_failed_files;
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+
+void CommandLineTestReport::print_summary() const{
+    std::lock_guard<Mutex> lg(m_lock);
+
+    std::vector<std::pair<WallDuration, const std::string*>> order;
+    for (const auto& item : m_detectors){
+        order.emplace_back(item.second.cpu_time, &item.first);
+    }
+    std::sort(order.rbegin(), order.rend());
+
+    cout << "Detector timings (total CPU / total wall / slowest file):" << endl;
+    for (const auto& item : order){
+        const DetectorStats& stats = m_detectors.find(*item.second)->second;
+        cout << "- " << *item.second
+             << ": " << stats.passed + stats.failed << " files, "
+             << tostr_ms(to_micros(stats.cpu_time)) << " / "
+             << tostr_ms(to_micros(stats.wall_time)) << " / "
+             << tostr_ms(to_micros(stats.max_wall_time)) << endl;
+    }
+    cout << "Total wall time: " << tostr_ms(to_micros(m_total_wall_time)) << endl;
+}
+
+
+JsonObject CommandLineTestReport::to_json() const{
+    std::lock_guard<Mutex> lg(m_lock);
+
+    JsonObject detectors;
+    for (const auto& item : m_detectors){
+        const DetectorStats& stats = item.second;
+        JsonObject obj;
+        obj["Passed"] = stats.passed;
+        obj["Failed"] = stats.failed;
+        obj["Skipped"] = stats.skipped;
+        obj["WallMicros"] = to_micros(stats.wall_time);
+        obj["CpuMicros"] = to_micros(stats.cpu_time);
+        obj["MaxWallMicros"] = to_micros(stats.max_wall_time);
+        obj["SlowestFile"] = stats.slowest_file;
+        detectors[item.first] = std::move(obj);
+    }
+
+    JsonObject ret;
+    ret["TotalWallMicros"] = to_micros(m_total_wall_time);
+    ret["Detectors"] = std::move(detectors);
+    return ret;
+}
+void CommandLineTestReport::save(const std::string& path) const{
+    to_json().dump(path);
+}
+
+
+std::vector<std::string> CommandLineTestReport::compare_to_baseline(const std::string& path, double tolerance) const{
+    JsonValue json = load_json_file(path);
+    const JsonObject& baseline = json.to_object_throw(path).get_object_throw("Detectors", path);
+
+    std::vector<std::string> ret;
+
+    std::lock_guard<Mutex> lg(m_lock);
+    for (const auto& item : m_detectors){
+        const JsonObject* old_stats = baseline.get_object(item.first);
+        if (old_stats == nullptr){
+            continue;
+        }
+
+        size_t old_files = old_stats->get_integer_default("Passed") + old_stats->get_integer_default("Failed");
+        size_t new_files = item.second.passed + item.second.failed;
+        if (old_files == 0 || new_files == 0){
+            continue;
+        }
+
+        int64_t old_average = old_stats->get_integer_default("CpuMicros") / old_files;
+        int64_t new_average = to_micros(item.second.cpu_time) / new_files;
+        if (new_average - old_average < MIN_REGRESSION.count()){
+            continue;
+        }
+        if (new_average <= old_average * tolerance){
+            continue;
+        }
+
+        ret.emplace_back(
+            item.first + ": " + tostr_ms(old_average) + " -> " + tostr_ms(new_average) +
+            " per file (" + tostr_fixed(old_average == 0 ? 0. : (double)new_average / old_average, 2) + "x)"
+        );
+    }
+    return ret;
+}
+
+
+
+}
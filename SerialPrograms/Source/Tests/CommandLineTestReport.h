@@ -0,0 +1,77 @@
+/*  Command Line Test Report
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Per-detector pass/fail counts and timings for the command line tests.
+ *
+ *  The report can be saved as JSON and a later run can be compared against
+ *  it to find detectors that have become slower.
+ *
+ */
+
+#ifndef PokemonAutomation_Tests_CommandLineTestReport_H
+#define PokemonAutomation_Tests_CommandLineTestReport_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/Mutex.h"
+
+namespace PokemonAutomation{
+
+class JsonObject;
+
+
+class CommandLineTestReport{
+public:
+    //  "detector" is "<test space>/<test object>". e.g. "PokemonLA/BattleMenuDetector"
+    //  "result" is the return value of the TestFunction.
+    //  Thread-safe.
+    void add_file(
+        const std::string& detector,
+        const std::string& file_path,
+        int result,
+        WallDuration wall_time,
+        WallDuration cpu_time
+    );
+
+    void set_total_wall_time(WallDuration wall_time);
+
+    size_t passed() const;
+    size_t failed() const;
+    std::vector<std::string> failed_files() const;
+
+    //  Print a table of all the detectors sorted by total CPU time.
+    void print_summary() const;
+
+    JsonObject to_json() const;
+    void save(const std::string& path) const;
+
+    //  Compare against a report previously written by save().
+    //  Returns a description of each detector whose average CPU time per
+    //  tested file exceeds the baseline by more than "tolerance" times.
+    std::vector<std::string> compare_to_baseline(const std::string& path, double tolerance) const;
+
+
+private:
+    struct DetectorStats{
+        size_t passed = 0;
+        size_t failed = 0;
+        size_t skipped = 0;
+        WallDuration wall_time = WallDuration::zero();
+        WallDuration cpu_time = WallDuration::zero();
+        WallDuration max_wall_time = WallDuration::zero();
+        std::string slowest_file;
+    };
+
+    mutable Mutex m_lock;
+    std::map<std::string, DetectorStats> m_detectors;
+    std::vector<std::string> m_failed_files;
+    WallDuration m_total_wall_time = WallDuration::zero();
+};
+
+
+
+}
+#endif
@@ -7,16 +7,22 @@
 
 #include "CommandLineTests.h"
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/CpuUtilization/CpuUtilization.h"
+#include "Common/Cpp/TestRunners/ParallelUnitTestRunner.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "ComputerPrograms/UnitTestRunner.h"
 #include "TestMap.h"
+#include "CommandLineTestReport.h"
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QImageReader>
 
 #include <iostream>
 #include <list>
+#include <set>
 #include <functional>
 using std::cout;
 using std::cerr;
@@ -44,26 +50,108 @@ void print_equals(){
         } \
     } while (0)
 
-#define RETURN_IF_TEST_FAILED(test_func, file_path, num_passed) \
-    do { \
-        int _ret = 0; \
-        try{ \
-            _ret = test_func(file_path); \
-        }catch (const std::exception& e){ \
-            cout << "Test: " << (file_path) << " threw exception: " << e.what() << endl; \
-            _ret = 1; \
-        }catch (const Exception& e){\
-           cout << "Test: " << (file_path) << " threw " << e.name() << ": <<<" << e.message() << ">>>" << endl; \
-           _ret = 1; \
-        } \
-        if (_ret > 0){\
-            print_equals(); \
-            cout << "Test: " << (file_path) << " failed." << endl; \
-            return _ret; \
-        }else if (_ret == 0){ \
-            num_passed++; \
-        } \
-    }while (0)
+// Run one test file and record its timing into "report".
+// Returns the value of the test function. Exceptions count as failures.
+int run_test_file(
+    CommandLineTestReport& report,
+    const std::string& detector, const TestFunction& test_func,
+    const std::string& file_path
+){
+    const ThreadHandle thread = current_thread_handle();
+    const WallDuration cpu_start = thread_cpu_time(thread);
+    const WallClock wall_start = current_time();
+
+    int ret = 0;
+    try{
+        ret = test_func(file_path);
+    }catch (const std::exception& e){
+        cout << "Test: " << file_path << " threw exception: " << e.what() << endl;
+        ret = 1;
+    }catch (const Exception& e){
+        cout << "Test: " << file_path << " threw " << e.name() << ": <<<" << e.message() << ">>>" << endl;
+        ret = 1;
+    }
+
+    const WallDuration wall_time = current_time() - wall_start;
+    const WallDuration cpu_time = thread_cpu_time(thread) - cpu_start;
+    report.add_file(detector, file_path, ret, wall_time, cpu_time);
+    return ret;
+}
+
+
+// A rough upper bound of the memory needed to run a test file. This is only
+// used to keep the parallel runner from loading too many large files at once.
+uint64_t estimate_test_memory(const std::string& file_path){
+    const QString path = QString::fromStdString(file_path);
+    const QSize image_size = QImageReader(path).size();
+    if (image_size.isValid()){
+        // The decoded image plus a few working copies made by the detector.
+        return (uint64_t)image_size.width() * image_size.height() * sizeof(uint32_t) * 4;
+    }
+    // Audio and video files expand several times once decoded.
+    return (uint64_t)QFileInfo(path).size() * 8;
+}
+
+
+// Wraps a single test file so it can be scheduled by UnitTestRunner.
+class CorpusFileTest : public UnitTest{
+public:
+    CorpusFileTest(
+        CommandLineTestReport& report,
+        std::string detector, TestFunction test_func,
+        const std::string& file_path
+    )
+        : UnitTest(file_path)
+        , m_report(report)
+        , m_detector(std::move(detector))
+        , m_test_func(std::move(test_func))
+    {
+        m_memory = estimate_test_memory(file_path);
+    }
+
+    virtual UnitTestResult run(Logger& logger, CancellableScope& scope) const override{
+        int ret = run_test_file(m_report, m_detector, m_test_func, m_name);
+        if (ret < 0){
+            return UnitTestResult(UnitTestResult::SKIPPED, "Not a test file.");
+        }
+        if (ret > 0){
+            return "Test function returned " + std::to_string(ret) + ".";
+        }
+        return true;
+    }
+
+private:
+    CommandLineTestReport& m_report;
+    const std::string m_detector;
+    const TestFunction m_test_func;
+};
+
+struct CorpusFile{
+    std::string detector;
+    TestFunction test_func;
+    std::string file_path;
+};
+
+// Run all the collected test files across the computation thread pool.
+// Unlike the serial mode, this does not stop at the first failure.
+void run_corpus_parallel(CommandLineTestReport& report, const std::vector<CorpusFile>& corpus){
+    print_equals();
+    cout << "Running " << corpus.size() << " test files in parallel..." << endl;
+
+    UnitTestRunner runner(
+        global_logger_command_line(),
+        GlobalThreadPools::computation_normal()
+    );
+    for (const CorpusFile& file : corpus){
+        runner.add_test<CorpusFileTest>(report, file.detector, file.test_func, file.file_path);
+    }
+    runner.run();
+}
+
+// Called on every test file found in the test folders.
+// "detector" is "<test space>/<test object>", e.g. "PokemonLA/BattleMenuDetector".
+// Return non-zero to stop looking for more files.
+using TestFileVisitor = std::function<int(const std::string& detector, const TestFunction& test_func, const std::string& file_path)>;
 
 bool skip_ignored_path(const QString& file_path, const std::vector<QString>& ignore_list){
     for (const auto& path_prefix : ignore_list){
@@ -75,16 +163,14 @@ bool skip_ignored_path(const QString& file_path, const std::vector<QString>& ign
     return false;
 }
 
-int run_test_obj_dir(TestFunction test_func, const QString& directory_path, size_t& num_passed, const std::vector<QString>& ignore_list){
+int run_test_obj_dir(
+    const std::string& detector, const TestFunction& test_func,
+    const QString& directory_path,
+    const TestFileVisitor& visitor, const std::vector<QString>& ignore_list
+){
     QDirIterator file_iter(directory_path, QDir::Filter::Files, QDirIterator::IteratorFlag::Subdirectories);
 
-    bool first_test_file = true;
     while (file_iter.hasNext()){
-        if (first_test_file == false){
-            cout << "-------------------------------------------" << endl;
-        }
-        first_test_file = false;
-
         const QString next_file = file_iter.next();
         
         // If filename or folder name starts with _, its considered a "hidden" file so skip it.
@@ -99,9 +185,7 @@ int run_test_obj_dir(TestFunction test_func, const QString& directory_path, size
             continue;
         }
 
-        // Call the function to do the actual test:
-        cout << file_path << endl;
-        RETURN_IF_TEST_FAILED(test_func, file_path, num_passed);
+        RETURN_IF_NOT_ZERO(visitor(detector, test_func, file_path));
     }
 
     return 0;
@@ -109,7 +193,7 @@ int run_test_obj_dir(TestFunction test_func, const QString& directory_path, size
 
 // Run the tests inside a folder representing a "test object".
 // It is usually defined as one detector, e.g. CommandLineTests/PokemonLA/BattleMenuDetector/
-int run_test_obj(const std::string& test_space, const QFileInfo& obj_info, size_t& num_passed, const std::vector<QString>& ignore_list){
+int run_test_obj(const std::string& test_space, const QFileInfo& obj_info, const TestFileVisitor& visitor, const std::vector<QString>& ignore_list){
     const std::string test_name = obj_info.fileName().toStdString();
     if (test_name == "." || test_name == ".."){
         return 0;
@@ -130,12 +214,12 @@ int run_test_obj(const std::string& test_space, const QFileInfo& obj_info, size_
 
     // Recursively get test filenames, like:
     // ./CommandLineTests/PokemonLA/BattleMenuDetector/IngoBattleMenuDayTime_True.png
-    return run_test_obj_dir(test_func, obj_info.filePath(), num_passed, ignore_list);
+    return run_test_obj_dir(test_space + "/" + test_name, test_func, obj_info.filePath(), visitor, ignore_list);
 }
 
 // Run the tests inside a folder representing a "test space".
 // It is usually defined as one pokemon game, e.g. CommandLineTests/PokemonLA/
-int run_test_space(const QFileInfo& space_info, size_t& num_passed, const std::vector<QString>& ignore_list){
+int run_test_space(const QFileInfo& space_info, const TestFileVisitor& visitor, const std::vector<QString>& ignore_list){
     QDir sub_dir(space_info.filePath());
     if (!sub_dir.exists()){
         cerr << "Error: cannot access " << space_info.filePath().toStdString() << endl;
@@ -157,7 +241,7 @@ int run_test_space(const QFileInfo& space_info, size_t& num_passed, const std::v
     // ./CommandLineTests/PokemonLA/BattleMenuDetector/
     const QFileInfoList obj_list = sub_dir.entryInfoList();
     for (const QFileInfo& obj_info : obj_list){
-        RETURN_IF_NOT_ZERO(run_test_obj(test_space, obj_info, num_passed, ignore_list));
+        RETURN_IF_NOT_ZERO(run_test_obj(test_space, obj_info, visitor, ignore_list));
     }
 
     return 0;
@@ -192,14 +276,50 @@ int run_command_line_tests(){
     QFileInfo test_root_info(root_folder_name.c_str());
     cout << "Looking for tests under test root folder: " << root_folder_name << endl;
 
-    size_t num_passed = 0;
+    const GlobalSettings& settings = GlobalSettings::instance();
+    const bool parallel = settings.COMMAND_LINE_TEST_PARALLEL;
+    CommandLineTestReport report;
+    const WallClock start_time = current_time();
+
+    // In parallel mode, the folders are walked first to collect all the test
+    // files. They are run afterwards by run_corpus_parallel().
+    std::vector<CorpusFile> corpus;
+    std::set<std::string> corpus_paths;
+    bool first_test_file = true;
+
+    TestFileVisitor visitor;
+    if (parallel){
+        visitor = [&](const std::string& detector, const TestFunction& test_func, const std::string& file_path){
+            // The same file can be reached from overlapping entries in TEST_LIST.
+            if (corpus_paths.insert(file_path).second){
+                corpus.emplace_back(CorpusFile{detector, test_func, file_path});
+            }
+            return 0;
+        };
+    }else{
+        visitor = [&](const std::string& detector, const TestFunction& test_func, const std::string& file_path){
+            if (first_test_file == false){
+                cout << "-------------------------------------------" << endl;
+            }
+            first_test_file = false;
+
+            cout << file_path << endl;
+            int ret = run_test_file(report, detector, test_func, file_path);
+            if (ret > 0){
+                print_equals();
+                cout << "Test: " << file_path << " failed." << endl;
+                return ret;
+            }
+            return 0;
+        };
+    }
 
     const auto& selected_test_list = GlobalSettings::instance().COMMAND_LINE_TEST_LIST;
 
     // The ignore list will be used to skip path.
     // The ignore list functions as path prefixes when determining which path to skip.
     std::vector<QString> ignore_list;
-    for (const std::string& ignore_path : GlobalSettings::instance().COMMAND_LINE_IGNORE_LIST){
+    for (const std::string& ignore_path : settings.COMMAND_LINE_IGNORE_LIST){
         QString path_cleaned = QDir::cleanPath(QString::fromStdString(root_folder_name + "/" + ignore_path));
         // Remove the trailing '/' or '\\' to make sure it can match the input path
         // without the trailing '/' or '\\'.
@@ -217,7 +337,7 @@ int run_command_line_tests(){
         test_root_dir.setFilter(QDir::Filter::Dirs);
         const QFileInfoList sub_dir_list = test_root_dir.entryInfoList();
         for (const QFileInfo& sub_dir_info : sub_dir_list){
-            RETURN_IF_NOT_ZERO(run_test_space(sub_dir_info, num_passed, ignore_list));
+            RETURN_IF_NOT_ZERO(run_test_space(sub_dir_info, visitor, ignore_list));
         }
     }else{
         // Only run on selected tests
@@ -270,7 +390,7 @@ int run_command_line_tests(){
             QFileInfo test_space_info(cur_dir.filePath(*it));
             cur_dir = QDir(test_space_info.filePath());
             if (path_components.size() == 1){
-                RETURN_IF_NOT_ZERO(run_test_space(test_space_info, num_passed, ignore_list));
+                RETURN_IF_NOT_ZERO(run_test_space(test_space_info, visitor, ignore_list));
                 continue;
             }
 
@@ -278,7 +398,7 @@ int run_command_line_tests(){
             std::string test_name = it->toStdString();
             QFileInfo test_obj_info(cur_dir.filePath(*it));
             if (path_components.size() == 2){
-                RETURN_IF_NOT_ZERO(run_test_obj(test_space, test_obj_info, num_passed, ignore_list));
+                RETURN_IF_NOT_ZERO(run_test_obj(test_space, test_obj_info, visitor, ignore_list));
                 continue;
             }
 
@@ -288,17 +408,61 @@ int run_command_line_tests(){
             }
 
             print_equals();
+            const std::string detector = test_space + "/" + test_name;
             if (selected_path_info.isFile()){
                 // Call the function to do the actual test:
-                RETURN_IF_TEST_FAILED(test_func, full_path_cleaned.toStdString(), num_passed);
+                RETURN_IF_NOT_ZERO(visitor(detector, test_func, full_path_cleaned.toStdString()));
             }else{
                 // selected_path_info is a directory, go through each file recursively in the directory
-                RETURN_IF_NOT_ZERO(run_test_obj_dir(test_func, full_path_cleaned, num_passed, ignore_list));
+                RETURN_IF_NOT_ZERO(run_test_obj_dir(detector, test_func, full_path_cleaned, visitor, ignore_list));
             }
         } // end selected_test_list
     }
 
+    if (parallel){
+        run_corpus_parallel(report, corpus);
+    }
+    report.set_total_wall_time(current_time() - start_time);
+
     print_equals();
+    report.print_summary();
+
+    if (!settings.COMMAND_LINE_TEST_TIMING_REPORT.empty()){
+        report.save(settings.COMMAND_LINE_TEST_TIMING_REPORT);
+        cout << "Timing report saved to " << settings.COMMAND_LINE_TEST_TIMING_REPORT << endl;
+    }
+    if (!settings.COMMAND_LINE_TEST_TIMING_BASELINE.empty()){
+        print_equals();
+        std::vector<std::string> regressions;
+        try{
+            regressions = report.compare_to_baseline(
+                settings.COMMAND_LINE_TEST_TIMING_BASELINE,
+                settings.COMMAND_LINE_TEST_TIMING_TOLERANCE
+            );
+        }catch (const Exception& e){
+            cout << "Unable to read timing baseline: " << e.message() << endl;
+        }
+        if (regressions.empty()){
+            cout << "No detector is slower than the timing baseline." << endl;
+        }else{
+            cout << "Detectors slower than the timing baseline:" << endl;
+            for (const std::string& line : regressions){
+                cout << "- " << line << endl;
+            }
+        }
+    }
+
+    print_equals();
+    const std::vector<std::string> failed_files = report.failed_files();
+    for (const std::string& file_path : failed_files){
+        cout << "Test: " << file_path << " failed." << endl;
+    }
+    if (!failed_files.empty()){
+        cout << failed_files.size() << " test" << (failed_files.size() > 1 ? "s" : "") << " failed" << std::endl;
+        return 1;
+    }
+
+    const size_t num_passed = report.passed();
     cout << num_passed << " test" << (num_passed > 1 ? "s" : "") << " passed" << std::endl;
     return 0;
 }
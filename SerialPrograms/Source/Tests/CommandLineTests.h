@@ -49,6 +49,16 @@
  * or serving as an extra file in case some tests need more than one test files. Files whose parent directory name starts with "_"
  * are skipped as well.
  * 
+ *  By default the test files are run one by one and the run stops at the first failure.
+ *  Set "20-GlobalSettings": "COMMAND_LINE_TESTS": "PARALLEL" to true to run them in parallel on the computation thread
+ *  pool and list all failures at the end.
+ *  Detectors that keep mutable global state must be safe to call from multiple threads to be tested in parallel.
+ * 
+ *  To record the pass/fail counts, CPU time and wall time of every detector, set
+ *  "20-GlobalSettings": "COMMAND_LINE_TESTS": "TIMING_REPORT" to the JSON file to write. To catch performance regressions, keep a report from a
+ *  known-good build and point "TIMING_BASELINE" to it. Detectors whose average CPU time per file grows by more than
+ *  "TIMING_TOLERANCE" times (default 1.5) are listed at the end of the run.
+ * 
  *  How to add new test code:
  * 
  *  The test framework calls TestMap.h: find_test_function(test_space, test_obj_name) to find the test function related to a test path.
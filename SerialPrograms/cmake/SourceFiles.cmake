@@ -68,6 +68,10 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/Containers/Pimpl.tpp
     ../Common/Cpp/Containers/SparseArray.cpp
     ../Common/Cpp/Containers/SparseArray.h
+    ../Common/Cpp/CpuAffinity/CpuAffinity.cpp
+    ../Common/Cpp/CpuAffinity/CpuAffinity.h
+    ../Common/Cpp/CpuAffinity/CpuAffinity_Linux.tpp
+    ../Common/Cpp/CpuAffinity/CpuAffinity_Windows.tpp
     ../Common/Cpp/CpuId/CpuId.cpp
     ../Common/Cpp/CpuId/CpuId.h
     ../Common/Cpp/CpuId/CpuId_arm64.h
@@ -82,6 +86,8 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/CpuUtilization/CpuUtilization_Windows.tpp
     ../Common/Cpp/Cryptography/SHA256.cpp
     ../Common/Cpp/Cryptography/SHA256.h
+    ../Common/Cpp/Cryptography/SHA256_arm64_SHA2.cpp
+    ../Common/Cpp/Cryptography/SHA256_x64_SHA.cpp
     ../Common/Cpp/DateTime.h
     ../Common/Cpp/EarlyShutdown.h
     ../Common/Cpp/EnumStringMap.h
@@ -112,6 +118,8 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/Json/JsonArray.h
     ../Common/Cpp/Json/JsonObject.cpp
     ../Common/Cpp/Json/JsonObject.h
+    ../Common/Cpp/Json/JsonParser.cpp
+    ../Common/Cpp/Json/JsonParser.h
     ../Common/Cpp/Json/JsonTools.cpp
     ../Common/Cpp/Json/JsonTools.h
     ../Common/Cpp/Json/JsonValue.cpp
@@ -228,10 +236,14 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/Strings/Unicode.h
     ../Common/Cpp/TestRunners/UnitTest.h
     ../Common/Cpp/TestRunners/UnitTestDatabase.h
+    ../Common/Cpp/TestRunners/UnitTestTempFolder.cpp
+    ../Common/Cpp/TestRunners/UnitTestTempFolder.h
     ../Common/Cpp/TestRunners/ParallelUnitTestRunner.cpp
     ../Common/Cpp/TestRunners/ParallelUnitTestRunner.h
     ../Common/Cpp/Time.cpp
     ../Common/Cpp/Time.h
+    ../Common/Cpp/Tracing/Tracing.cpp
+    ../Common/Cpp/Tracing/Tracing.h
     ../Common/Cpp/UiWrapper.h
     ../Common/Cpp/ValueDebouncer.h
     ../Common/CRC32/pabb_CRC32.c
@@ -327,6 +339,7 @@ file(GLOB LIBRARY_SOURCES
     ../Common/PABotBase2/Controllers/PABotBase2_Controller_NS1_OemController.h
     ../Common/PABotBase2/PABotBase2CC_MessageDumper.cpp
     ../Common/PABotBase2/PABotBase2CC_MessageDumper.h
+    ../Common/PABotBase2/PABotBase2FW_CommandBatch.h
     ../Common/PABotBase2/PABotBase2_MessageProtocol.h
     ../Common/SerialPABotBase/SerialPABotBase_Messages_HID_Keyboard.h
     ../Common/SerialPABotBase/SerialPABotBase_Messages_NS1_OemControllers.h
@@ -417,6 +430,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/ImageTools/ImageBoxes.h
     Source/CommonFramework/ImageTools/ImageDiff.cpp
     Source/CommonFramework/ImageTools/ImageDiff.h
+    Source/CommonFramework/ImageTools/ImageSignature.cpp
+    Source/CommonFramework/ImageTools/ImageSignature.h
     Source/CommonFramework/ImageTools/ImageStats.cpp
     Source/CommonFramework/ImageTools/ImageStats.h
     Source/CommonFramework/ImageTypes/BinaryImage.cpp
@@ -472,6 +487,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Options/Environment/SleepSuppressOption.h
     Source/CommonFramework/Options/Environment/ThemeSelectorOption.cpp
     Source/CommonFramework/Options/Environment/ThemeSelectorOption.h
+    Source/CommonFramework/Options/Environment/ThreadAffinityOption.cpp
+    Source/CommonFramework/Options/Environment/ThreadAffinityOption.h
     Source/CommonFramework/Options/LabelCellOption.cpp
     Source/CommonFramework/Options/LabelCellOption.h
     Source/CommonFramework/Options/NestedBoxDrawOption.cpp
@@ -517,6 +534,7 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Recording/StreamHistoryOption.h
     Source/CommonFramework/Recording/StreamHistorySession.cpp
     Source/CommonFramework/Recording/StreamHistorySession.h
+    Source/CommonFramework/Recording/StreamHistoryStats.h
     Source/CommonFramework/Recording/StreamHistoryTracker_Null.h
     Source/CommonFramework/Recording/StreamHistoryTracker_ParallelStreams.h
     Source/CommonFramework/Recording/StreamHistoryTracker_RecordOnTheFly.h
@@ -550,6 +568,18 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Startup/NewVersionCheck.h
     Source/CommonFramework/Startup/SetupSettings.cpp
     Source/CommonFramework/Startup/SetupSettings.h
+    Source/CommonFramework/Tests/CommonFramework_Tests.cpp
+    Source/CommonFramework/Tests/CommonFramework_Tests.h
+    Source/CommonFramework/Tests/FileTools_Tests.cpp
+    Source/CommonFramework/Tests/FileTools_Tests.h
+    Source/CommonFramework/Tests/ImageEncoder_Tests.cpp
+    Source/CommonFramework/Tests/ImageEncoder_Tests.h
+    Source/CommonFramework/Tests/ImageSignature_Tests.cpp
+    Source/CommonFramework/Tests/ImageSignature_Tests.h
+    Source/CommonFramework/Tests/Json_Tests.cpp
+    Source/CommonFramework/Tests/Json_Tests.h
+    Source/CommonFramework/Tests/ProgramStats_Tests.cpp
+    Source/CommonFramework/Tests/ProgramStats_Tests.h
     Source/CommonFramework/Tools/DebugDumper.cpp
     Source/CommonFramework/Tools/DebugDumper.h
     Source/CommonFramework/Tools/ErrorDumper.cpp
@@ -562,10 +592,20 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/Tools/FileUnzip.h
     Source/CommonFramework/Tools/GlobalThreadPools.cpp
     Source/CommonFramework/Tools/GlobalThreadPools.h
+    Source/CommonFramework/Tools/ImageEncoder.cpp
+    Source/CommonFramework/Tools/ImageEncoder.h
+    Source/CommonFramework/Tools/InputLatencyDatabase.cpp
+    Source/CommonFramework/Tools/InputLatencyDatabase.h
     Source/CommonFramework/Tools/ProgramEnvironment.cpp
     Source/CommonFramework/Tools/ProgramEnvironment.h
     Source/CommonFramework/Tools/StatAccumulator.cpp
     Source/CommonFramework/Tools/StatAccumulator.h
+    Source/CommonFramework/Tools/TelemetryFile.cpp
+    Source/CommonFramework/Tools/TelemetryFile.h
+    Source/CommonFramework/Tools/TelemetryRecorder.cpp
+    Source/CommonFramework/Tools/TelemetryRecorder.h
+    Source/CommonFramework/Tools/ThreadAffinityPolicy.cpp
+    Source/CommonFramework/Tools/ThreadAffinityPolicy.h
     Source/CommonFramework/Tools/VideoStream.cpp
     Source/CommonFramework/Tools/VideoStream.h
     Source/CommonFramework/VideoPipeline/Backends/CameraImplementations.cpp
@@ -689,9 +729,13 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonTools/Images/ImageTools.h
     Source/CommonTools/Images/SolidColorTest.cpp
     Source/CommonTools/Images/SolidColorTest.h
+    Source/CommonTools/Images/WaterfillCellGrid.cpp
+    Source/CommonTools/Images/WaterfillCellGrid.h
     Source/CommonTools/Images/WaterfillUtilities.cpp
     Source/CommonTools/Images/WaterfillUtilities.h
     Source/CommonTools/InferenceCallbacks/AudioInferenceCallback.h
+    Source/CommonTools/InferenceCallbacks/ChangeGatedInferenceCallback.cpp
+    Source/CommonTools/InferenceCallbacks/ChangeGatedInferenceCallback.h
     Source/CommonTools/InferenceCallbacks/InferenceCallback.h
     Source/CommonTools/InferenceCallbacks/VisualInferenceCallback.cpp
     Source/CommonTools/InferenceCallbacks/VisualInferenceCallback.h
@@ -752,6 +796,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonTools/StartupChecks/VideoResolutionCheck.h
     Source/CommonTools/TrendInference/AnomalyDetector.cpp
     Source/CommonTools/TrendInference/AnomalyDetector.h
+    Source/CommonTools/TrendInference/SlidingWindowStats.cpp
+    Source/CommonTools/TrendInference/SlidingWindowStats.h
     Source/CommonTools/TrendInference/TimeWindowStatTracker.h
     Source/CommonTools/VisualDetector.h
     Source/CommonTools/VisualDetectors/BlackBorderDetector.cpp
@@ -1030,6 +1076,12 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX2.cpp
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX512.cpp
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_SSE41.cpp
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor.cpp
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor.h
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor_Default.cpp
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor_arm64_NEON.cpp
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor_x64_AVX2.cpp
+    Source/Kernels/ImageToTensor/Kernels_ImageToTensor_x64_SSE41.cpp
     Source/Kernels/Kernels_Alignment.h
     Source/Kernels/Kernels_BitScan.h
     Source/Kernels/Kernels_BitSet.h
@@ -1088,6 +1140,8 @@ file(GLOB LIBRARY_SOURCES
     Source/ML/DataLabeling/ML_AnnotationIO.h
     Source/ML/DataLabeling/ML_ObjectAnnotation.cpp
     Source/ML/DataLabeling/ML_ObjectAnnotation.h
+    Source/ML/DataLabeling/ML_SegmentAnythingEmbeddingJob.cpp
+    Source/ML/DataLabeling/ML_SegmentAnythingEmbeddingJob.h
     Source/ML/DataLabeling/ML_SegmentAnythingModel.cpp
     Source/ML/DataLabeling/ML_SegmentAnythingModel.h
     Source/ML/DataLabeling/ML_SegmentAnythingModelConstants.h
@@ -1165,7 +1219,11 @@ file(GLOB LIBRARY_SOURCES
     Source/NintendoSwitch/Controllers/SerialPABotBase/NintendoSwitch_SerialPABotBase_Controller.h
     Source/NintendoSwitch/Controllers/SerialPABotBase/NintendoSwitch_SerialPABotBase_WiredController.cpp
     Source/NintendoSwitch/Controllers/SerialPABotBase/NintendoSwitch_SerialPABotBase_WiredController.h
+    Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_CommandPipeline.cpp
+    Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_CommandPipeline.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_ControllerState.h
+    Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_FakeServer.cpp
+    Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_FakeServer.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_ProController.cpp
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase3_ProController.h
     Source/NintendoSwitch/Controllers/SysbotBase/SysbotBase_Connection.cpp
@@ -1295,6 +1353,8 @@ file(GLOB LIBRARY_SOURCES
     Source/NintendoSwitch/Programs/NintendoSwitch_FriendDelete.h
     Source/NintendoSwitch/Programs/NintendoSwitch_GameEntry.cpp
     Source/NintendoSwitch/Programs/NintendoSwitch_GameEntry.h
+    Source/NintendoSwitch/Programs/NintendoSwitch_InputLatencyCalibrator.cpp
+    Source/NintendoSwitch/Programs/NintendoSwitch_InputLatencyCalibrator.h
     Source/NintendoSwitch/Programs/NintendoSwitch_MenuStabilityTester.cpp
     Source/NintendoSwitch/Programs/NintendoSwitch_MenuStabilityTester.h
     Source/NintendoSwitch/Programs/NintendoSwitch_PreventSleep.cpp
@@ -1353,6 +1413,10 @@ file(GLOB LIBRARY_SOURCES
     Source/Pokemon/Options/Pokemon_StatsHuntFilter.h
     Source/Pokemon/Pokemon_BdspRng.cpp
     Source/Pokemon/Pokemon_BdspRng.h
+    Source/Pokemon/Pokemon_BdspRngScan.cpp
+    Source/Pokemon/Pokemon_BdspRngScan.h
+    Source/Pokemon/Pokemon_BdspRngScan_x64_AVX2.cpp
+    Source/Pokemon/Pokemon_BdspRngScan_x64_AVX512.cpp
     Source/Pokemon/Pokemon_BoxCursor.cpp
     Source/Pokemon/Pokemon_BoxCursor.h
     Source/Pokemon/Pokemon_CollectedPokemonInfo.cpp
@@ -2545,6 +2609,8 @@ file(GLOB LIBRARY_SOURCES
     Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterRNGTable.h
     Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedCalc.cpp
     Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedCalc.h
+    Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedIndex.cpp
+    Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterSeedIndex.h
     Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterTools.cpp
     Source/PokemonSV/Programs/ItemPrinter/PokemonSV_ItemPrinterTools.h
     Source/PokemonSV/Programs/PokemonSV_AreaZero.cpp
@@ -2696,6 +2762,8 @@ file(GLOB LIBRARY_SOURCES
     Source/PokemonSwSh/InferenceTraining/PokemonSwSh_GeneratePokedexSprites.h
     Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI.cpp
     Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI.h
+    Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_MatchupTables.cpp
+    Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_MatchupTables.h
     Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_PathMatchup.cpp
     Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_PathMatchup.h
     Source/PokemonSwSh/MaxLair/AI/PokemonSwSh_MaxLair_AI_RentalBossMatchup.cpp
@@ -2990,6 +3058,8 @@ file(GLOB LIBRARY_SOURCES
     Source/PokemonSwSh/ShinyHuntTracker.h
     Source/StaticRegistration.h
     Source/StaticRegistrationQt.cpp
+    Source/Tests/CommandLineTestReport.cpp
+    Source/Tests/CommandLineTestReport.h
     Source/Tests/CommandLineTests.cpp
     Source/Tests/CommandLineTests.h
     Source/Tests/TestMap.cpp